@@ -21,6 +21,7 @@ CL_PLUGIN_API PluginInfo* GetPluginInfo()
     info.SetName(wxT("AutoSave"));
     info.SetDescription(_("Automatically save modified source files"));
     info.SetVersion(wxT("v1.0"));
+    info.EnableFlag(PluginInfo::kLoadOnIdle, true);
     return &info;
 }
 
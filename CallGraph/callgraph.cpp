@@ -76,7 +76,7 @@ CL_PLUGIN_API PluginInfo* GetPluginInfo()
     info.SetName(wxT("CallGraph"));
     info.SetDescription(_("Create application call graph from profiling information provided by gprof tool."));
     info.SetVersion(wxT("v1.1.0"));
-    info.EnableFlag(PluginInfo::kNone, true);
+    info.EnableFlag(PluginInfo::kLoadOnIdle, true);
     return &info;
 }
 
@@ -392,24 +392,10 @@ void CallGraph::OnShowCallGraph(wxCommandEvent& event)
 
     if(!cfn.DirExists()) cfn.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
 
-    cfn.SetFullName(DOT_FILENAME_TXT);
-    wxString dot_fn = cfn.GetFullPath();
+    // the image is reused when the same profile was already rendered with the same settings
+    wxString output_png_fn = dotWriter.RenderToPng(GetDotPath(), cfn.GetPath());
 
-    dotWriter.SendToDotAppOutputDirectory(dot_fn);
-
-    cfn.SetFullName(DOT_FILENAME_PNG);
-    wxString output_png_fn = cfn.GetFullPath();
-
-    // delete any existing PNG
-    if(wxFileExists(output_png_fn)) clRemoveFile(output_png_fn);
-
-    wxString cmddot_ln;
-
-    cmddot_ln << GetDotPath() << " -Tpng -o" << output_png_fn << " " << dot_fn;
-
-    wxExecute(cmddot_ln, wxEXEC_SYNC | wxEXEC_HIDE_CONSOLE);
-
-    if(!wxFileExists(output_png_fn))
+    if(output_png_fn.IsEmpty())
         return MessageBox(_("Failed to open file CallGraph.png. Please check the project settings, rebuild the project "
                             "and try again."),
                           wxICON_INFORMATION);
@@ -24,6 +24,10 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "dotwriter.h"
+#include "fileutils.h"
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
 #include <wx/strconv.h>
 #include <wx/file.h>
 #include <wx/msgdlg.h>
@@ -31,6 +35,29 @@
 #include <wx/regex.h>
 #include <math.h>
 
+namespace
+{
+// number of rendered images kept in the output directory
+const size_t MAX_CACHED_IMAGES = 20;
+
+void PruneCachedImages(const wxString& output_dir, const wxString& spec)
+{
+    wxArrayString files;
+    wxDir::GetAllFiles(output_dir, &files, spec, wxDIR_FILES);
+    if(files.GetCount() <= MAX_CACHED_IMAGES) return;
+
+    // remove the least recently used images
+    std::vector<std::pair<time_t, wxString>> images;
+    for(const wxString& file : files) {
+        images.push_back({ FileUtils::GetFileModificationTime(file), file });
+    }
+    std::sort(images.begin(), images.end());
+    for(size_t i = 0; i < images.size() - MAX_CACHED_IMAGES; i++) {
+        clRemoveFile(images[i].second);
+    }
+}
+} // namespace
+
 DotWriter::DotWriter()
 {
     begin_graph = wxT("digraph\n{");
@@ -98,7 +125,7 @@ void DotWriter::WriteToDotLanguage()
     int pl_index = 0;
     float pl_time = 0;
     bool is_node = false;
-    wxArrayInt index_pl_nodes;
+    std::unordered_set<int> index_pl_nodes;
 
     if(mlines == NULL) return;
 
@@ -120,7 +147,7 @@ void DotWriter::WriteToDotLanguage()
 
         if(line->pline && wxRound(line->time) >= dwtn) {
             is_node = true;
-            index_pl_nodes.Add(line->index);
+            index_pl_nodes.insert(line->index);
             dlabel = wxString::Format(wxT("%i"), line->index);
             dlabel += wxT(" [label=\"");
             dlabel += OptionsShortNameAndParameters(line->name);
@@ -166,7 +193,7 @@ void DotWriter::WriteToDotLanguage()
             pl_time = line->time;   // time for primary node
         }
 
-        if(line->child && IsInArray(line->nameid, index_pl_nodes) && IsInArray(pl_index, index_pl_nodes) &&
+        if(line->child && index_pl_nodes.count(line->nameid) && index_pl_nodes.count(pl_index) &&
            (wxRound(pl_time) >= dwte)) {
             dedge = wxString::Format(wxT("%i"), pl_index);
             dedge += wxT(" -> ");
@@ -208,6 +235,37 @@ bool DotWriter::SendToDotAppOutputDirectory(const wxString& dot_fn)
     return ok;
 }
 
+wxString DotWriter::GetHash() const
+{
+    // the hash must not change between sessions
+    return wxString::Format(wxT("%016llx"), (unsigned long long)FileUtils::GetStableHash(m_OutputString));
+}
+
+wxString DotWriter::RenderToPng(const wxString& dot_exe, const wxString& output_dir)
+{
+    wxFileName png_fn(output_dir, DOT_FILENAME_PNG);
+    const wxString spec = png_fn.GetName() + wxT("-*.") + png_fn.GetExt();
+    png_fn.SetName(png_fn.GetName() + wxT("-") + GetHash());
+
+    if(png_fn.FileExists()) {
+        // this graph was already rendered, the layout of a large graph takes long
+        png_fn.Touch();
+        return png_fn.GetFullPath();
+    }
+
+    wxFileName dot_fn(output_dir, DOT_FILENAME_TXT);
+    if(!SendToDotAppOutputDirectory(dot_fn.GetFullPath())) return wxEmptyString;
+
+    wxString cmddot_ln;
+    cmddot_ln << dot_exe << " -Tpng -o" << png_fn.GetFullPath() << " " << dot_fn.GetFullPath();
+    wxExecute(cmddot_ln, wxEXEC_SYNC | wxEXEC_HIDE_CONSOLE);
+
+    if(!png_fn.FileExists()) return wxEmptyString;
+
+    PruneCachedImages(output_dir, spec);
+    return png_fn.GetFullPath();
+}
+
 wxString DotWriter::OptionsShortNameAndParameters(const wxString& name)
 {
     if((dwhidenamespaces || dwhideparams) && name.Contains(wxT('(')) && name.Contains(wxT(')'))) {
@@ -121,6 +121,18 @@ public:
 	 * @param path for file where write file with DOT language.
 	 */
 	bool SendToDotAppOutputDirectory(const wxString& path);
+	/**
+	 * @brief Function return a hash of the data in the DOT language, it identifies the graph.
+	 */
+	wxString GetHash() const;
+	/**
+	 * @brief Function render the data in the DOT language to a PNG image in the directory output_dir. The images are
+	 * cached by the hash of the graph: when the same graph was already rendered the dot tool is not executed again.
+	 * @param dot_exe path to the dot tool.
+	 * @param output_dir directory for the DOT file and the images.
+	 * @return path of the image or an empty string on failure.
+	 */
+	wxString RenderToPng(const wxString& dot_exe, const wxString& output_dir);
 	
 	/**
 	 * @brief Function return string modified by the options in the dialog settings of the plugin.
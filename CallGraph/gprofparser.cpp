@@ -53,7 +53,6 @@ GprofParser::~GprofParser()
 
 void	GprofParser::GprofParserStream(wxInputStream *gprof_output)
 {
-	wxRegEx re;
 	readlinetext = wxT("");
 	readlinetexttemp = wxT("");
 	wxCSConv conv( wxT("ISO-8859-1") );
@@ -64,6 +63,12 @@ void	GprofParser::GprofParserStream(wxInputStream *gprof_output)
 	isspontaneous = false;
 	calls.clear();
 
+	// compile the expressions once, compiling them for every line took most of the time spent on large profiles
+	wxRegEx reSpaces(wxT("[ ]{2,}"));
+	wxRegEx reRatio(wxT("[0-9]+/[0-9]+"), wxRE_ADVANCED);
+	wxRegEx rePlus(wxT("([0-9]+)\\+([0-9]+)"), wxRE_ADVANCED);
+	const wxString dot = wxLocale::GetInfo(wxLOCALE_DECIMAL_POINT, wxLOCALE_CAT_NUMBER);
+
 	while(!gprof_output->Eof()) {
 		readlinetext = text.ReadLine();
 		//tout.WriteString( readlinetext + wxT("\n") );
@@ -101,8 +106,8 @@ void	GprofParser::GprofParserStream(wxInputStream *gprof_output)
 				line->self = -1;
 				line->time = -1;
 
-				if(re.Compile(wxT("[ ]{2,}")) && re.Matches( readlinetext )) {
-					re.Replace(&readlinetext, wxT(" "));
+				if(reSpaces.IsValid() && reSpaces.Matches( readlinetext )) {
+					reSpaces.Replace(&readlinetext, wxT(" "));
 				}
 
 				if (readlinetext.Contains(wxT("."))) isdot = true;
@@ -112,19 +117,18 @@ void	GprofParser::GprofParserStream(wxInputStream *gprof_output)
 				else iscycle = false;
 
 				//if (readlinetext.Contains(wxT("/"))) islom = true;
-				if(re.Compile( wxT("[0-9]+/[0-9]+"), wxRE_ADVANCED) && re.Matches( readlinetext)) islom = true;
+				if(reRatio.IsValid() && reRatio.Matches( readlinetext)) islom = true;
 				else islom = false;
 
 				//if (readlinetext.Contains(wxT("+"))) isplus = true;
-				if(re.Compile( wxT("([0-9]+)\\+([0-9]+)"), wxRE_ADVANCED) && re.Matches( readlinetext)) { 
+				if(rePlus.IsValid() && rePlus.Matches( readlinetext)) {
 					isplus = true;
 					//readlinetext.Replace( wxT("+"), wxT(" ") );
-					re.Replace(&readlinetext, wxT("\\1 \\2"));
+					rePlus.Replace(&readlinetext, wxT("\\1 \\2"));
 				}
 				else isplus = false;
 
-				wxString dot = wxLocale::GetInfo(wxLOCALE_DECIMAL_POINT, wxLOCALE_CAT_NUMBER);
-				readlinetext.Replace( wxT("."), dot );
+				if (dot != wxT(".")) readlinetext.Replace( wxT("."), dot );
 
 				if ((readlinetext[0] == '[') && (readlinetext[(readlinetext.length()) - 1] == ']')) {
 					primaryline = true;
@@ -262,8 +266,14 @@ void	GprofParser::GprofParserStream(wxInputStream *gprof_output)
 					}
 				}
 				
-				lines.Append( line );
 				calls[ wxRound(line->time) ] = calls[ wxRound(line->time) ] + 1;
+
+				if (line->parents) {
+					// the callers lines are not used by the call graph nor by the table, do not keep them
+					delete line;
+					continue;
+				}
+				lines.Append( line );
 			}
 		} else if (lineheader) {
 			break;
@@ -103,13 +103,20 @@ int uicallgraphpanel::CreateAndInserDataToTable(int node_thr)
     int nr = 0;
     float max_time = -2;
 
+    // add all the rows at once, adding them one by one refreshes the grid for each row
+    int rows = 0;
+    for(const auto line : m_lines) {
+        if(line->pline && wxRound(line->time) >= node_thr) rows++;
+    }
+    wxGridUpdateLocker locker(m_grid);
+    m_grid->AppendRows(rows, true);
+
     while(it) {
         LineParser* line = it->GetData();
 
         if(max_time < line->time) max_time = line->time;
 
         if(line->pline && wxRound(line->time) >= node_thr) {
-            m_grid->AppendRows(1, true);
             // name   time %   self  children    called
             m_grid->SetCellValue(nr, 0, line->name);
             m_grid->SetCellValue(nr, 1, wxString::Format(wxT("%.2f"), line->time));
@@ -133,7 +140,7 @@ int uicallgraphpanel::CreateAndInserDataToTable(int node_thr)
 
 void uicallgraphpanel::OnRefreshClick(wxCommandEvent& event)
 {
-    if(m_grid->GetNumberRows()) m_grid->DeleteRows(0, (m_grid->GetNumberRows() - 1));
+    if(m_grid->GetNumberRows()) m_grid->DeleteRows(0, m_grid->GetNumberRows());
 
     // write to output png file
     DotWriter dw;
@@ -144,22 +151,14 @@ void uicallgraphpanel::OnRefreshClick(wxCommandEvent& event)
 
     dw.WriteToDotLanguage();
 
-    wxFileName cfn(m_pathproject, DOT_FILENAME_TXT);
+    wxFileName cfn(m_pathproject, "");
     cfn.AppendDir(CALLGRAPH_DIR);
     cfn.Normalize();
 
-    wxString dot_fn = cfn.GetFullPath();
-
-    bool ok = dw.SendToDotAppOutputDirectory(dot_fn);
-    if(ok) { // delete any existing PNG
-        if(wxFileExists(m_pathimage)) { clRemoveFile(m_pathimage); }
-
-        wxString cmddot_ln;
-
-        cmddot_ln << confData.GetDotPath() << " -Tpng -o" << m_pathimage << " " << dot_fn;
-
-        wxExecute(cmddot_ln, wxEXEC_SYNC | wxEXEC_HIDE_CONSOLE);
-
+    // going back to thresholds that were already displayed does not execute the dot tool again
+    wxString pathimage = dw.RenderToPng(confData.GetDotPath(), cfn.GetPath());
+    if(!pathimage.IsEmpty()) {
+        m_pathimage = pathimage;
         if(m_bmpOrig.LoadFile(m_pathimage, wxBITMAP_TYPE_PNG)) UpdateImage();
 
     } else
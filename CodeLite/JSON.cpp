@@ -29,6 +29,7 @@
 #include "clFontHelper.h"
 #include "fileutils.h"
 
+#include <ctype.h>
 #include <stdlib.h>
 #include <wx/dynarray.h>
 #include <wx/ffile.h>
@@ -98,19 +99,50 @@ JSONItem JSON::toElement() const
 
 wxString JSON::errorString() const { return _errorString; }
 
+namespace
+{
+/**
+ * @brief find a property by its name. Like cJSON_GetObjectItem, ASCII letters are compared case-insensitive, but the
+ * name does not need to be NULL terminated
+ */
+cJSON* find_property(cJSON* json, std::string_view name)
+{
+    if (!json) {
+        return nullptr;
+    }
+
+    for (cJSON* child = json->child; child; child = child->next) {
+        const char* key = child->string;
+        if (!key) {
+            continue;
+        }
+
+        size_t i = 0;
+        for (; i < name.length() && key[i]; ++i) {
+            if (::tolower((unsigned char)key[i]) != ::tolower((unsigned char)name[i])) {
+                break;
+            }
+        }
+        if (i == name.length() && key[i] == 0) {
+            return child;
+        }
+    }
+    return nullptr;
+}
+} // namespace
+
 JSONItem JSONItem::namedObject(const wxString& name) const
 {
     if (!m_json) {
         return JSONItem(NULL);
     }
 
-    cJSON* obj = cJSON_GetObjectItem(m_json, name.mb_str(wxConvUTF8).data());
-    if (!obj) {
-        return JSONItem(NULL);
-    }
-    return JSONItem(obj);
+    const wxCharBuffer cb = name.mb_str(wxConvUTF8);
+    return namedObject(std::string_view(cb.data(), cb.length()));
 }
 
+JSONItem JSONItem::namedObject(std::string_view name) const { return JSONItem(find_property(m_json, name)); }
+
 void JSON::clear()
 {
     int type = cJSON_Object;
@@ -138,11 +170,20 @@ JSONItem::JSONItem(cJSON* json)
     : m_json(json)
 {
     if (m_json) {
-        m_propertyName = m_json->string ? m_json->string : "";
+        m_propertyNameLoaded = false;
         m_type = m_json->type;
     }
 }
 
+const wxString& JSONItem::GetPropertyName() const
+{
+    if (!m_propertyNameLoaded) {
+        m_propertyNameLoaded = true;
+        m_propertyName = m_json->string ? m_json->string : "";
+    }
+    return m_propertyName;
+}
+
 JSONItem::JSONItem(const wxString& name, double val)
     : m_propertyName(name)
     , m_type(cJSON_Number)
@@ -540,9 +581,11 @@ bool JSONItem::hasNamedObject(const wxString& name) const
         return false;
     }
 
-    cJSON* obj = cJSON_GetObjectItem(m_json, name.mb_str(wxConvUTF8).data());
-    return obj != NULL;
+    const wxCharBuffer cb = name.mb_str(wxConvUTF8);
+    return hasNamedObject(std::string_view(cb.data(), cb.length()));
 }
+
+bool JSONItem::hasNamedObject(std::string_view name) const { return find_property(m_json, name) != nullptr; }
 #if wxUSE_GUI
 JSONItem& JSONItem::addProperty(const wxString& name, const wxPoint& pt)
 {
@@ -643,9 +686,9 @@ wxStringMap_t JSONItem::toStringMap() const
         return res;
     }
 
-    for (int i = 0; i < arraySize(); ++i) {
-        wxString key = arrayItem(i).namedObject("key").toString();
-        wxString val = arrayItem(i).namedObject("value").toString();
+    for (const auto& item : *this) {
+        wxString key = item.namedObject("key").toString();
+        wxString val = item.namedObject("value").toString();
         res.insert(std::make_pair(key, val));
     }
     return res;
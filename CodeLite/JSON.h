@@ -42,6 +42,8 @@
 #endif
 #include "macros.h"
 #include <vector>
+#include <iterator>
+#include <string>
 #include <type_traits>
 // clang-format on
 
@@ -50,10 +52,49 @@
 
 class WXDLLIMPEXP_CL JSONItem
 {
+public:
+    /**
+     * @brief forward iterator over the children of an array (or the properties of an object). Each step is `O(1)`,
+     * so prefer `for (auto item : arr)` over `for (int i = 0; i < arr.arraySize(); ++i) arr[i]` which is `O(n^2)`
+     */
+    class Iterator
+    {
+        cJSON* m_current = nullptr;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef JSONItem value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const JSONItem* pointer;
+        typedef JSONItem reference;
+
+        Iterator(cJSON* current = nullptr)
+            : m_current(current)
+        {
+        }
+
+        JSONItem operator*() const { return JSONItem(m_current); }
+        Iterator& operator++()
+        {
+            m_current = m_current->next;
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator temp = *this;
+            m_current = m_current->next;
+            return temp;
+        }
+        bool operator==(const Iterator& other) const { return m_current == other.m_current; }
+        bool operator!=(const Iterator& other) const { return m_current != other.m_current; }
+    };
+
 protected:
     cJSON* m_json = nullptr;
     cJSON* m_walker = nullptr;
-    wxString m_propertyName;
+    // items that wrap a cJSON node read their name from it on demand
+    mutable wxString m_propertyName;
+    mutable bool m_propertyNameLoaded = true;
     int m_type = wxNOT_FOUND;
 
     // Values
@@ -77,18 +118,37 @@ public:
     ////////////////////////////////////////////////
     void setType(int m_type) { this->m_type = m_type; }
     int getType() const { return m_type; }
-    const wxString& GetPropertyName() const { return m_propertyName; }
-    void SetPropertyName(const wxString& name) { m_propertyName = name; }
+    const wxString& GetPropertyName() const;
+    void SetPropertyName(const wxString& name)
+    {
+        m_propertyName = name;
+        m_propertyNameLoaded = true;
+    }
 
     // Readers
     ////////////////////////////////////////////////
+    /// Keys are matched case-insensitive (same as `cJSON_GetObjectItem`). The `std::string_view` (UTF-8) overloads
+    /// do not convert the key
     JSONItem namedObject(const wxString& name) const;
+    JSONItem namedObject(std::string_view name) const;
+    JSONItem namedObject(const char* name) const { return namedObject(std::string_view(name)); }
+    JSONItem namedObject(const std::string& name) const { return namedObject(std::string_view(name)); }
     bool hasNamedObject(const wxString& name) const;
+    bool hasNamedObject(std::string_view name) const;
+    bool hasNamedObject(const char* name) const { return hasNamedObject(std::string_view(name)); }
+    bool hasNamedObject(const std::string& name) const { return hasNamedObject(std::string_view(name)); }
 
-    /// If your array is big (hundred of entries) use
-    /// `GetAsVector` and iterate it instead
+    /// If your array is big (hundred of entries) iterate it
+    /// with `begin()` / `end()` instead
     JSONItem operator[](int index) const;
     JSONItem operator[](const wxString& name) const;
+    JSONItem operator[](std::string_view name) const { return namedObject(name); }
+    JSONItem operator[](const char* name) const { return namedObject(std::string_view(name)); }
+    JSONItem operator[](const std::string& name) const { return namedObject(std::string_view(name)); }
+
+    /// Iterate the children of this item (array entries or object properties)
+    Iterator begin() const { return Iterator(m_json ? m_json->child : nullptr); }
+    Iterator end() const { return Iterator(); }
 
     /// the C implementation for accessing large arrays, is the sum of an arithmetic progression.
     /// Use this method to get an array with `O(1)` access
@@ -34,9 +34,9 @@ void LSP::CodeActionRequest::OnResponse(const LSP::ResponseMessage& response, wx
     auto& commands = event.GetCommands();
     commands.reserve(count);
 
-    for(size_t i = 0; i < count; ++i) {
+    for(const auto& item : result_arr) {
         LSP::Command cmd;
-        cmd.FromJSON(result_arr[i]);
+        cmd.FromJSON(item);
         commands.push_back(cmd);
     }
 
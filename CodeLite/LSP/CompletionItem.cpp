@@ -32,10 +32,9 @@ void LSP::CompletionItem::FromJSON(const JSONItem& json)
     m_vAdditionalText.clear();
     if(json.hasNamedObject("additionalTextEdits")) {
         JSONItem additionalTextEdits = json.namedObject("additionalTextEdits");
-        int count = additionalTextEdits.arraySize();
-        for(int i = 0; i < count; ++i) {
+        for(const auto& item : additionalTextEdits) {
             wxSharedPtr<TextEdit> edit(new TextEdit());
-            edit->FromJSON(additionalTextEdits.arrayItem(i));
+            edit->FromJSON(item);
             m_vAdditionalText.push_back(edit);
         }
     }
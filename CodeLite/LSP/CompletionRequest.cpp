@@ -41,9 +41,10 @@ void LSP::CompletionRequest::OnResponse(const LSP::ResponseMessage& response, wx
     CompletionItem::Vec_t completions;
     const int itemsCount = pItems->arraySize();
     LSP_DEBUG() << "Read" << itemsCount << "completion items";
-    for(int i = 0; i < itemsCount; ++i) {
+    completions.reserve(itemsCount);
+    for(const auto& item : *pItems) {
         CompletionItem::Ptr_t completionItem(new CompletionItem());
-        completionItem->FromJSON(pItems->arrayItem(i));
+        completionItem->FromJSON(item);
         if(completionItem->GetInsertText().IsEmpty()) {
             completionItem->SetInsertText(completionItem->GetLabel());
         }
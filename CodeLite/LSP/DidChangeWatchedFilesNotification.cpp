@@ -0,0 +1,47 @@
+#include "DidChangeWatchedFilesNotification.hpp"
+
+#include "LSP/basic_types.h"
+
+#include <vector>
+
+namespace LSP
+{
+namespace
+{
+struct DidChangeWatchedFilesParams : public Params {
+    std::vector<std::pair<wxString, int>> m_changes;
+
+    JSONItem ToJSON(const wxString& name) const override
+    {
+        JSONItem json = JSONItem::createObject(name);
+        JSONItem changes = json.AddArray("changes");
+        for (const auto& change : m_changes) {
+            JSONItem event = JSONItem::createObject();
+            event.addProperty("uri", FileNameToURI(change.first));
+            event.addProperty("type", change.second);
+            changes.arrayAppend(event);
+        }
+        return json;
+    }
+
+    void FromJSON(const JSONItem& json) override { wxUnusedVar(json); };
+};
+} // namespace
+
+DidChangeWatchedFilesNotification::DidChangeWatchedFilesNotification(const wxArrayString& created,
+                                                                     const wxArrayString& deleted)
+{
+    SetMethod("workspace/didChangeWatchedFiles");
+    DidChangeWatchedFilesParams* params = new DidChangeWatchedFilesParams();
+    for (const wxString& file : created) {
+        params->m_changes.push_back({ file, kCreated });
+    }
+    for (const wxString& file : deleted) {
+        params->m_changes.push_back({ file, kDeleted });
+    }
+    m_params.reset(params);
+}
+
+DidChangeWatchedFilesNotification::~DidChangeWatchedFilesNotification() {}
+
+} // namespace LSP
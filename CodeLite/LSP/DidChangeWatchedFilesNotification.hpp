@@ -0,0 +1,29 @@
+#ifndef DIDCHANGEWATCHEDFILESNOTIFICATION_HPP
+#define DIDCHANGEWATCHEDFILESNOTIFICATION_HPP
+
+#include "LSP/Notification.h"
+
+#include <wx/arrstr.h>
+
+namespace LSP
+{
+
+/**
+ * @brief "workspace/didChangeWatchedFiles": files were created, modified or deleted outside of the editors
+ */
+class WXDLLIMPEXP_CL DidChangeWatchedFilesNotification : public Notification
+{
+public:
+    enum eFileChangeType {
+        kCreated = 1,
+        kChanged = 2,
+        kDeleted = 3,
+    };
+
+    DidChangeWatchedFilesNotification(const wxArrayString& created, const wxArrayString& deleted);
+    virtual ~DidChangeWatchedFilesNotification();
+};
+
+} // namespace LSP
+
+#endif // DIDCHANGEWATCHEDFILESNOTIFICATION_HPP
@@ -61,9 +61,9 @@ void LSP::DocumentSymbolsRequest::OnResponse(const LSP::ResponseMessage& const_r
             auto result = json->toElement().namedObject("result");
             std::vector<LSP::SymbolInformation> symbols;
             symbols.reserve(size);
-            for(int i = 0; i < size; ++i) {
+            for(const auto& item : result) {
                 SymbolInformation si;
-                si.FromJSON(result[i]);
+                si.FromJSON(item);
                 symbols.push_back(si);
             }
 
@@ -93,9 +93,9 @@ void LSP::DocumentSymbolsRequest::OnResponse(const LSP::ResponseMessage& const_r
         } else {
             std::vector<DocumentSymbol> symbols;
             symbols.reserve(size);
-            for(int i = 0; i < size; ++i) {
+            for(const auto& item : result) {
                 DocumentSymbol ds;
-                ds.FromJSON(result[i]);
+                ds.FromJSON(item);
                 symbols.push_back(ds);
             }
             wxUnusedVar(symbols);
@@ -29,8 +29,7 @@ void LSP::FindReferencesRequest::OnResponse(const LSP::ResponseMessage& response
     std::vector<LSP::Location>& locations = references_event.GetLocations();
     locations.reserve(array_size);
 
-    for(int i = 0; i < array_size; ++i) {
-        auto d = result[i];
+    for(const auto& d : result) {
         LSP::Location loc;
         loc.FromJSON(d);
         locations.emplace_back(loc);
@@ -25,11 +25,9 @@ void LSP::GotoDefinitionRequest::OnResponse(const LSP::ResponseMessage& response
 
     std::vector<LSP::Location> locations;
     if(result.isArray()) {
-        int count = result.arraySize();
-        locations.reserve(count);
-        for(int i = 0; i < count; ++i) {
+        for(const auto& item : result) {
             LSP::Location loc;
-            loc.FromJSON(result.arrayItem(i));
+            loc.FromJSON(item);
             locations.emplace_back(loc);
         }
     } else {
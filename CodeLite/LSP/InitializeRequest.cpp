@@ -82,6 +82,9 @@ JSONItem LSP::InitializeRequest::ToJSON(const wxString& name) const
         tokenModifiers.arrayAppend("modification");
         tokenModifiers.arrayAppend("documentation");
         tokenModifiers.arrayAppend("defaultLibrary");
+
+        // we can apply "textDocument/semanticTokens/full/delta" responses
+        sematicTokens.AddObject("requests").AddObject("full").addProperty("delta", true);
     }
     return json;
 }
@@ -26,6 +26,7 @@ protected:
     LSP::SignatureHelp m_signatureHelp;
     LSP::Hover m_hover;
     std::vector<LSP::Diagnostic> m_diagnostics;
+    int m_diagnosticsVersion = wxNOT_FOUND;
     std::vector<LSP::SymbolInformation> m_symbolsInformation;
     std::vector<LSP::SemanticTokenRange> m_semanticTokens;
     std::vector<LSP::Location> m_locations;                             // used by wxEVT_LSP_REFERENCES
@@ -94,6 +95,12 @@ public:
         return *this;
     }
     const std::vector<LSP::Diagnostic>& GetDiagnostics() const { return m_diagnostics; }
+    LSPEvent& SetDiagnosticsVersion(int diagnosticsVersion)
+    {
+        this->m_diagnosticsVersion = diagnosticsVersion;
+        return *this;
+    }
+    int GetDiagnosticsVersion() const { return m_diagnosticsVersion; }
     void SetSymbolsInformation(const std::vector<LSP::SymbolInformation>& symbolsInformation)
     {
         this->m_symbolsInformation = symbolsInformation;
@@ -50,10 +50,9 @@ std::vector<LSP::Diagnostic> LSP::ResponseMessage::GetDiagnostics() const
 
     std::vector<LSP::Diagnostic> res;
     JSONItem arrDiags = params.namedObject("diagnostics");
-    int size = arrDiags.arraySize();
-    for(int i = 0; i < size; ++i) {
+    for(const auto& item : arrDiags) {
         LSP::Diagnostic d;
-        d.FromJSON(arrDiags.arrayItem(i));
+        d.FromJSON(item);
         res.push_back(d);
     }
     return res;
@@ -68,4 +67,13 @@ wxString LSP::ResponseMessage::GetDiagnosticsUri() const
     return params.namedObject("uri").toString();
 }
 
+int LSP::ResponseMessage::GetDiagnosticsVersion() const
+{
+    JSONItem params = Get("params");
+    if(!params.isOk()) {
+        return wxNOT_FOUND;
+    }
+    return params.namedObject("version").toInt(wxNOT_FOUND);
+}
+
 bool LSP::ResponseMessage::IsErrorResponse() const { return Has("error"); }
@@ -51,6 +51,10 @@ public:
      * @brief return the URI diagnostics
      */
     wxString GetDiagnosticsUri() const;
+    /**
+     * @brief return the document version of the diagnostics, or wxNOT_FOUND if the server did not provide it
+     */
+    int GetDiagnosticsVersion() const;
 };
 }; // namespace LSP
 
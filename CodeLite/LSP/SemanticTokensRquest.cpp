@@ -5,20 +5,53 @@
 #include "file_logger.h"
 #include "json_rpc_params.h"
 
-#include <thread>
+#include <algorithm>
 #include <vector>
 #include <wx/vector.h>
 
-LSP::SemanticTokensRquest::SemanticTokensRquest(const wxString& filename)
+LSP::SemanticTokensRquest::SemanticTokensRquest(const wxString& filename, const wxString& previousResultId,
+                                                std::vector<int> previousData)
     : m_filename(filename)
+    , m_data(std::move(previousData))
 {
-    SetMethod("textDocument/semanticTokens/full");
+    SetMethod(previousResultId.empty() ? "textDocument/semanticTokens/full" : "textDocument/semanticTokens/full/delta");
     m_params.reset(new SemanticTokensParams());
     m_params->As<SemanticTokensParams>()->SetTextDocument(filename);
+    m_params->As<SemanticTokensParams>()->SetPreviousResultId(previousResultId);
 }
 
 LSP::SemanticTokensRquest::~SemanticTokensRquest() {}
 
+bool LSP::SemanticTokensRquest::ApplyEdits(const JSONItem& edits)
+{
+    struct Edit {
+        size_t start = 0;
+        size_t delete_count = 0;
+        std::vector<int> data;
+    };
+
+    std::vector<Edit> all_edits;
+    for(const auto& item : edits) {
+        Edit edit;
+        edit.start = item["start"].toSize_t();
+        edit.delete_count = item["deleteCount"].toSize_t();
+        edit.data = item["data"].toIntArray();
+        all_edits.push_back(std::move(edit));
+    }
+
+    // all the edits refer to the previous array, apply them from the last one so the offsets remain valid
+    std::sort(all_edits.begin(), all_edits.end(),
+              [](const Edit& a, const Edit& b) { return a.start > b.start; });
+    for(const auto& edit : all_edits) {
+        if(edit.start > m_data.size() || edit.delete_count > m_data.size() - edit.start) {
+            return false;
+        }
+        auto where = m_data.erase(m_data.begin() + edit.start, m_data.begin() + edit.start + edit.delete_count);
+        m_data.insert(where, edit.data.begin(), edit.data.end());
+    }
+    return true;
+}
+
 void LSP::SemanticTokensRquest::OnResponse(const LSP::ResponseMessage& response, wxEvtHandler* owner)
 {
     // build set of classes, locals so we can colour them
@@ -26,16 +59,29 @@ void LSP::SemanticTokensRquest::OnResponse(const LSP::ResponseMessage& response,
         return;
     }
 
-    std::vector<int> encoded_types;
-    encoded_types = response["result"]["data"].toIntArray();
+    // a "full/delta" request may be answered with either a full result ("data") or with a list of edits
+    JSONItem result = response["result"];
+    JSONItem edits = result["edits"];
+    if(edits.isOk() && edits.isArray()) {
+        if(!ApplyEdits(edits)) {
+            LSP_WARNING() << "Invalid semantic tokens delta for file:" << m_filename << endl;
+            m_data.clear();
+            m_resultId.clear();
+            return;
+        }
+        LSP_DEBUG() << "Applied" << edits.arraySize() << "semantic tokens edits" << endl;
+    } else {
+        m_data = result["data"].toIntArray();
+    }
+    m_resultId = result["resultId"].toString();
 
-    // since this is CPU heavy processing, spawn a thread to do the job
+    const std::vector<int>& encoded_types = m_data;
     wxString filename = m_filename;
-    wxString server_name = GetServerName();
 
     // sanity: each token is represented by a set of 5 integers
     // { line, startChar, length, tokenType, tokenModifiers}
     if(encoded_types.size() % 5 != 0) {
+        m_resultId.clear();
         return;
     }
 
@@ -5,17 +5,40 @@
 #include "basic_types.h"
 #include "codelite_exports.h"
 
+#include <vector>
+
 namespace LSP
 {
 class WXDLLIMPEXP_CL SemanticTokensRquest : public Request
 {
     wxString m_filename;
+    // the encoded tokens of the previous response, delta requests apply the server edits on top of it
+    std::vector<int> m_data;
+    wxString m_resultId;
+
+protected:
+    bool ApplyEdits(const JSONItem& edits);
 
 public:
-    SemanticTokensRquest(const wxString& filename);
+    /**
+     * @brief request the semantic tokens of `filename`. When `previousResultId` is set, only the changes since that
+     * result are requested ("textDocument/semanticTokens/full/delta"), `previousData` is the encoded tokens array
+     * of that result
+     */
+    SemanticTokensRquest(const wxString& filename, const wxString& previousResultId = wxEmptyString,
+                         std::vector<int> previousData = {});
     ~SemanticTokensRquest();
 
     void OnResponse(const LSP::ResponseMessage& response, wxEvtHandler* owner);
+
+    const wxString& GetFilename() const { return m_filename; }
+
+    /**
+     * @brief the result ID and the encoded tokens, valid once the response was processed. The result ID is empty if
+     * the server does not support delta requests or the response could not be applied
+     */
+    const wxString& GetResultId() const { return m_resultId; }
+    std::vector<int>& GetData() { return m_data; }
 };
 } // namespace LSP
 
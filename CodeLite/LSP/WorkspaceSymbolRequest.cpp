@@ -84,9 +84,9 @@ void LSP::WorkspaceSymbolRequest::OnResponse(const LSP::ResponseMessage& respons
     auto& symbols = symbols_event.GetSymbolsInformation();
     symbols.reserve(size);
 
-    for(int i = 0; i < size; ++i) {
+    for(const auto& item : result) {
         SymbolInformation si;
-        si.FromJSON(result[i]);
+        si.FromJSON(item);
         symbols.push_back(si);
     }
 
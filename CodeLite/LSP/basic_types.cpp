@@ -193,14 +193,10 @@ void SignatureInformation::FromJSON(const JSONItem& json)
     m_parameters.clear();
     if(json.hasNamedObject("parameters")) {
         JSONItem parameters = json.namedObject("parameters");
-        const int size = parameters.arraySize();
-        if(size > 0) {
-            m_parameters.reserve(size);
-            for(int i = 0; i < size; ++i) {
-                ParameterInformation p;
-                p.FromJSON(parameters.arrayItem(i));
-                m_parameters.push_back(p);
-            }
+        for(const auto& parameter : parameters) {
+            ParameterInformation p;
+            p.FromJSON(parameter);
+            m_parameters.push_back(p);
         }
     }
 }
@@ -225,10 +221,9 @@ void SignatureHelp::FromJSON(const JSONItem& json)
     // Read the signatures
     m_signatures.clear();
     JSONItem signatures = json.namedObject("signatures");
-    const int count = signatures.arraySize();
-    for(int i = 0; i < count; ++i) {
+    for(const auto& signature : signatures) {
         SignatureInformation si;
-        si.FromJSON(signatures.arrayItem(i));
+        si.FromJSON(signature);
         m_signatures.push_back(si);
     }
 
@@ -318,11 +313,8 @@ void DocumentSymbol::FromJSON(const JSONItem& json)
 
     // read the children
     auto jsonChildren = json["children"];
-    int size = jsonChildren.arraySize();
     children.clear();
-    children.reserve(size);
-    for(int i = 0; i < size; ++i) {
-        auto child = jsonChildren[i];
+    for(const auto& child : jsonChildren) {
         DocumentSymbol ds;
         ds.FromJSON(child);
         children.push_back(ds);
@@ -407,11 +399,8 @@ std::unordered_map<wxString, std::vector<LSP::TextEdit>> ParseWorkspaceEdit(cons
 
         modifications.reserve(M.size());
         for(const auto& [filepath, json] : M) {
-            int count = json.arraySize();
             std::vector<LSP::TextEdit> file_changes;
-            file_changes.reserve(count);
-            for(int i = 0; i < count; ++i) {
-                auto e = json[i];
+            for(const auto& e : json) {
                 LSP::TextEdit te;
                 te.FromJSON(e);
                 file_changes.push_back(te);
@@ -422,16 +411,12 @@ std::unordered_map<wxString, std::vector<LSP::TextEdit>> ParseWorkspaceEdit(cons
         }
     } else if(result.hasNamedObject("documentChanges")) {
         auto documentChanges = result["documentChanges"];
-        int files_count = documentChanges.arraySize();
-        for(int i = 0; i < files_count; ++i) {
-            auto edits = documentChanges[i]["edits"];
-            wxString filepath = documentChanges[i]["textDocument"]["uri"].toString();
+        for(const auto& documentChange : documentChanges) {
+            auto edits = documentChange["edits"];
+            wxString filepath = documentChange["textDocument"]["uri"].toString();
             filepath = FileUtils::FilePathFromURI(filepath);
             std::vector<LSP::TextEdit> file_changes;
-            int edits_count = edits.arraySize();
-            file_changes.reserve(edits_count);
-            for(int j = 0; j < edits_count; ++j) {
-                auto e = edits[j];
+            for(const auto& e : edits) {
                 LSP::TextEdit te;
                 te.FromJSON(e);
                 file_changes.push_back(te);
@@ -152,6 +152,8 @@ public:
     const Position& GetEnd() const { return m_end; }
     const Position& GetStart() const { return m_start; }
     bool IsOk() const { return m_start.IsOk() && m_end.IsOk(); }
+    bool operator==(const Range& rhs) const { return m_start == rhs.m_start && m_end == rhs.m_end; }
+    bool operator!=(const Range& rhs) const { return !(*this == rhs); }
 };
 
 //===----------------------------------------------------------------------------------
@@ -529,6 +531,11 @@ public:
     const wxString& GetMessage() const { return m_message; }
     void SetSeverity(const DiagnosticSeverity& severity) { this->m_severity = severity; }
     const DiagnosticSeverity& GetSeverity() const { return m_severity; }
+    bool operator==(const Diagnostic& rhs) const
+    {
+        return m_severity == rhs.m_severity && m_range == rhs.m_range && m_message == rhs.m_message;
+    }
+    bool operator!=(const Diagnostic& rhs) const { return !(*this == rhs); }
 };
 
 class WXDLLIMPEXP_CL Command : public Serializable
@@ -26,12 +26,19 @@ JSONItem TextDocumentPositionParams::ToJSON(const wxString& name) const
 //===----------------------------------------------
 SemanticTokensParams::SemanticTokensParams() {}
 
-void SemanticTokensParams::FromJSON(const JSONItem& json) { m_textDocument.FromJSON(json["textDocument"]); }
+void SemanticTokensParams::FromJSON(const JSONItem& json)
+{
+    m_textDocument.FromJSON(json["textDocument"]);
+    m_previousResultId = json["previousResultId"].toString();
+}
 
 JSONItem SemanticTokensParams::ToJSON(const wxString& name) const
 {
     JSONItem json = JSONItem::createObject(name);
     json.append(m_textDocument.ToJSON("textDocument"));
+    if(!m_previousResultId.empty()) {
+        json.addProperty("previousResultId", m_previousResultId);
+    }
     return json;
 }
 
@@ -74,10 +81,9 @@ void DidChangeTextDocumentParams::FromJSON(const JSONItem& json)
     m_contentChanges.clear();
     if(json.hasNamedObject("contentChanges")) {
         JSONItem arr = json.namedObject("contentChanges");
-        int count = arr.arraySize();
-        for(int i = 0; i < count; ++i) {
+        for(const auto& item : arr) {
             TextDocumentContentChangeEvent c;
-            c.FromJSON(arr.arrayItem(i));
+            c.FromJSON(item);
             m_contentChanges.push_back(c);
         }
     }
@@ -92,6 +92,7 @@ public:
 class WXDLLIMPEXP_CL SemanticTokensParams : public Params
 {
     TextDocumentIdentifier m_textDocument;
+    wxString m_previousResultId; // set for "textDocument/semanticTokens/full/delta" requests
 
 public:
     SemanticTokensParams();
@@ -102,6 +103,8 @@ public:
 
     void SetTextDocument(const TextDocumentIdentifier& textDocument) { this->m_textDocument = textDocument; }
     const TextDocumentIdentifier& GetTextDocument() const { return m_textDocument; }
+    void SetPreviousResultId(const wxString& previousResultId) { this->m_previousResultId = previousResultId; }
+    const wxString& GetPreviousResultId() const { return m_previousResultId; }
 };
 
 struct WXDLLIMPEXP_CL SemanticTokenRange {
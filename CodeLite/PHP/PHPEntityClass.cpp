@@ -31,7 +31,7 @@ void PHPEntityClass::Store(PHPLookupTable* lookup)
 {
     try {
         wxSQLite3Database& db = lookup->Database();
-        wxSQLite3Statement statement = db.PrepareStatement(
+        wxSQLite3Statement& statement = lookup->GetCachedStatement(
             "REPLACE INTO SCOPE_TABLE (ID, SCOPE_TYPE, SCOPE_ID, NAME, FULLNAME, EXTENDS, "
             "IMPLEMENTS, USING_TRAITS, FLAGS, DOC_COMMENT, "
             "LINE_NUMBER, FILE_NAME) VALUES (NULL, 1, :SCOPE_ID, :NAME, :FULLNAME, :EXTENDS, "
@@ -25,7 +25,7 @@ void PHPEntityFunctionAlias::Store(PHPLookupTable* lookup)
 {
     try {
         wxSQLite3Database& db = lookup->Database();
-        wxSQLite3Statement statement = db.PrepareStatement(
+        wxSQLite3Statement& statement = lookup->GetCachedStatement(
             "INSERT OR REPLACE INTO FUNCTION_ALIAS_TABLE VALUES(NULL, :SCOPE_ID, :NAME, :REALNAME, :FULLNAME, :SCOPE, "
             ":LINE_NUMBER, :FILE_NAME)");
         statement.Bind(statement.GetParamIndex(":SCOPE_ID"), Parent()->GetDbId());
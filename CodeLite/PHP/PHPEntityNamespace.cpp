@@ -44,7 +44,7 @@ void PHPEntityNamespace::Store(PHPLookupTable* lookup)
         DoEnsureNamespacePathExists(db, parentPath);
 
         {
-            wxSQLite3Statement statement = db.PrepareStatement(
+            wxSQLite3Statement& statement = lookup->GetCachedStatement(
                 "INSERT INTO SCOPE_TABLE (ID, SCOPE_TYPE, SCOPE_ID, NAME, FULLNAME, LINE_NUMBER, FILE_NAME) "
                 "VALUES (NULL, 0, -1, :NAME, :FULLNAME, :LINE_NUMBER, :FILE_NAME)");
             statement.Bind(statement.GetParamIndex(":NAME"), GetShortName());
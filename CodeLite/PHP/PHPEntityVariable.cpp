@@ -85,7 +85,7 @@ void PHPEntityVariable::Store(PHPLookupTable* lookup)
     if(IsFunctionArg() || IsMember() || IsDefine()) {
         try {
             wxSQLite3Database& db = lookup->Database();
-            wxSQLite3Statement statement = db.PrepareStatement(
+            wxSQLite3Statement& statement = lookup->GetCachedStatement(
                 "INSERT OR REPLACE INTO VARIABLES_TABLE VALUES (NULL, "
                 ":SCOPE_ID, :FUNCTION_ID, :NAME, :FULLNAME, :SCOPE, :TYPEHINT, :DEFAULT_VALUE, "
                 ":FLAGS, :DOC_COMMENT, :LINE_NUMBER, :FILE_NAME)");
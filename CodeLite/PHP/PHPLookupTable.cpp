@@ -12,6 +12,12 @@
 #include "fileutils.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <wx/ffile.h>
 #include <wx/filename.h>
 #include <wx/log.h>
 #include <wx/stopwatch.h>
@@ -21,7 +27,7 @@ wxDEFINE_EVENT(wxPHP_PARSE_STARTED, clParseEvent);
 wxDEFINE_EVENT(wxPHP_PARSE_ENDED, clParseEvent);
 wxDEFINE_EVENT(wxPHP_PARSE_PROGRESS, clParseEvent);
 
-static wxString PHP_SCHEMA_VERSION = "9.3.0.1";
+static wxString PHP_SCHEMA_VERSION = "9.3.0.2";
 
 //------------------------------------------------
 // Metadata table
@@ -156,11 +162,39 @@ const static wxString CREATE_PHPDOC_VAR_TABLE_SQL_IDX2 =
 const static wxString CREATE_FILES_TABLE_SQL =
     "CREATE TABLE IF NOT EXISTS FILES_TABLE(ID INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, "
     "FILE_NAME TEXT, "                        // for global variable or class member this will be the scope_id parent id
-    "LAST_UPDATED INTEGER NOT NULL DEFAULT 0" // for function argument
+    "LAST_UPDATED INTEGER NOT NULL DEFAULT 0, "
+    "CONTENT_HASH INTEGER NOT NULL DEFAULT 0" // hash of the content that was parsed, 0 if unknown
     ")";
 const static wxString CREATE_FILES_TABLE_SQL_IDX1 =
     "CREATE UNIQUE INDEX IF NOT EXISTS FILES_TABLE_IDX_1 ON FILES_TABLE(FILE_NAME)";
 
+namespace
+{
+// the maximum number of parsed files waiting to be stored
+const size_t MAX_PENDING_FILES = 256;
+
+wxLongLong HashContent(const char* data, size_t len)
+{
+    return wxLongLong((wxInt64)FileUtils::GetStableHash(data, len));
+}
+
+bool ReadFileBytes(const wxFileName& filename, std::string& content)
+{
+    wxLogNull noLog;
+    wxFFile fp(filename.GetFullPath(), "rb");
+    if(!fp.IsOpened()) {
+        return false;
+    }
+
+    wxFileOffset len = fp.Length();
+    if(len < 0) {
+        return false;
+    }
+    content.resize(len);
+    return len == 0 || fp.Read(&content[0], len) == (size_t)len;
+}
+} // namespace
+
 PHPLookupTable::PHPLookupTable()
     : m_sizeLimit(50)
 {
@@ -331,7 +365,7 @@ void PHPLookupTable::CreateSchema()
     }
 }
 
-void PHPLookupTable::UpdateSourceFile(PHPSourceFile& source, bool autoCommit)
+void PHPLookupTable::UpdateSourceFile(PHPSourceFile& source, bool autoCommit, wxLongLong contentHash)
 {
     try {
         if(autoCommit)
@@ -344,7 +378,7 @@ void PHPLookupTable::UpdateSourceFile(PHPSourceFile& source, bool autoCommit)
         PHPEntityBase::Ptr_t topNamespace = source.Namespace();
         if(topNamespace) {
             topNamespace->StoreRecursive(this);
-            UpdateFileLastParsedTimestamp(source.GetFilename());
+            UpdateFileLastParsedTimestamp(source.GetFilename(), contentHash);
         }
 
         // Store defines
@@ -772,7 +806,7 @@ void PHPLookupTable::DeleteFileEntries(const wxFileName& filename, bool autoComm
             wxString sql;
             sql << "delete from SCOPE_TABLE where FILE_NAME=:FILE_NAME AND SCOPE_TYPE != "
                 << (int)kPhpScopeTypeNamespace;
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
+            wxSQLite3Statement& st = GetCachedStatement(sql);
             st.Bind(st.GetParamIndex(":FILE_NAME"), filename.GetFullPath());
             st.ExecuteUpdate();
         }
@@ -780,7 +814,7 @@ void PHPLookupTable::DeleteFileEntries(const wxFileName& filename, bool autoComm
         {
             wxString sql;
             sql << "delete from FUNCTION_TABLE where FILE_NAME=:FILE_NAME";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
+            wxSQLite3Statement& st = GetCachedStatement(sql);
             st.Bind(st.GetParamIndex(":FILE_NAME"), filename.GetFullPath());
             st.ExecuteUpdate();
         }
@@ -788,7 +822,7 @@ void PHPLookupTable::DeleteFileEntries(const wxFileName& filename, bool autoComm
         {
             wxString sql;
             sql << "delete from FUNCTION_ALIAS_TABLE where FILE_NAME=:FILE_NAME";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
+            wxSQLite3Statement& st = GetCachedStatement(sql);
             st.Bind(st.GetParamIndex(":FILE_NAME"), filename.GetFullPath());
             st.ExecuteUpdate();
         }
@@ -796,7 +830,7 @@ void PHPLookupTable::DeleteFileEntries(const wxFileName& filename, bool autoComm
         {
             wxString sql;
             sql << "delete from VARIABLES_TABLE where FILE_NAME=:FILE_NAME";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
+            wxSQLite3Statement& st = GetCachedStatement(sql);
             st.Bind(st.GetParamIndex(":FILE_NAME"), filename.GetFullPath());
             st.ExecuteUpdate();
         }
@@ -804,7 +838,7 @@ void PHPLookupTable::DeleteFileEntries(const wxFileName& filename, bool autoComm
         {
             wxString sql;
             sql << "delete from FILES_TABLE where FILE_NAME=:FILE_NAME";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
+            wxSQLite3Statement& st = GetCachedStatement(sql);
             st.Bind(st.GetParamIndex(":FILE_NAME"), filename.GetFullPath());
             st.ExecuteUpdate();
         }
@@ -812,7 +846,7 @@ void PHPLookupTable::DeleteFileEntries(const wxFileName& filename, bool autoComm
         {
             wxString sql;
             sql << "delete from PHPDOC_VAR_TABLE where FILE_NAME=:FILE_NAME";
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
+            wxSQLite3Statement& st = GetCachedStatement(sql);
             st.Bind(st.GetParamIndex(":FILE_NAME"), filename.GetFullPath());
             st.ExecuteUpdate();
         }
@@ -829,10 +863,13 @@ void PHPLookupTable::DeleteFileEntries(const wxFileName& filename, bool autoComm
 void PHPLookupTable::Close()
 {
     try {
+        // the statements must be finalized before the database is closed
+        m_statements.clear();
         if(m_db.IsOpen()) {
             m_db.Close();
         }
         m_filename.Clear();
+        std::lock_guard<std::mutex> lock(m_allClassesMutex);
         m_allClasses.clear();
 
     } catch (const wxSQLite3Exception& e) {
@@ -967,13 +1004,15 @@ wxLongLong PHPLookupTable::GetFileLastParsedTimestamp(const wxFileName& filename
     return 0;
 }
 
-void PHPLookupTable::UpdateFileLastParsedTimestamp(const wxFileName& filename)
+void PHPLookupTable::UpdateFileLastParsedTimestamp(const wxFileName& filename, wxLongLong contentHash)
 {
     try {
-        wxSQLite3Statement st = m_db.PrepareStatement(
-            "REPLACE INTO FILES_TABLE (ID, FILE_NAME, LAST_UPDATED) VALUES (NULL, :FILE_NAME, :LAST_UPDATED)");
+        wxSQLite3Statement& st =
+            GetCachedStatement("REPLACE INTO FILES_TABLE (ID, FILE_NAME, LAST_UPDATED, CONTENT_HASH) VALUES (NULL, "
+                               ":FILE_NAME, :LAST_UPDATED, :CONTENT_HASH)");
         st.Bind(st.GetParamIndex(":FILE_NAME"), filename.GetFullPath());
         st.Bind(st.GetParamIndex(":LAST_UPDATED"), (wxLongLong)time(NULL));
+        st.Bind(st.GetParamIndex(":CONTENT_HASH"), contentHash);
         st.ExecuteUpdate();
 
     } catch (const wxSQLite3Exception& e) {
@@ -1306,18 +1345,24 @@ void PHPLookupTable::DoFixVarsDocComment(PHPEntityBase::List_t& matches, wxLongL
 
 void PHPLookupTable::UpdateClassCache(const wxString& classname)
 {
-    if(m_allClasses.count(classname) == 0) {
-        m_allClasses.insert(classname);
-    }
+    std::lock_guard<std::mutex> lock(m_allClassesMutex);
+    m_allClasses.insert(classname);
 }
 
-bool PHPLookupTable::ClassExists(const wxString& classname) const { return m_allClasses.count(classname) != 0; }
+bool PHPLookupTable::ClassExists(const wxString& classname) const
+{
+    std::lock_guard<std::mutex> lock(m_allClassesMutex);
+    return m_allClasses.count(classname) != 0;
+}
 
 void PHPLookupTable::RebuildClassCache()
 {
     // locate the scope
     clDEBUG() << "Rebuilding PHP class cache..." << clEndl;
-    m_allClasses.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_allClassesMutex);
+        m_allClasses.clear();
+    }
     size_t count = 0;
     try {
         wxString sql;
@@ -1359,3 +1404,283 @@ size_t PHPLookupTable::FindFunctionsByFile(const wxFileName& filename, PHPEntity
     }
     return functions.size();
 }
+
+wxSQLite3Statement& PHPLookupTable::GetCachedStatement(const wxString& sql)
+{
+    auto iter = m_statements.find(sql);
+    if(iter == m_statements.end()) {
+        // PrepareStatement throws on error, so only valid statements are cached
+        iter = m_statements.insert({ sql, m_db.PrepareStatement(sql) }).first;
+    }
+    return iter->second;
+}
+
+void PHPLookupTable::LoadFilesTable(std::unordered_map<wxString, FileInfo>& files)
+{
+    try {
+        wxSQLite3ResultSet res = m_db.ExecuteQuery("SELECT FILE_NAME, LAST_UPDATED, CONTENT_HASH FROM FILES_TABLE");
+        while(res.NextRow()) {
+            FileInfo info;
+            info.lastUpdated = res.GetInt64("LAST_UPDATED");
+            info.contentHash = res.GetInt64("CONTENT_HASH");
+            files.insert({ res.GetString("FILE_NAME"), info });
+        }
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "PHPLookupTable::LoadFilesTable:" << e.GetMessage() << clEndl;
+    }
+}
+
+void PHPLookupTable::ResolveDeferredTypehints(
+    const std::unordered_map<wxString, std::unordered_set<wxString>>& typehints)
+{
+    size_t count = 0;
+    for(const auto& vt : typehints) {
+        std::set<wxLongLong> functions;
+        for(const wxString& typehint : vt.second) {
+            if(ClassExists(typehint)) {
+                continue;
+            }
+
+            wxString globalTypehint = "\\" + typehint.AfterLast('\\');
+            {
+                wxSQLite3Statement st = m_db.PrepareStatement(
+                    "SELECT DISTINCT FUNCTION_ID FROM VARIABLES_TABLE WHERE FILE_NAME=:FILE_NAME AND "
+                    "TYPEHINT=:TYPEHINT AND FUNCTION_ID != -1");
+                st.Bind(st.GetParamIndex(":FILE_NAME"), vt.first);
+                st.Bind(st.GetParamIndex(":TYPEHINT"), typehint);
+                wxSQLite3ResultSet res = st.ExecuteQuery();
+                while(res.NextRow()) {
+                    functions.insert(res.GetInt64("FUNCTION_ID"));
+                }
+            }
+
+            wxSQLite3Statement& update = GetCachedStatement(
+                "UPDATE VARIABLES_TABLE SET TYPEHINT=:GLOBAL_TYPEHINT WHERE FILE_NAME=:FILE_NAME AND "
+                "TYPEHINT=:TYPEHINT AND FUNCTION_ID != -1");
+            update.Bind(update.GetParamIndex(":GLOBAL_TYPEHINT"), globalTypehint);
+            update.Bind(update.GetParamIndex(":FILE_NAME"), vt.first);
+            update.Bind(update.GetParamIndex(":TYPEHINT"), typehint);
+            update.ExecuteUpdate();
+        }
+
+        // the stored signatures embed the argument type hints, format them again
+        for(const wxLongLong& functionId : functions) {
+            wxString signature;
+            {
+                wxString sql;
+                sql << "SELECT SIGNATURE FROM FUNCTION_TABLE WHERE ID=" << functionId;
+                wxSQLite3ResultSet res = m_db.ExecuteQuery(sql);
+                if(!res.NextRow()) {
+                    continue;
+                }
+                signature = res.GetString("SIGNATURE");
+            }
+
+            wxString strSignature = "(";
+            for(const auto& arg : LoadFunctionArguments(functionId)) {
+                strSignature << arg->Cast<PHPEntityVariable>()->ToFuncArgString() << ", ";
+            }
+            if(strSignature.EndsWith(", ")) {
+                strSignature.RemoveLast(2);
+            }
+            // keep the return value
+            strSignature << ")" << signature.AfterLast(')');
+
+            wxSQLite3Statement& update =
+                GetCachedStatement("UPDATE FUNCTION_TABLE SET SIGNATURE=:SIGNATURE WHERE ID=:ID");
+            update.Bind(update.GetParamIndex(":SIGNATURE"), strSignature);
+            update.Bind(update.GetParamIndex(":ID"), functionId);
+            update.ExecuteUpdate();
+            ++count;
+        }
+    }
+    clDEBUG() << "PHP: updated the signature of" << count << "functions with global type hints" << clEndl;
+}
+
+void PHPLookupTable::DoRecreateSymbolsDatabase(const wxArrayString& files, eUpdateMode updateMode,
+                                               const std::function<bool()>& goingDown, bool parseFuncBodies)
+{
+    {
+        clParseEvent event(wxPHP_PARSE_STARTED);
+        event.SetTotalFiles(files.GetCount());
+        event.SetCurfileIndex(0);
+        EventNotifier::Get()->AddPendingEvent(event);
+    }
+
+    wxStopWatch sw;
+    sw.Start();
+
+    std::unordered_map<wxString, FileInfo> filesTable;
+    LoadFilesTable(filesTable);
+
+    // Parse only valid PHP files that exist. In fast mode, skip the files that were not modified since they were last
+    // stored
+    std::vector<wxFileName> jobs;
+    jobs.reserve(files.GetCount());
+    for(const wxString& file : files) {
+        wxFileName fnFile(file);
+        if(FileExtManager::GetType(fnFile.GetFullName()) != FileExtManager::TypePhp || !fnFile.Exists()) {
+            continue;
+        }
+
+        if(updateMode == kUpdateMode_Fast) {
+            auto iter = filesTable.find(fnFile.GetFullPath());
+            if(iter != filesTable.end() &&
+               (wxLongLong)FileUtils::GetFileModificationTime(fnFile) <= iter->second.lastUpdated) {
+                continue;
+            }
+        }
+        jobs.push_back(fnFile);
+    }
+
+    struct Result {
+        wxFileName filename;
+        wxLongLong contentHash;
+        std::unique_ptr<PHPSourceFile> source; // null when the content did not change
+    };
+
+    std::atomic_bool cancelled{ false };
+    std::atomic_size_t next{ 0 };
+    std::mutex mutex;
+    std::condition_variable cvFull;
+    std::condition_variable cvEmpty;
+    std::deque<Result> pending;
+    size_t producers = 0;
+
+    auto worker = [&]() {
+        std::string raw;
+        while(!cancelled.load()) {
+            size_t index = next++;
+            if(index >= jobs.size()) {
+                break;
+            }
+
+            const wxFileName& fnFile = jobs[index];
+            if(!ReadFileBytes(fnFile, raw)) {
+                clWARNING() << "PHP: Failed to read file:" << fnFile << "for parsing" << clEndl;
+                continue;
+            }
+
+            Result result;
+            result.filename = fnFile;
+            result.contentHash = HashContent(raw.c_str(), raw.length());
+
+            // A full update re-parses everything: the symbols of a file also depend on the classes defined by the
+            // other files
+            auto iter = filesTable.find(fnFile.GetFullPath());
+            bool unchanged = updateMode == kUpdateMode_Fast && iter != filesTable.end() &&
+                             iter->second.contentHash != 0 && iter->second.contentHash == result.contentHash;
+            if(!unchanged) {
+                wxString content(raw.c_str(), wxConvISO8859_1, raw.length());
+                result.source.reset(new PHPSourceFile(content, this));
+                result.source->SetDeferTypehintLookup(true);
+                result.source->SetFilename(fnFile);
+                result.source->SetParseFunctionBody(parseFuncBodies);
+                result.source->Parse();
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            cvFull.wait(lock, [&]() { return pending.size() < MAX_PENDING_FILES || cancelled.load(); });
+            pending.push_back(std::move(result));
+            cvEmpty.notify_one();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        --producers;
+        cvEmpty.notify_one();
+    };
+
+    size_t threadsCount = std::max(1u, std::thread::hardware_concurrency());
+    // the calling thread is the database writer
+    threadsCount = std::min(std::max<size_t>(1, threadsCount - 1), std::max<size_t>(1, jobs.size()));
+
+    std::vector<std::thread> workers;
+    producers = threadsCount;
+    for(size_t i = 0; i < threadsCount; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    auto stopWorkers = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cancelled.store(true);
+        }
+        cvFull.notify_all();
+        for(auto& t : workers) {
+            t.join();
+        }
+        workers.clear();
+    };
+
+    size_t parsed = 0;
+    size_t skipped = files.GetCount() - jobs.size();
+    std::unordered_map<wxString, std::unordered_set<wxString>> deferredTypehints;
+    try {
+        m_db.Begin();
+        size_t stored = 0;
+        while(true) {
+            if(goingDown()) {
+                break;
+            }
+
+            Result result;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cvEmpty.wait(lock, [&]() { return !pending.empty() || producers == 0; });
+                if(pending.empty()) {
+                    break;
+                }
+                result = std::move(pending.front());
+                pending.pop_front();
+                cvFull.notify_one();
+            }
+
+            {
+                clParseEvent event(wxPHP_PARSE_PROGRESS);
+                event.SetTotalFiles(files.GetCount());
+                event.SetCurfileIndex(skipped + stored);
+                event.SetFileName(result.filename.GetFullPath());
+                EventNotifier::Get()->AddPendingEvent(event);
+            }
+            ++stored;
+
+            if(result.source) {
+                UpdateSourceFile(*result.source, false, result.contentHash);
+                if(!result.source->GetDeferredTypehints().empty()) {
+                    deferredTypehints.insert({ result.filename.GetFullPath(), result.source->GetDeferredTypehints() });
+                }
+                ++parsed;
+            } else {
+                // same content: the symbols are up to date, only mark the file as checked
+                UpdateFileLastParsedTimestamp(result.filename, result.contentHash);
+            }
+        }
+        stopWorkers();
+
+        // all the files are stored: the class cache is now complete and the type hints can be resolved the same way
+        // regardless of the order in which the files were parsed
+        RebuildClassCache();
+        ResolveDeferredTypehints(deferredTypehints);
+        m_db.Commit();
+
+    } catch (const wxSQLite3Exception& e) {
+        stopWorkers();
+        try {
+            m_db.Rollback();
+
+        } catch (...) {
+        }
+        clWARNING() << "PHPLookupTable::UpdateSourceFiles:" << e.GetMessage() << clEndl;
+    }
+
+    clDEBUG() << "PHP: parsed" << parsed << "out of" << files.GetCount() << "files (" << threadsCount
+              << "threads) in" << sw.Time() << "milliseconds" << clEndl;
+
+    {
+        // always make sure that the end event is sent
+        clParseEvent event(wxPHP_PARSE_ENDED);
+        event.SetTotalFiles(files.GetCount());
+        event.SetCurfileIndex(files.GetCount());
+        EventNotifier::Get()->AddPendingEvent(event);
+    }
+}
@@ -36,7 +36,10 @@
 #include "fileutils.h"
 #include "wxStringHash.h"
 
+#include <functional>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <wx/longlong.h>
@@ -65,6 +68,9 @@ class WXDLLIMPEXP_CL PHPLookupTable
     wxFileName m_filename;
     size_t m_sizeLimit;
     std::unordered_set<wxString> m_allClasses;
+    // the class cache is queried by the parser threads while the symbols are being stored
+    mutable std::mutex m_allClassesMutex;
+    std::unordered_map<wxString, wxSQLite3Statement> m_statements;
 
 public:
     enum eLookupFlags {
@@ -91,6 +97,11 @@ public:
 
     static void DoSplitFullname(const wxString& fullname, wxString& ns, wxString& shortName);
 
+    struct FileInfo {
+        wxLongLong lastUpdated = 0;
+        wxLongLong contentHash = 0;
+    };
+
 private:
     void EnsureIntegrity(const wxFileName& filename);
     void DoAddNameFilter(wxString& sql, const wxString& nameHint, size_t flags);
@@ -147,9 +158,25 @@ private:
     wxLongLong GetFileLastParsedTimestamp(const wxFileName& filename);
 
     /**
-     * @brief update the file's last updated timestamp
+     * @brief update the file's last updated timestamp and the hash of the content that was parsed
+     */
+    void UpdateFileLastParsedTimestamp(const wxFileName& filename, wxLongLong contentHash = 0);
+
+    /**
+     * @brief load the whole files table (one query instead of one per file)
+     */
+    void LoadFilesTable(std::unordered_map<wxString, FileInfo>& files);
+
+    /**
+     * @brief fall back to the global namespace for the function argument type hints that were resolved to the file
+     * namespace while parsing (see PHPSourceFile::SetDeferTypehintLookup) but do not name a known class. Must be
+     * called once all the files are stored and the class cache is complete
+     * @param typehints file name => the namespace candidates recorded while parsing it
      */
-    void UpdateFileLastParsedTimestamp(const wxFileName& filename);
+    void ResolveDeferredTypehints(const std::unordered_map<wxString, std::unordered_set<wxString>>& typehints);
+
+    void DoRecreateSymbolsDatabase(const wxArrayString& files, eUpdateMode updateMode,
+                                   const std::function<bool()>& goingDown, bool parseFuncBodies);
 
     /**
      * @brief check the database disk image to see if it corrupted
@@ -265,11 +292,14 @@ public:
                          eLookupFlags flags = kLookupFlags_Contains);
     /**
      * @brief save source file into the database
+     * @param contentHash the hash of the parsed content, used to skip the file when it is indexed again unchanged
      */
-    void UpdateSourceFile(PHPSourceFile& source, bool autoCommit = true);
+    void UpdateSourceFile(PHPSourceFile& source, bool autoCommit = true, wxLongLong contentHash = 0);
 
     /**
-     * @brief update list of source files
+     * @brief update list of source files. The files are parsed by a pool of threads while the calling thread stores
+     * the results in the database, in a single transaction. Files whose content did not change since they were last
+     * stored are skipped
      */
     template <typename GoindDownFunc>
     void RecreateSymbolsDatabase(const wxArrayString& files, eUpdateMode updateMode, GoindDownFunc pFuncGoingDown,
@@ -292,113 +322,19 @@ public:
      * @brief return reference to the underlying database
      */
     wxSQLite3Database& Database() { return m_db; }
+
+    /**
+     * @brief return a statement for `sql`, prepared on its first use and kept until the database is closed.
+     * Used by the insert paths which run the same statements once per symbol
+     */
+    wxSQLite3Statement& GetCachedStatement(const wxString& sql);
 };
 
 template <typename GoindDownFunc>
 void PHPLookupTable::RecreateSymbolsDatabase(const wxArrayString& files, eUpdateMode updateMode,
                                              GoindDownFunc pFuncGoingDown, bool parseFuncBodies)
 {
-    try {
-
-        {
-            clParseEvent event(wxPHP_PARSE_STARTED);
-            event.SetTotalFiles(files.GetCount());
-            event.SetCurfileIndex(0);
-            EventNotifier::Get()->AddPendingEvent(event);
-        }
-
-        wxStopWatch sw;
-        sw.Start();
-
-        m_allClasses.clear(); // clear the cache
-        m_db.Begin();
-        for(size_t i = 0; i < files.GetCount(); ++i) {
-            if(pFuncGoingDown()) {
-                break;
-            }
-            {
-                clParseEvent event(wxPHP_PARSE_PROGRESS);
-                event.SetTotalFiles(files.GetCount());
-                event.SetCurfileIndex(i);
-                event.SetFileName(files.Item(i));
-                EventNotifier::Get()->AddPendingEvent(event);
-            }
-
-            wxFileName fnFile(files.Item(i));
-            bool reParseNeeded(true);
-
-            if(updateMode == kUpdateMode_Fast) {
-                // Check to see if we need to re-parse this file
-                // and store it to the database
-
-                if(!fnFile.Exists()) {
-                    reParseNeeded = false;
-                } else {
-                    time_t lastModifiedOnDisk = fnFile.GetModificationTime().GetTicks();
-                    wxLongLong lastModifiedInDB = GetFileLastParsedTimestamp(fnFile);
-                    if(lastModifiedOnDisk <= lastModifiedInDB.ToLong()) {
-                        reParseNeeded = false;
-                    }
-                }
-            }
-
-            // Ensure that the file exists
-            if(!fnFile.Exists()) {
-                reParseNeeded = false;
-            }
-
-            // Parse only valid PHP files
-            if(FileExtManager::GetType(fnFile.GetFullName()) != FileExtManager::TypePhp) {
-                reParseNeeded = false;
-            }
-
-            if(reParseNeeded) {
-                // For performance reaons, load the file into memory and then parse it
-                wxFileName fnSourceFile(files.Item(i));
-                wxString content;
-                if(!FileUtils::ReadFileContent(fnSourceFile, content, wxConvISO8859_1)) {
-                    clWARNING() << "PHP: Failed to read file:" << fnSourceFile << "for parsing" << clEndl;
-                    continue;
-                }
-                PHPSourceFile sourceFile(content, this);
-                sourceFile.SetFilename(fnSourceFile);
-                sourceFile.SetParseFunctionBody(parseFuncBodies);
-                sourceFile.Parse();
-                UpdateSourceFile(sourceFile, false);
-            }
-        }
-        m_db.Commit();
-        long elapsedMs = sw.Time();
-
-        LOG_IF_TRACE
-        {
-            clDEBUG1() << _("PHP: parsed ") << files.GetCount() << " in " << elapsedMs << " milliseconds" << clEndl;
-        }
-
-        {
-            clParseEvent event(wxPHP_PARSE_ENDED);
-            event.SetTotalFiles(files.GetCount());
-            event.SetCurfileIndex(files.GetCount());
-            EventNotifier::Get()->AddPendingEvent(event);
-        }
-
-    } catch (const wxSQLite3Exception& e) {
-        try {
-            m_db.Rollback();
-
-        } catch (...) {
-        }
-
-        {
-            // always make sure that the end event is sent
-            clParseEvent event(wxPHP_PARSE_ENDED);
-            event.SetTotalFiles(files.GetCount());
-            event.SetCurfileIndex(files.GetCount());
-            EventNotifier::Get()->AddPendingEvent(event);
-        }
-
-        clWARNING() << "PHPLookupTable::UpdateSourceFiles:" << e.GetMessage() << clEndl;
-    }
+    DoRecreateSymbolsDatabase(files, updateMode, pFuncGoingDown, parseFuncBodies);
 }
 
 #endif // PHPLOOKUPTABLE_H
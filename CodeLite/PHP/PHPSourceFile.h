@@ -29,6 +29,8 @@
 #include "PHPEntityBase.h"
 #include "PhpLexerAPI.h"
 #include "codelite_exports.h"
+#include "wxStringHash.h"
+#include <unordered_set>
 #include <vector>
 #include <wx/filename.h>
 
@@ -51,6 +53,8 @@ class WXDLLIMPEXP_CL PHPSourceFile
     PHPSourceFile* m_converter = nullptr;
     PHPLookupTable* m_lookup = nullptr;
     PHPEntityBase::List_t m_allMatchesInorder;
+    bool m_deferTypehintLookup = false;
+    std::unordered_set<wxString> m_deferredTypehints;
 
 public:
     typedef wxSharedPtr<PHPSourceFile> Ptr_t;
@@ -304,6 +308,14 @@ public:
     const wxFileName& GetFilename() const { return m_filename; }
     void SetParseFunctionBody(bool parseFunctionBody) { this->m_parseFunctionBody = parseFunctionBody; }
     bool IsParseFunctionBody() const { return m_parseFunctionBody; }
+
+    /**
+     * @brief when set, an unqualified type hint is always resolved to the file namespace and recorded instead of
+     * being checked against the lookup table class cache. Used by the indexer threads: the caller resolves the
+     * recorded type hints once all the files are stored (see PHPLookupTable::ResolveDeferredTypehints)
+     */
+    void SetDeferTypehintLookup(bool deferTypehintLookup) { this->m_deferTypehintLookup = deferTypehintLookup; }
+    const std::unordered_set<wxString>& GetDeferredTypehints() const { return m_deferredTypehints; }
 };
 
 #endif // PHPPARSER_H
@@ -108,6 +108,7 @@ private:
     int m_commentEndLine;
     bool m_insidePhp;
     FILE* m_fp;
+    int m_bracketCount;
 
 public:
     void Clear()
@@ -117,6 +118,7 @@ public:
         }
         m_fp = NULL;
         m_insidePhp = false;
+        m_bracketCount = 0;
         ClearComment();
         m_rawStringLabel.clear();
         m_string.clear();
@@ -128,11 +130,18 @@ public:
         , m_commentEndLine(wxNOT_FOUND)
         , m_insidePhp(false)
         , m_fp(NULL)
+        , m_bracketCount(0)
     {
     }
 
     ~phpLexerUserData() { Clear(); }
     void SetFp(FILE* fp) { this->m_fp = fp; }
+    /**
+     * @brief the nesting depth of the '#[...]' attribute being scanned. Kept per scanner (and not as a global) so
+     * files can be scanned concurrently
+     */
+    void SetBracketCount(int count) { this->m_bracketCount = count; }
+    int GetBracketCount() const { return m_bracketCount; }
     /**
      * @brief do we collect comments?
      */
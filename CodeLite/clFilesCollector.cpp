@@ -68,6 +68,20 @@ bool IsRelPathContainedInSpec(const wxString& rootPath, const wxString& fullPath
 }
 } // namespace
 
+bool clFilesScanner::IsExcludedFolder(const wxString& rootFolder, const wxString& fullpath,
+                                      const wxStringSet_t& excludeFolders)
+{
+    // Use FileUtils::RealPath() here to cope with symlinks on Linux
+#if defined(__FreeBSD__)
+    if (FileUtils::IsSymlink(fullpath) && excludeFolders.count(FileUtils::RealPath(fullpath))) {
+#else
+    if (excludeFolders.count(FileUtils::RealPath(fullpath))) {
+#endif
+        return true;
+    }
+    return IsRelPathContainedInSpec(rootFolder, fullpath, excludeFolders);
+}
+
 size_t clFilesScanner::Scan(const wxString& rootFolder, std::vector<wxString>& filesOutput, const wxString& filespec,
                             const wxString& excludeFilespec, const wxStringSet_t& excludeFolders)
 {
@@ -110,16 +124,7 @@ size_t clFilesScanner::Scan(const wxString& rootFolder, std::vector<wxString>& f
             filename.MakeLower();
 #endif
             bool isDirectory = wxFileName::DirExists(fullpath);
-            // Use FileUtils::RealPath() here to cope with symlinks on Linux
-            bool isExcludeDir =
-                isDirectory &&
-                (
-#if defined(__FreeBSD__)
-                    ((FileUtils::IsSymlink(fullpath) && excludeFolders.count(FileUtils::RealPath(fullpath)))
-#else
-                    (excludeFolders.count(FileUtils::RealPath(fullpath))
-#endif
-                     || IsRelPathContainedInSpec(rootFolder, fullpath, excludeFolders)));
+            bool isExcludeDir = isDirectory && IsExcludedFolder(rootFolder, fullpath, excludeFolders);
             if (isDirectory && !isExcludeDir) {
                 // Traverse into this folder
                 wxString realPath = FileUtils::RealPath(fullpath);
@@ -59,6 +59,13 @@ public:
      */
     size_t Scan(const wxString& rootFolder, const wxString& filespec, const wxString& excludeFilespec,
                 const wxString& excludeFoldersSpec, std::function<bool(const wxString&)>&& collect_cb);
+    /**
+     * @brief return true if `fullpath`, a folder found under `rootFolder`, is excluded by `excludeFolders`.
+     * This is the test used by Scan()
+     */
+    static bool IsExcludedFolder(const wxString& rootFolder, const wxString& fullpath,
+                                 const wxStringSet_t& excludeFolders);
+
     /**
      * @brief scan folder for files and folders. This function does not recurse into folders. Everything that matches
      * "matchSpec" will get collected.
@@ -0,0 +1,327 @@
+#include "clFilesSnapshot.h"
+
+#include "clFilesCollector.h"
+#include "file_logger.h"
+#include "fileutils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/thread.h>
+#include <wx/tokenzr.h>
+
+namespace
+{
+const char SNAPSHOT_MAGIC[] = "CLFILES1";
+const size_t SNAPSHOT_MAGIC_LEN = sizeof(SNAPSHOT_MAGIC) - 1;
+
+void WriteU64(std::string& buffer, wxUint64 value) { buffer.append(reinterpret_cast<const char*>(&value), 8); }
+
+void WriteString(std::string& buffer, const wxString& str)
+{
+    const wxScopedCharBuffer cb = str.mb_str(wxConvUTF8);
+    WriteU64(buffer, cb.length());
+    buffer.append(cb.data(), cb.length());
+}
+
+class SnapshotReader
+{
+    const std::string& m_buffer;
+    size_t m_pos = 0;
+    bool m_ok = true;
+
+public:
+    SnapshotReader(const std::string& buffer, size_t pos)
+        : m_buffer(buffer)
+        , m_pos(pos)
+    {
+    }
+
+    bool IsOk() const { return m_ok; }
+
+    wxUint64 ReadU64()
+    {
+        wxUint64 value = 0;
+        if (!m_ok || m_pos + 8 > m_buffer.size()) {
+            m_ok = false;
+            return 0;
+        }
+        memcpy(&value, m_buffer.data() + m_pos, 8);
+        m_pos += 8;
+        return value;
+    }
+
+    wxString ReadString()
+    {
+        wxUint64 len = ReadU64();
+        if (!m_ok || len > m_buffer.size() - m_pos) {
+            m_ok = false;
+            return wxEmptyString;
+        }
+        wxString str = wxString::FromUTF8(m_buffer.data() + m_pos, len);
+        m_pos += len;
+        return str;
+    }
+};
+
+std::vector<wxString> SortedExcludes(const wxStringSet_t& excludes)
+{
+    std::vector<wxString> v{ excludes.begin(), excludes.end() };
+    std::sort(v.begin(), v.end());
+    return v;
+}
+} // namespace
+
+clFilesSnapshot::clFilesSnapshot(const wxString& root, const wxString& filespec, const wxStringSet_t& excludeFolders)
+    : m_root(root)
+    , m_filespec(filespec)
+    , m_excludeFolders(excludeFolders)
+{
+#ifdef __WXMSW__
+    m_specArr = ::wxStringTokenize(m_filespec.Lower(), ";,|", wxTOKEN_STRTOK);
+#else
+    m_specArr = ::wxStringTokenize(m_filespec, ";,|", wxTOKEN_STRTOK);
+#endif
+}
+
+wxString clFilesSnapshot::Join(const wxString& folder, const wxString& name)
+{
+    wxString fullpath;
+    fullpath.reserve(folder.length() + name.length() + 1);
+    fullpath << folder;
+    if (!fullpath.EndsWith(wxFILE_SEP_PATH)) {
+        fullpath << wxFILE_SEP_PATH;
+    }
+    fullpath << name;
+    return fullpath;
+}
+
+bool clFilesSnapshot::Load(const wxFileName& file)
+{
+    wxFFile fp(file.GetFullPath(), "rb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
+
+    std::string buffer;
+    buffer.resize(fp.Length());
+    if (buffer.empty() || fp.Read(&buffer[0], buffer.size()) != buffer.size()) {
+        return false;
+    }
+
+    if (buffer.compare(0, SNAPSHOT_MAGIC_LEN, SNAPSHOT_MAGIC) != 0) {
+        clDEBUG() << "Files snapshot:" << file << "has an unknown format" << endl;
+        return false;
+    }
+
+    SnapshotReader reader(buffer, SNAPSHOT_MAGIC_LEN);
+    if (reader.ReadString() != m_root || reader.ReadString() != m_filespec) {
+        clDEBUG() << "Files snapshot:" << file << "was built with different settings" << endl;
+        return false;
+    }
+
+    auto excludes = SortedExcludes(m_excludeFolders);
+    if (reader.ReadU64() != excludes.size()) {
+        return false;
+    }
+    for (const wxString& exclude : excludes) {
+        if (reader.ReadString() != exclude) {
+            clDEBUG() << "Files snapshot:" << file << "was built with different settings" << endl;
+            return false;
+        }
+    }
+
+    std::unordered_map<wxString, Folder> folders;
+    size_t filesCount = 0;
+    wxUint64 foldersCount = reader.ReadU64();
+    for (wxUint64 i = 0; i < foldersCount && reader.IsOk(); ++i) {
+        wxString path = reader.ReadString();
+        Folder& folder = folders[path];
+        folder.mtime = (time_t)reader.ReadU64();
+
+        wxUint64 count = reader.ReadU64();
+        for (wxUint64 j = 0; j < count && reader.IsOk(); ++j) {
+            folder.files.push_back(reader.ReadString());
+        }
+        filesCount += folder.files.size();
+
+        count = reader.ReadU64();
+        for (wxUint64 j = 0; j < count && reader.IsOk(); ++j) {
+            folder.folders.push_back(reader.ReadString());
+        }
+    }
+
+    if (!reader.IsOk()) {
+        clWARNING() << "Files snapshot:" << file << "is corrupted" << endl;
+        return false;
+    }
+
+    m_folders.swap(folders);
+    m_filesCount = filesCount;
+    clDEBUG() << "Files snapshot: loaded" << m_filesCount << "files," << m_folders.size() << "folders from" << file
+              << endl;
+    return true;
+}
+
+bool clFilesSnapshot::Save(const wxFileName& file) const
+{
+    std::string buffer;
+    buffer.append(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_LEN);
+    WriteString(buffer, m_root);
+    WriteString(buffer, m_filespec);
+
+    auto excludes = SortedExcludes(m_excludeFolders);
+    WriteU64(buffer, excludes.size());
+    for (const wxString& exclude : excludes) {
+        WriteString(buffer, exclude);
+    }
+
+    WriteU64(buffer, m_folders.size());
+    for (const auto& vt : m_folders) {
+        WriteString(buffer, vt.first);
+        WriteU64(buffer, (wxUint64)vt.second.mtime);
+        WriteU64(buffer, vt.second.files.size());
+        for (const wxString& name : vt.second.files) {
+            WriteString(buffer, name);
+        }
+        WriteU64(buffer, vt.second.folders.size());
+        for (const wxString& name : vt.second.folders) {
+            WriteString(buffer, name);
+        }
+    }
+
+    // write to a temporary file and rename it, so a reader never sees a partial file. The name of the temporary file
+    // is unique per thread, since two updates of the same snapshot might run concurrently
+    wxFileName tmpfile = file;
+    tmpfile.SetFullName(wxString::Format("%s.%lu.tmp", file.GetFullName(), (unsigned long)wxThread::GetCurrentId()));
+    if (!FileUtils::WriteFileContentRaw(tmpfile, buffer)) {
+        return false;
+    }
+    return ::wxRenameFile(tmpfile.GetFullPath(), file.GetFullPath(), true);
+}
+
+void clFilesSnapshot::ReadFolder(const wxString& path, Folder& folder) const
+{
+    folder.files.clear();
+    folder.folders.clear();
+    folder.mtime = FileUtils::GetFileModificationTime(path);
+    if (folder.mtime + 2 > time(nullptr)) {
+        // the folder was modified within the timestamp resolution: it might change again without changing its
+        // modification time. Read it again on the next update
+        folder.mtime = 0;
+    }
+
+    wxDir dir(path);
+    if (!dir.IsOpened()) {
+        return;
+    }
+
+    wxString filename;
+    bool cont = dir.GetFirst(&filename);
+    while (cont) {
+        wxString fullpath = Join(path, filename);
+        if (wxFileName::DirExists(fullpath)) {
+            if (!clFilesScanner::IsExcludedFolder(m_root, fullpath, m_excludeFolders)) {
+                folder.folders.push_back(filename);
+            }
+        } else {
+#ifdef __WXMSW__
+            wxString name = filename.Lower();
+#else
+            const wxString& name = filename;
+#endif
+            if (FileUtils::WildMatch(m_specArr, name)) {
+                folder.files.push_back(filename);
+            }
+        }
+        cont = dir.GetNext(&filename);
+    }
+}
+
+size_t clFilesSnapshot::Update(Delta& delta)
+{
+    std::unordered_map<wxString, Folder> folders;
+    std::unordered_set<wxString> visitedReal;
+    std::vector<wxString> Q;
+    size_t folders_read = 0;
+    size_t filesCount = 0;
+
+    if (wxFileName::DirExists(m_root)) {
+        Q.push_back(m_root);
+        visitedReal.insert(FileUtils::RealPath(m_root));
+    }
+
+    while (!Q.empty()) {
+        wxString path = std::move(Q.back());
+        Q.pop_back();
+        if (folders.count(path)) {
+            continue;
+        }
+
+        auto iter = m_folders.find(path);
+        Folder& folder = folders[path];
+        if (iter != m_folders.end() && iter->second.mtime != 0 &&
+            iter->second.mtime == FileUtils::GetFileModificationTime(path)) {
+            // unchanged
+            folder = std::move(iter->second);
+            m_folders.erase(iter);
+
+        } else {
+            ReadFolder(path, folder);
+            ++folders_read;
+
+            // report the difference with the previous content of this folder
+            std::unordered_set<wxString> before;
+            if (iter != m_folders.end()) {
+                before.insert(iter->second.files.begin(), iter->second.files.end());
+                m_folders.erase(iter);
+            }
+            for (const wxString& name : folder.files) {
+                if (before.erase(name) == 0) {
+                    delta.added.push_back(Join(path, name));
+                }
+            }
+            for (const wxString& name : before) {
+                delta.removed.push_back(Join(path, name));
+            }
+
+            // avoid following symlinks that lead back to a folder that was already read
+            std::vector<wxString> subfolders;
+            subfolders.reserve(folder.folders.size());
+            for (const wxString& name : folder.folders) {
+                if (visitedReal.insert(FileUtils::RealPath(Join(path, name))).second) {
+                    subfolders.push_back(name);
+                }
+            }
+            folder.folders.swap(subfolders);
+        }
+
+        filesCount += folder.files.size();
+        for (const wxString& name : folder.folders) {
+            Q.push_back(Join(path, name));
+        }
+    }
+
+    // folders that are no longer reachable (deleted, excluded or renamed)
+    for (const auto& vt : m_folders) {
+        for (const wxString& name : vt.second.files) {
+            delta.removed.push_back(Join(vt.first, name));
+        }
+    }
+
+    m_folders.swap(folders);
+    m_filesCount = filesCount;
+    return folders_read;
+}
+
+void clFilesSnapshot::GetFiles(std::vector<wxString>& files) const
+{
+    files.reserve(files.size() + m_filesCount);
+    for (const auto& vt : m_folders) {
+        for (const wxString& name : vt.second.files) {
+            files.push_back(Join(vt.first, name));
+        }
+    }
+}
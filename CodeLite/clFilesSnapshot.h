@@ -0,0 +1,71 @@
+#ifndef CLFILESSNAPSHOT_H
+#define CLFILESSNAPSHOT_H
+
+#include "codelite_exports.h"
+#include "macros.h"
+#include "wxStringHash.h"
+
+#include <ctime>
+#include <unordered_map>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+/**
+ * @brief the list of files found under a root folder, kept per folder together with the folder modification time.
+ * Adding, removing or renaming an entry changes the modification time of its parent folder, so an update only needs
+ * to stat the folders: only the folders that changed are read again.
+ * The snapshot can be saved to (and loaded from) a compact binary file. It produces the same files as
+ * clFilesScanner::Scan() with the same arguments
+ */
+class WXDLLIMPEXP_CL clFilesSnapshot
+{
+public:
+    struct Folder {
+        time_t mtime = 0;
+        std::vector<wxString> files;   // names of the matching files
+        std::vector<wxString> folders; // names of the sub folders that are traversed
+    };
+
+    struct Delta {
+        std::vector<wxString> added;
+        std::vector<wxString> removed;
+        bool empty() const { return added.empty() && removed.empty(); }
+    };
+
+protected:
+    wxString m_root;
+    wxString m_filespec;
+    wxStringSet_t m_excludeFolders;
+    wxArrayString m_specArr;
+    std::unordered_map<wxString, Folder> m_folders;
+    size_t m_filesCount = 0;
+
+protected:
+    void ReadFolder(const wxString& path, Folder& folder) const;
+    static wxString Join(const wxString& folder, const wxString& name);
+
+public:
+    clFilesSnapshot(const wxString& root, const wxString& filespec, const wxStringSet_t& excludeFolders);
+    ~clFilesSnapshot() = default;
+
+    /**
+     * @brief load a snapshot. A file built for a different root, file spec or excluded folders is rejected
+     */
+    bool Load(const wxFileName& file);
+    bool Save(const wxFileName& file) const;
+
+    /**
+     * @brief bring the snapshot up to date. Folders whose modification time did not change are not read.
+     * `delta` holds the files that were added or removed since the previous update (or since the snapshot was
+     * loaded). Return the number of folders that were read
+     */
+    size_t Update(Delta& delta);
+
+    void GetFiles(std::vector<wxString>& files) const;
+    size_t GetFilesCount() const { return m_filesCount; }
+    size_t GetFoldersCount() const { return m_folders.size(); }
+};
+
+#endif // CLFILESSNAPSHOT_H
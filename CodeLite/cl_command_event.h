@@ -899,6 +899,8 @@ protected:
     wxArrayString m_languages;
     eAction m_action = kInvalidAction;
     wxString m_rootUri;
+    wxArrayString m_createdFiles;
+    wxArrayString m_deletedFiles;
 
 public:
     clLanguageServerEvent(wxEventType commandType = wxEVT_NULL, int winid = 0);
@@ -926,6 +928,10 @@ public:
     const wxString& GetRootUri() const { return m_rootUri; }
     void SetEnviroment(const clEnvList_t& enviroment) { this->m_enviroment = enviroment; }
     const clEnvList_t& GetEnviroment() const { return m_enviroment; }
+    void SetCreatedFiles(const wxArrayString& createdFiles) { this->m_createdFiles = createdFiles; }
+    const wxArrayString& GetCreatedFiles() const { return m_createdFiles; }
+    void SetDeletedFiles(const wxArrayString& deletedFiles) { this->m_deletedFiles = deletedFiles; }
+    const wxArrayString& GetDeletedFiles() const { return m_deletedFiles; }
 };
 
 using clLanguageServerEventFunction = void (wxEvtHandler::*)(clLanguageServerEvent&);
@@ -216,6 +216,7 @@ wxDEFINE_EVENT(wxEVT_LSP_STOP, clLanguageServerEvent);
 wxDEFINE_EVENT(wxEVT_LSP_START, clLanguageServerEvent);
 wxDEFINE_EVENT(wxEVT_LSP_RESTART, clLanguageServerEvent);
 wxDEFINE_EVENT(wxEVT_LSP_DELETE, clLanguageServerEvent);
+wxDEFINE_EVENT(wxEVT_LSP_WATCHED_FILES_CHANGED, clLanguageServerEvent);
 wxDEFINE_EVENT(wxEVT_LSP_CONFIGURE, clLanguageServerEvent);
 wxDEFINE_EVENT(wxEVT_LSP_OPEN_SETTINGS_DLG, clLanguageServerEvent);
 wxDEFINE_EVENT(wxEVT_LSP_ENABLE_SERVER, clLanguageServerEvent);
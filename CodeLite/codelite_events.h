@@ -963,6 +963,9 @@ wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxEVT_LSP_START, clLanguageServerEvent)
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxEVT_LSP_RESTART, clLanguageServerEvent);
 // delete a single LSP identified by event.GetLspName()
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxEVT_LSP_DELETE, clLanguageServerEvent);
+// tell a single LSP identified by event.GetLspName() that files were created (event.GetCreatedFiles()) or deleted
+// (event.GetDeletedFiles()) outside of the editors, without restarting it
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxEVT_LSP_WATCHED_FILES_CHANGED, clLanguageServerEvent);
 // configure new LSP
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxEVT_LSP_CONFIGURE, clLanguageServerEvent);
 // Enable server
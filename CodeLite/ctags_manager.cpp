@@ -33,7 +33,9 @@
 #include "codelite_events.h"
 #include "database/tags_storage_sqlite3.h"
 #include "event_notifier.h"
+#include "file_logger.h"
 #include "fileextmanager.h"
+#include "fileutils.h"
 #include "precompiled_header.h"
 
 #include <algorithm>
@@ -513,11 +515,12 @@ wxString TagsManager::DoReplaceMacros(const wxString& name)
     return _name;
 }
 
-void TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db)
+void TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db, wxStringMap_t* hashes)
 {
     std::vector<FileEntryPtr> files_entries;
     db->GetFiles(files_entries);
     std::unordered_set<wxString> files_set;
+    size_t unchanged_content = 0;
 
     for(size_t i = 0; i < strFiles.GetCount(); i++) {
         files_set.insert(strFiles.Item(i));
@@ -541,10 +544,32 @@ void TagsManager::FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITags
             // if the timestamp from the database < then the actual timestamp, re-tag the file
             if(fe->GetLastRetaggedTimestamp() >= modified) {
                 files_set.erase(iter);
+
+            } else if(!fe->GetHash().empty()) {
+                wxString hash = FileUtils::GetFileHash(*iter);
+                if(fe->GetHash() == hash) {
+                    // the file was touched (e.g. by a branch switch) but its content is the one that was tagged: keep
+                    // its tags and store the new timestamp, so the file is not hashed again on the next call
+                    if(unchanged_content == 0) {
+                        db->Begin();
+                    }
+                    db->UpdateFileEntry(fe->GetFile(), modified, fe->GetHash());
+                    ++unchanged_content;
+                    files_set.erase(iter);
+
+                } else if(hashes) {
+                    // the caller re-tags the file, no need to read it again
+                    (*hashes)[*iter] = hash;
+                }
             }
         }
     }
 
+    if(unchanged_content) {
+        db->Commit();
+        clDEBUG() << "Skipping" << unchanged_content << "modified files with unchanged content" << endl;
+    }
+
     // copy back the files to the array
     strFiles.Clear();
     strFiles.Alloc(files_set.size());
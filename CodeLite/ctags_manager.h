@@ -309,8 +309,10 @@ public:
      * @brief filter a recently tagged files from the strFiles array
      * @param strFiles
      * @param db
+     * @param hashes [output] if provided, the content hash of the remaining files that were hashed while filtering
      */
-    void FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db);
+    void FilterNonNeededFilesForRetaging(wxArrayString& strFiles, ITagsStoragePtr db,
+                                         wxStringMap_t* hashes = nullptr);
 
     /**
      * @brief insert functionBody into clsname. This function will search for best location
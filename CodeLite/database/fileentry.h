@@ -34,6 +34,7 @@ class FileEntry
 	long      m_id;
 	wxString  m_file;
 	int       m_lastRetaggedTimestamp;
+	wxString  m_hash;
 
 public:
 	FileEntry();
@@ -50,6 +51,11 @@ public:
 	int GetLastRetaggedTimestamp() const { return m_lastRetaggedTimestamp; }
 	void SetId(long id) { this->m_id = id; }
 	long GetId() const { return m_id; }
+	void SetHash(const wxString& hash) { this->m_hash = hash; }
+	/**
+	 * @brief hash of the file content when it was retagged (see FileUtils::GetFileHash()). Empty if unknown
+	 */
+	const wxString& GetHash() const { return m_hash; }
 };
 using FileEntryPtr = std::unique_ptr<FileEntry>;
 
@@ -32,6 +32,7 @@
 #include "pptable.h"
 #include "tag_tree.h"
 
+#include <functional>
 #include <memory>
 #include <wx/filename.h>
 
@@ -54,6 +55,8 @@ protected:
 
 public:
     enum { OrderNone, OrderAsc, OrderDesc };
+    typedef std::function<void(long id, const wxString& name, const wxString& path, const wxString& file)>
+        TagNameCallback_t;
 
 public:
     ITagsStorage()
@@ -205,17 +208,19 @@ public:
     /**
      * @brief insert entry by file name
      * @param filename
+     * @param hash hash of the content that was retagged (see FileUtils::GetFileHash()), empty if unknown
      * @return
      */
-    virtual int InsertFileEntry(const wxString& filename, int timestamp) = 0;
+    virtual int InsertFileEntry(const wxString& filename, int timestamp, const wxString& hash = wxEmptyString) = 0;
 
     /**
      * @brief update file entry using file name as key
      * @param filename
      * @param timestamp new timestamp
+     * @param hash hash of the content that was retagged, empty if unknown
      * @return
      */
-    virtual int UpdateFileEntry(const wxString& filename, int timestamp) = 0;
+    virtual int UpdateFileEntry(const wxString& filename, int timestamp, const wxString& hash = wxEmptyString) = 0;
 
     // -------------------------- TagEntry -------------------------------------------
     /**
@@ -316,6 +321,25 @@ public:
      */
     virtual const bool IsOpen() const = 0;
 
+    /**
+     * @brief answer the code completion lookups from a read-only snapshot of the tags table (when one that matches
+     * the database content exists), instead of running SQL queries. Whether the snapshot still matches the database
+     * is checked once, on the first lookup that follows a call to RecheckSnapshot()
+     */
+    virtual void SetUseSnapshot(bool useSnapshot) = 0;
+
+    /**
+     * @brief check again, on the next lookup, whether the snapshot matches the database. Call this at the start of
+     * each request, so the lookups of a request do not query the database state one by one
+     */
+    virtual void RecheckSnapshot() = 0;
+
+    /**
+     * @brief build the snapshot of the tags table. Call this once the indexing is done, and again once incremental
+     * updates settle: the connections that use the snapshot load the new one on their next check
+     */
+    virtual bool BuildSnapshot() = 0;
+
     /**
      * @brief return list of tags by scopes and kinds
      * @param scopes array of possible scopes
@@ -346,6 +370,17 @@ public:
      */
     virtual void GetTagsByPartName(const wxArrayString& parts, std::vector<TagEntryPtr>& tags) = 0;
 
+    /**
+     * @brief return the tags with the given IDs, in the order of `ids`. IDs that no longer exist are skipped
+     */
+    virtual void GetTagsByIds(const std::vector<long>& ids, std::vector<TagEntryPtr>& tags) = 0;
+
+    /**
+     * @brief call `callback` with the ID, name, path and file of the tags found in `files` (of all the tags, if
+     * `files` is empty). No TagEntry is created, this is meant for building indexes over the whole table
+     */
+    virtual void EnumerateTagNames(const wxArrayString& files, const TagNameCallback_t& callback) = 0;
+
     /**
      * @brief search for a single match in the database for an entry with a given name
      */
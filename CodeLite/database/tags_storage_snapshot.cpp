@@ -0,0 +1,817 @@
+#include "tags_storage_snapshot.h"
+
+#include "StdToWX.h"
+#include "file_logger.h"
+#include "fileutils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+#include <wx/ffile.h>
+#include <wx/log.h>
+#include <wx/wxsqlite3.h>
+
+#ifndef __WXMSW__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+const wxUint32 SNAPSHOT_MAGIC = 0x53544c43; // "CLTS"
+// bump this whenever the file layout or the hash function changes
+const wxUint32 SNAPSHOT_VERSION = 2;
+const wxUint32 NOT_FOUND = 0xFFFFFFFF;
+
+// The file layout. All the numbers are stored in the native byte order (the file is a local cache, it is never
+// shared between machines):
+// Header
+// wxUint32 ids[rows]
+// wxInt32 lines[rows]
+// wxUint32 columns[COL_COUNT][rows]      string pool offsets
+// wxUint32 name_index[rows]              rows ordered by (case-folded name, ID)
+// wxUint32 indexes[INDEX_COUNT][rows]    rows ordered by (string pool offset, ID)
+// wxUint32 buckets[buckets]              string pool offsets, open addressing (linear probing)
+// char strings[strings_size]             NULL terminated strings, padded to 4 bytes
+// wxUint32 magic
+struct Header {
+    wxUint32 magic;
+    wxUint32 version;
+    wxUint64 max_id;
+    wxUint64 count;
+    wxUint32 rows;
+    wxUint32 buckets;
+    wxUint32 strings_size;
+    wxUint32 reserved;
+};
+static_assert(sizeof(Header) == 40, "unexpected snapshot header size");
+
+// the "tags" table column of each TagsSnapshot::eColumn
+const int SQL_COLUMNS[TagsSnapshot::COL_COUNT] = { 1, 2, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+// the column of each TagsSnapshot::eIndex
+const TagsSnapshot::eColumn INDEX_COLUMNS[TagsSnapshot::INDEX_COUNT] = {
+    TagsSnapshot::COL_FILE,
+    TagsSnapshot::COL_PATH,
+    TagsSnapshot::COL_SCOPE,
+    TagsSnapshot::COL_PARENT,
+};
+
+wxUint32 Hash(const char* str, size_t len)
+{
+    wxUint64 hash = FileUtils::GetStableHash(str, len);
+    return (wxUint32)(hash ^ (hash >> 32));
+}
+
+inline unsigned char Fold(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (unsigned char)(c + ('a' - 'A')) : (unsigned char)c;
+}
+
+/**
+ * @brief compare two strings, ignoring the case of ASCII letters (SQLite's LIKE does the same)
+ */
+int CompareFolded(const char* a, const char* b)
+{
+    for(; *a && Fold(*a) == Fold(*b); ++a, ++b) {
+    }
+    return (int)Fold(*a) - (int)Fold(*b);
+}
+
+/**
+ * @brief compare the first `len` characters of `str` with `prefix`, ignoring the case of ASCII letters
+ */
+int ComparePrefixFolded(const char* str, const char* prefix, size_t len)
+{
+    for(size_t i = 0; i < len; ++i) {
+        if(str[i] == 0) {
+            return -1;
+        }
+        int diff = (int)Fold(str[i]) - (int)Fold(prefix[i]);
+        if(diff != 0) {
+            return diff;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief SQL LIKE: '%' matches any sequence, '_' matches a single character and `escape` (when not 0) makes the
+ * next pattern character literal. ASCII letters are compared case-insensitive
+ */
+bool Like(const char* str, const char* pattern, const char* pattern_end, char escape)
+{
+    while(pattern != pattern_end) {
+        char p = *pattern;
+        if(p == '%') {
+            while(pattern != pattern_end && *pattern == '%') {
+                ++pattern;
+            }
+            if(pattern == pattern_end) {
+                return true;
+            }
+            for(; *str; ++str) {
+                if(Like(str, pattern, pattern_end, escape)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        if(*str == 0) {
+            return false;
+        }
+
+        if(p == '_') {
+            // a single UTF-8 character
+            ++str;
+            while((*str & 0xC0) == 0x80) {
+                ++str;
+            }
+            ++pattern;
+            continue;
+        }
+
+        if(escape != 0 && p == escape && pattern + 1 != pattern_end) {
+            ++pattern;
+            p = *pattern;
+        }
+
+        if(Fold(*str) != Fold(p)) {
+            return false;
+        }
+        ++str;
+        ++pattern;
+    }
+    return *str == 0;
+}
+
+bool Like(const char* str, const wxScopedCharBuffer& pattern, char escape)
+{
+    return Like(str, pattern.data(), pattern.data() + pattern.length(), escape);
+}
+
+/**
+ * @brief LIKE '__anon%'
+ */
+bool IsAnonymous(const char* str)
+{
+    static const char pattern[] = "__anon%";
+    return Like(str, pattern, pattern + sizeof(pattern) - 1, 0);
+}
+
+inline bool HasKind(const std::vector<wxUint32>& kinds, wxUint32 kind)
+{
+    return kinds.empty() || std::find(kinds.begin(), kinds.end(), kind) != kinds.end();
+}
+
+template <typename T> void Append(std::string& content, const std::vector<T>& v)
+{
+    if(!v.empty()) {
+        content.append((const char*)v.data(), v.size() * sizeof(T));
+    }
+}
+} // namespace
+
+TagsSnapshot::TagsSnapshot() {}
+
+TagsSnapshot::~TagsSnapshot() { Unload(); }
+
+bool TagsSnapshot::ReadStamp(wxSQLite3Database& db, Stamp& stamp)
+{
+    try {
+        stamp.max_id = db.ExecuteScalar("select max(ID) from tags");
+        stamp.count = db.ExecuteScalar("select count(*) from tags");
+        return true;
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "Failed to read the tags table stamp:" << e.GetMessage() << endl;
+        return false;
+    }
+}
+
+bool TagsSnapshot::Build(wxSQLite3Database& db, const wxFileName& file)
+{
+    std::vector<wxUint32> ids;
+    std::vector<wxInt32> lines;
+    std::vector<wxUint32> columns[COL_COUNT];
+
+    // offset 0 is the empty string (NULL values are stored as empty strings, like wxSQLite3ResultSet::GetString does)
+    std::string strings(1, '\0');
+    std::unordered_map<std::string, wxUint32> interned;
+    interned.insert({ std::string(), 0 });
+
+    Stamp stamp;
+    try {
+        // a read transaction, so the stamp matches the rows we read
+        db.Begin();
+        if(!ReadStamp(db, stamp)) {
+            db.Rollback();
+            return false;
+        }
+
+        std::string str;
+        wxSQLite3ResultSet rs = db.ExecuteQuery("select * from tags order by ID");
+        while(rs.NextRow()) {
+            ids.push_back(rs.GetInt(0));
+            lines.push_back(rs.GetInt(3));
+            for(size_t col = 0; col < COL_COUNT; ++col) {
+                int len = 0;
+                const unsigned char* data = rs.GetBlob(SQL_COLUMNS[col], len);
+                str.assign(data ? (const char*)data : "", data ? len : 0);
+                auto where = interned.insert({ str, (wxUint32)strings.length() });
+                if(where.second) {
+                    strings.append(str);
+                    strings.append(1, '\0');
+                }
+                columns[col].push_back(where.first->second);
+            }
+        }
+        rs.Finalize();
+        db.Commit();
+
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "Failed to read the tags table:" << e.GetMessage() << endl;
+        try {
+            db.Rollback();
+        } catch (const wxSQLite3Exception&) {
+        }
+        return false;
+    }
+
+    if(strings.length() >= NOT_FOUND) {
+        clWARNING() << "Tags snapshot: too many strings, will not build it" << endl;
+        return false;
+    }
+
+    const wxUint32 rows = ids.size();
+    const char* pool = strings.c_str();
+
+    std::vector<wxUint32> name_index(rows);
+    std::iota(name_index.begin(), name_index.end(), 0);
+    const auto& names = columns[COL_NAME];
+    std::sort(name_index.begin(), name_index.end(), [&](wxUint32 a, wxUint32 b) {
+        int cmp = CompareFolded(pool + names[a], pool + names[b]);
+        return cmp == 0 ? a < b : cmp < 0;
+    });
+
+    std::vector<wxUint32> indexes[INDEX_COUNT];
+    for(size_t i = 0; i < INDEX_COUNT; ++i) {
+        const auto& column = columns[INDEX_COLUMNS[i]];
+        indexes[i].resize(rows);
+        std::iota(indexes[i].begin(), indexes[i].end(), 0);
+        std::sort(indexes[i].begin(), indexes[i].end(), [&](wxUint32 a, wxUint32 b) {
+            return column[a] == column[b] ? a < b : column[a] < column[b];
+        });
+    }
+
+    // keep the load factor below 0.5
+    wxUint32 buckets_count = 2;
+    while(buckets_count < interned.size() * 2) {
+        buckets_count <<= 1;
+    }
+    std::vector<wxUint32> buckets(buckets_count, NOT_FOUND);
+    for(const auto& vt : interned) {
+        wxUint32 pos = Hash(vt.first.c_str(), vt.first.length()) & (buckets_count - 1);
+        while(buckets[pos] != NOT_FOUND) {
+            pos = (pos + 1) & (buckets_count - 1);
+        }
+        buckets[pos] = vt.second;
+    }
+
+    // pad the pool, so the trailing magic number is aligned
+    strings.append((4 - strings.length() % 4) % 4, '\0');
+
+    Header header;
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.max_id = stamp.max_id;
+    header.count = stamp.count;
+    header.rows = rows;
+    header.buckets = buckets_count;
+    header.strings_size = strings.length();
+    header.reserved = 0;
+
+    std::string content;
+    content.reserve(sizeof(header) + sizeof(wxUint32) * (rows * (3 + COL_COUNT + INDEX_COUNT) + buckets_count + 1) +
+                    strings.length());
+    content.append((const char*)&header, sizeof(header));
+    Append(content, ids);
+    Append(content, lines);
+    for(const auto& column : columns) {
+        Append(content, column);
+    }
+    Append(content, name_index);
+    for(const auto& index : indexes) {
+        Append(content, index);
+    }
+    Append(content, buckets);
+    content.append(strings);
+    content.append((const char*)&SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+
+    if(!FileUtils::WriteFileContentRaw(file, content)) {
+        clWARNING() << "Failed to write tags snapshot:" << file << endl;
+        return false;
+    }
+    clDEBUG() << "Tags snapshot:" << rows << "tags," << interned.size() << "strings. Written to:" << file << endl;
+    return true;
+}
+
+bool TagsSnapshot::Load(const wxFileName& file)
+{
+    Unload();
+    if(!DoMap(file)) {
+        Unload();
+        return false;
+    }
+
+    if(!DoSetup()) {
+        clDEBUG() << "Ignoring outdated or corrupted tags snapshot:" << file << endl;
+        Unload();
+        return false;
+    }
+    return true;
+}
+
+bool TagsSnapshot::DoMap(const wxFileName& file)
+{
+#ifdef __WXMSW__
+    // files that are mapped can not be replaced on Windows, read the content instead
+    wxLogNull noLog;
+    wxFFile fp(file.GetFullPath(), "rb");
+    if(!fp.IsOpened()) {
+        return false;
+    }
+    wxFileOffset len = fp.Length();
+    if(len <= 0 || fp.Read(m_buffer.GetWriteBuf(len), len) != (size_t)len) {
+        return false;
+    }
+    m_buffer.UngetWriteBuf(len);
+    m_data = (const char*)m_buffer.GetData();
+    m_size = m_buffer.GetDataLen();
+    return true;
+#else
+    int fd = ::open(file.GetFullPath().mb_str(wxConvUTF8).data(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if(::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // the mapping keeps the file content alive, even after the file is replaced by a newer snapshot
+    void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(addr == MAP_FAILED) {
+        return false;
+    }
+    m_data = (const char*)addr;
+    m_size = st.st_size;
+    m_mapped = true;
+    return true;
+#endif
+}
+
+bool TagsSnapshot::DoSetup()
+{
+    if(m_size < sizeof(Header) + sizeof(wxUint32)) {
+        return false;
+    }
+
+    Header header;
+    memcpy(&header, m_data, sizeof(header));
+    if(header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION) {
+        return false;
+    }
+
+    if(header.buckets == 0 || (header.buckets & (header.buckets - 1)) != 0 || header.strings_size == 0 ||
+       header.strings_size % 4 != 0) {
+        return false;
+    }
+
+    wxUint64 numbers = (wxUint64)header.rows * (3 + COL_COUNT + INDEX_COUNT) + header.buckets + 1;
+    wxUint64 expected_size = sizeof(Header) + numbers * sizeof(wxUint32) + header.strings_size;
+    if(expected_size != m_size) {
+        return false;
+    }
+
+    wxUint32 trailer = 0;
+    memcpy(&trailer, m_data + m_size - sizeof(trailer), sizeof(trailer));
+    if(trailer != SNAPSHOT_MAGIC) {
+        return false;
+    }
+
+    const wxUint32* p = (const wxUint32*)(m_data + sizeof(Header));
+    m_ids = p;
+    p += header.rows;
+    m_lines = (const wxInt32*)p;
+    p += header.rows;
+    for(auto& column : m_columns) {
+        column = p;
+        p += header.rows;
+    }
+    m_nameIndex = p;
+    p += header.rows;
+    for(auto& index : m_indexes) {
+        index = p;
+        p += header.rows;
+    }
+    m_buckets = p;
+    p += header.buckets;
+    m_strings = (const char*)p;
+
+    m_rows = header.rows;
+    m_bucketsCount = header.buckets;
+    m_stringsSize = header.strings_size;
+    m_stamp.max_id = header.max_id;
+    m_stamp.count = header.count;
+    return m_strings[m_stringsSize - 1] == 0;
+}
+
+void TagsSnapshot::Unload()
+{
+#ifndef __WXMSW__
+    if(m_mapped && m_data) {
+        ::munmap((void*)m_data, m_size);
+    }
+#endif
+    m_buffer = wxMemoryBuffer();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+
+    m_stamp = Stamp();
+    m_rows = 0;
+    m_ids = nullptr;
+    m_lines = nullptr;
+    std::fill(std::begin(m_columns), std::end(m_columns), nullptr);
+    m_nameIndex = nullptr;
+    std::fill(std::begin(m_indexes), std::end(m_indexes), nullptr);
+    m_buckets = nullptr;
+    m_bucketsCount = 0;
+    m_strings = nullptr;
+    m_stringsSize = 0;
+}
+
+wxUint32 TagsSnapshot::FindString(const char* str, size_t len) const
+{
+    if(!IsOk()) {
+        return NOT_FOUND;
+    }
+
+    wxUint32 pos = Hash(str, len) & (m_bucketsCount - 1);
+    for(wxUint32 i = 0; i < m_bucketsCount; ++i) {
+        wxUint32 offset = m_buckets[pos];
+        if(offset == NOT_FOUND) {
+            return NOT_FOUND;
+        }
+        if(offset + len < m_stringsSize && memcmp(m_strings + offset, str, len) == 0 &&
+           m_strings[offset + len] == 0) {
+            return offset;
+        }
+        pos = (pos + 1) & (m_bucketsCount - 1);
+    }
+    return NOT_FOUND;
+}
+
+wxUint32 TagsSnapshot::FindString(const wxString& str) const
+{
+    const wxScopedCharBuffer cb = str.utf8_str();
+    return FindString(cb.data(), cb.length());
+}
+
+bool TagsSnapshot::FindKinds(const wxArrayString& kinds, std::vector<wxUint32>& offsets) const
+{
+    offsets.reserve(kinds.size());
+    for(const wxString& kind : kinds) {
+        wxUint32 offset = FindString(kind);
+        if(offset != NOT_FOUND) {
+            offsets.push_back(offset);
+        }
+    }
+    return !offsets.empty();
+}
+
+TagsSnapshot::Range TagsSnapshot::Find(eIndex index, const wxString& value) const
+{
+    Range range;
+    wxUint32 offset = FindString(value);
+    if(offset == NOT_FOUND) {
+        return range;
+    }
+
+    const wxUint32* column = m_columns[INDEX_COLUMNS[index]];
+    const wxUint32* end = m_indexes[index] + m_rows;
+    range.first = std::lower_bound(m_indexes[index], end, offset,
+                                   [column](wxUint32 row, wxUint32 value) { return column[row] < value; });
+    range.last = std::upper_bound(range.first, end, offset,
+                                  [column](wxUint32 value, wxUint32 row) { return value < column[row]; });
+    return range;
+}
+
+TagsSnapshot::Range TagsSnapshot::FindByName(const char* prefix, size_t len) const
+{
+    Range range;
+    if(!IsOk()) {
+        return range;
+    }
+
+    const wxUint32* names = m_columns[COL_NAME];
+    const char* strings = m_strings;
+    range.first = std::lower_bound(m_nameIndex, m_nameIndex + m_rows, 0, [=](wxUint32 row, int) {
+        return ComparePrefixFolded(strings + names[row], prefix, len) < 0;
+    });
+    range.last = std::upper_bound(range.first, m_nameIndex + m_rows, 0, [=](int, wxUint32 row) {
+        return ComparePrefixFolded(strings + names[row], prefix, len) > 0;
+    });
+    return range;
+}
+
+bool TagsSnapshot::IsNameMatch(wxUint32 row, const char* name, size_t len, bool partial, bool caseInsensitive) const
+{
+    const char* str = GetString(row, COL_NAME);
+    if(partial && caseInsensitive) {
+        return ComparePrefixFolded(str, name, len) == 0;
+    }
+    return strncmp(str, name, len) == 0 && (partial || str[len] == 0);
+}
+
+void TagsSnapshot::CollectByScopeAndName(const wxString& scope, const wxScopedCharBuffer& name, bool partial,
+                                         bool caseInsensitive, size_t limit, std::vector<wxUint32>& rows) const
+{
+    Range by_scope = Find(INDEX_SCOPE, scope);
+    if(by_scope.empty()) {
+        return;
+    }
+
+    // walk the shorter of the two indexes
+    Range by_name = FindByName(name.data(), name.length());
+    size_t first = rows.size();
+    if(by_scope.size() <= by_name.size()) {
+        for(wxUint32 row : by_scope) {
+            if(rows.size() - first >= limit) {
+                break;
+            }
+            if(IsNameMatch(row, name.data(), name.length(), partial, caseInsensitive)) {
+                rows.push_back(row);
+            }
+        }
+        return;
+    }
+
+    wxUint32 scope_offset = GetOffset(*by_scope.begin(), COL_SCOPE);
+    for(wxUint32 row : by_name) {
+        if(GetOffset(row, COL_SCOPE) == scope_offset &&
+           IsNameMatch(row, name.data(), name.length(), partial, caseInsensitive)) {
+            rows.push_back(row);
+        }
+    }
+
+    // the rows are ordered by ID, same as the table
+    std::sort(rows.begin() + first, rows.end());
+    if(rows.size() - first > limit) {
+        rows.resize(first + limit);
+    }
+}
+
+void TagsSnapshot::AppendTags(const std::vector<wxUint32>& rows, size_t limit, std::vector<TagEntryPtr>& tags) const
+{
+    size_t count = std::min(limit, rows.size());
+    tags.reserve(tags.size() + count);
+    for(size_t i = 0; i < count; ++i) {
+        tags.push_back(ToTagEntry(rows[i]));
+    }
+}
+
+TagEntryPtr TagsSnapshot::ToTagEntry(wxUint32 row) const
+{
+    TagEntryPtr tag(new TagEntry());
+    tag->SetId(m_ids[row]);
+    tag->SetName(wxString::FromUTF8(GetString(row, COL_NAME)));
+    tag->SetFile(wxString::FromUTF8(GetString(row, COL_FILE)));
+    tag->SetLine(m_lines[row]);
+    tag->SetKind(wxString::FromUTF8(GetString(row, COL_KIND)));
+    tag->SetAccess(wxString::FromUTF8(GetString(row, COL_ACCESS)));
+    tag->SetSignature(wxString::FromUTF8(GetString(row, COL_SIGNATURE)));
+    tag->SetPattern(wxString::FromUTF8(GetString(row, COL_PATTERN)));
+    tag->SetParent(wxString::FromUTF8(GetString(row, COL_PARENT)));
+    tag->SetInherits(wxString::FromUTF8(GetString(row, COL_INHERITS)));
+    tag->SetPath(wxString::FromUTF8(GetString(row, COL_PATH)));
+    tag->SetTypename(wxString::FromUTF8(GetString(row, COL_TYPEREF)));
+    tag->SetScope(wxString::FromUTF8(GetString(row, COL_SCOPE)));
+    tag->SetTemplateDefinition(wxString::FromUTF8(GetString(row, COL_TEMPLATE_DEFINITION)));
+    tag->SetTagProperties(wxString::FromUTF8(GetString(row, COL_TAG_PROPERTIES)));
+    tag->SetMacrodef(wxString::FromUTF8(GetString(row, COL_MACRODEF)));
+    return tag;
+}
+
+void TagsSnapshot::GetTagsByScopeAndName(const wxString& scope, const wxString& name, bool partial,
+                                         bool caseInsensitive, size_t limit, std::vector<TagEntryPtr>& tags) const
+{
+    if(name.empty()) {
+        return;
+    }
+
+    const wxScopedCharBuffer cb = name.utf8_str();
+    std::vector<wxUint32> rows;
+    CollectByScopeAndName(scope.empty() ? wxString("<global>") : scope, cb, partial, caseInsensitive, limit, rows);
+    AppendTags(rows, limit, tags);
+}
+
+void TagsSnapshot::GetTagsByScopesAndName(const wxArrayString& scopes, const wxString& name, bool partial,
+                                          bool caseInsensitive, size_t limit, std::vector<TagEntryPtr>& tags) const
+{
+    if(name.empty()) {
+        return;
+    }
+
+    const wxScopedCharBuffer cb = name.utf8_str();
+    std::vector<wxUint32> rows;
+    for(const wxString& scope : scopes) {
+        CollectByScopeAndName(scope, cb, partial, caseInsensitive, limit, rows);
+    }
+    std::sort(rows.begin(), rows.end());
+    AppendTags(rows, limit, tags);
+}
+
+void TagsSnapshot::GetTagsByName(const wxString& name, bool partial, bool caseInsensitive, size_t limit,
+                                 std::vector<TagEntryPtr>& tags) const
+{
+    if(name.empty()) {
+        return;
+    }
+
+    const wxScopedCharBuffer cb = name.utf8_str();
+    std::vector<wxUint32> rows;
+    for(wxUint32 row : FindByName(cb.data(), cb.length())) {
+        if(IsNameMatch(row, cb.data(), cb.length(), partial, caseInsensitive)) {
+            rows.push_back(row);
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    AppendTags(rows, limit, tags);
+}
+
+void TagsSnapshot::GetTagsByNameAndParent(const wxString& name, const wxString& parent, size_t limit,
+                                          std::vector<TagEntryPtr>& tags) const
+{
+    wxUint32 name_offset = FindString(name);
+    if(name_offset == NOT_FOUND) {
+        return;
+    }
+
+    size_t count = 0;
+    for(wxUint32 row : Find(INDEX_PARENT, parent)) {
+        if(count >= limit) {
+            break;
+        }
+        if(GetOffset(row, COL_NAME) == name_offset) {
+            tags.push_back(ToTagEntry(row));
+            ++count;
+        }
+    }
+}
+
+void TagsSnapshot::GetTagsByScope(const wxString& scope, size_t limit, std::vector<TagEntryPtr>& tags) const
+{
+    Range range = Find(INDEX_SCOPE, scope);
+    std::vector<wxUint32> rows(range.begin(), range.end());
+    auto by_name = [this](wxUint32 a, wxUint32 b) {
+        int cmp = strcmp(GetString(a, COL_NAME), GetString(b, COL_NAME));
+        return cmp == 0 ? a < b : cmp < 0;
+    };
+
+    if(limit < rows.size()) {
+        std::partial_sort(rows.begin(), rows.begin() + limit, rows.end(), by_name);
+    } else {
+        std::sort(rows.begin(), rows.end(), by_name);
+    }
+    AppendTags(rows, limit, tags);
+}
+
+void TagsSnapshot::GetTagsByScopeAndKind(const wxString& scope, const wxArrayString& kinds,
+                                         const wxString& nameLike, size_t limit, std::vector<TagEntryPtr>& tags) const
+{
+    std::vector<wxUint32> kind_offsets;
+    if(!kinds.empty() && !FindKinds(kinds, kind_offsets)) {
+        return;
+    }
+
+    const wxScopedCharBuffer pattern = nameLike.utf8_str();
+    size_t count = 0;
+    for(wxUint32 row : Find(INDEX_SCOPE, scope)) {
+        if(count >= limit) {
+            break;
+        }
+        if(!HasKind(kind_offsets, GetOffset(row, COL_KIND))) {
+            continue;
+        }
+        if(!nameLike.empty() && !Like(GetString(row, COL_NAME), pattern, '^')) {
+            continue;
+        }
+        tags.push_back(ToTagEntry(row));
+        ++count;
+    }
+}
+
+void TagsSnapshot::GetTagsByPath(const wxString& path, const wxArrayString& kinds, size_t limit,
+                                 std::vector<TagEntryPtr>& tags) const
+{
+    std::vector<wxUint32> kind_offsets;
+    if(!kinds.empty() && !FindKinds(kinds, kind_offsets)) {
+        return;
+    }
+
+    size_t count = 0;
+    for(wxUint32 row : Find(INDEX_PATH, path)) {
+        if(count >= limit) {
+            break;
+        }
+        if(HasKind(kind_offsets, GetOffset(row, COL_KIND))) {
+            tags.push_back(ToTagEntry(row));
+            ++count;
+        }
+    }
+}
+
+TagEntryPtr TagsSnapshot::GetTagById(long id) const
+{
+    // rows are ordered by ID
+    if(id < 0 || (wxUint64)id > 0xFFFFFFFF) {
+        return nullptr;
+    }
+    const wxUint32* first = m_ids;
+    const wxUint32* last = m_ids + m_rows;
+    const wxUint32* iter = std::lower_bound(first, last, (wxUint32)id);
+    if(iter == last || *iter != (wxUint32)id) {
+        return nullptr;
+    }
+    return ToTagEntry(iter - first);
+}
+
+void TagsSnapshot::GetTagsByFileAndLine(const wxString& file, int line, std::vector<TagEntryPtr>& tags) const
+{
+    for(wxUint32 row : Find(INDEX_FILE, file)) {
+        if(m_lines[row] == line) {
+            tags.push_back(ToTagEntry(row));
+        }
+    }
+}
+
+TagEntryPtr TagsSnapshot::GetScope(const wxString& file, int line) const
+{
+    static const wxArrayString scope_kinds = StdToWX::ToArrayString({ "function", "class", "struct", "namespace" });
+
+    std::vector<wxUint32> kind_offsets;
+    if(!FindKinds(scope_kinds, kind_offsets)) {
+        return nullptr;
+    }
+
+    wxUint32 best = NOT_FOUND;
+    for(wxUint32 row : Find(INDEX_FILE, file)) {
+        if(m_lines[row] > line || (best != NOT_FOUND && m_lines[row] <= m_lines[best])) {
+            continue;
+        }
+        if(HasKind(kind_offsets, GetOffset(row, COL_KIND)) && !IsAnonymous(GetString(row, COL_NAME))) {
+            best = row;
+        }
+    }
+    return best == NOT_FOUND ? nullptr : ToTagEntry(best);
+}
+
+size_t TagsSnapshot::GetFileScopedTags(const wxString& file, const wxString& name, const wxArrayString& kinds,
+                                       std::vector<TagEntryPtr>& tags) const
+{
+    static const wxArrayString static_kinds =
+        StdToWX::ToArrayString({ "member", "variable", "class", "struct", "enum" });
+
+    // tags of anonymous scopes (of the requested kinds) and the static members of the file
+    std::vector<wxUint32> anon_kinds;
+    std::vector<wxUint32> static_kinds_offsets;
+    bool has_anon_kinds = FindKinds(kinds, anon_kinds);
+    bool has_static_kinds = FindKinds(static_kinds, static_kinds_offsets);
+
+    const wxScopedCharBuffer pattern = (name + "%").utf8_str();
+    std::vector<wxUint32> rows;
+    for(wxUint32 row : Find(INDEX_FILE, file)) {
+        if(!name.empty() && !Like(GetString(row, COL_NAME), pattern, 0)) {
+            continue;
+        }
+
+        wxUint32 kind = GetOffset(row, COL_KIND);
+        if((has_static_kinds && HasKind(static_kinds_offsets, kind)) ||
+           (has_anon_kinds && HasKind(anon_kinds, kind) && IsAnonymous(GetString(row, COL_SCOPE)))) {
+            rows.push_back(row);
+        }
+    }
+
+    // sort by line number (asc)
+    std::stable_sort(rows.begin(), rows.end(), [this](wxUint32 a, wxUint32 b) { return m_lines[a] < m_lines[b]; });
+    AppendTags(rows, rows.size(), tags);
+    return tags.size();
+}
@@ -0,0 +1,197 @@
+#ifndef CODELITE_TAGS_STORAGE_SNAPSHOT_H
+#define CODELITE_TAGS_STORAGE_SNAPSHOT_H
+
+#include "codelite_exports.h"
+#include "entry.h"
+
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/buffer.h>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+class wxSQLite3Database;
+
+/**
+ * @brief a read-only copy of the "tags" table, stored in a single file that is memory mapped when loaded.
+ * The table is stored column by column (rows are ordered by ID) and all the strings are interned into a single pool,
+ * so equal strings share the same offset. The file also contains a case-insensitive name index for prefix searches
+ * and hash indexes on the file, path, scope and parent columns.
+ * Lookups walk these indexes in place: a TagEntry is only allocated for the rows returned to the caller
+ */
+class WXDLLIMPEXP_CL TagsSnapshot
+{
+public:
+    enum eColumn {
+        COL_NAME,
+        COL_FILE,
+        COL_KIND,
+        COL_ACCESS,
+        COL_SIGNATURE,
+        COL_PATTERN,
+        COL_PARENT,
+        COL_INHERITS,
+        COL_PATH,
+        COL_TYPEREF,
+        COL_SCOPE,
+        COL_TEMPLATE_DEFINITION,
+        COL_TAG_PROPERTIES,
+        COL_MACRODEF,
+        COL_COUNT,
+    };
+
+    enum eIndex {
+        INDEX_FILE,
+        INDEX_PATH,
+        INDEX_SCOPE,
+        INDEX_PARENT,
+        INDEX_COUNT,
+    };
+
+    /**
+     * @brief identifies the content of the tags table the snapshot was built from. IDs are never reused, so any
+     * insert changes the max ID and any delete changes the count
+     */
+    struct Stamp {
+        wxUint64 max_id = 0;
+        wxUint64 count = 0;
+
+        bool operator==(const Stamp& other) const { return max_id == other.max_id && count == other.count; }
+        bool operator!=(const Stamp& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @brief a sequence of row numbers
+     */
+    struct Range {
+        const wxUint32* first = nullptr;
+        const wxUint32* last = nullptr;
+
+        const wxUint32* begin() const { return first; }
+        const wxUint32* end() const { return last; }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+    };
+
+protected:
+    // the mapped file (or the buffer holding its content, when it can not be mapped)
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    wxMemoryBuffer m_buffer;
+
+    Stamp m_stamp;
+    wxUint32 m_rows = 0;
+    const wxUint32* m_ids = nullptr;
+    const wxInt32* m_lines = nullptr;
+    const wxUint32* m_columns[COL_COUNT] = {};
+    const wxUint32* m_nameIndex = nullptr;
+    const wxUint32* m_indexes[INDEX_COUNT] = {};
+    const wxUint32* m_buckets = nullptr;
+    wxUint32 m_bucketsCount = 0;
+    const char* m_strings = nullptr;
+    wxUint32 m_stringsSize = 0;
+
+protected:
+    bool DoMap(const wxFileName& file);
+    bool DoSetup();
+
+    const char* GetString(wxUint32 row, eColumn col) const { return m_strings + m_columns[col][row]; }
+    wxUint32 GetOffset(wxUint32 row, eColumn col) const { return m_columns[col][row]; }
+
+    /**
+     * @brief return the pool offset of `str` or 0xFFFFFFFF if no row holds this string
+     */
+    wxUint32 FindString(const char* str, size_t len) const;
+    wxUint32 FindString(const wxString& str) const;
+
+    /**
+     * @brief translate a list of kinds into pool offsets. Return false if none of them exist
+     */
+    bool FindKinds(const wxArrayString& kinds, std::vector<wxUint32>& offsets) const;
+
+    /**
+     * @brief rows whose column `index` equals `value`, ordered by ID
+     */
+    Range Find(eIndex index, const wxString& value) const;
+
+    /**
+     * @brief rows whose name starts with `prefix` (ASCII case-insensitive), ordered by name
+     */
+    Range FindByName(const char* prefix, size_t len) const;
+
+    bool IsNameMatch(wxUint32 row, const char* name, size_t len, bool partial, bool caseInsensitive) const;
+    void CollectByScopeAndName(const wxString& scope, const wxScopedCharBuffer& name, bool partial,
+                               bool caseInsensitive, size_t limit, std::vector<wxUint32>& rows) const;
+    void AppendTags(const std::vector<wxUint32>& rows, size_t limit, std::vector<TagEntryPtr>& tags) const;
+
+public:
+    TagsSnapshot();
+    ~TagsSnapshot();
+
+    /**
+     * @brief write a snapshot of the tags table of `db` into `file`. The file is replaced atomically, so snapshots
+     * that are already loaded are not affected
+     */
+    static bool Build(wxSQLite3Database& db, const wxFileName& file);
+
+    /**
+     * @brief read the current stamp of the tags table
+     */
+    static bool ReadStamp(wxSQLite3Database& db, Stamp& stamp);
+
+    /**
+     * @brief map a snapshot file. A corrupted file (or a file built by a different version) is rejected
+     */
+    bool Load(const wxFileName& file);
+    void Unload();
+
+    bool IsOk() const { return m_data != nullptr; }
+    const Stamp& GetStamp() const { return m_stamp; }
+    size_t GetRowsCount() const { return m_rows; }
+
+    /**
+     * @brief create a tag from a row
+     */
+    TagEntryPtr ToTagEntry(wxUint32 row) const;
+
+    /**
+     * @brief create the tag with the given ID, or return nullptr if no row has this ID
+     */
+    TagEntryPtr GetTagById(long id) const;
+
+    // The lookups below return the same rows as their TagsStorageSQLite SQL counterparts
+
+    void GetTagsByScopeAndName(const wxString& scope, const wxString& name, bool partial, bool caseInsensitive,
+                               size_t limit, std::vector<TagEntryPtr>& tags) const;
+    void GetTagsByScopesAndName(const wxArrayString& scopes, const wxString& name, bool partial, bool caseInsensitive,
+                                size_t limit, std::vector<TagEntryPtr>& tags) const;
+    void GetTagsByName(const wxString& name, bool partial, bool caseInsensitive, size_t limit,
+                       std::vector<TagEntryPtr>& tags) const;
+    void GetTagsByNameAndParent(const wxString& name, const wxString& parent, size_t limit,
+                                std::vector<TagEntryPtr>& tags) const;
+
+    /**
+     * @brief tags of a scope, ordered by name
+     */
+    void GetTagsByScope(const wxString& scope, size_t limit, std::vector<TagEntryPtr>& tags) const;
+
+    /**
+     * @brief tags of a scope, ordered by ID. An empty `kinds` array accepts all the kinds, `nameLike` is an SQL
+     * LIKE pattern ('^' is the escape character)
+     */
+    void GetTagsByScopeAndKind(const wxString& scope, const wxArrayString& kinds, const wxString& nameLike,
+                               size_t limit, std::vector<TagEntryPtr>& tags) const;
+
+    /**
+     * @brief tags by path, ordered by ID. An empty `kinds` array accepts all the kinds
+     */
+    void GetTagsByPath(const wxString& path, const wxArrayString& kinds, size_t limit,
+                       std::vector<TagEntryPtr>& tags) const;
+    void GetTagsByFileAndLine(const wxString& file, int line, std::vector<TagEntryPtr>& tags) const;
+    TagEntryPtr GetScope(const wxString& file, int line) const;
+    size_t GetFileScopedTags(const wxString& file, const wxString& name, const wxArrayString& kinds,
+                             std::vector<TagEntryPtr>& tags) const;
+};
+
+#endif // CODELITE_TAGS_STORAGE_SNAPSHOT_H
@@ -24,12 +24,14 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "tags_storage_sqlite3.h"
 
+#include "StdToWX.h"
 #include "file_logger.h"
 #include "fileutils.h"
 #include "macros.h"
 #include "precompiled_header.h"
 
 #include <algorithm>
+#include <limits>
 #include <unordered_set>
 #include <wx/longlong.h>
 #include <wx/tokenzr.h>
@@ -78,6 +80,7 @@ void TagsStorageSQLite::OpenDatabase(const wxFileName& fileName)
         } else {
             // We have both fileName & m_fileName and they
             // are different, Close previous db
+            DropSnapshot(true);
             m_db->Close();
             m_db->Open(fileName.GetFullPath());
             m_db->SetBusyTimeout(10);
@@ -121,9 +124,24 @@ void TagsStorageSQLite::CreateSchema()
         m_db->ExecuteUpdate(sql);
 
         sql = wxT("create  table if not exists FILES (ID INTEGER PRIMARY KEY AUTOINCREMENT, file string, last_retagged "
-                  "integer);");
+                  "integer, hash string);");
         m_db->ExecuteUpdate(sql);
 
+        // databases created by older versions don't have the hash column. Add it instead of dropping the database, the
+        // files will get their hash the next time they are retagged
+        bool has_hash_column = false;
+        wxSQLite3ResultSet columns = m_db->ExecuteQuery(wxT("PRAGMA table_info(FILES)"));
+        while(columns.NextRow()) {
+            if(columns.GetString(1) == wxT("hash")) {
+                has_hash_column = true;
+                break;
+            }
+        }
+        columns.Finalize();
+        if(!has_hash_column) {
+            m_db->ExecuteUpdate(wxT("ALTER TABLE FILES ADD COLUMN hash string"));
+        }
+
         sql = wxT("create  table if not exists MACROS (ID INTEGER PRIMARY KEY AUTOINCREMENT, file string, line "
                   "integer, name string, is_function_like int, replacement string, signature string);");
         m_db->ExecuteUpdate(sql);
@@ -303,6 +321,8 @@ void TagsStorageSQLite::SelectTagsByFile(const wxString& file, std::vector<TagEn
 
 void TagsStorageSQLite::DeleteByFileName(const wxFileName& path, const wxString& fileName, bool autoCommit)
 {
+    DropSnapshot();
+
     // make sure database is open
     try {
         OpenDatabase(path);
@@ -343,6 +363,7 @@ wxSQLite3ResultSet TagsStorageSQLite::Query(const wxString& sql, const wxFileNam
 
 void TagsStorageSQLite::ExecuteUpdate(const wxString& sql)
 {
+    DropSnapshot();
     try {
         m_db->ExecuteUpdate(sql);
     } catch (const wxSQLite3Exception& e) {
@@ -396,8 +417,8 @@ void TagsStorageSQLite::GetFiles(const wxString& partialName, std::vector<FileEn
         wxString query;
         wxString tmpName(partialName);
         tmpName.Replace(wxT("_"), wxT("^_"));
-        query << wxT("select * from files where file like '%%") << tmpName << wxT("%%' ESCAPE '^' ")
-              << wxT("order by file");
+        query << wxT("select ID, file, last_retagged, hash from files where file like '%%") << tmpName
+              << wxT("%%' ESCAPE '^' order by file");
 
         wxSQLite3ResultSet res = m_db->ExecuteQuery(query);
         while(res.NextRow()) {
@@ -406,6 +427,7 @@ void TagsStorageSQLite::GetFiles(const wxString& partialName, std::vector<FileEn
             fe->SetId(res.GetInt(0));
             fe->SetFile(res.GetString(1));
             fe->SetLastRetaggedTimestamp(res.GetInt(2));
+            fe->SetHash(res.GetString(3));
 
             wxFileName fileName(fe->GetFile());
             wxString match = match_path ? fileName.GetFullPath() : fileName.GetFullName();
@@ -431,7 +453,7 @@ void TagsStorageSQLite::GetFiles(const wxString& partialName, std::vector<FileEn
 void TagsStorageSQLite::GetFiles(std::vector<FileEntryPtr>& files)
 {
     try {
-        wxString query(wxT("select * from files order by file"));
+        wxString query(wxT("select ID, file, last_retagged, hash from files order by file"));
         wxSQLite3ResultSet res = m_db->ExecuteQuery(query);
 
         // Pre allocate a reasonable amount of entries
@@ -442,6 +464,7 @@ void TagsStorageSQLite::GetFiles(std::vector<FileEntryPtr>& files)
             fe->SetId(res.GetInt(0));
             fe->SetFile(res.GetString(1));
             fe->SetLastRetaggedTimestamp(res.GetInt(2));
+            fe->SetHash(res.GetString(3));
 
             files.push_back(std::move(fe));
         }
@@ -578,6 +601,12 @@ void TagsStorageSQLite::GetTagsByScopeAndName(const wxString& scope, const wxStr
     if(name.IsEmpty())
         return;
 
+    if(auto snapshot = GetSnapshot()) {
+        snapshot->GetTagsByScopeAndName(scope, name, partialNameAllowed, m_enableCaseInsensitive,
+                                        GetSingleSearchLimit(), tags);
+        return;
+    }
+
     wxString sql;
     sql << wxT("select * from tags where ");
 
@@ -600,6 +629,11 @@ void TagsStorageSQLite::GetTagsByScopeAndName(const wxString& scope, const wxStr
 
 void TagsStorageSQLite::GetTagsByScope(const wxString& scope, std::vector<TagEntryPtr>& tags)
 {
+    if(auto snapshot = GetSnapshot()) {
+        snapshot->GetTagsByScope(scope, GetSingleSearchLimit(), tags);
+        return;
+    }
+
     wxString sql;
 
     // Build the SQL statement
@@ -656,6 +690,11 @@ void TagsStorageSQLite::GetTagsByPath(const wxArrayString& path, std::vector<Tag
 void TagsStorageSQLite::GetTagsByNameAndParent(const wxString& name, const wxString& parent,
                                                std::vector<TagEntryPtr>& tags)
 {
+    if(auto snapshot = GetSnapshot()) {
+        snapshot->GetTagsByNameAndParent(name, parent, GetSingleSearchLimit(), tags);
+        return;
+    }
+
     wxString sql;
     sql << wxT("select * from tags where name='") << name << wxT("' LIMIT ") << GetSingleSearchLimit();
 
@@ -677,6 +716,11 @@ void TagsStorageSQLite::GetTagsByKindAndPath(const wxArrayString& kinds, const w
         return;
     }
 
+    if(auto snapshot = GetSnapshot()) {
+        snapshot->GetTagsByPath(path, kinds, GetSingleSearchLimit(), tags);
+        return;
+    }
+
     wxString sql;
     sql << wxT("select * from tags where path='") << path << wxT("' LIMIT ") << GetSingleSearchLimit();
 
@@ -685,6 +729,11 @@ void TagsStorageSQLite::GetTagsByKindAndPath(const wxArrayString& kinds, const w
 
 void TagsStorageSQLite::GetTagsByFileAndLine(const wxString& file, int line, std::vector<TagEntryPtr>& tags)
 {
+    if(auto snapshot = GetSnapshot()) {
+        snapshot->GetTagsByFileAndLine(file, line, tags);
+        return;
+    }
+
     wxString sql;
     sql << wxT("select * from tags where file='") << file << wxT("' and line=") << line << wxT(" ");
     DoFetchTags(sql, tags);
@@ -738,13 +787,14 @@ int TagsStorageSQLite::DeleteFileEntry(const wxString& filename)
     return TagOk;
 }
 
-int TagsStorageSQLite::InsertFileEntry(const wxString& filename, int timestamp)
+int TagsStorageSQLite::InsertFileEntry(const wxString& filename, int timestamp, const wxString& hash)
 {
     try {
-        wxSQLite3Statement statement =
-            m_db->GetPrepareStatement(wxT("INSERT OR REPLACE INTO FILES VALUES(NULL, ?, ?)"));
+        wxSQLite3Statement statement = m_db->GetPrepareStatement(
+            wxT("INSERT OR REPLACE INTO FILES (ID, file, last_retagged, hash) VALUES(NULL, ?, ?, ?)"));
         statement.Bind(1, filename);
         statement.Bind(2, timestamp);
+        statement.Bind(3, hash);
         statement.ExecuteUpdate();
 
     } catch (const wxSQLite3Exception& exc) {
@@ -753,13 +803,14 @@ int TagsStorageSQLite::InsertFileEntry(const wxString& filename, int timestamp)
     return TagOk;
 }
 
-int TagsStorageSQLite::UpdateFileEntry(const wxString& filename, int timestamp)
+int TagsStorageSQLite::UpdateFileEntry(const wxString& filename, int timestamp, const wxString& hash)
 {
     try {
         wxSQLite3Statement statement =
-            m_db->GetPrepareStatement(wxT("UPDATE OR REPLACE FILES SET last_retagged=? WHERE file=?"));
+            m_db->GetPrepareStatement(wxT("UPDATE OR REPLACE FILES SET last_retagged=?, hash=? WHERE file=?"));
         statement.Bind(1, timestamp);
-        statement.Bind(2, filename);
+        statement.Bind(2, hash);
+        statement.Bind(3, filename);
         statement.ExecuteUpdate();
 
     } catch (const wxSQLite3Exception& exc) {
@@ -778,6 +829,7 @@ int TagsStorageSQLite::DoInsertTagEntry(const TagEntry& tag)
     if(GetUseCache()) {
         ClearCache();
     }
+    DropSnapshot();
 
     try {
         wxSQLite3Statement statement = m_db->GetPrepareStatement(
@@ -900,6 +952,11 @@ void TagsStorageSQLite::GetTagsByPath(const wxString& path, std::vector<TagEntry
     if(path.empty())
         return;
 
+    if(auto snapshot = GetSnapshot()) {
+        snapshot->GetTagsByPath(path, wxArrayString(), limit < 0 ? std::numeric_limits<size_t>::max() : limit, tags);
+        return;
+    }
+
     wxString sql;
     sql << wxT("select * from tags where path ='") << path << wxT("' LIMIT ") << limit;
     DoFetchTags(sql, tags);
@@ -925,6 +982,12 @@ void TagsStorageSQLite::GetTagsByScopeAndName(const wxArrayString& scope, const
     }
 
     if(scopes.IsEmpty() == false) {
+        if(auto snapshot = GetSnapshot()) {
+            snapshot->GetTagsByScopesAndName(scopes, name, partialNameAllowed, m_enableCaseInsensitive,
+                                             DoGetRemainingLimit(tags), tags);
+            return;
+        }
+
         wxString sql;
         sql << wxT("select * from tags where scope in(");
 
@@ -948,6 +1011,12 @@ void TagsStorageSQLite::GetTagsByScopeAndKind(const wxString& scope, const wxArr
         return;
     }
 
+    if(auto snapshot = GetSnapshot()) {
+        snapshot->GetTagsByScopeAndKind(scope, kinds, filter.empty() ? wxString() : filter + "%",
+                                        GetSingleSearchLimit(), tags);
+        return;
+    }
+
     wxString sql;
     sql << "select * from tags where scope='" << scope << "' ";
     if(!filter.empty()) {
@@ -998,6 +1067,11 @@ bool TagsStorageSQLite::IsTypeAndScopeExistLimitOne(const wxString& typeName, co
 
 void TagsStorageSQLite::GetDereferenceOperator(const wxString& scope, std::vector<TagEntryPtr>& tags)
 {
+    if(auto snapshot = GetSnapshot()) {
+        snapshot->GetTagsByScopeAndKind(scope, wxArrayString(), "operator%->%", 1, tags);
+        return;
+    }
+
     wxString sql;
     sql << wxT("select * from tags where scope ='") << scope << wxT("' and name like 'operator%->%' LIMIT 1");
     DoFetchTags(sql, tags);
@@ -1005,6 +1079,11 @@ void TagsStorageSQLite::GetDereferenceOperator(const wxString& scope, std::vecto
 
 void TagsStorageSQLite::GetSubscriptOperator(const wxString& scope, std::vector<TagEntryPtr>& tags)
 {
+    if(auto snapshot = GetSnapshot()) {
+        snapshot->GetTagsByScopeAndKind(scope, wxArrayString(), "operator%[%]%", 1, tags);
+        return;
+    }
+
     wxString sql;
     sql << wxT("select * from tags where scope ='") << scope << wxT("' and name like 'operator%[%]%' LIMIT 1");
     DoFetchTags(sql, tags);
@@ -1111,6 +1190,11 @@ void TagsStorageSQLite::GetTagsByName(const wxString& prefix, std::vector<TagEnt
         if(prefix.IsEmpty())
             return;
 
+        if(auto snapshot = GetSnapshot()) {
+            snapshot->GetTagsByName(prefix, !exactMatch, m_enableCaseInsensitive, DoGetRemainingLimit(tags), tags);
+            return;
+        }
+
         wxString sql;
         sql << wxT("select * from tags where ");
         DoAddNamePartToQuery(sql, prefix, !exactMatch, false);
@@ -1156,12 +1240,16 @@ void TagsStorageSQLite::DoAddNamePartToQuery(wxString& sql, const wxString& name
 }
 
 void TagsStorageSQLite::DoAddLimitPartToQuery(wxString& sql, const std::vector<TagEntryPtr>& tags)
+{
+    sql << wxT(" LIMIT ") << DoGetRemainingLimit(tags) << wxT(" ");
+}
+
+size_t TagsStorageSQLite::DoGetRemainingLimit(const std::vector<TagEntryPtr>& tags) const
 {
     if(tags.size() >= (size_t)GetSingleSearchLimit()) {
-        sql << wxT(" LIMIT 1 ");
-    } else {
-        sql << wxT(" LIMIT ") << (size_t)GetSingleSearchLimit() - tags.size();
+        return 1;
     }
+    return (size_t)GetSingleSearchLimit() - tags.size();
 }
 
 TagEntryPtr TagsStorageSQLite::GetTagsByNameLimitOne(const wxString& name)
@@ -1237,6 +1325,77 @@ void TagsStorageSQLite::GetTagsByPartName(const wxArrayString& parts, std::vecto
     }
 }
 
+void TagsStorageSQLite::GetTagsByIds(const std::vector<long>& ids, std::vector<TagEntryPtr>& tags)
+{
+    if(ids.empty()) {
+        return;
+    }
+
+    tags.reserve(tags.size() + ids.size());
+    if(auto snapshot = GetSnapshot()) {
+        for(long id : ids) {
+            TagEntryPtr tag = snapshot->GetTagById(id);
+            if(tag) {
+                tags.push_back(tag);
+            }
+        }
+        return;
+    }
+
+    wxString sql;
+    sql << "select * from tags where ID in (";
+    for(size_t i = 0; i < ids.size(); ++i) {
+        sql << (i ? "," : "") << ids[i];
+    }
+    sql << ")";
+
+    // the result is not ordered, restore the order of `ids`
+    std::vector<TagEntryPtr> matches;
+    DoFetchTags(sql, matches);
+    std::unordered_map<long, TagEntryPtr> by_id;
+    by_id.reserve(matches.size());
+    for(TagEntryPtr tag : matches) {
+        by_id.insert({ (long)tag->GetId(), tag });
+    }
+    for(long id : ids) {
+        auto iter = by_id.find(id);
+        if(iter != by_id.end()) {
+            tags.push_back(iter->second);
+        }
+    }
+}
+
+void TagsStorageSQLite::EnumerateTagNames(const wxArrayString& files, const TagNameCallback_t& callback)
+{
+    // query the files in batches, to keep the statements short
+    const size_t batch_size = 500;
+    size_t offset = 0;
+    do {
+        wxString sql = "select ID, name, path, file from tags";
+        if(!files.empty()) {
+            sql << " where file in (";
+            size_t last = std::min(files.size(), offset + batch_size);
+            for(size_t i = offset; i < last; ++i) {
+                wxString file = files[i];
+                file.Replace("'", "''");
+                sql << (i > offset ? "," : "") << "'" << file << "'";
+            }
+            sql << ")";
+        }
+        offset += batch_size;
+
+        try {
+            wxSQLite3ResultSet rs = Query(sql);
+            while(rs.NextRow()) {
+                callback(rs.GetInt(0), rs.GetString(1), rs.GetString(2), rs.GetString(3));
+            }
+            rs.Finalize();
+        } catch (const wxSQLite3Exception& e) {
+            clWARNING() << "EnumerateTagNames:" << e.GetMessage() << endl;
+        }
+    } while(offset < files.size());
+}
+
 void TagsStorageSQLite::ReOpenDatabase()
 {
     // Did we get a file name to use?
@@ -1246,6 +1405,7 @@ void TagsStorageSQLite::ReOpenDatabase()
     clDEBUG() << "ReOpenDatabase called for file:" << m_fileName;
     // Close database first
     clDEBUG() << "Closing database first";
+    DropSnapshot(true);
     try {
         if(m_db) {
             m_db->Close();
@@ -1296,6 +1456,10 @@ TagEntryPtr TagsStorageSQLite::GetScope(const wxString& filename, int line_numbe
     if(filename.empty() || line_number == wxNOT_FOUND)
         return nullptr;
 
+    if(auto snapshot = GetSnapshot()) {
+        return snapshot->GetScope(filename, line_number);
+    }
+
     wxString sql;
     sql << "select * from tags where file='" << filename << "' and line <= " << line_number
         << " and name NOT LIKE '__anon%' and KIND IN ('function', 'class', 'struct', 'namespace') order by line desc "
@@ -1316,6 +1480,10 @@ size_t TagsStorageSQLite::GetFileScopedTags(const wxString& filepath, const wxSt
     if(filepath.empty())
         return 0;
 
+    if(auto snapshot = GetSnapshot()) {
+        return snapshot->GetFileScopedTags(filepath, name, kinds, tags);
+    }
+
     // get anoymous tags first
     wxString sql;
     std::vector<TagEntryPtr> tags_1;
@@ -1364,6 +1532,12 @@ size_t TagsStorageSQLite::GetFileScopedTags(const wxString& filepath, const wxSt
 
 size_t TagsStorageSQLite::GetParameters(const wxString& function_path, std::vector<TagEntryPtr>& tags)
 {
+    if(auto snapshot = GetSnapshot()) {
+        static const wxArrayString kinds = StdToWX::ToArrayString({ "parameter" });
+        snapshot->GetTagsByScopeAndKind(function_path, kinds, wxEmptyString, std::numeric_limits<size_t>::max(), tags);
+        return tags.size();
+    }
+
     wxString sql;
     sql << "select * from tags where kind = 'parameter' and scope = '" << function_path << "' order by ID asc";
     DoFetchTags(sql, tags);
@@ -1372,9 +1546,118 @@ size_t TagsStorageSQLite::GetParameters(const wxString& function_path, std::vect
 
 size_t TagsStorageSQLite::GetLambdas(const wxString& parent_function, std::vector<TagEntryPtr>& tags)
 {
+    if(auto snapshot = GetSnapshot()) {
+        static const wxArrayString kinds = StdToWX::ToArrayString({ "function" });
+        snapshot->GetTagsByScopeAndKind(parent_function, kinds, wxEmptyString, std::numeric_limits<size_t>::max(),
+                                        tags);
+        return tags.size();
+    }
+
     wxString sql;
     // assuming `parent_function` is a function, this will return all the lambda children
     sql << "select * from tags where kind = 'function' and scope = '" << parent_function << "' order by ID asc";
     DoFetchTags(sql, tags);
     return tags.size();
 }
+
+wxFileName TagsStorageSQLite::GetSnapshotFile() const
+{
+    wxFileName fn(m_fileName);
+    fn.SetFullName(m_fileName.GetFullName() + ".snapshot");
+    return fn;
+}
+
+void TagsStorageSQLite::DropSnapshot(bool forgetFile)
+{
+    m_snapshot.Unload();
+    if(forgetFile) {
+        m_snapshotChecked = false;
+        m_dataVersion = wxNOT_FOUND;
+        m_snapshotFileMtime = 0;
+        m_snapshotFileSize = 0;
+    }
+}
+
+void TagsStorageSQLite::SetUseSnapshot(bool useSnapshot)
+{
+    m_useSnapshot = useSnapshot;
+    DropSnapshot(true);
+}
+
+const TagsSnapshot* TagsStorageSQLite::GetSnapshot()
+{
+    if(!m_useSnapshot || !IsOpen()) {
+        return nullptr;
+    }
+
+    if(m_snapshotChecked) {
+        // a stale snapshot stays unloaded until the next check: the lookups fall back to SQL meanwhile
+        return m_snapshot.IsOk() ? &m_snapshot : nullptr;
+    }
+    m_snapshotChecked = true;
+
+    try {
+        // changes committed by other connections (e.g. the ctagsd parser thread) make the snapshot stale
+        int dataVersion = m_db->ExecuteScalar("PRAGMA data_version");
+        if(dataVersion != m_dataVersion) {
+            m_dataVersion = dataVersion;
+            m_snapshot.Unload();
+        }
+
+        if(m_snapshot.IsOk()) {
+            return &m_snapshot;
+        }
+
+        // try each version of the snapshot file once
+        wxFileName fn = GetSnapshotFile();
+        time_t mtime = FileUtils::GetFileModificationTime(fn);
+        if(mtime == 0) {
+            return nullptr;
+        }
+
+        size_t size = FileUtils::GetFileSize(fn);
+        if(mtime == m_snapshotFileMtime && size == m_snapshotFileSize) {
+            return nullptr;
+        }
+        m_snapshotFileMtime = mtime;
+        m_snapshotFileSize = size;
+
+        TagsSnapshot::Stamp stamp;
+        if(!TagsSnapshot::ReadStamp(*m_db, stamp) || !m_snapshot.Load(fn)) {
+            return nullptr;
+        }
+
+        if(m_snapshot.GetStamp() != stamp) {
+            clDEBUG() << "Tags snapshot does not match the database content:" << fn << endl;
+            m_snapshot.Unload();
+            return nullptr;
+        }
+        clDEBUG() << "Using tags snapshot:" << fn << "(" << m_snapshot.GetRowsCount() << "tags )" << endl;
+        return &m_snapshot;
+
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "Failed to check the tags snapshot:" << e.GetMessage() << endl;
+        m_snapshot.Unload();
+        return nullptr;
+    }
+}
+
+bool TagsStorageSQLite::BuildSnapshot()
+{
+    if(!IsOpen()) {
+        return false;
+    }
+
+    wxFileName fn = GetSnapshotFile();
+    TagsSnapshot::Stamp stamp;
+    TagsSnapshot current;
+    if(!TagsSnapshot::ReadStamp(*m_db, stamp) || !current.Load(fn) || current.GetStamp() != stamp) {
+        if(!TagsSnapshot::Build(*m_db, fn)) {
+            return false;
+        }
+    }
+
+    // the next lookup picks up the file
+    DropSnapshot(true);
+    return true;
+}
@@ -30,6 +30,7 @@
 #include "fileentry.h"
 #include "istorage.h"
 #include "tag_tree.h"
+#include "tags_storage_snapshot.h"
 #include "wxStringHash.h"
 
 #include <unordered_map>
@@ -74,6 +75,7 @@
  * | id           | Number | ID
  * | file         | String | Full path of the file
  * | last_retagged| Number | Timestamp for the last time this file was retagged
+ * | hash         | String | Hash of the file content when it was retagged (may be empty)
  *
  * Table Name: MACROS
  *
@@ -135,8 +137,34 @@ class WXDLLIMPEXP_CL TagsStorageSQLite : public ITagsStorage
 {
     clSqliteDB* m_db;
     TagsStorageSQLiteCache m_cache;
+    TagsSnapshot m_snapshot;
+    bool m_useSnapshot = false;
+    int m_dataVersion = wxNOT_FOUND;
+    // the snapshot state was checked since the last call to RecheckSnapshot()
+    bool m_snapshotChecked = false;
+    // the snapshot file state, when it was last loaded (or rejected)
+    time_t m_snapshotFileMtime = 0;
+    size_t m_snapshotFileSize = 0;
 
 private:
+    /**
+     * @brief return the snapshot of the tags table, or nullptr if it does not match the database content (or if it
+     * is disabled). A snapshot built by another connection is picked up here
+     */
+    const TagsSnapshot* GetSnapshot();
+
+    /**
+     * @brief unload the snapshot, called whenever this connection modifies the tags table. Pass `forgetFile` when
+     * the database file itself changes, so the snapshot file is checked again on the next lookup
+     */
+    void DropSnapshot(bool forgetFile = false);
+
+    /**
+     * @brief the LIMIT to use for a query that appends to `tags`
+     */
+    size_t DoGetRemainingLimit(const std::vector<TagEntryPtr>& tags) const;
+    wxFileName GetSnapshotFile() const;
+
     /**
      * @brief fetch tags from the database
      * @param sql
@@ -198,6 +226,22 @@ public:
      */
     void ReOpenDatabase();
 
+    /**
+     * @see ITagsStorage::SetUseSnapshot
+     */
+    void SetUseSnapshot(bool useSnapshot);
+
+    /**
+     * @see ITagsStorage::RecheckSnapshot
+     */
+    void RecheckSnapshot() { m_snapshotChecked = false; }
+
+    /**
+     * @brief write the snapshot of the tags table next to the database file (unless the existing one is up to
+     * date). The snapshot is loaded when this connection uses it
+     */
+    bool BuildSnapshot();
+
     /**
      * Create database if not existed already.
      */
@@ -444,17 +488,19 @@ public:
     /**
      * @brief insert entry by file name
      * @param filename
+     * @param hash
      * @return
      */
-    virtual int InsertFileEntry(const wxString& filename, int timestamp);
+    virtual int InsertFileEntry(const wxString& filename, int timestamp, const wxString& hash = wxEmptyString);
 
     /**
      * @brief update file entry using file name as key
      * @param filename
      * @param timestamp new timestamp
+     * @param hash
      * @return
      */
-    virtual int UpdateFileEntry(const wxString& filename, int timestamp);
+    virtual int UpdateFileEntry(const wxString& filename, int timestamp, const wxString& hash = wxEmptyString);
 
     /**
      * @brief
@@ -494,6 +540,9 @@ public:
      */
     void GetTagsByPartName(const wxArrayString& parts, std::vector<TagEntryPtr>& tags);
 
+    void GetTagsByIds(const std::vector<long>& ids, std::vector<TagEntryPtr>& tags);
+    void EnumerateTagNames(const wxArrayString& files, const TagNameCallback_t& callback);
+
     virtual size_t GetFileScopedTags(const wxString& filepath, const wxString& name, const wxArrayString& kinds,
                                      std::vector<TagEntryPtr>& tags);
 
@@ -931,6 +931,131 @@ bool FileUtils::GetChecksum(const wxString& filepath, size_t* checksum)
     return cksum(ToStdString(filepath), checksum);
 }
 
+namespace
+{
+// XXH64 (https://github.com/Cyan4973/xxHash): a fast non-cryptographic 64 bit hash
+constexpr wxUint64 XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr wxUint64 XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr wxUint64 XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr wxUint64 XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr wxUint64 XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline wxUint64 xxh_rotl(wxUint64 x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline wxUint64 xxh_read64(const unsigned char* p)
+{
+    wxUint64 v;
+    memcpy(&v, p, sizeof(v));
+    return wxUINT64_SWAP_ON_BE(v);
+}
+
+inline wxUint32 xxh_read32(const unsigned char* p)
+{
+    wxUint32 v;
+    memcpy(&v, p, sizeof(v));
+    return wxUINT32_SWAP_ON_BE(v);
+}
+
+inline wxUint64 xxh_round(wxUint64 acc, wxUint64 input)
+{
+    acc += input * XXH_PRIME64_2;
+    acc = xxh_rotl(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+inline wxUint64 xxh_merge_round(wxUint64 acc, wxUint64 val)
+{
+    acc ^= xxh_round(0, val);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+wxUint64 xxh64(const void* data, size_t len, wxUint64 seed)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* end = p + len;
+    wxUint64 h;
+
+    if (len >= 32) {
+        wxUint64 v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        wxUint64 v2 = seed + XXH_PRIME64_2;
+        wxUint64 v3 = seed;
+        wxUint64 v4 = seed - XXH_PRIME64_1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = xxh_round(v1, xxh_read64(p));
+            v2 = xxh_round(v2, xxh_read64(p + 8));
+            v3 = xxh_round(v3, xxh_read64(p + 16));
+            v4 = xxh_round(v4, xxh_read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = xxh_rotl(v1, 1) + xxh_rotl(v2, 7) + xxh_rotl(v3, 12) + xxh_rotl(v4, 18);
+        h = xxh_merge_round(h, v1);
+        h = xxh_merge_round(h, v2);
+        h = xxh_merge_round(h, v3);
+        h = xxh_merge_round(h, v4);
+    } else {
+        h = seed + XXH_PRIME64_5;
+    }
+
+    h += (wxUint64)len;
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh_round(0, xxh_read64(p));
+        h = xxh_rotl(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        h ^= (wxUint64)xxh_read32(p) * XXH_PRIME64_1;
+        h = xxh_rotl(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= (*p) * XXH_PRIME64_5;
+        h = xxh_rotl(h, 11) * XXH_PRIME64_1;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+} // namespace
+
+wxUint64 FileUtils::GetStableHash(const void* data, size_t len, wxUint64 seed) { return xxh64(data, len, seed); }
+
+wxUint64 FileUtils::GetStableHash(const wxString& str, wxUint64 seed)
+{
+    const wxScopedCharBuffer utf8 = str.utf8_str();
+    return xxh64(utf8.data(), utf8.length(), seed);
+}
+
+wxString FileUtils::GetContentHash(const std::string& content)
+{
+    return wxString::Format("%016llx", (unsigned long long)GetStableHash(content.data(), content.length()));
+}
+
+wxString FileUtils::GetFileHash(const wxString& filepath)
+{
+    wxLogNull noLog;
+    wxFFile fp(filepath, "rb");
+    if (!fp.IsOpened()) {
+        return wxEmptyString;
+    }
+
+    std::string content;
+    wxFileOffset size = fp.Length();
+    if (size < 0) {
+        return wxEmptyString;
+    }
+
+    content.resize(size);
+    if (size > 0 && fp.Read(&content[0], content.size()) != content.size()) {
+        return wxEmptyString;
+    }
+    return GetContentHash(content);
+}
+
 bool FileUtils::IsBinaryExecutable(const wxString& filename)
 {
 #ifdef __WXMSW__
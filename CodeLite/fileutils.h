@@ -311,6 +311,29 @@ public:
      */
     static bool GetChecksum(const wxString& filepath, size_t* checksum);
 
+    /**
+     * @brief return a fast 64 bit hash (XXH64) of `len` bytes. Unlike std::hash, the result is the same on every build
+     * and every run, so it can be stored on the disk. To hash several buffers, pass the hash of the previous ones as
+     * `seed`
+     */
+    static wxUint64 GetStableHash(const void* data, size_t len, wxUint64 seed = 0);
+
+    /**
+     * @brief return the stable hash (see above) of the UTF-8 representation of `str`
+     */
+    static wxUint64 GetStableHash(const wxString& str, wxUint64 seed = 0);
+
+    /**
+     * @brief return the stable hash of `content` (see GetStableHash()) as a 16 digits hex string
+     */
+    static wxString GetContentHash(const std::string& content);
+
+    /**
+     * @brief return the hash of the content of `filepath` (see GetContentHash()). Return an empty string if the file
+     * could not be read
+     */
+    static wxString GetFileHash(const wxString& filepath);
+
     /**
      * @brief convert any string into a valid filename while allowing only alphanum + '_' + '-' + '.'
      * example: "/12d#$file.exe" -> "_12d__file.exe"
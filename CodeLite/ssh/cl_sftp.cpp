@@ -30,13 +30,139 @@
 #include "file_logger.h"
 
 #include <atomic>
+#include <deque>
 #include <libssh/sftp.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <vector>
 #include <wx/ffile.h>
 #include <wx/filefn.h>
+#include <wx/stopwatch.h>
 #include <wx/tokenzr.h>
 
+#if LIBSSH_VERSION_INT >= SSH_VERSION_INT(0, 11, 0)
+#define CL_SFTP_HAS_AIO 1
+#else
+#define CL_SFTP_HAS_AIO 0
+#endif
+
+namespace
+{
+// 32K is the largest read length that every SFTP server is required to honour. Using it for the
+// pipelined reads means that we never get a short read in the middle of the file
+constexpr size_t SFTP_READ_CHUNK_SIZE = 32768;
+constexpr size_t SFTP_WRITE_CHUNK_SIZE = 65536;
+
+/**
+ * @brief keeps up to N read requests in flight for a single remote file. Replies are consumed in the order the
+ * requests were sent, so the data is always written sequentially into the output buffer
+ */
+class SFTPReadPipeline
+{
+#if CL_SFTP_HAS_AIO
+    typedef sftp_aio Request_t;
+#else
+    typedef int Request_t;
+#endif
+    struct PendingRead {
+        Request_t request;
+        size_t len = 0;
+    };
+
+    sftp_file m_file = nullptr;
+    std::deque<PendingRead> m_queue;
+
+public:
+    SFTPReadPipeline(sftp_file file)
+        : m_file(file)
+    {
+    }
+    ~SFTPReadPipeline() { Discard(); }
+
+    size_t GetInFlight() const { return m_queue.size(); }
+    bool IsEmpty() const { return m_queue.empty(); }
+
+    /**
+     * @brief send a read request for the next `len` bytes of the file
+     * @return the number of bytes requested or -1 on error
+     */
+    wxInt64 Begin(size_t len)
+    {
+        PendingRead pending;
+#if CL_SFTP_HAS_AIO
+        pending.request = nullptr;
+        ssize_t rc = sftp_aio_begin_read(m_file, len, &pending.request);
+        if (rc == SSH_ERROR) {
+            return -1;
+        }
+        pending.len = rc;
+#else
+        pending.request = sftp_async_read_begin(m_file, len);
+        if (pending.request < 0) {
+            return -1;
+        }
+        pending.len = len;
+#endif
+        m_queue.push_back(pending);
+        return pending.len;
+    }
+
+    /**
+     * @brief wait for the oldest request and copy its data into `dest`
+     * @param requested [output] the number of bytes that were requested for this reply
+     * @return the number of bytes read, 0 on EOF or -1 on error
+     */
+    wxInt64 Wait(char* dest, size_t* requested)
+    {
+        if (m_queue.empty()) {
+            return -1;
+        }
+
+        PendingRead pending = m_queue.front();
+        m_queue.pop_front();
+        *requested = pending.len;
+#if CL_SFTP_HAS_AIO
+        // sftp_aio_wait_read() releases the request
+        ssize_t nbytes = sftp_aio_wait_read(&pending.request, dest, pending.len);
+        return nbytes == SSH_ERROR ? -1 : nbytes;
+#else
+        int nbytes = sftp_async_read(m_file, dest, pending.len, pending.request);
+        return nbytes < 0 ? -1 : nbytes;
+#endif
+    }
+
+    /**
+     * @brief drop all the outstanding requests
+     */
+    void Discard()
+    {
+#if CL_SFTP_HAS_AIO
+        for (auto& pending : m_queue) {
+            sftp_aio_free(pending.request);
+        }
+#else
+        // the older API has no way of cancelling a request, read the replies into a scratch buffer
+        std::vector<char> scratch;
+        for (const auto& pending : m_queue) {
+            scratch.resize(pending.len);
+            sftp_async_read(m_file, scratch.data(), pending.len, pending.request);
+        }
+#endif
+        m_queue.clear();
+    }
+};
+} // namespace
+
+wxString clSFTPTransferStats::ToString() const
+{
+    wxString s;
+    s << "files: " << files << ", bytes: " << bytes << ", elapsed: " << elapsed_ms << "ms"
+      << ", first byte: " << first_byte_ms << "ms"
+      << ", requests: " << requests << ", max in flight: " << max_in_flight
+      << wxString::Format(", throughput: %.2f KB/s", GetThroughput() / 1024.0);
+    return s;
+}
+
 class SFTPDirCloser
 {
     sftp_dir m_dir;
@@ -168,22 +294,80 @@ void clSFTP::Write(const wxMemoryBuffer& fileContent, const wxString& remotePath
                           sftp_get_error(m_sftp));
     }
 
-    char* p = (char*)fileContent.GetData();
-    const int maxChunkSize = 65536;
-    wxInt64 bytesLeft = fileContent.GetDataLen();
+    const char* p = (const char*)fileContent.GetData();
+    wxInt64 totalBytes = fileContent.GetDataLen();
+    wxInt64 bytesWritten = 0;
+
+    wxStopWatch sw;
+    m_lastTransferStats = clSFTPTransferStats();
 
-    while (bytesLeft > 0) {
-        wxInt64 chunkSize = bytesLeft > maxChunkSize ? maxChunkSize : bytesLeft;
-        wxInt64 bytesWritten = sftp_write(file, p, chunkSize);
-        if (bytesWritten < 0) {
-            sftp_close(file);
-            throw clException(wxString() << _("Can't write data to file: ") << tmpRemoteFile << ". "
-                                         << ssh_get_error(m_ssh->GetSession()),
-                              sftp_get_error(m_sftp));
+    auto throw_write_error = [&]() {
+        sftp_close(file);
+        throw clException(wxString() << _("Can't write data to file: ") << tmpRemoteFile << ". "
+                                     << ssh_get_error(m_ssh->GetSession()),
+                          sftp_get_error(m_sftp));
+    };
+
+#if CL_SFTP_HAS_AIO
+    // keep up to m_pipelineDepth write requests in flight. The server replies in order, so we only need to
+    // wait for the oldest request before sending the next chunk
+    std::deque<std::pair<sftp_aio, size_t>> in_flight;
+    wxInt64 bytesSent = 0;
+    bool failed = false;
+    while (!failed && bytesWritten < totalBytes) {
+        while (in_flight.size() < m_pipelineDepth && bytesSent < totalBytes) {
+            size_t chunkSize = wxMin((wxInt64)SFTP_WRITE_CHUNK_SIZE, totalBytes - bytesSent);
+            sftp_aio aio = nullptr;
+            ssize_t rc = sftp_aio_begin_write(file, p + bytesSent, chunkSize, &aio);
+            if (rc == SSH_ERROR) {
+                failed = true;
+                break;
+            }
+            in_flight.push_back({ aio, (size_t)rc });
+            bytesSent += rc;
+            m_lastTransferStats.requests++;
+            m_lastTransferStats.max_in_flight = wxMax(m_lastTransferStats.max_in_flight, in_flight.size());
+        }
+
+        if (failed || in_flight.empty()) {
+            break;
+        }
+
+        auto pending = in_flight.front();
+        in_flight.pop_front();
+        ssize_t rc = sftp_aio_wait_write(&pending.first);
+        if (rc == SSH_ERROR || (size_t)rc != pending.second) {
+            failed = true;
+            break;
+        }
+        if (bytesWritten == 0) {
+            m_lastTransferStats.first_byte_ms = sw.Time();
         }
-        bytesLeft -= bytesWritten;
-        p += bytesWritten;
+        bytesWritten += rc;
+    }
+
+    for (auto& pending : in_flight) {
+        sftp_aio_free(pending.first);
     }
+
+    if (failed || bytesWritten != totalBytes) {
+        throw_write_error();
+    }
+#else
+    while (bytesWritten < totalBytes) {
+        wxInt64 chunkSize = wxMin((wxInt64)SFTP_WRITE_CHUNK_SIZE, totalBytes - bytesWritten);
+        wxInt64 nbytes = sftp_write(file, p + bytesWritten, chunkSize);
+        if (nbytes < 0) {
+            throw_write_error();
+        }
+        if (bytesWritten == 0) {
+            m_lastTransferStats.first_byte_ms = sw.Time();
+        }
+        m_lastTransferStats.requests++;
+        bytesWritten += nbytes;
+    }
+    m_lastTransferStats.max_in_flight = m_lastTransferStats.requests > 0 ? 1 : 0;
+#endif
     sftp_close(file);
 
     // Unlink the original file if it exists
@@ -206,6 +390,11 @@ void clSFTP::Write(const wxMemoryBuffer& fileContent, const wxString& remotePath
     if (pattr->IsOk()) {
         Chmod(remotePath, pattr->GetPermissions());
     }
+
+    m_lastTransferStats.bytes = bytesWritten;
+    m_lastTransferStats.files = 1;
+    m_lastTransferStats.elapsed_ms = sw.Time();
+    clDEBUG1() << "SFTP write" << remotePath << ":" << m_lastTransferStats.ToString() << endl;
 }
 
 SFTPAttribute::List_t clSFTP::List(const wxString& folder, size_t flags, const wxString& filter)
@@ -289,23 +478,70 @@ SFTPAttribute::Ptr_t clSFTP::Read(const wxString& remotePath, wxMemoryBuffer& bu
                           sftp_get_error(m_sftp));
     }
     wxInt64 fileSize = fileAttr->GetSize();
-    if (fileSize == 0)
+    if (fileSize == 0) {
+        sftp_close(file);
         return fileAttr;
+    }
 
-    // Allocate buffer for the file content
-    char pBuffer[65536]; // buffer
+    wxStopWatch sw;
+    m_lastTransferStats = clSFTPTransferStats();
 
-    // Read the entire file content
-    wxInt64 bytesLeft = fileSize;
+    // Read the file content directly into the output buffer
+    char* pBuffer = (char*)buffer.GetAppendBuf(fileSize);
     wxInt64 bytesRead = 0;
-    while (bytesLeft > 0) {
-        wxInt64 nbytes = sftp_read(file, pBuffer, sizeof(pBuffer));
-        if (nbytes <= 0) {
-            break; // we will throw later
+    wxInt64 bytesRequested = 0;
+    bool sequential = false;
+    {
+        SFTPReadPipeline pipeline(file);
+        while (bytesRead < fileSize) {
+            // top up the pipeline
+            while (pipeline.GetInFlight() < m_pipelineDepth && bytesRequested < fileSize) {
+                size_t chunkSize = wxMin((wxInt64)SFTP_READ_CHUNK_SIZE, fileSize - bytesRequested);
+                wxInt64 rc = pipeline.Begin(chunkSize);
+                if (rc <= 0) {
+                    break;
+                }
+                bytesRequested += rc;
+                m_lastTransferStats.requests++;
+                m_lastTransferStats.max_in_flight = wxMax(m_lastTransferStats.max_in_flight, pipeline.GetInFlight());
+            }
+
+            if (pipeline.IsEmpty()) {
+                break; // we will throw later
+            }
+
+            size_t requested = 0;
+            wxInt64 nbytes = pipeline.Wait(pBuffer + bytesRead, &requested);
+            if (nbytes <= 0) {
+                break; // we will throw later
+            }
+
+            if (bytesRead == 0) {
+                m_lastTransferStats.first_byte_ms = sw.Time();
+            }
+            bytesRead += nbytes;
+
+            if ((size_t)nbytes < requested && bytesRead < fileSize) {
+                // short read in the middle of the file (the file was truncated while we read it, or the server
+                // capped the request size). The replies that are still in flight no longer line up with our buffer,
+                // drop them and read the rest sequentially
+                sequential = true;
+                break;
+            }
+        }
+    }
+
+    if (sequential && sftp_seek64(file, bytesRead) == SSH_OK) {
+        clDEBUG() << "SFTP: short read while reading:" << remotePath << ". Reading the rest sequentially" << endl;
+        while (bytesRead < fileSize) {
+            size_t chunkSize = wxMin((wxInt64)SFTP_READ_CHUNK_SIZE, fileSize - bytesRead);
+            wxInt64 nbytes = sftp_read(file, pBuffer + bytesRead, chunkSize);
+            if (nbytes <= 0) {
+                break;
+            }
+            m_lastTransferStats.requests++;
+            bytesRead += nbytes;
         }
-        bytesRead += nbytes;
-        bytesLeft -= nbytes;
-        buffer.AppendData(pBuffer, nbytes);
     }
 
     if (bytesRead != fileSize) {
@@ -315,7 +551,13 @@ SFTPAttribute::Ptr_t clSFTP::Read(const wxString& remotePath, wxMemoryBuffer& bu
                                      << ssh_get_error(m_ssh->GetSession()),
                           sftp_get_error(m_sftp));
     }
+    buffer.UngetAppendBuf(bytesRead);
     sftp_close(file);
+
+    m_lastTransferStats.bytes = bytesRead;
+    m_lastTransferStats.files = 1;
+    m_lastTransferStats.elapsed_ms = sw.Time();
+    clDEBUG1() << "SFTP read" << remotePath << ":" << m_lastTransferStats.ToString() << endl;
     return fileAttr;
 }
 
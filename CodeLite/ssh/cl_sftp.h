@@ -41,6 +41,41 @@
 struct sftp_session_struct;
 typedef struct sftp_session_struct* SFTPSession_t;
 
+/**
+ * @brief statistics collected for a single file transfer (or an accumulation of several transfers)
+ */
+struct WXDLLIMPEXP_CL clSFTPTransferStats {
+    wxInt64 bytes = 0;          // number of bytes transferred
+    wxInt64 elapsed_ms = 0;     // total time spent on the transfer
+    wxInt64 first_byte_ms = 0;  // latency: time until the first reply arrived
+    size_t requests = 0;        // number of SFTP read/write requests sent
+    size_t max_in_flight = 0;   // the maximum number of requests that were outstanding at the same time
+    size_t files = 0;           // number of files transferred
+
+    /**
+     * @brief return the throughput in bytes per second
+     */
+    double GetThroughput() const
+    {
+        return elapsed_ms > 0 ? ((double)bytes * 1000.0) / (double)elapsed_ms : (double)bytes * 1000.0;
+    }
+
+    /**
+     * @brief merge another transfer into this one. Elapsed time is not accumulated as transfers
+     * might have been running in parallel
+     */
+    void Merge(const clSFTPTransferStats& other)
+    {
+        bytes += other.bytes;
+        requests += other.requests;
+        files += other.files;
+        max_in_flight = wxMax(max_in_flight, other.max_in_flight);
+        first_byte_ms = first_byte_ms == 0 ? other.first_byte_ms : wxMin(first_byte_ms, other.first_byte_ms);
+    }
+
+    wxString ToString() const;
+};
+
 class WXDLLIMPEXP_CL clSFTP
 {
     clSSH::Ptr_t m_ssh;
@@ -48,6 +83,8 @@ class WXDLLIMPEXP_CL clSFTP
     bool m_connected;
     wxString m_currentFolder;
     wxString m_account;
+    size_t m_pipelineDepth = 16;
+    clSFTPTransferStats m_lastTransferStats;
 
 public:
     typedef std::shared_ptr<clSFTP> Ptr_t;
@@ -85,6 +122,18 @@ public:
 
     void SetAccount(const wxString& account) { this->m_account = account; }
     const wxString& GetAccount() const { return m_account; }
+
+    /**
+     * @brief set the number of read/write requests that are kept in flight while transferring a file.
+     * Higher values hide the network round-trip time on high latency links. Setting it to 1 disables pipelining
+     */
+    void SetPipelineDepth(size_t depth) { this->m_pipelineDepth = wxMax((size_t)1, depth); }
+    size_t GetPipelineDepth() const { return m_pipelineDepth; }
+
+    /**
+     * @brief return the statistics of the last Read() or Write() call
+     */
+    const clSFTPTransferStats& GetLastTransferStats() const { return m_lastTransferStats; }
     /**
      * @brief intialize the scp over ssh
      */
@@ -110,6 +159,7 @@ public:
 
     /**
      * @brief write the content of 'fileContent' into the remote file represented by remotePath
+     * When built against libssh 0.11 or later, the write requests are pipelined (see SetPipelineDepth)
      */
     void Write(const wxMemoryBuffer& fileContent, const wxString& remotePath);
 
@@ -119,7 +169,7 @@ public:
     void CreateEmptyFile(const wxString& remotePath);
 
     /**
-     * @brief read remote file and return its content
+     * @brief read remote file and return its content. The read requests are pipelined (see SetPipelineDepth)
      * @return the file content + the file attributes
      */
     SFTPAttribute::Ptr_t Read(const wxString& remotePath, wxMemoryBuffer& buffer);
@@ -36,9 +36,9 @@
 #include "globals.h"
 #include "imanager.h"
 #include "lexer_configuration.h"
+#include "macros.h"
 
 #include <algorithm>
-#include <set>
 #include <wx/busyinfo.h>
 #include <wx/file.h>
 #include <wx/textfile.h>
@@ -103,15 +103,27 @@ SQLCommandPanel::SQLCommandPanel(wxWindow* parent, IDbAdapter* dbAdapter, const
     auto images = m_toolbar->GetBitmapsCreateIfNeeded();
     m_toolbar->AddTool(wxID_OPEN, _("Load SQL Script"), images->Add("file_open"));
     m_toolbar->AddTool(wxID_EXECUTE, _("Execute SQL"), images->Add("execute"));
+    m_toolbar->AddTool(wxID_STOP, _("Stop"), images->Add("stop"));
     m_toolbar->Realize();
     GetSizer()->Insert(0, m_toolbar, 0, wxEXPAND);
 
+    m_staticTextStatus = new wxStaticText(this, wxID_ANY, wxEmptyString);
+    GetSizer()->Add(m_staticTextStatus, 0, wxEXPAND | wxALL, 5);
+    m_table->SetFetchMoreCallback([this]() { OnFetchMore(); });
+
     // Bind events
     m_toolbar->Bind(wxEVT_TOOL, &SQLCommandPanel::OnExecuteClick, this, wxID_EXECUTE);
+    m_toolbar->Bind(wxEVT_TOOL, &SQLCommandPanel::OnStopClick, this, wxID_STOP);
+    m_toolbar->Bind(wxEVT_UPDATE_UI, &SQLCommandPanel::OnStopUI, this, wxID_STOP);
     m_toolbar->Bind(wxEVT_TOOL, &SQLCommandPanel::OnLoadClick, this, wxID_OPEN);
 }
 
-SQLCommandPanel::~SQLCommandPanel() { wxDELETE(m_pDbAdapter); }
+SQLCommandPanel::~SQLCommandPanel()
+{
+    // the worker posts to this panel, release it first
+    StopQuery();
+    wxDELETE(m_pDbAdapter);
+}
 
 void SQLCommandPanel::OnExecuteClick(wxCommandEvent& event) { ExecuteSql(); }
 
@@ -125,157 +137,113 @@ void SQLCommandPanel::OnScintilaKeyDown(wxKeyEvent& event)
 
 void SQLCommandPanel::ExecuteSql()
 {
-    clStatusBarMessage message(_("Executing SQL..."));
-
-    clWindowUpdateLocker locker(this);
-    std::set<int> textCols;
-    std::set<int> blobCols;
-    DatabaseLayerPtr m_pDbLayer = m_pDbAdapter->GetDatabaseLayer(m_dbName);
-    if(m_pDbLayer->IsOpen()) {
-        // build string of SQL statements with comments removed
-        wxArrayString sqls = ParseSql();
-        wxString sqlStmt = "";
-        for(size_t i = 0; i < sqls.GetCount(); i++) {
-            sqlStmt += sqls[i];
-        }
+    // build string of SQL statements with comments removed
+    wxArrayString sqls = ParseSql();
+    wxString sqlStmt = "";
+    for(size_t i = 0; i < sqls.GetCount(); i++) {
+        sqlStmt += sqls[i];
+    }
 
-        // save the history
-        SaveSqlHistory(sqls);
-
-        if(!sqls.IsEmpty()) {
-            try {
-                m_colsMetaData.clear();
-                if(!m_pDbAdapter->GetUseDb(m_dbName).IsEmpty())
-                    m_pDbLayer->RunQuery(m_pDbAdapter->GetUseDb(m_dbName));
-                // run query
-                DatabaseResultSet* pResultSet = m_pDbLayer->RunQueryWithResults(sqlStmt);
-
-                m_table->ClearAll();
-                if(!pResultSet) {
-                    wxMessageBox(_("Unknown SQL error."), _("DB Error"), wxOK | wxICON_ERROR);
-                    return;
-                }
-
-                int cols = pResultSet->GetMetaData()->GetColumnCount();
-                m_colsMetaData.resize(cols);
-
-                // create table header
-                wxArrayString columns;
-                for(int i = 1; i <= pResultSet->GetMetaData()->GetColumnCount(); i++) {
-                    columns.Add(pResultSet->GetMetaData()->GetColumnName(i));
-                    m_colsMetaData.at(i - 1) = ColumnInfo(pResultSet->GetMetaData()->GetColumnType(i),
-                                                          pResultSet->GetMetaData()->GetColumnName(i));
-                }
-                m_table->SetColumns(columns);
-
-                // fill table data
-                std::vector<wxArrayString> data;
-                while(pResultSet->Next()) {
-                    data.push_back(wxArrayString());
-                    wxArrayString& row = data.back();
-                    wxString value;
-                    for(int i = 1; i <= pResultSet->GetMetaData()->GetColumnCount(); i++) {
-
-                        switch(pResultSet->GetMetaData()->GetColumnType(i)) {
-                        case ResultSetMetaData::COLUMN_INTEGER:
-                            if(m_pDbAdapter->GetAdapterType() == IDbAdapter::atSQLITE) {
-                                value = pResultSet->GetResultString(i);
-
-                            } else {
-                                value = wxString::Format(wxT("%i"), pResultSet->GetResultInt(i));
-                            }
-                            break;
-
-                        case ResultSetMetaData::COLUMN_STRING:
-                            value = pResultSet->GetResultString(i);
-                            break;
-
-                        case ResultSetMetaData::COLUMN_UNKNOWN:
-                            value = pResultSet->GetResultString(i);
-                            break;
-
-                        case ResultSetMetaData::COLUMN_BLOB: {
-                            if(textCols.find(i) != textCols.end()) {
-                                // this column should be displayed as TEXT rather than BLOB
-                                value = pResultSet->GetResultString(i);
-
-                            } else if(blobCols.find(i) != blobCols.end()) {
-                                // this column should be displayed as BLOB
-                                wxMemoryBuffer buffer;
-                                pResultSet->GetResultBlob(i, buffer);
-                                value = wxString::Format(wxT("BLOB (Size:%u)"), buffer.GetDataLen());
-
-                            } else {
-                                // first time
-                                wxString strCol = pResultSet->GetResultString(i);
-                                if(IsBlobColumn(strCol)) {
-                                    blobCols.insert(i);
-                                    wxMemoryBuffer buffer;
-                                    pResultSet->GetResultBlob(i, buffer);
-                                    value = wxString::Format(wxT("BLOB (Size:%u)"), buffer.GetDataLen());
-
-                                } else {
-                                    textCols.insert(i);
-                                    value = strCol;
-                                }
-                            }
-                            break;
-                        }
-                        case ResultSetMetaData::COLUMN_BOOL:
-                            value = wxString::Format(wxT("%b"), pResultSet->GetResultBool(i));
-                            break;
-
-                        case ResultSetMetaData::COLUMN_DATE: {
-                            wxDateTime dt = pResultSet->GetResultDate(i);
-                            if(dt.IsValid()) {
-                                value = dt.Format();
-                            } else {
-                                value.Clear();
-                            }
-                        } break;
-
-                        case ResultSetMetaData::COLUMN_DOUBLE:
-                            value = wxString::Format(wxT("%f"), pResultSet->GetResultDouble(i));
-                            break;
-
-                        case ResultSetMetaData::COLUMN_NULL:
-                            value = wxT("NULL");
-                            break;
-
-                        default:
-                            value = pResultSet->GetResultString(i);
-                            break;
-                        }
-                        row.Add(value);
-                    }
-                }
-                m_pDbLayer->CloseResultSet(pResultSet);
-
-                // Populate the data
-                m_table->SetData(data);
-                GetSizer()->Layout();
-                Layout();
-
-            } catch (const DatabaseLayerException& e) {
-                // for some reason an exception is thrown even if the error code is 0...
-                if(e.GetErrorCode() != 0) {
-                    wxString errorMessage =
-                        wxString::Format(_("Error (%d): %s"), e.GetErrorCode(), e.GetErrorMessage().c_str());
-                    wxMessageDialog dlg(this, errorMessage, _("DB Error"), wxOK | wxCENTER | wxICON_ERROR);
-                    dlg.ShowModal();
-                }
-
-            } catch (...) {
-                wxMessageDialog dlg(this, _("Unknown error."), _("DB Error"), wxOK | wxCENTER | wxICON_ERROR);
-                dlg.ShowModal();
-            }
-        }
+    // save the history
+    SaveSqlHistory(sqls);
+    if(sqls.IsEmpty()) {
+        return;
+    }
 
-    } else {
-        wxMessageBox(_("Cant connect!"));
+    // the query runs on a worker thread with its own connection. The rows are read as the user moves through the
+    // pages, so a large table does not freeze the UI nor load the entire result into memory
+    StopQuery();
+    m_colsMetaData.clear();
+    m_table->ClearAll();
+    m_rowsCount = 0;
+    m_staticTextStatus->SetLabel(_("Executing SQL..."));
+
+    m_worker = new SqlQueryWorker(m_pDbAdapter->Clone(), m_dbName, sqlStmt, this, ++m_queryId);
+    m_worker->Start(2 * m_table->GetLinesPerPage());
+}
+
+void SQLCommandPanel::StopQuery()
+{
+    if(m_worker) {
+        // this does not wait for the statement to complete
+        m_worker->Stop();
+        m_worker = nullptr;
+        m_table->SetComplete(true);
     }
 }
 
+void SQLCommandPanel::OnFetchMore()
+{
+    if(m_worker) {
+        m_worker->RequestMore(m_table->GetLinesPerPage());
+    }
+}
+
+void SQLCommandPanel::OnStopClick(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    CHECK_PTR_RET(m_worker);
+
+    StopQuery();
+    m_staticTextStatus->SetLabel(wxString() << _("Query cancelled. Fetched ") << m_rowsCount << _(" rows"));
+}
+
+void SQLCommandPanel::OnStopUI(wxUpdateUIEvent& event) { event.Enable(m_worker != nullptr); }
+
+void SQLCommandPanel::OnQueryColumns(size_t queryId, const ColumnInfo::Vector_t& columns)
+{
+    if(queryId != m_queryId) {
+        return;
+    }
+
+    m_colsMetaData = columns;
+    wxArrayString names;
+    for(const auto& column : m_colsMetaData) {
+        names.Add(column.GetName());
+    }
+    m_table->SetColumns(names);
+    m_table->SetComplete(false);
+    GetSizer()->Layout();
+}
+
+void SQLCommandPanel::OnQueryRows(size_t queryId, std::vector<wxArrayString>& rows)
+{
+    if(queryId != m_queryId) {
+        return;
+    }
+    m_rowsCount += rows.size();
+    m_table->AppendData(rows);
+}
+
+void SQLCommandPanel::OnQueryDone(size_t queryId, const SqlQueryStats& stats)
+{
+    if(queryId != m_queryId) {
+        return;
+    }
+
+    StopQuery();
+    if(stats.HasError()) {
+        m_staticTextStatus->SetLabel(_("Query failed"));
+        wxString errorMessage = stats.error_code != 0
+                                    ? wxString::Format(_("Error (%d): %s"), stats.error_code, stats.error_message)
+                                    : stats.error_message;
+        wxMessageDialog dlg(this, errorMessage, _("DB Error"), wxOK | wxCENTER | wxICON_ERROR);
+        dlg.ShowModal();
+        return;
+    }
+
+    wxString status;
+    status << _("Query: ") << stats.query_ms << _("ms. Fetched ") << stats.rows << _(" rows in ") << stats.fetch_ms
+           << _("ms");
+    if(stats.fetch_ms > 0) {
+        status << " (" << (stats.rows * 1000 / stats.fetch_ms) << _(" rows/sec)");
+    }
+    if(stats.truncated) {
+        status << _(". The remaining rows were dropped to release the database");
+    }
+    m_staticTextStatus->SetLabel(status);
+}
+
 void SQLCommandPanel::OnLoadClick(wxCommandEvent& event)
 {
     wxFileDialog dlg(this, _("Choose a file"), wxT(""), wxT(""), wxT("Sql files(*.sql)|*.sql"),
@@ -369,16 +337,6 @@ void SQLCommandPanel::OnCopyCellValue(wxCommandEvent& e)
     }
 }
 
-bool SQLCommandPanel::IsBlobColumn(const wxString& str)
-{
-    for(size_t i = 0; i < str.Len(); i++) {
-        if(!wxIsprint(str.GetChar(i))) {
-            return true;
-        }
-    }
-    return false;
-}
-
 void SQLCommandPanel::SetDefaultSelect()
 {
     m_scintillaSQL->ClearAll();
@@ -28,10 +28,12 @@
 
 #include "GUI.h" // Base class: _SqlCommandPanel
 #include "IDbAdapter.h"
+#include "SqlQueryWorker.h"
 #include "clEditorEditEventsHandler.h"
 #include "clToolBar.h"
 
 #include <map>
+#include <memory>
 #include <wx/aui/auibar.h>
 #include <wx/dblayer/include/DatabaseErrorCodes.h>
 #include <wx/dblayer/include/DatabaseLayer.h>
@@ -84,11 +86,18 @@ protected:
     ColumnInfo::Vector_t m_colsMetaData;
     clEditEventsHandler::Ptr_t m_editHelper;
     clToolBarGeneric* m_toolbar;
+    wxStaticText* m_staticTextStatus = nullptr;
+    SqlQueryWorker* m_worker = nullptr; // deletes itself in Stop()
+    size_t m_queryId = 0;
+    size_t m_rowsCount = 0;
 
 protected:
-    bool IsBlobColumn(const wxString& str);
     wxArrayString ParseSql() const;
     void SaveSqlHistory(wxArrayString sqls);
+    void StopQuery();
+    void OnFetchMore();
+    void OnStopClick(wxCommandEvent& event);
+    void OnStopUI(wxUpdateUIEvent& event);
 
 public:
     SQLCommandPanel(wxWindow* parent, IDbAdapter* dbAdapter, const wxString& dbName, const wxString& dbTable);
@@ -106,6 +115,11 @@ public:
     void OnCopyCellValue(wxCommandEvent& e);
     DECLARE_EVENT_TABLE()
     void OnExecuteSQL(wxCommandEvent& e);
+
+    // Called by the query worker. Results of older queries are ignored
+    void OnQueryColumns(size_t queryId, const ColumnInfo::Vector_t& columns);
+    void OnQueryRows(size_t queryId, std::vector<wxArrayString>& rows);
+    void OnQueryDone(size_t queryId, const SqlQueryStats& stats);
 };
 
 #endif // SQLCOMMANDPANEL_H
@@ -0,0 +1,276 @@
+#include "SqlQueryWorker.h"
+
+#include "IDbAdapter.h"
+#include "SqlCommandPanel.h"
+#include "file_logger.h"
+
+#include <chrono>
+#include <wx/dblayer/include/DatabaseLayerException.h>
+
+namespace
+{
+// how long an SQLite result set is kept open while the view does not ask for more rows
+constexpr int SQLITE_IDLE_TIMEOUT_SECONDS = 30;
+
+typedef std::chrono::steady_clock Clock_t;
+long ElapsedMs(const Clock_t::time_point& since)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock_t::now() - since).count();
+}
+} // namespace
+
+SqlQueryWorker::SqlQueryWorker(IDbAdapter* adapter, const wxString& dbName, const wxString& sql,
+                               SQLCommandPanel* sink, size_t queryId)
+    : m_adapter(adapter)
+    , m_dbName(dbName)
+    , m_sql(sql)
+    , m_sink(sink)
+    , m_queryId(queryId)
+    , m_cancelled(false)
+{
+}
+
+SqlQueryWorker::~SqlQueryWorker()
+{
+    wxDELETE(m_thread);
+    wxDELETE(m_adapter);
+}
+
+void SqlQueryWorker::Start(size_t rows)
+{
+    m_requested = rows;
+    m_thread = new std::thread(&SqlQueryWorker::Run, this);
+}
+
+void SqlQueryWorker::RequestMore(size_t rows)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requested += rows;
+    }
+    m_cv.notify_one();
+}
+
+void SqlQueryWorker::Cancel()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled.store(true);
+    }
+    m_cv.notify_one();
+}
+
+void SqlQueryWorker::Stop()
+{
+    bool done = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled.store(true);
+        if (m_db) {
+            // only SQLite supports this, the other databases complete the statement on the detached thread
+            m_db->Interrupt();
+        }
+        done = m_done || !m_thread;
+        if (!done) {
+            m_detached = true;
+            m_thread->detach();
+        }
+    }
+    m_cv.notify_one();
+
+    if (done) {
+        // the thread is exiting (or was never started), no need to hand it the worker
+        if (m_thread) {
+            m_thread->join();
+        }
+        delete this;
+    }
+}
+
+bool SqlQueryWorker::WaitForRequest(size_t fetched, bool* timedOut)
+{
+    auto ready = [&]() { return m_cancelled.load() || m_requested > fetched; };
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_adapter->GetAdapterType() == IDbAdapter::atSQLITE) {
+        *timedOut = !m_cv.wait_for(lock, std::chrono::seconds(SQLITE_IDLE_TIMEOUT_SECONDS), ready);
+    } else {
+        m_cv.wait(lock, ready);
+    }
+    return !m_cancelled.load() && !*timedOut;
+}
+
+bool SqlQueryWorker::SetDatabase(std::shared_ptr<DatabaseLayer> db)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_db = db;
+    return !m_cancelled.load();
+}
+
+template <typename Method, typename... Args> void SqlQueryWorker::Post(Method method, Args... args)
+{
+    // Stop() sets the flag under the same lock, so the sink is never used after it was released
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_cancelled.load()) {
+        m_sink->CallAfter(method, args...);
+    }
+}
+
+void SqlQueryWorker::Run()
+{
+    DoRun();
+
+    bool detached = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+        detached = m_detached;
+    }
+    if (detached) {
+        delete this;
+    }
+}
+
+void SqlQueryWorker::DoRun()
+{
+    SqlQueryStats stats;
+    auto start = Clock_t::now();
+    DatabaseLayerPtr db;
+    try {
+        db = m_adapter->GetDatabaseLayer(m_dbName);
+        if (!db || !db->IsOpen()) {
+            stats.error_message = _("Cant connect!");
+        } else if (SetDatabase(db)) {
+            if (!m_adapter->GetUseDb(m_dbName).IsEmpty()) {
+                db->RunQuery(m_adapter->GetUseDb(m_dbName));
+            }
+
+            DatabaseResultSet* resultSet = db->RunQueryWithResults(m_sql);
+            stats.query_ms = ElapsedMs(start);
+            if (!resultSet) {
+                stats.error_message = _("Unknown SQL error.");
+            } else {
+                // the column types never change, read them once
+                ResultSetMetaData* metaData = resultSet->GetMetaData();
+                int cols = metaData->GetColumnCount();
+                ColumnInfo::Vector_t columns;
+                columns.reserve(cols);
+                for (int i = 1; i <= cols; i++) {
+                    columns.push_back(ColumnInfo(metaData->GetColumnType(i), metaData->GetColumnName(i)));
+                }
+                Post(&SQLCommandPanel::OnQueryColumns, m_queryId, columns);
+
+                bool isSQLite = m_adapter->GetAdapterType() == IDbAdapter::atSQLITE;
+                bool more = true;
+                while (more && WaitForRequest(stats.rows, &stats.truncated)) {
+                    size_t limit = 0;
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        limit = m_requested;
+                    }
+
+                    auto fetch_start = Clock_t::now();
+                    std::vector<wxArrayString> rows;
+                    rows.reserve(limit - stats.rows);
+                    while (stats.rows < limit && !m_cancelled.load() && (more = resultSet->Next())) {
+                        rows.emplace_back();
+                        wxArrayString& row = rows.back();
+                        row.reserve(cols);
+                        for (int i = 1; i <= cols; i++) {
+                            row.Add(FormatValue(resultSet, i, columns[i - 1].GetType(), isSQLite));
+                        }
+                        ++stats.rows;
+                    }
+                    stats.fetch_ms += ElapsedMs(fetch_start);
+
+                    if (!rows.empty()) {
+                        Post(&SQLCommandPanel::OnQueryRows, m_queryId, rows);
+                    }
+                }
+                db->CloseResultSet(resultSet);
+            }
+        }
+
+    } catch (const DatabaseLayerException& e) {
+        // for some reason an exception is thrown even if the error code is 0...
+        if (e.GetErrorCode() != 0) {
+            stats.error_code = e.GetErrorCode();
+            stats.error_message = e.GetErrorMessage();
+        }
+
+    } catch (...) {
+        stats.error_message = _("Unknown error.");
+    }
+
+    // the connection is closed by the adapter, Stop() must not interrupt it anymore
+    SetDatabase(nullptr);
+    db.reset();
+
+    stats.cancelled = m_cancelled.load();
+    if (stats.cancelled) {
+        // the panel already knows, and it might be going away
+        return;
+    }
+    clDEBUG() << "DatabaseExplorer: query completed." << stats.rows << "rows, query:" << stats.query_ms
+              << "ms, fetch:" << stats.fetch_ms << "ms" << endl;
+    Post(&SQLCommandPanel::OnQueryDone, m_queryId, stats);
+}
+
+wxString SqlQueryWorker::FormatValue(DatabaseResultSet* resultSet, int col, int type, bool isSQLite)
+{
+    switch (type) {
+    case ResultSetMetaData::COLUMN_INTEGER:
+        if (isSQLite) {
+            return resultSet->GetResultString(col);
+        }
+        return wxString() << resultSet->GetResultInt(col);
+
+    case ResultSetMetaData::COLUMN_BLOB: {
+        if (m_textCols.count(col)) {
+            // this column should be displayed as TEXT rather than BLOB
+            return resultSet->GetResultString(col);
+        }
+
+        if (m_blobCols.count(col) == 0) {
+            // first time
+            wxString strCol = resultSet->GetResultString(col);
+            if (!IsBlobColumn(strCol)) {
+                m_textCols.insert(col);
+                return strCol;
+            }
+            m_blobCols.insert(col);
+        }
+
+        // this column should be displayed as BLOB
+        wxMemoryBuffer buffer;
+        resultSet->GetResultBlob(col, buffer);
+        return wxString::Format(wxT("BLOB (Size:%u)"), (unsigned)buffer.GetDataLen());
+    }
+    case ResultSetMetaData::COLUMN_BOOL:
+        return wxString::Format(wxT("%d"), (int)resultSet->GetResultBool(col));
+
+    case ResultSetMetaData::COLUMN_DATE: {
+        wxDateTime dt = resultSet->GetResultDate(col);
+        return dt.IsValid() ? dt.Format() : wxString();
+    }
+    case ResultSetMetaData::COLUMN_DOUBLE:
+        return wxString::Format(wxT("%f"), resultSet->GetResultDouble(col));
+
+    case ResultSetMetaData::COLUMN_NULL:
+        return wxT("NULL");
+
+    case ResultSetMetaData::COLUMN_STRING:
+    case ResultSetMetaData::COLUMN_UNKNOWN:
+    default:
+        return resultSet->GetResultString(col);
+    }
+}
+
+bool SqlQueryWorker::IsBlobColumn(const wxString& str)
+{
+    for (size_t i = 0; i < str.Len(); i++) {
+        if (!wxIsprint(str.GetChar(i))) {
+            return true;
+        }
+    }
+    return false;
+}
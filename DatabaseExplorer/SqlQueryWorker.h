@@ -0,0 +1,108 @@
+#ifndef SQLQUERYWORKER_H
+#define SQLQUERYWORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+class IDbAdapter;
+class DatabaseLayer;
+class DatabaseResultSet;
+class SQLCommandPanel;
+
+/**
+ * @brief timing and outcome of a query executed by SqlQueryWorker
+ */
+struct SqlQueryStats {
+    size_t rows = 0;
+    long query_ms = 0; // time spent until the first row was available
+    long fetch_ms = 0; // time spent reading rows (time spent waiting for the view is excluded)
+    bool cancelled = false;
+    bool truncated = false; // the rows that were not requested in time were dropped to release the database
+    int error_code = 0;
+    wxString error_message;
+    bool HasError() const { return !error_message.empty(); }
+};
+
+/**
+ * @brief execute an SQL statement on a worker thread and deliver the rows to a SQLCommandPanel, page by page.
+ * The worker only reads ahead of what was requested by the view, so the memory used by the result is bounded by what
+ * the user actually browsed. The worker owns its adapter (and thus its database connection).
+ *
+ * While the result set is open, SQLite holds a read transaction that blocks the writers of the database (and the WAL
+ * checkpoints). So an SQLite result set that nobody reads from for SQLITE_IDLE_TIMEOUT_SECONDS is closed, and the rows
+ * that were not read yet are dropped
+ */
+class SqlQueryWorker
+{
+    IDbAdapter* m_adapter = nullptr;
+    wxString m_dbName;
+    wxString m_sql;
+    SQLCommandPanel* m_sink = nullptr;
+    size_t m_queryId = 0;
+    std::thread* m_thread = nullptr;
+    std::shared_ptr<DatabaseLayer> m_db; // the connection used by the running statement, for Stop()
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    size_t m_requested = 0;
+    std::atomic_bool m_cancelled;
+    bool m_detached = false; // Stop() was called, the thread deletes the worker
+    bool m_done = false;     // the thread function returned
+
+    // per column display mode for BLOB columns, decided from the first row
+    std::set<int> m_textCols;
+    std::set<int> m_blobCols;
+
+protected:
+    void Run();
+    void DoRun();
+    bool WaitForRequest(size_t fetched, bool* timedOut);
+    /**
+     * @brief publish the connection used by the statement to Stop(). Return false if the query was already cancelled
+     */
+    bool SetDatabase(std::shared_ptr<DatabaseLayer> db);
+    template <typename Method, typename... Args> void Post(Method method, Args... args);
+    wxString FormatValue(DatabaseResultSet* resultSet, int col, int type, bool isSQLite);
+    static bool IsBlobColumn(const wxString& str);
+
+public:
+    /**
+     * @brief the worker takes the ownership of `adapter`
+     */
+    SqlQueryWorker(IDbAdapter* adapter, const wxString& dbName, const wxString& sql, SQLCommandPanel* sink,
+                   size_t queryId);
+
+    /**
+     * @brief start the query and read up to `rows` rows
+     */
+    void Start(size_t rows);
+
+    /**
+     * @brief allow the worker to read `rows` more rows
+     */
+    void RequestMore(size_t rows);
+
+    /**
+     * @brief stop reading rows. The rows that were not delivered yet are dropped
+     */
+    void Cancel();
+
+    /**
+     * @brief cancel the query and release the worker. This does not wait for the worker thread: a running SQLite
+     * statement is interrupted, the other databases complete the statement (or the current row) in the background.
+     * Nothing is posted to the sink once this returns. The worker deletes itself, do not use it afterwards
+     */
+    void Stop();
+
+private:
+    ~SqlQueryWorker();
+};
+
+#endif // SQLQUERYWORKER_H
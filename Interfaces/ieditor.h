@@ -70,6 +70,22 @@ struct CompilerMessage {
     }
 };
 
+/**
+ * @brief a semantic token, in document positions. `kind` is the word set the token belongs to
+ * (LexerConf::WS_CLASS, LexerConf::WS_FUNCTIONS, ...)
+ */
+struct SemanticToken {
+    int start = 0;
+    int length = 0;
+    int kind = 0;
+
+    bool operator==(const SemanticToken& other) const
+    {
+        return start == other.start && length == other.length && kind == other.kind;
+    }
+    bool operator!=(const SemanticToken& other) const { return !(*this == other); }
+};
+
 //------------------------------------------------------------------
 // Defines the interface to the editor control
 //------------------------------------------------------------------
@@ -514,6 +530,11 @@ public:
      */
     virtual void DelAllCompilerMarkers() = 0;
 
+    /**
+     * @brief delete the compiler markers (warnings/errors) of a single line
+     */
+    virtual void DelCompilerMarker(int lineno) = 0;
+
     //-------------------------------------------------
     // Provide a user client data API
     //-------------------------------------------------
@@ -634,6 +655,14 @@ public:
                                    const wxString& methods,
                                    const wxString& others) = 0;
 
+    /**
+     * @brief colour the semantic tokens by their position. Unlike SetSemanticTokens() this does not re-lex the
+     * document and identifiers that share a name are coloured by their own kind. `tokens` must be sorted by position.
+     * Only the regions that changed since the previous call are updated: the visible lines immediately, the rest of
+     * the document when the editor is idle
+     */
+    virtual void SetSemanticTokenRanges(std::vector<SemanticToken> tokens) = 0;
+
     /**
      * @brief similar to wxStyledTextCtrl::GetColumn(), but treat TAB as a single char
      * width
@@ -0,0 +1,127 @@
+#include "DiagnosticsStore.hpp"
+
+DiagnosticsStore::File& DiagnosticsStore::GetOrCreate(const wxString& path)
+{
+    auto iter = m_index.find(path);
+    if (iter != m_index.end()) {
+        return m_files[iter->second];
+    }
+
+    m_index.insert({ path, m_files.size() });
+    m_files.emplace_back();
+    m_files.back().path = path;
+    return m_files.back();
+}
+
+DiagnosticsStore::LineMap_t DiagnosticsStore::GetLines(const std::vector<LSP::Diagnostic>& diagnostics)
+{
+    LineMap_t lines;
+    for (const auto& d : diagnostics) {
+        int line = d.GetRange().GetStart().GetLine();
+        if (line < 0) {
+            continue;
+        }
+
+        // lower value means higher severity
+        auto where = lines.insert({ line, &d });
+        if (!where.second && d.GetSeverity() < where.first->second->GetSeverity()) {
+            where.first->second = &d;
+        }
+    }
+    return lines;
+}
+
+void DiagnosticsStore::Diff(const LineMap_t& before, const LineMap_t& after, Changes* changes)
+{
+    // both maps are sorted by line, walk them side by side
+    auto b = before.begin();
+    auto a = after.begin();
+    while (b != before.end() || a != after.end()) {
+        if (a == after.end() || (b != before.end() && b->first < a->first)) {
+            changes->removed_lines.push_back(b->first);
+            ++b;
+        } else if (b == before.end() || a->first < b->first) {
+            changes->updated_lines.push_back(a->second);
+            ++a;
+        } else {
+            if (*a->second != *b->second) {
+                changes->updated_lines.push_back(a->second);
+            }
+            ++a;
+            ++b;
+        }
+    }
+}
+
+bool DiagnosticsStore::Set(const wxString& path, int version, std::vector<LSP::Diagnostic> diagnostics,
+                           Changes* changes)
+{
+    if (diagnostics.empty() && m_index.count(path) == 0) {
+        return false;
+    }
+
+    File& file = GetOrCreate(path);
+    if (version != wxNOT_FOUND && file.version != wxNOT_FOUND && version < file.version) {
+        // a late reply for an older version of the document
+        return false;
+    }
+
+    if (version != wxNOT_FOUND) {
+        file.version = version;
+    }
+
+    if (file.diagnostics == diagnostics) {
+        return false;
+    }
+
+    if (changes) {
+        // moving the vector keeps its elements in place, so the pointers in `after` remain valid
+        LineMap_t before = GetLines(file.diagnostics);
+        LineMap_t after = GetLines(diagnostics);
+        Diff(before, after, changes);
+    }
+
+    m_count -= file.diagnostics.size();
+    m_count += diagnostics.size();
+    file.diagnostics = std::move(diagnostics);
+    file.generation = ++m_generation;
+    return true;
+}
+
+void DiagnosticsStore::ClearAll()
+{
+    m_files.clear();
+    m_index.clear();
+    m_count = 0;
+    m_clear_generation = ++m_generation;
+}
+
+void DiagnosticsStore::ResetVersion(const wxString& path)
+{
+    auto iter = m_index.find(path);
+    if (iter != m_index.end()) {
+        m_files[iter->second].version = wxNOT_FOUND;
+    }
+}
+
+bool DiagnosticsStore::GetAll(const wxString& path, Changes* changes) const
+{
+    const File* file = Find(path);
+    if (!file || file->diagnostics.empty()) {
+        return false;
+    }
+
+    for (const auto& vt : GetLines(file->diagnostics)) {
+        changes->updated_lines.push_back(vt.second);
+    }
+    return true;
+}
+
+const DiagnosticsStore::File* DiagnosticsStore::Find(const wxString& path) const
+{
+    auto iter = m_index.find(path);
+    if (iter == m_index.end()) {
+        return nullptr;
+    }
+    return &m_files[iter->second];
+}
@@ -0,0 +1,99 @@
+#ifndef DIAGNOSTICSSTORE_HPP
+#define DIAGNOSTICSSTORE_HPP
+
+#include "LSP/basic_types.h"
+#include "wxStringHash.h"
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief the diagnostics published by the language servers, for all the files (open or not).
+ * Each new set is compared with the previous set of the same file, so only the editor lines that changed are updated.
+ * Files are kept in stable slots, so views can refer to a diagnostic with a (file id, index) pair
+ */
+class DiagnosticsStore
+{
+public:
+    struct File {
+        wxString path;
+        int version = wxNOT_FOUND;
+        // the store generation of the last change of this file
+        size_t generation = 0;
+        std::vector<LSP::Diagnostic> diagnostics;
+    };
+
+    /**
+     * @brief the diagnostic displayed for each line: the most severe one reported for it
+     */
+    typedef std::map<int, const LSP::Diagnostic*> LineMap_t;
+
+    /**
+     * @brief the editor updates needed to move from one set to another
+     */
+    struct Changes {
+        std::vector<int> removed_lines;
+        std::vector<const LSP::Diagnostic*> updated_lines;
+        bool empty() const { return removed_lines.empty() && updated_lines.empty(); }
+    };
+
+protected:
+    std::vector<File> m_files;
+    std::unordered_map<wxString, size_t> m_index;
+    size_t m_count = 0;
+    size_t m_generation = 0;
+    size_t m_clear_generation = 0;
+
+protected:
+    File& GetOrCreate(const wxString& path);
+    static void Diff(const LineMap_t& before, const LineMap_t& after, Changes* changes);
+
+public:
+    DiagnosticsStore() = default;
+    ~DiagnosticsStore() = default;
+
+    static LineMap_t GetLines(const std::vector<LSP::Diagnostic>& diagnostics);
+
+    /**
+     * @brief replace the diagnostics of `path`. Return false if nothing changed or if `version` is older than the
+     * version of the stored set. Otherwise, `changes` (optional) holds the lines to update. Its pointers refer to the
+     * stored diagnostics and remain valid until the next update of this file
+     */
+    bool Set(const wxString& path, int version, std::vector<LSP::Diagnostic> diagnostics, Changes* changes);
+    bool Clear(const wxString& path, int version, Changes* changes) { return Set(path, version, {}, changes); }
+    void ClearAll();
+
+    /**
+     * @brief forget the document version of `path`. Call it when the file is closed or re-opened: the language server
+     * starts counting the versions again from `didOpen`, so the next set must not be compared with the previous session
+     */
+    void ResetVersion(const wxString& path);
+
+    /**
+     * @brief return the lines of a file as a list of updates. Use it to populate an editor that was just loaded
+     */
+    bool GetAll(const wxString& path, Changes* changes) const;
+
+    const File* Find(const wxString& path) const;
+    const File* GetFile(size_t file_id) const { return file_id < m_files.size() ? &m_files[file_id] : nullptr; }
+    size_t GetFilesCount() const { return m_files.size(); }
+
+    /**
+     * @brief the number of diagnostics, for all the files
+     */
+    size_t GetCount() const { return m_count; }
+
+    /**
+     * @brief a counter that is increased whenever the content changes
+     */
+    size_t GetGeneration() const { return m_generation; }
+
+    /**
+     * @brief the generation of the last ClearAll(). The file ids given before that are no longer valid
+     */
+    size_t GetClearGeneration() const { return m_clear_generation; }
+};
+
+#endif // DIAGNOSTICSSTORE_HPP
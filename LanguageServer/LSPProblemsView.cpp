@@ -0,0 +1,298 @@
+#include "LSPProblemsView.hpp"
+
+#include "LanguageServerCluster.h"
+#include "file_logger.h"
+#include "globals.h"
+#include "ieditor.h"
+#include "imanager.h"
+#include "macros.h"
+
+#include <algorithm>
+#include <wx/sizer.h>
+
+namespace
+{
+wxString SeverityToString(int severity)
+{
+    switch (severity) {
+    case LSP::DiagnosticSeverity::Error:
+        return _("Error");
+    case LSP::DiagnosticSeverity::Warning:
+        return _("Warning");
+    case LSP::DiagnosticSeverity::Information:
+        return _("Information");
+    default:
+        return _("Hint");
+    }
+}
+} // namespace
+
+LSPProblemsList::LSPProblemsList(wxWindow* parent, const DiagnosticsStore* store)
+    : wxListView(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT | wxLC_VIRTUAL | wxLC_SINGLE_SEL)
+    , m_store(store)
+{
+    AppendColumn(_("Severity"));
+    AppendColumn(_("File"), wxLIST_FORMAT_LEFT, FromDIP(300));
+    AppendColumn(_("Line"));
+    AppendColumn(_("Message"), wxLIST_FORMAT_LEFT, FromDIP(800));
+}
+
+const LSP::Diagnostic* LSPProblemsList::GetDiagnostic(long item, wxString* path) const
+{
+    if (item < 0 || item >= (long)m_rows.size()) {
+        return nullptr;
+    }
+
+    const Row& row = m_rows[item];
+    const DiagnosticsStore::File* file = m_store->GetFile(row.file_id);
+    if (!file || row.index >= file->diagnostics.size()) {
+        return nullptr;
+    }
+
+    if (path) {
+        *path = file->path;
+    }
+    return &file->diagnostics[row.index];
+}
+
+void LSPProblemsList::UpdateItemCount()
+{
+    SetItemCount(m_rows.size());
+    Refresh();
+}
+
+wxString LSPProblemsList::OnGetItemText(long item, long column) const
+{
+    wxString path;
+    const LSP::Diagnostic* d = GetDiagnostic(item, &path);
+    if (!d) {
+        return wxEmptyString;
+    }
+
+    switch (column) {
+    case COL_SEVERITY:
+        return SeverityToString(d->GetSeverity());
+    case COL_FILE:
+        return path;
+    case COL_LINE:
+        // LSP lines are 0 based
+        return wxString() << (d->GetRange().GetStart().GetLine() + 1);
+    case COL_MESSAGE:
+    default:
+        return d->GetMessage();
+    }
+}
+
+LSPProblemsView::LSPProblemsView(wxWindow* parent, LanguageServerCluster* cluster)
+    : wxPanel(parent)
+    , m_cluster(cluster)
+{
+    SetSizer(new wxBoxSizer(wxVERTICAL));
+
+    wxBoxSizer* toolbarSizer = new wxBoxSizer(wxHORIZONTAL);
+    wxArrayString severities;
+    severities.Add(_("Errors"));
+    severities.Add(_("Errors and warnings"));
+    severities.Add(_("All"));
+    m_choiceSeverity = new wxChoice(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, severities);
+    m_choiceSeverity->SetSelection(2);
+    m_textCtrlFilter = new wxTextCtrl(this, wxID_ANY);
+    m_textCtrlFilter->SetHint(_("Filter by file or message"));
+    toolbarSizer->Add(m_choiceSeverity, 0, wxALL | wxALIGN_CENTER_VERTICAL, 5);
+    toolbarSizer->Add(m_textCtrlFilter, 1, wxALL | wxALIGN_CENTER_VERTICAL, 5);
+    GetSizer()->Add(toolbarSizer, 0, wxEXPAND);
+
+    m_list = new LSPProblemsList(this, &m_cluster->GetDiagnosticsStore());
+    GetSizer()->Add(m_list, 1, wxEXPAND);
+
+    m_choiceSeverity->Bind(wxEVT_CHOICE, &LSPProblemsView::OnFilter, this);
+    m_textCtrlFilter->Bind(wxEVT_TEXT, &LSPProblemsView::OnFilter, this);
+    m_list->Bind(wxEVT_LIST_COL_CLICK, &LSPProblemsView::OnColumnClick, this);
+    m_list->Bind(wxEVT_LIST_ITEM_ACTIVATED, &LSPProblemsView::OnItemActivated, this);
+    Bind(wxEVT_IDLE, &LSPProblemsView::OnIdle, this);
+}
+
+LSPProblemsView::~LSPProblemsView() { Unbind(wxEVT_IDLE, &LSPProblemsView::OnIdle, this); }
+
+void LSPProblemsView::OnIdle(wxIdleEvent& event)
+{
+    event.Skip();
+    // the diagnostics change on every keystroke, only refresh the view when it is visible
+    const DiagnosticsStore& store = m_cluster->GetDiagnosticsStore();
+    if (m_generation == store.GetGeneration() || !IsShownOnScreen()) {
+        return;
+    }
+
+    if (store.GetClearGeneration() > m_generation) {
+        // the file ids were reset
+        DoRefresh();
+        return;
+    }
+    DoUpdate();
+}
+
+void LSPProblemsView::OnFilter(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    DoRefresh();
+}
+
+void LSPProblemsView::OnColumnClick(wxListEvent& event)
+{
+    if (event.GetColumn() == m_sortColumn) {
+        m_sortAscending = !m_sortAscending;
+    } else {
+        m_sortColumn = event.GetColumn();
+        m_sortAscending = true;
+    }
+    if (m_generation != m_cluster->GetDiagnosticsStore().GetGeneration()) {
+        // the rows refer to an older content of the store
+        DoRefresh();
+        return;
+    }
+    DoSort();
+    m_list->UpdateItemCount();
+}
+
+void LSPProblemsView::OnItemActivated(wxListEvent& event)
+{
+    wxString path;
+    const LSP::Diagnostic* d = m_list->GetDiagnostic(event.GetIndex(), &path);
+    CHECK_PTR_RET(d);
+
+    LSP::Range range = d->GetRange();
+    auto callback = [range](IEditor* editor) { editor->SelectRange(range); };
+    clGetManager()->OpenFileAndAsyncExecute(path, std::move(callback));
+}
+
+bool LSPProblemsView::IsMatch(const wxString& path, const LSP::Diagnostic& d, int max_severity,
+                              const wxString& filter) const
+{
+    if (d.GetSeverity() > max_severity) {
+        return false;
+    }
+
+    if (filter.empty()) {
+        return true;
+    }
+    return path.Lower().Contains(filter) || d.GetMessage().Lower().Contains(filter);
+}
+
+bool LSPProblemsView::IsLess(const LSPProblemsList::Row& a, const LSPProblemsList::Row& b) const
+{
+    const DiagnosticsStore& store = m_cluster->GetDiagnosticsStore();
+    const DiagnosticsStore::File* file_a = store.GetFile(a.file_id);
+    const DiagnosticsStore::File* file_b = store.GetFile(b.file_id);
+    const LSP::Diagnostic& da = file_a->diagnostics[a.index];
+    const LSP::Diagnostic& db = file_b->diagnostics[b.index];
+    int line_a = da.GetRange().GetStart().GetLine();
+    int line_b = db.GetRange().GetStart().GetLine();
+
+    int res = 0;
+    switch (m_sortColumn) {
+    case LSPProblemsList::COL_SEVERITY:
+        res = (int)da.GetSeverity() - (int)db.GetSeverity();
+        break;
+    case LSPProblemsList::COL_FILE:
+        res = (a.file_id == b.file_id) ? line_a - line_b : file_a->path.CmpNoCase(file_b->path);
+        break;
+    case LSPProblemsList::COL_LINE:
+        res = line_a - line_b;
+        break;
+    case LSPProblemsList::COL_MESSAGE:
+    default:
+        res = da.GetMessage().CmpNoCase(db.GetMessage());
+        break;
+    }
+
+    if (res == 0) {
+        // keep the (file, index) order for equal keys, so merging new rows gives the same order as a full sort
+        return a.file_id != b.file_id ? a.file_id < b.file_id : a.index < b.index;
+    }
+    return m_sortAscending ? res < 0 : res > 0;
+}
+
+int LSPProblemsView::GetMaxSeverity() const
+{
+    switch (m_choiceSeverity->GetSelection()) {
+    case 0:
+        return LSP::DiagnosticSeverity::Error;
+    case 1:
+        return LSP::DiagnosticSeverity::Warning;
+    default:
+        return LSP::DiagnosticSeverity::Hint;
+    }
+}
+
+void LSPProblemsView::DoAddRows(size_t file_id, int max_severity, const wxString& filter,
+                                std::vector<LSPProblemsList::Row>& rows) const
+{
+    const DiagnosticsStore::File* file = m_cluster->GetDiagnosticsStore().GetFile(file_id);
+    for (size_t i = 0; i < file->diagnostics.size(); ++i) {
+        if (IsMatch(file->path, file->diagnostics[i], max_severity, filter)) {
+            rows.push_back({ file_id, i });
+        }
+    }
+}
+
+void LSPProblemsView::DoRefresh()
+{
+    const DiagnosticsStore& store = m_cluster->GetDiagnosticsStore();
+    m_generation = store.GetGeneration();
+
+    int max_severity = GetMaxSeverity();
+    wxString filter = m_textCtrlFilter->GetValue().Lower();
+
+    auto& rows = m_list->GetRows();
+    rows.clear();
+    rows.reserve(store.GetCount());
+    for (size_t file_id = 0; file_id < store.GetFilesCount(); ++file_id) {
+        DoAddRows(file_id, max_severity, filter, rows);
+    }
+    DoSort();
+    m_list->UpdateItemCount();
+    clDEBUG1() << "Problems view:" << rows.size() << "of" << store.GetCount() << "diagnostics" << endl;
+}
+
+void LSPProblemsView::DoUpdate()
+{
+    const DiagnosticsStore& store = m_cluster->GetDiagnosticsStore();
+    std::vector<bool> changed(store.GetFilesCount(), false);
+    std::vector<size_t> changed_files;
+    for (size_t file_id = 0; file_id < store.GetFilesCount(); ++file_id) {
+        if (store.GetFile(file_id)->generation > m_generation) {
+            changed[file_id] = true;
+            changed_files.push_back(file_id);
+        }
+    }
+    m_generation = store.GetGeneration();
+
+    // drop the rows of the changed files, the remaining rows keep their order
+    auto& rows = m_list->GetRows();
+    rows.erase(std::remove_if(rows.begin(), rows.end(),
+                              [&changed](const LSPProblemsList::Row& row) { return changed[row.file_id]; }),
+               rows.end());
+
+    std::vector<LSPProblemsList::Row> new_rows;
+    int max_severity = GetMaxSeverity();
+    wxString filter = m_textCtrlFilter->GetValue().Lower();
+    for (size_t file_id : changed_files) {
+        DoAddRows(file_id, max_severity, filter, new_rows);
+    }
+
+    auto compare = [this](const LSPProblemsList::Row& a, const LSPProblemsList::Row& b) { return IsLess(a, b); };
+    std::sort(new_rows.begin(), new_rows.end(), compare);
+    size_t count = rows.size();
+    rows.insert(rows.end(), new_rows.begin(), new_rows.end());
+    std::inplace_merge(rows.begin(), rows.begin() + count, rows.end(), compare);
+    m_list->UpdateItemCount();
+    clDEBUG1() << "Problems view:" << changed_files.size() << "files changed," << rows.size() << "of"
+               << store.GetCount() << "diagnostics" << endl;
+}
+
+void LSPProblemsView::DoSort()
+{
+    auto& rows = m_list->GetRows();
+    auto compare = [this](const LSPProblemsList::Row& a, const LSPProblemsList::Row& b) { return IsLess(a, b); };
+    std::sort(rows.begin(), rows.end(), compare);
+}
@@ -0,0 +1,88 @@
+#ifndef LSPPROBLEMSVIEW_HPP
+#define LSPPROBLEMSVIEW_HPP
+
+#include "DiagnosticsStore.hpp"
+
+#include <vector>
+#include <wx/choice.h>
+#include <wx/listctrl.h>
+#include <wx/panel.h>
+#include <wx/textctrl.h>
+
+class LanguageServerCluster;
+
+/**
+ * @brief a virtual list of the diagnostics kept in a DiagnosticsStore. Each row is a (file id, index) pair, so
+ * filtering and sorting only reorder a vector of integers: the diagnostics are never copied
+ */
+class LSPProblemsList : public wxListView
+{
+public:
+    struct Row {
+        size_t file_id = 0;
+        size_t index = 0;
+    };
+
+    enum eColumn {
+        COL_SEVERITY,
+        COL_FILE,
+        COL_LINE,
+        COL_MESSAGE,
+    };
+
+protected:
+    const DiagnosticsStore* m_store = nullptr;
+    std::vector<Row> m_rows;
+
+public:
+    LSPProblemsList(wxWindow* parent, const DiagnosticsStore* store);
+    ~LSPProblemsList() override = default;
+
+    /**
+     * @brief return the diagnostic displayed at `item`, or nullptr if the store changed since the last update
+     */
+    const LSP::Diagnostic* GetDiagnostic(long item, wxString* path = nullptr) const;
+    std::vector<Row>& GetRows() { return m_rows; }
+    void UpdateItemCount();
+
+protected:
+    wxString OnGetItemText(long item, long column) const override;
+};
+
+/**
+ * @brief the "Problems" tab: all the diagnostics reported by the language servers, filtered by severity and text
+ */
+class LSPProblemsView : public wxPanel
+{
+    LanguageServerCluster* m_cluster = nullptr;
+    wxChoice* m_choiceSeverity = nullptr;
+    wxTextCtrl* m_textCtrlFilter = nullptr;
+    LSPProblemsList* m_list = nullptr;
+    size_t m_generation = 0;
+    int m_sortColumn = LSPProblemsList::COL_SEVERITY;
+    bool m_sortAscending = true;
+
+protected:
+    void OnIdle(wxIdleEvent& event);
+    void OnFilter(wxCommandEvent& event);
+    void OnColumnClick(wxListEvent& event);
+    void OnItemActivated(wxListEvent& event);
+
+    bool IsMatch(const wxString& path, const LSP::Diagnostic& d, int max_severity, const wxString& filter) const;
+    bool IsLess(const LSPProblemsList::Row& a, const LSPProblemsList::Row& b) const;
+    int GetMaxSeverity() const;
+    void DoAddRows(size_t file_id, int max_severity, const wxString& filter,
+                   std::vector<LSPProblemsList::Row>& rows) const;
+    void DoRefresh();
+    /**
+     * @brief replace only the rows of the files that changed since the last refresh. The other rows are already sorted
+     */
+    void DoUpdate();
+    void DoSort();
+
+public:
+    LSPProblemsView(wxWindow* parent, LanguageServerCluster* cluster);
+    ~LSPProblemsView() override;
+};
+
+#endif // LSPPROBLEMSVIEW_HPP
@@ -5,6 +5,7 @@
 #include "LSPOutlineViewDlg.h"
 #include "LanguageServerConfig.h"
 #include "StringUtils.h"
+#include "bookmark_manager.h"
 #include "clAuiBook.hpp"
 #include "clEditorBar.h"
 #include "clEditorStateLocker.h"
@@ -22,6 +23,7 @@
 #include "ieditor.h"
 #include "imanager.h"
 #include "languageserver.h"
+#include "lexer_configuration.h"
 #include "macromanager.h"
 #include "macros.h"
 #include "wxCodeCompletionBoxManager.h"
@@ -31,6 +33,7 @@
 #endif
 
 #include <thread>
+#include <unordered_set>
 #include <wx/arrstr.h>
 #include <wx/choicdlg.h>
 #include <wx/richmsgdlg.h>
@@ -131,6 +134,7 @@ LanguageServerCluster::LanguageServerCluster(LanguageServerPlugin* plugin)
     EventNotifier::Get()->Bind(wxEVT_WORKSPACE_CLOSED, &LanguageServerCluster::OnWorkspaceClosed, this);
     EventNotifier::Get()->Bind(wxEVT_WORKSPACE_LOADED, &LanguageServerCluster::OnWorkspaceOpen, this);
     EventNotifier::Get()->Bind(wxEVT_FILE_CLOSED, &LanguageServerCluster::OnEditorClosed, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_LOADED, &LanguageServerCluster::OnFileLoaded, this);
     EventNotifier::Get()->Bind(wxEVT_ACTIVE_EDITOR_CHANGED, &LanguageServerCluster::OnActiveEditorChanged, this);
 
     EventNotifier::Get()->Bind(
@@ -167,6 +171,7 @@ LanguageServerCluster::~LanguageServerCluster()
     EventNotifier::Get()->Unbind(wxEVT_WORKSPACE_CLOSED, &LanguageServerCluster::OnWorkspaceClosed, this);
     EventNotifier::Get()->Unbind(wxEVT_WORKSPACE_LOADED, &LanguageServerCluster::OnWorkspaceOpen, this);
     EventNotifier::Get()->Unbind(wxEVT_FILE_CLOSED, &LanguageServerCluster::OnEditorClosed, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_LOADED, &LanguageServerCluster::OnFileLoaded, this);
     EventNotifier::Get()->Unbind(wxEVT_ACTIVE_EDITOR_CHANGED, &LanguageServerCluster::OnActiveEditorChanged, this);
     EventNotifier::Get()->Unbind(wxEVT_WORKSPACE_FILES_SCANNED, &LanguageServerCluster::OnWorkspaceScanCompleted, this);
     EventNotifier::Get()->Unbind(
@@ -417,65 +422,45 @@ void LanguageServerCluster::OnSemanticTokens(LSPEvent& event)
     wxStringSet_t classes_tokens = { "class", "enum", "namespace", "type", "struct", "trait", "interface" };
     wxStringSet_t method_tokens = { "function", "method" };
 
-    wxStringSet_t classes_set;
-    wxStringSet_t variables_set;
-    wxStringSet_t methods_set;
+    // the token types are indexes into the server legend, map each one of them only once
+    std::unordered_map<int, int> kinds;
+    wxStyledTextCtrl* ctrl = editor->GetCtrl();
 
-    wxString classes_str;
-    wxString variabls_str;
-    wxString method_str;
+    std::vector<SemanticToken> tokens;
+    tokens.reserve(semanticTokens.size());
 
     LSP_TRACE() << "Going over" << semanticTokens.size() << "tokens" << endl;
     for (const auto& token : semanticTokens) {
         // is this an interesting token?
-        wxString token_type = server->GetSemanticToken(token.token_type);
-        bool is_class = classes_tokens.count(token_type) > 0;
-        bool is_variable = variables_tokens.count(token_type) > 0;
-        bool is_method = method_tokens.count(token_type) > 0;
-
-        // read its name
-        int start_pos = editor->GetCtrl()->PositionFromLine(token.line) + token.column;
-        int end_pos = start_pos + token.length;
-        wxString token_name = editor->GetTextRange(start_pos, end_pos);
-        if (!is_class && !is_variable && !is_method) {
+        auto iter = kinds.find(token.token_type);
+        if (iter == kinds.end()) {
+            const wxString& token_type = server->GetSemanticToken(token.token_type);
+            int kind = wxNOT_FOUND;
+            if (classes_tokens.count(token_type)) {
+                kind = LexerConf::WS_CLASS;
+            } else if (variables_tokens.count(token_type)) {
+                kind = LexerConf::WS_VARIABLES;
+            } else if (method_tokens.count(token_type)) {
+                kind = LexerConf::WS_FUNCTIONS;
+            }
+            iter = kinds.insert({ token.token_type, kind }).first;
+        }
+
+        if (iter->second == wxNOT_FOUND || token.length <= 0) {
             continue;
         }
 
-        if (is_class && classes_set.count(token_name) == 0) {
-            classes_set.insert(token_name);
-            classes_str << token_name << " ";
-        } else if (is_variable && variables_set.count(token_name) == 0) {
-            variables_set.insert(token_name);
-            variabls_str << token_name << " ";
-        } else if (is_method && methods_set.count(token_name) == 0) {
-            methods_set.insert(token_name);
-            method_str << token_name << " ";
+        // the tokens arrive sorted by their position
+        int line_start_pos = ctrl->PositionFromLine(token.line);
+        if (line_start_pos == wxNOT_FOUND) {
+            continue;
         }
+        tokens.push_back({ line_start_pos + token.column, token.length, iter->second });
     }
     LSP_TRACE() << "Done" << endl;
 
-    // trim the strings, so we can rely on the below test (.empty())
-    method_str.Trim().Trim(false);
-    variabls_str.Trim().Trim(false);
-    classes_str.Trim().Trim(false);
-
-    LOG_IF_TRACE
-    {
-        LSP_TRACE() << "Classes:" << endl;
-        LSP_TRACE() << classes_str << endl;
-        LSP_TRACE() << "Methods:" << endl;
-        LSP_TRACE() << method_str << endl;
-        LSP_TRACE() << "Variables:" << endl;
-        LSP_TRACE() << variabls_str << endl;
-    }
-
-    LSP_TRACE() << "Calling editor->SetSemanticTokens" << endl;
-    if (!classes_str.empty() || !variabls_str.empty() || !method_str.empty()) {
-        // we got something to colour
-        editor->SetSemanticTokens(classes_str, variabls_str, method_str, wxEmptyString);
-    } else {
-        LSP_TRACE() << "empty semantic tokens, leaving editor untouched" << endl;
-    }
+    LSP_TRACE() << "Calling editor->SetSemanticTokenRanges" << endl;
+    editor->SetSemanticTokenRanges(std::move(tokens));
     LSP_TRACE() << "Success" << endl;
 }
 
@@ -890,45 +875,116 @@ void LanguageServerCluster::OnQuickOutlineView(LSPEvent& event)
     }
 }
 
+void LanguageServerCluster::ApplyDiagnostics(IEditor* editor, const wxString& path,
+                                             const DiagnosticsStore::Changes& changes)
+{
+    const DiagnosticsStore::Changes* updates = &changes;
+    DiagnosticsStore::Changes resync;
+    if (!changes.removed_lines.empty()) {
+        // the lines of the previous set are the lines at the time it was reported: the markers moved with any edit
+        // made since then. Walk the markers where they actually are and remove those that are not in the new set
+        std::unordered_set<int> lines;
+        m_diagnostics.GetAll(path, &resync);
+        for (const LSP::Diagnostic* d : resync.updated_lines) {
+            lines.insert(d->GetRange().GetStart().GetLine());
+        }
+
+        wxStyledTextCtrl* ctrl = editor->GetCtrl();
+        std::vector<int> ghost_lines;
+        for (int line = ctrl->MarkerNext(0, mmt_compiler); line != wxNOT_FOUND;
+             line = ctrl->MarkerNext(line + 1, mmt_compiler)) {
+            if (lines.count(line) == 0) {
+                ghost_lines.push_back(line);
+            }
+        }
+
+        for (int line : ghost_lines) {
+            editor->DelCompilerMarker(line);
+        }
+
+        // the unchanged diagnostics may have lost their marker as well, so re-apply the whole set
+        updates = &resync;
+    }
+
+    for (const LSP::Diagnostic* d : updates->updated_lines) {
+        int line = d->GetRange().GetStart().GetLine();
+        editor->DelCompilerMarker(line);
+
+        CompilerMessage cm{ d->GetMessage(), std::make_unique<DiagnosticsData>(*d) };
+        switch (d->GetSeverity()) {
+        case LSP::DiagnosticSeverity::Error:
+            editor->SetErrorMarker(line, std::move(cm));
+            break;
+        case LSP::DiagnosticSeverity::Warning:
+        case LSP::DiagnosticSeverity::Information:
+        case LSP::DiagnosticSeverity::Hint:
+            editor->SetWarningMarker(line, std::move(cm));
+            break;
+        }
+    }
+}
+
 void LanguageServerCluster::OnSetDiagnostics(LSPEvent& event)
 {
     event.Skip();
+    DiagnosticsStore::Changes changes;
+    if (!m_diagnostics.Set(event.GetFileName(), event.GetDiagnosticsVersion(), event.GetDiagnostics(), &changes)) {
+        LSP_DEBUG() << "Diagnostics for file:" << event.GetFileName() << "are unchanged" << endl;
+        return;
+    }
+
     IEditor* editor = FindEditor(event);
     if (editor) {
-        LSP_DEBUG() << "Setting diagnostics for file:" << editor->GetRemotePathOrLocal() << endl;
-        // always clear old markers
-        editor->DelAllCompilerMarkers();
-
-        for (const LSP::Diagnostic& d : event.GetDiagnostics()) {
-            // LSP uses 1 based line numbers
-            CompilerMessage cm{ d.GetMessage(), std::make_unique<DiagnosticsData>(d) };
-            switch (d.GetSeverity()) {
-            case LSP::DiagnosticSeverity::Error:
-                editor->SetErrorMarker(d.GetRange().GetStart().GetLine(), std::move(cm));
-                break;
-            case LSP::DiagnosticSeverity::Warning:
-            case LSP::DiagnosticSeverity::Information:
-            case LSP::DiagnosticSeverity::Hint:
-                editor->SetWarningMarker(d.GetRange().GetStart().GetLine(), std::move(cm));
-                break;
-            }
-        }
+        LSP_DEBUG() << "Updating diagnostics for file:" << editor->GetRemotePathOrLocal() << ". Removed"
+                    << changes.removed_lines.size() << "lines, updated" << changes.updated_lines.size() << "lines"
+                    << endl;
+        ApplyDiagnostics(editor, event.GetFileName(), changes);
     } else {
-        LSP_DEBUG() << "Setting diagnostics: could not locate editor for file:" << event.GetFileName() << endl;
+        LSP_DEBUG() << "Storing diagnostics for file:" << event.GetFileName() << "(no editor)" << endl;
     }
 }
 
 void LanguageServerCluster::OnClearDiagnostics(LSPEvent& event)
 {
     event.Skip();
+    DiagnosticsStore::Changes changes;
+    if (!m_diagnostics.Clear(event.GetFileName(), event.GetDiagnosticsVersion(), &changes)) {
+        return;
+    }
+
     IEditor* editor = FindEditor(event);
     if (editor) {
-        editor->DelAllCompilerMarkers();
+        ApplyDiagnostics(editor, event.GetFileName(), changes);
+    }
+}
+
+void LanguageServerCluster::OnFileLoaded(clCommandEvent& event)
+{
+    event.Skip();
+    IEditor* editor = FindEditor(event.GetFileName());
+    CHECK_PTR_RET(editor);
+
+    // loading the file sends a new didOpen, which restarts the document versions
+    wxString path = event.GetFileName();
+    m_diagnostics.ResetVersion(path);
+    m_diagnostics.ResetVersion(editor->GetRemotePathOrLocal());
+
+    // a new editor (or a reloaded one) has no markers: restore the stored diagnostics of this file until the
+    // language server publishes a fresh set
+    DiagnosticsStore::Changes changes;
+    if (!m_diagnostics.GetAll(path, &changes)) {
+        path = editor->GetRemotePathOrLocal();
+        if (!m_diagnostics.GetAll(path, &changes)) {
+            return;
+        }
     }
+    editor->DelAllCompilerMarkers();
+    ApplyDiagnostics(editor, path, changes);
 }
 
 void LanguageServerCluster::ClearAllDiagnostics()
 {
+    m_diagnostics.ClearAll();
     IEditor::List_t editors;
     clGetManager()->GetAllEditors(editors);
     for (IEditor* editor : editors) {
@@ -1152,6 +1208,9 @@ void LanguageServerCluster::OnEditorClosed(clCommandEvent& event)
     event.Skip();
     // clear the cache for the closed file
     m_symbols_to_file_cache.erase(event.GetFileName());
+
+    // the next didOpen restarts the document versions: keep the diagnostics, but not the version they belong to
+    m_diagnostics.ResetVersion(event.GetFileName());
 }
 
 void LanguageServerCluster::OnActiveEditorChanged(wxCommandEvent& event)
@@ -2,6 +2,7 @@
 #define LANGUAGESERVERCLUSTER_H
 
 #include "CodeLiteRemoteHelper.hpp"
+#include "DiagnosticsStore.hpp"
 #include "LSP/LSPEvent.h"
 #include "LSP/LanguageServerProtocol.h"
 #include "LSP/basic_types.h"
@@ -31,6 +32,7 @@ class LanguageServerCluster : public wxEvtHandler
     LanguageServerPlugin* m_plugin = nullptr;
     LSPOutlineViewDlg* m_quick_outline_dlg = nullptr;
     std::unique_ptr<CodeLiteRemoteHelper> m_remoteHelper;
+    DiagnosticsStore m_diagnostics;
 
 public:
     typedef wxSharedPtr<LanguageServerCluster> Ptr_t;
@@ -77,6 +79,7 @@ protected:
     void OnBuildEnded(clBuildEvent& event);
     void OnOpenResource(wxCommandEvent& event);
     void OnEditorClosed(clCommandEvent& event);
+    void OnFileLoaded(clCommandEvent& event);
     void OnActiveEditorChanged(wxCommandEvent& event);
     void OnWorkspaceScanCompleted(clWorkspaceEvent& event);
     void OnMarginClicked(clEditorEvent& event);
@@ -84,6 +87,7 @@ protected:
     void OnApplyEdits(LSPEvent& event);
 
     wxString GetEditorFilePath(IEditor* editor) const;
+    void ApplyDiagnostics(IEditor* editor, const wxString& path, const DiagnosticsStore::Changes& changes);
     /**
      * @brief find an editor either by local or remote path
      */
@@ -104,6 +108,11 @@ public:
     LanguageServerProtocol::Ptr_t GetServerByName(const wxString& name);
     LanguageServerProtocol::Ptr_t GetServerForLanguage(const wxString& lang);
     void ClearRestartCounters();
+
+    /**
+     * @brief the diagnostics of all the files
+     */
+    const DiagnosticsStore& GetDiagnosticsStore() const { return m_diagnostics; }
 };
 
 #endif // LANGUAGESERVERCLUSTER_H
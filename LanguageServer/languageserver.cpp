@@ -50,6 +50,10 @@ LanguageServerPlugin::LanguageServerPlugin(IManager* manager)
     m_mgr->BookAddPage(PaneId::BOTTOM_BAR, m_logView, _("Language Server"));
     m_tabToggler.reset(new clTabTogglerHelper(_("Language Server"), m_logView, "", NULL));
 
+    // add the problems view
+    m_problemsView = new LSPProblemsView(m_mgr->BookGet(PaneId::BOTTOM_BAR), m_servers.get());
+    m_mgr->BookAddPage(PaneId::BOTTOM_BAR, m_problemsView, _("Problems"));
+
     EventNotifier::Get()->Bind(wxEVT_INIT_DONE, &LanguageServerPlugin::OnInitDone, this);
     EventNotifier::Get()->Bind(wxEVT_CONTEXT_MENU_EDITOR, &LanguageServerPlugin::OnEditorContextMenu, this);
     wxTheApp->Bind(wxEVT_MENU, &LanguageServerPlugin::OnSettings, this, XRCID("language-server-settings"));
@@ -63,6 +67,7 @@ LanguageServerPlugin::LanguageServerPlugin(IManager* manager)
     EventNotifier::Get()->Bind(wxEVT_LSP_STOP, &LanguageServerPlugin::OnLSPStopOne, this);
     EventNotifier::Get()->Bind(wxEVT_LSP_START, &LanguageServerPlugin::OnLSPStartOne, this);
     EventNotifier::Get()->Bind(wxEVT_LSP_RESTART, &LanguageServerPlugin::OnLSPRestartOne, this);
+    EventNotifier::Get()->Bind(wxEVT_LSP_WATCHED_FILES_CHANGED, &LanguageServerPlugin::OnLSPWatchedFilesChanged, this);
     EventNotifier::Get()->Bind(wxEVT_LSP_CONFIGURE, &LanguageServerPlugin::OnLSPConfigure, this);
     EventNotifier::Get()->Bind(wxEVT_LSP_DELETE, &LanguageServerPlugin::OnLSPDelete, this);
     EventNotifier::Get()->Bind(wxEVT_LSP_OPEN_SETTINGS_DLG, &LanguageServerPlugin::OnLSPShowSettingsDlg, this);
@@ -124,6 +129,8 @@ void LanguageServerPlugin::UnPlug()
     EventNotifier::Get()->Unbind(wxEVT_LSP_STOP, &LanguageServerPlugin::OnLSPStopOne, this);
     EventNotifier::Get()->Unbind(wxEVT_LSP_START, &LanguageServerPlugin::OnLSPStartOne, this);
     EventNotifier::Get()->Unbind(wxEVT_LSP_RESTART, &LanguageServerPlugin::OnLSPRestartOne, this);
+    EventNotifier::Get()->Unbind(wxEVT_LSP_WATCHED_FILES_CHANGED, &LanguageServerPlugin::OnLSPWatchedFilesChanged,
+                                 this);
     EventNotifier::Get()->Unbind(wxEVT_LSP_CONFIGURE, &LanguageServerPlugin::OnLSPConfigure, this);
     EventNotifier::Get()->Unbind(wxEVT_LSP_DELETE, &LanguageServerPlugin::OnLSPDelete, this);
     EventNotifier::Get()->Unbind(wxEVT_LSP_OPEN_SETTINGS_DLG, &LanguageServerPlugin::OnLSPShowSettingsDlg, this);
@@ -138,6 +145,11 @@ void LanguageServerPlugin::UnPlug()
         m_logView->Destroy();
     }
     m_logView = nullptr;
+
+    if (!m_mgr->BookDeletePage(PaneId::BOTTOM_BAR, m_problemsView)) {
+        m_problemsView->Destroy();
+    }
+    m_problemsView = nullptr;
     m_servers.reset();
 }
 
@@ -359,6 +371,14 @@ void LanguageServerPlugin::OnLSPStartOne(clLanguageServerEvent& event)
     lsp->Start();
 }
 
+void LanguageServerPlugin::OnLSPWatchedFilesChanged(clLanguageServerEvent& event)
+{
+    CHECK_PTR_RET(m_servers);
+    auto lsp = m_servers->GetServerByName(event.GetLspName());
+    CHECK_PTR_RET(lsp);
+    lsp->SendWatchedFilesChanged(event.GetCreatedFiles(), event.GetDeletedFiles());
+}
+
 void LanguageServerPlugin::OnLSPRestartOne(clLanguageServerEvent& event)
 {
     CHECK_PTR_RET(m_servers);
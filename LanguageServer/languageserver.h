@@ -2,6 +2,7 @@
 #define __LanguageServerPlugin__
 
 #include "LanguageServerCluster.h"
+#include "LSPProblemsView.hpp"
 #include "LanguageServerLogView.h"
 #include "clTabTogglerHelper.h"
 #include "cl_command_event.h"
@@ -14,6 +15,7 @@ class LanguageServerPlugin : public IPlugin
     IProcess* m_process = nullptr;
     clTabTogglerHelper::Ptr_t m_tabToggler;
     LanguageServerLogView* m_logView = nullptr;
+    LSPProblemsView* m_problemsView = nullptr;
 
 protected:
     void OnSettings(wxCommandEvent& e);
@@ -31,6 +33,7 @@ protected:
     void OnLSPStopOne(clLanguageServerEvent& event);
     void OnLSPStartOne(clLanguageServerEvent& event);
     void OnLSPRestartOne(clLanguageServerEvent& event);
+    void OnLSPWatchedFilesChanged(clLanguageServerEvent& event);
     void OnLSPConfigure(clLanguageServerEvent& event);
     void OnLSPDelete(clLanguageServerEvent& event);
     void OnLSPShowSettingsDlg(clLanguageServerEvent& event);
@@ -0,0 +1,349 @@
+#include "ReplaceInFilesEngine.h"
+
+#include "file_logger.h"
+#include "fileutils.h"
+
+#include <algorithm>
+#include <memory>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/log.h>
+#include <wx/strconv.h>
+#include <wx/thread.h>
+
+namespace
+{
+// post a progress update every N files
+constexpr size_t PROGRESS_INTERVAL = 16;
+const std::string UTF8_BOM = "\xEF\xBB\xBF";
+
+std::atomic_size_t s_tmpCounter{ 0 };
+
+bool ReadRaw(const wxString& path, std::string& content)
+{
+    wxLogNull noLog;
+    wxFFile fp(path, "rb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
+
+    wxFileOffset len = fp.Length();
+    if (len < 0) {
+        return false;
+    }
+
+    content.resize(len);
+    return len == 0 || fp.Read(&content[0], len) == (size_t)len;
+}
+
+/**
+ * @brief write `content` into a temp file next to `path` and rename it over `path`. The file permissions are kept
+ */
+bool WriteAtomic(const wxString& path, const std::string& content)
+{
+    wxLogNull noLog;
+
+    // rand() based temp names (FileUtils::CreateTempFileName) are not safe to use from multiple threads
+    wxString tmpfile;
+    tmpfile << path << ".cltmp-" << wxThread::GetCurrentId() << "-" << s_tmpCounter++;
+    FileUtils::Deleter deleter{ wxFileName(tmpfile) };
+
+    {
+        wxFFile fp(tmpfile, "wb");
+        if (!fp.IsOpened()) {
+            return false;
+        }
+        if (!content.empty() && fp.Write(content.c_str(), content.length()) != content.length()) {
+            return false;
+        }
+        if (!fp.Close()) {
+            return false;
+        }
+    }
+
+    mode_t perm = 0;
+    bool has_perm = FileUtils::GetFilePermissions(path, perm);
+    if (!::wxRenameFile(tmpfile, path, true)) {
+        return false;
+    }
+
+    if (has_perm) {
+        FileUtils::SetFilePermissions(path, perm);
+    }
+    return true;
+}
+
+/**
+ * @brief pick the encoding that can decode `data`: the user encoding first, then UTF-8 and finally plain 8 bit
+ */
+wxFontEncoding FindEncoding(const char* data, size_t len, wxFontEncoding encoding)
+{
+    if (encoding != wxFONTENCODING_DEFAULT && encoding != wxFONTENCODING_UTF8) {
+        wxCSConv conv(encoding);
+        if (conv.IsOk() && conv.ToWChar(nullptr, 0, data, len) != wxCONV_FAILED) {
+            return encoding;
+        }
+    }
+
+    if (wxConvUTF8.ToWChar(nullptr, 0, data, len) != wxCONV_FAILED) {
+        return wxFONTENCODING_UTF8;
+    }
+    return wxFONTENCODING_ISO8859_1;
+}
+
+/**
+ * @brief split `raw` into its BOM and its content as UTF-8 (the match columns are UTF-8 offsets, same as the editor
+ * positions). UTF-8 files are used as is
+ */
+void Decode(const std::string& raw, wxFontEncoding encoding, std::string& bom, std::string& buffer)
+{
+    size_t bom_len = raw.compare(0, UTF8_BOM.length(), UTF8_BOM) == 0 ? UTF8_BOM.length() : 0;
+    bom = raw.substr(0, bom_len);
+    if (encoding == wxFONTENCODING_UTF8) {
+        buffer = raw.substr(bom_len);
+    } else {
+        wxString text(raw.c_str() + bom_len, wxCSConv(encoding), raw.length() - bom_len);
+        const wxScopedCharBuffer utf8 = text.utf8_str();
+        buffer.assign(utf8.data(), utf8.length());
+    }
+}
+
+/**
+ * @brief the reverse of Decode(). Return false if the content can not be represented in `encoding`
+ */
+bool Encode(const std::string& bom, const std::string& buffer, wxFontEncoding encoding, std::string& content)
+{
+    content = bom;
+    if (encoding == wxFONTENCODING_UTF8) {
+        content.append(buffer);
+        return true;
+    }
+
+    wxString text = wxString::FromUTF8(buffer.c_str(), buffer.length());
+    const wxScopedCharBuffer encoded = text.mb_str(wxCSConv(encoding));
+    if (!text.empty() && encoded.length() == 0) {
+        return false;
+    }
+    content.append(encoded.data(), encoded.length());
+    return true;
+}
+
+bool IsMatch(const std::string& buffer, size_t pos, size_t len, const ReplaceInFilesEngine::Edit& edit)
+{
+    if (edit.match_case) {
+        const wxScopedCharBuffer find_what = edit.find_what.utf8_str();
+        return buffer.compare(pos, len, find_what.data(), find_what.length()) == 0;
+    }
+    return wxString::FromUTF8(buffer.c_str() + pos, len).CmpNoCase(edit.find_what) == 0;
+}
+} // namespace
+
+ReplaceInFilesEngine::ReplaceInFilesEngine(wxEvtHandler* owner)
+    : m_owner(owner)
+    , m_cancel(false)
+    , m_busy(false)
+{
+}
+
+ReplaceInFilesEngine::~ReplaceInFilesEngine() { Stop(); }
+
+void ReplaceInFilesEngine::Start(std::vector<Job>&& jobs, wxFontEncoding encoding, ProgressCallback_t on_progress,
+                                 DoneCallback_t on_done)
+{
+    Stop();
+    m_cancel.store(false);
+    m_busy.store(true);
+    m_thread = new std::thread(&ReplaceInFilesEngine::Run, this, std::move(jobs), encoding, std::move(on_progress),
+                               std::move(on_done));
+}
+
+void ReplaceInFilesEngine::Stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    m_cancel.store(true);
+    m_thread->join();
+    wxDELETE(m_thread);
+    m_busy.store(false);
+}
+
+void ReplaceInFilesEngine::Run(ReplaceInFilesEngine* engine, std::vector<Job> jobs, wxFontEncoding encoding,
+                               ProgressCallback_t on_progress, DoneCallback_t on_done)
+{
+    auto results = std::make_shared<ChangeSet_t>(jobs.size());
+    std::atomic_size_t next{ 0 };
+    std::atomic_size_t done{ 0 };
+    size_t total = jobs.size();
+
+    auto worker = [&]() {
+        while (!engine->m_cancel.load()) {
+            size_t index = next++;
+            if (index >= total) {
+                break;
+            }
+
+            Apply(jobs[index], encoding, (*results)[index]);
+            size_t count = ++done;
+            if (on_progress && (count % PROGRESS_INTERVAL) == 0) {
+                engine->m_owner->CallAfter([on_progress, count, total]() { on_progress(count, total); });
+            }
+        }
+    };
+
+    size_t threads_count = std::max(1u, std::thread::hardware_concurrency());
+    threads_count = std::min(threads_count, total);
+
+    // the calling thread is a worker as well
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads_count; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    if (engine->m_cancel.load()) {
+        clDEBUG() << "Replace in files: cancelled after" << done.load() << "files" << endl;
+        return;
+    }
+
+    clDEBUG() << "Replace in files: processed" << total << "files using" << threads_count << "threads" << endl;
+    engine->m_busy.store(false);
+    engine->m_owner->CallAfter([on_done, results]() { on_done(std::move(*results)); });
+}
+
+void ReplaceInFilesEngine::Apply(const Job& job, wxFontEncoding encoding, Result& result)
+{
+    result.filename = job.filename;
+    auto fail_all = [&](const wxString& error) {
+        result.error = error;
+        result.replaced_rows.clear();
+        result.failed_rows.clear();
+        for (const auto& edit : job.edits) {
+            result.failed_rows.push_back(edit.row);
+        }
+    };
+
+    // write through symbolic links, not over them
+    wxString path = FileUtils::RealPath(job.filename, true);
+    std::string raw;
+    if (!ReadRaw(path, raw)) {
+        fail_all(_("Failed to read file"));
+        return;
+    }
+
+    size_t bom_len = raw.compare(0, UTF8_BOM.length(), UTF8_BOM) == 0 ? UTF8_BOM.length() : 0;
+    wxFontEncoding file_encoding =
+        bom_len ? wxFONTENCODING_UTF8 : FindEncoding(raw.c_str() + bom_len, raw.length() - bom_len, encoding);
+
+    std::string bom;
+    std::string buffer;
+    Decode(raw, file_encoding, bom, buffer);
+
+    // line start offsets. Lines are split on LF only, like the search thread does
+    std::vector<size_t> lines = { 0 };
+    for (size_t pos = buffer.find('\n'); pos != std::string::npos; pos = buffer.find('\n', pos + 1)) {
+        lines.push_back(pos + 1);
+    }
+
+    // apply the edits from the last to the first, so the recorded columns of the remaining edits stay valid
+    std::vector<const Edit*> edits;
+    edits.reserve(job.edits.size());
+    for (const auto& edit : job.edits) {
+        edits.push_back(&edit);
+    }
+    std::sort(edits.begin(), edits.end(), [](const Edit* a, const Edit* b) {
+        return a->line == b->line ? a->column > b->column : a->line > b->line;
+    });
+
+    size_t limit = buffer.length();
+    for (const Edit* edit : edits) {
+        size_t line_index = edit->line - 1;
+        if (edit->line < 1 || line_index >= lines.size() || edit->column < 0 || edit->len < 0) {
+            result.failed_rows.push_back(edit->row);
+            continue;
+        }
+
+        size_t line_end = line_index + 1 < lines.size() ? lines[line_index + 1] - 1 : buffer.length();
+        size_t pos = lines[line_index] + edit->column;
+        size_t end = pos + edit->len;
+        if (end > line_end || end > limit || !IsMatch(buffer, pos, edit->len, *edit)) {
+            // the file was modified since the search (or the match overlaps a previous one)
+            result.failed_rows.push_back(edit->row);
+            continue;
+        }
+
+        const wxScopedCharBuffer replace_with = edit->replace_with.utf8_str();
+        UndoEdit undo;
+        undo.pos = pos;
+        undo.len = replace_with.length();
+        undo.original = buffer.substr(pos, edit->len);
+        buffer.replace(pos, edit->len, replace_with.data(), replace_with.length());
+        result.undo.push_back(std::move(undo));
+        result.replaced_rows.push_back(edit->row);
+        limit = pos;
+    }
+
+    if (result.replaced_rows.empty()) {
+        return;
+    }
+
+    // the edits were applied from the last to the first: shift each one by the size change of the edits before it
+    long delta = 0;
+    for (auto iter = result.undo.rbegin(); iter != result.undo.rend(); ++iter) {
+        iter->pos += delta;
+        delta += (long)iter->len - (long)iter->original.length();
+    }
+
+    std::string content;
+    if (!Encode(bom, buffer, file_encoding, content)) {
+        fail_all(_("The replacement text can not be represented in the file encoding"));
+        result.undo.clear();
+        return;
+    }
+
+    if (!WriteAtomic(path, content)) {
+        fail_all(_("Failed to write file"));
+        result.undo.clear();
+        return;
+    }
+
+    result.written = true;
+    result.written_encoding = file_encoding;
+    result.written_hash = std::hash<std::string>{}(content);
+}
+
+void ReplaceInFilesEngine::Undo(const ChangeSet_t& changes, wxArrayString& restored, wxArrayString& failed)
+{
+    for (const auto& result : changes) {
+        if (!result.written) {
+            continue;
+        }
+
+        // only restore files that were not modified since the replace
+        wxString path = FileUtils::RealPath(result.filename, true);
+        std::string current;
+        if (!ReadRaw(path, current) || std::hash<std::string>{}(current) != result.written_hash) {
+            failed.Add(result.filename);
+            continue;
+        }
+
+        // the undo edits are sorted from the last to the first
+        std::string bom;
+        std::string buffer;
+        Decode(current, result.written_encoding, bom, buffer);
+        for (const auto& undo : result.undo) {
+            buffer.replace(undo.pos, undo.len, undo.original);
+        }
+
+        std::string content;
+        if (!Encode(bom, buffer, result.written_encoding, content) || !WriteAtomic(path, content)) {
+            failed.Add(result.filename);
+            continue;
+        }
+        restored.Add(result.filename);
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef REPLACEINFILESENGINE_H
+#define REPLACEINFILESENGINE_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/event.h>
+#include <wx/fontenc.h>
+#include <wx/string.h>
+
+/**
+ * @brief apply "Replace in Files" edits to files that are not opened in an editor.
+ * Files are processed in parallel, on background threads. Each file is loaded into a byte buffer, the edits are
+ * applied from the last to the first (so the recorded columns remain valid) and the file is written back atomically
+ * (temp file + rename) using the encoding it was read with. Line endings are untouched, since only the matched bytes are
+ * replaced
+ */
+class ReplaceInFilesEngine
+{
+public:
+    struct Edit {
+        int row = wxNOT_FOUND; // the line in the replace view
+        int line = 0;          // 1 based
+        int column = 0;        // UTF-8 bytes offset in the line
+        int len = 0;           // UTF-8 bytes length
+        wxString find_what;    // the text expected at the match location
+        bool match_case = true;
+        wxString replace_with;
+    };
+
+    struct UndoEdit {
+        size_t pos = 0;       // UTF-8 bytes offset in the file content after the replace
+        size_t len = 0;       // UTF-8 bytes length of the replacement
+        std::string original; // UTF-8 text that was replaced
+    };
+
+    struct Job {
+        wxString filename;
+        std::vector<Edit> edits;
+    };
+
+    struct Result {
+        wxString filename;
+        std::vector<int> replaced_rows;
+        std::vector<int> failed_rows;
+        wxString error;
+        // used to undo the change: the replaced texts, the encoding the file was written with (wxFONTENCODING_UTF8
+        // when it was edited in place) and the hash of the content that was written
+        std::vector<UndoEdit> undo;
+        wxFontEncoding written_encoding = wxFONTENCODING_UTF8;
+        size_t written_hash = 0;
+        bool written = false;
+    };
+
+    /**
+     * @brief the outcome of a single replace operation, undone as a whole
+     */
+    typedef std::vector<Result> ChangeSet_t;
+    typedef std::function<void(size_t, size_t)> ProgressCallback_t;
+    typedef std::function<void(ChangeSet_t&&)> DoneCallback_t;
+
+protected:
+    wxEvtHandler* m_owner = nullptr;
+    std::thread* m_thread = nullptr;
+    std::atomic_bool m_cancel;
+    std::atomic_bool m_busy;
+
+protected:
+    static void Run(ReplaceInFilesEngine* engine, std::vector<Job> jobs, wxFontEncoding encoding,
+                    ProgressCallback_t on_progress, DoneCallback_t on_done);
+
+public:
+    /**
+     * @param owner callbacks are executed on the main thread, via owner->CallAfter()
+     */
+    ReplaceInFilesEngine(wxEvtHandler* owner);
+    ~ReplaceInFilesEngine();
+
+    /**
+     * @brief start processing the jobs in the background. on_progress is called periodically and on_done once all the
+     * files were processed (neither is called when the engine is stopped)
+     */
+    void Start(std::vector<Job>&& jobs, wxFontEncoding encoding, ProgressCallback_t on_progress,
+               DoneCallback_t on_done);
+
+    /**
+     * @brief cancel and wait for the current run. Files already written are not restored
+     */
+    void Stop();
+    bool IsBusy() const { return m_busy.load(); }
+
+    /**
+     * @brief apply the edits of a single file
+     */
+    static void Apply(const Job& job, wxFontEncoding encoding, Result& result);
+
+    /**
+     * @brief restore the files of a change set to their content before the replace. Files that were modified since are
+     * left untouched and reported in `failed`
+     */
+    static void Undo(const ChangeSet_t& changes, wxArrayString& restored, wxArrayString& failed);
+};
+
+#endif // REPLACEINFILESENGINE_H
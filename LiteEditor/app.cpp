@@ -41,6 +41,7 @@
 #include "SocketAPI/clSocketClient.h"
 #include "autoversion.h"
 #include "clSystemSettings.h"
+#include "clStartupTrace.hpp"
 #include "cl_config.h"
 #include "conffilelocator.h"
 #include "editor_config.h"
@@ -281,6 +282,7 @@ static wxLogNull NO_LOG;
 
 bool CodeLiteApp::OnInit()
 {
+    clStartupTrace::Scope trace("CodeLiteApp::OnInit");
 #if defined(__WXOSX__)
     SetAppName(wxT("CodeLite"));
 #else
@@ -743,12 +745,22 @@ bool CodeLiteApp::OnInit()
     FileUtils::RealPathSetModeResolveSymlinks(clConfig::Get().Read(kRealPathResolveSymlinks, true));
 
     // Make sure that the colours and fonts manager is instantiated
-    ColoursAndFontsManager::Get().Load();
+    {
+        clStartupTrace::Scope trace_themes("ColoursAndFontsManager::Load");
+        ColoursAndFontsManager::Get().Load();
+    }
 
     // Create the main application window
-    clMainFrame::Initialize((m_parser.GetParamCount() == 0) && !IsStartedInDebuggerMode());
+    {
+        clStartupTrace::Scope trace_frame("clMainFrame::Initialize");
+        clMainFrame::Initialize((m_parser.GetParamCount() == 0) && !IsStartedInDebuggerMode());
+    }
     m_pMainFrame = clMainFrame::Get();
-    m_pMainFrame->Show(TRUE);
+    {
+        clStartupTrace::Scope trace_show("clMainFrame::Show");
+        m_pMainFrame->Show(TRUE);
+    }
+    clStartupTrace::Get().AddInstant("main frame shown");
     SetTopWindow(m_pMainFrame);
 
     // Especially with the OutputView open, CodeLite was consuming 50% of a cpu, mostly in updateui
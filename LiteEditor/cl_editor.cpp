@@ -1102,6 +1102,7 @@ void clEditor::SetProperties()
 
     IndicatorSetStyle(INDICATOR_DEBUGGER, indicator_style);
     IndicatorSetForeground(INDICATOR_DEBUGGER, wxT("GREY"));
+    UpdateSemanticIndicators(lexer);
 
     CmdKeyClear(wxT('L'), wxSTC_KEYMOD_CTRL); // clear Ctrl+D because we use it for something else
 
@@ -3827,6 +3828,30 @@ void clEditor::DelAllCompilerMarkers()
     NotifyMarkerChanged();
 }
 
+void clEditor::DelCompilerMarker(int lineno)
+{
+    if (lineno < 0) {
+        return;
+    }
+
+    m_compilerMessagesMap.erase(lineno);
+    if (MarkerGet(lineno) & mmt_compiler) {
+        // a line may hold more than one instance of a marker
+        while (MarkerGet(lineno) & mmt_warning) {
+            MarkerDelete(lineno, smt_warning);
+        }
+        while (MarkerGet(lineno) & mmt_error) {
+            MarkerDelete(lineno, smt_error);
+        }
+        NotifyMarkerChanged(lineno);
+    }
+
+    int annotation_style = AnnotationGetStyle(lineno);
+    if (annotation_style == ANNOTATION_STYLE_WARNING || annotation_style == ANNOTATION_STYLE_ERROR) {
+        AnnotationSetText(lineno, wxEmptyString);
+    }
+}
+
 // Maybe one day we'll display multiple bps differently
 void clEditor::SetBreakpointMarker(int lineno,
                                    BreakpointType bptype,
@@ -5816,6 +5841,10 @@ void clEditor::ReloadFromDisk(bool keepUndoHistory)
     // clear the modified lines
     m_modifiedLines.clear();
 
+    // the indicators are gone with the old text
+    m_semanticTokens.clear();
+    m_semanticDirtyFrom = m_semanticDirtyTo = wxNOT_FOUND;
+
     Colourise(0, wxNOT_FOUND);
 
     m_modifyTime = GetFileLastModifiedTime();
@@ -6091,6 +6120,137 @@ void clEditor::SetSemanticTokens(const wxString& classes,
     Colourise(0, wxSTC_INVALID_POSITION);
 }
 
+void clEditor::SetSemanticTokenRanges(std::vector<SemanticToken> tokens)
+{
+    const int doc_length = GetLength();
+    const int delta = doc_length - m_semanticTokensDocLength;
+    const std::vector<SemanticToken>& prev = m_semanticTokens;
+
+    // the tokens before the first change did not move
+    size_t prefix = 0;
+    while (prefix < prev.size() && prefix < tokens.size() && prev[prefix] == tokens[prefix]) {
+        ++prefix;
+    }
+
+    // the tokens after the last change keep their distance from the end of the document
+    size_t suffix = 0;
+    while (suffix < prev.size() - prefix && suffix < tokens.size() - prefix) {
+        const SemanticToken& a = prev[prev.size() - suffix - 1];
+        const SemanticToken& b = tokens[tokens.size() - suffix - 1];
+        if (a.start + delta != b.start || a.length != b.length || a.kind != b.kind) {
+            break;
+        }
+        ++suffix;
+    }
+
+    // compute the changed region. The old tokens were placed before the last edits, so we don't know whether they
+    // moved or not: include both locations
+    int from = doc_length;
+    int to = 0;
+    if (prefix < prev.size() - suffix) {
+        const SemanticToken& first = prev[prefix];
+        const SemanticToken& last = prev[prev.size() - suffix - 1];
+        from = std::min({ from, first.start, first.start + delta });
+        to = std::max({ to, last.start + last.length, last.start + last.length + delta });
+    }
+    if (prefix < tokens.size() - suffix) {
+        const SemanticToken& first = tokens[prefix];
+        const SemanticToken& last = tokens[tokens.size() - suffix - 1];
+        from = std::min(from, first.start);
+        to = std::max(to, last.start + last.length);
+    }
+
+    LOG_IF_DEBUG
+    {
+        clDEBUG1() << "Semantic tokens:" << tokens.size() << "tokens," << (tokens.size() - prefix - suffix)
+                   << "changed" << endl;
+    }
+
+    m_semanticTokens.swap(tokens);
+    m_semanticTokensDocLength = doc_length;
+
+    // merge with the region that was not coloured yet
+    if (m_semanticDirtyFrom != wxNOT_FOUND) {
+        from = std::min(from, m_semanticDirtyFrom);
+        to = std::max(to, m_semanticDirtyTo + std::max(delta, 0));
+    }
+    from = std::max(from, 0);
+    to = std::min(to, doc_length);
+    if (from >= to) {
+        m_semanticDirtyFrom = m_semanticDirtyTo = wxNOT_FOUND;
+        return;
+    }
+    m_semanticDirtyFrom = from;
+    m_semanticDirtyTo = to;
+
+    // colour the visible lines now, the rest is done from the idle event
+    int first_line = DocLineFromVisible(GetFirstVisibleLine());
+    int last_line = DocLineFromVisible(GetFirstVisibleLine() + LinesOnScreen());
+    DoColourSemanticTokens(std::max(from, PositionFromLine(first_line)), std::min(to, GetLineEndPosition(last_line)));
+}
+
+void clEditor::UpdateSemanticIndicators(LexerConf::Ptr_t lexer)
+{
+    // draw the tokens with the colour the lexer uses for the matching word set
+    for (int kind = LexerConf::WS_FIRST; kind <= LexerConf::WS_LAST; ++kind) {
+        int indicator = INDICATOR_SEMANTIC_CLASS + kind;
+        int style = lexer ? lexer->GetWordSetStyle(this, (LexerConf::eWordSetIndex)kind) : wxNOT_FOUND;
+        if (style == wxNOT_FOUND) {
+            IndicatorSetStyle(indicator, wxSTC_INDIC_HIDDEN);
+        } else {
+            IndicatorSetStyle(indicator, wxSTC_INDIC_TEXTFORE);
+            IndicatorSetForeground(indicator, StyleGetForeground(style));
+        }
+    }
+}
+
+void clEditor::DoColourSemanticTokens(int from, int to)
+{
+    if (from >= to) {
+        return;
+    }
+
+    for (int kind = LexerConf::WS_FIRST; kind <= LexerConf::WS_LAST; ++kind) {
+        SetIndicatorCurrent(INDICATOR_SEMANTIC_CLASS + kind);
+        IndicatorClearRange(from, to - from);
+    }
+
+    auto iter = std::lower_bound(m_semanticTokens.begin(), m_semanticTokens.end(), from,
+                                 [](const SemanticToken& token, int pos) { return token.start < pos; });
+    for (; iter != m_semanticTokens.end() && iter->start < to; ++iter) {
+        if (iter->kind < LexerConf::WS_FIRST || iter->kind > LexerConf::WS_LAST) {
+            continue;
+        }
+        SetIndicatorCurrent(INDICATOR_SEMANTIC_CLASS + iter->kind);
+        IndicatorFillRange(iter->start, std::min(iter->length, to - iter->start));
+    }
+}
+
+bool clEditor::DoColourSemanticTokensChunk()
+{
+    if (m_semanticDirtyFrom == wxNOT_FOUND) {
+        return false;
+    }
+
+    constexpr size_t CHUNK_SIZE = 1000;
+    int from = std::max(m_semanticDirtyFrom, 0);
+    int to = std::min(m_semanticDirtyTo, GetLength());
+    auto iter = std::lower_bound(m_semanticTokens.begin(), m_semanticTokens.end(), from,
+                                 [](const SemanticToken& token, int pos) { return token.start < pos; });
+    int chunk_end = to;
+    if ((size_t)std::distance(iter, m_semanticTokens.end()) > CHUNK_SIZE && iter[CHUNK_SIZE].start > from) {
+        chunk_end = std::min(to, iter[CHUNK_SIZE].start);
+    }
+
+    DoColourSemanticTokens(from, chunk_end);
+    if (chunk_end >= to) {
+        m_semanticDirtyFrom = m_semanticDirtyTo = wxNOT_FOUND;
+        return false;
+    }
+    m_semanticDirtyFrom = chunk_end;
+    return true;
+}
+
 int clEditor::GetColumnInChars(int pos)
 {
     int line = LineFromPosition(pos);
@@ -6181,6 +6341,11 @@ void clEditor::OnIdle(wxIdleEvent& event)
 
     event.Skip();
 
+    // colour the semantic tokens outside of the visible area, one chunk per idle event
+    if (DoColourSemanticTokensChunk()) {
+        event.RequestMore();
+    }
+
     // The interval between idle events can not be under 250ms
     static clIdleEventThrottler event_throttler{ 100 };
     if (!event_throttler.CanHandle()) {
@@ -327,6 +327,11 @@ public:
                            const wxString& methods,
                            const wxString& others) override;
 
+    /**
+     * @brief colour semantic tokens by their position (see IEditor::SetSemanticTokenRanges)
+     */
+    void SetSemanticTokenRanges(std::vector<SemanticToken> tokens) override;
+
     /**
      * @brief split the current selection into multiple carets.
      * i.e. place a caret at the end of each line in the selection
@@ -744,6 +749,7 @@ public:
     void SetWarningMarker(int lineno, CompilerMessage&& msg) override;
     void SetErrorMarker(int lineno, CompilerMessage&& msg) override;
     void DelAllCompilerMarkers() override;
+    void DelCompilerMarker(int lineno) override;
 
     void DoShowCalltip(int pos, const wxString& title, const wxString& tip, bool strip_html_tags = true);
     /**
@@ -1063,6 +1069,11 @@ private:
     void UpdateLineNumbers(bool force);
     void UpdateDefaultTextWidth();
 
+    // Semantic tokens
+    void UpdateSemanticIndicators(LexerConf::Ptr_t lexer);
+    void DoColourSemanticTokens(int from, int to);
+    bool DoColourSemanticTokensChunk();
+
     // Event handlers
     void OnIdle(wxIdleEvent& event);
     void OpenURL(wxCommandEvent& event);
@@ -1155,6 +1166,11 @@ private:
     wxString m_keywordMethods;
     wxString m_keywordOthers;
     wxString m_keywordLocals;
+    std::vector<SemanticToken> m_semanticTokens;
+    int m_semanticTokensDocLength = 0;
+    // the region that still needs to be coloured with the semantic tokens
+    int m_semanticDirtyFrom = wxNOT_FOUND;
+    int m_semanticDirtyTo = wxNOT_FOUND;
     int m_editorBitmap = wxNOT_FOUND;
     size_t m_statusBarFields;
     EditorViewState m_editorState;
@@ -52,6 +52,14 @@
 #include <wx/wupdlock.h>
 #include <wx/xrc/xmlres.h>
 
+namespace
+{
+// rate at which pending matches are appended to the view (~30 frames per second)
+constexpr int FLUSH_INTERVAL_MS = 33;
+// flush right away when that many lines are pending, this bounds the size of a single append
+constexpr int MAX_PENDING_LINES = 20000;
+} // namespace
+
 BEGIN_EVENT_TABLE(FindResultsTab, OutputTabWindow)
 EVT_UPDATE_UI(XRCID("hold_pane_open"), FindResultsTab::OnHoldOpenUpdateUI)
 END_EVENT_TABLE()
@@ -59,9 +67,12 @@ END_EVENT_TABLE()
 FindResultsTab::FindResultsTab(wxWindow* parent, wxWindowID id, const wxString& name)
     : OutputTabWindow(parent, id, name)
     , m_searchInProgress(false)
+    , m_flushTimer(this)
 {
     BindSearchEvents(this);
     m_sci->Connect(wxEVT_STC_STYLENEEDED, wxStyledTextEventHandler(FindResultsTab::OnStyleNeeded), NULL, this);
+    m_sci->Bind(wxEVT_STC_UPDATEUI, &FindResultsTab::OnViewUpdated, this);
+    Bind(wxEVT_TIMER, &FindResultsTab::OnFlushTimer, this, m_flushTimer.GetId());
     wxTheApp->Connect(XRCID("find_in_files"), wxEVT_COMMAND_MENU_SELECTED,
                       wxCommandEventHandler(FindResultsTab::OnFindInFiles), NULL, this);
     m_tb->Bind(wxEVT_TOOL_DROPDOWN, &FindResultsTab::OnRecentSearches, this, XRCID("recent_searches"));
@@ -87,6 +98,8 @@ FindResultsTab::FindResultsTab(wxWindow* parent, wxWindowID id, const wxString&
 
 FindResultsTab::~FindResultsTab()
 {
+    m_flushTimer.Stop();
+    Unbind(wxEVT_TIMER, &FindResultsTab::OnFlushTimer, this, m_flushTimer.GetId());
     UnbindSearchEvents(this);
     EventNotifier::Get()->Connect(wxEVT_CL_THEME_CHANGED, wxCommandEventHandler(FindResultsTab::OnThemeChanged), NULL,
                                   this);
@@ -108,8 +121,12 @@ void FindResultsTab::AppendLine(const wxString& line, bool scroll_to_bottom)
 
 void FindResultsTab::Clear()
 {
+    m_flushTimer.Stop();
+    m_pendingText.clear();
+    m_pendingLines = 0;
+    m_flushedMatches = 0;
     m_matchInfo.clear();
-    m_indicators.clear();
+    m_store.Clear();
     m_searchTitle.clear();
     OutputTabWindow::Clear();
     m_styler->Reset();
@@ -145,6 +162,7 @@ void FindResultsTab::OnSearchStart(wxCommandEvent& e)
         ScrollToBottom();
     }
     wxDELETE(data);
+    m_flushTimer.Start(FLUSH_INTERVAL_MS);
 
     // Make sure that the Output view & the "Replace" tab
     // are visible
@@ -161,35 +179,103 @@ void FindResultsTab::OnSearchMatch(wxCommandEvent& e)
         return;
     }
 
-    wxWindowUpdateLocker locker{ m_sci };
-    m_indicators.reserve(m_indicators.size() + res->size());
-
+    // the text is only formatted here, it is added to the view by FlushPendingMatches()
     for (const auto& searchResult : *res) {
-        if (m_matchInfo.empty() || m_matchInfo.rbegin()->second.GetFileName() != searchResult.GetFileName()) {
-            if(!m_matchInfo.empty()) {
-                AppendLine("\n", false);
+        if (m_store.IsEmpty() || m_store.GetFileName(m_store.Back()) != searchResult.GetFileName()) {
+            if (!m_store.IsEmpty()) {
+                m_pendingText << "\n";
+                ++m_pendingLines;
             }
-            AppendLine(searchResult.GetFileName() + wxT("\n"), false);
+            m_pendingText << searchResult.GetFileName() << "\n";
+            ++m_pendingLines;
         }
 
-        int lineno = m_sci->GetLineCount() - 1;
-        m_matchInfo.insert(std::make_pair(lineno, searchResult));
-        wxString text = searchResult.GetPattern();
-
+        // the view always ends with an empty line, this is where the next line goes
+        int lineno = m_sci->GetLineCount() - 1 + m_pendingLines;
         wxString linenum = wxString::Format(wxT(" %5u: "), searchResult.GetLineNumber());
-        AppendLine(linenum + text + wxT("\n"), false);
-        int indicatorStartPos = m_sci->PositionFromLine(lineno) + searchResult.GetColumn() + linenum.Length();
-        int indicatorLen = searchResult.GetLen();
-        m_indicators.emplace_back(indicatorStartPos);
-        m_sci->IndicatorFillRange(indicatorStartPos, indicatorLen);
+        m_store.Add(searchResult, lineno, linenum.length());
+        if (m_keepFullResults) {
+            m_matchInfo.insert(std::make_pair(lineno, searchResult));
+        }
+        m_pendingText << linenum << searchResult.GetPattern() << "\n";
+        ++m_pendingLines;
     }
-    ScrollToBottom();
     wxDELETE(res);
+
+    if (m_pendingLines >= MAX_PENDING_LINES) {
+        FlushPendingMatches();
+    }
+}
+
+void FindResultsTab::FlushPendingMatches()
+{
+    if (m_pendingText.empty()) {
+        return;
+    }
+
+    wxWindowUpdateLocker locker{ m_sci };
+    AppendLine(m_pendingText, false);
+    m_pendingText.clear();
+    m_pendingLines = 0;
+
+    auto& matches = m_store.GetMatches();
+    auto begin = matches.begin() + m_flushedMatches;
+    m_flushedMatches = matches.size();
+    ScrollToBottom();
+
+    if (m_keepFullResults) {
+        PaintIndicators(begin, matches.end());
+    } else {
+        PaintVisibleIndicators();
+    }
+}
+
+void FindResultsTab::PaintIndicators(FindResultsStore::Vec_t::iterator begin, FindResultsStore::Vec_t::iterator end)
+{
+    m_sci->SetIndicatorCurrent(1);
+    int maxRow = m_sci->GetLineCount() - 1;
+    for (; begin != end && begin->row < maxRow; ++begin) {
+        if (begin->painted) {
+            continue;
+        }
+        begin->painted = true;
+        m_sci->IndicatorFillRange(m_sci->PositionFromLine(begin->row) + begin->offset + begin->column, begin->len);
+    }
+}
+
+void FindResultsTab::PaintVisibleIndicators()
+{
+    if (m_store.IsEmpty()) {
+        return;
+    }
+
+    // map the visible lines (folding aware) to document lines
+    int firstVisible = m_sci->GetFirstVisibleLine();
+    int firstRow = m_sci->DocLineFromVisible(firstVisible);
+    int lastRow = m_sci->DocLineFromVisible(firstVisible + m_sci->LinesOnScreen());
+    PaintIndicators(m_store.LowerBound(firstRow), m_store.LowerBound(lastRow + 1));
+}
+
+void FindResultsTab::OnViewUpdated(wxStyledTextEvent& e)
+{
+    e.Skip();
+    if (!m_keepFullResults && (e.GetUpdated() & (wxSTC_UPDATE_V_SCROLL | wxSTC_UPDATE_CONTENT))) {
+        PaintVisibleIndicators();
+    }
+}
+
+void FindResultsTab::OnFlushTimer(wxTimerEvent& e)
+{
+    wxUnusedVar(e);
+    FlushPendingMatches();
 }
 
 void FindResultsTab::OnSearchEnded(wxCommandEvent& e)
 {
     m_searchInProgress = false;
+    m_flushTimer.Stop();
+    FlushPendingMatches();
+
     SearchSummary* summary = (SearchSummary*)e.GetClientData();
     if(!summary)
         return;
@@ -229,7 +315,11 @@ void FindResultsTab::OnSearchEnded(wxCommandEvent& e)
     }
 }
 
-void FindResultsTab::OnSearchCancel(wxCommandEvent& e) { AppendLine(_("====== Search cancelled by user ======\n")); }
+void FindResultsTab::OnSearchCancel(wxCommandEvent& e)
+{
+    FlushPendingMatches();
+    AppendLine(_("====== Search cancelled by user ======\n"));
+}
 
 void FindResultsTab::OnClearAll(wxCommandEvent& e)
 {
@@ -261,9 +351,9 @@ void FindResultsTab::OnMouseDClick(wxStyledTextEvent& e)
         m_sci->ToggleFold(toggleLine);
 
     } else {
-        MatchInfo_t::const_iterator m = m_matchInfo.find(clickedLine);
-        if(m != m_matchInfo.end()) {
-            DoOpenSearchResult(m->second, m_sci, m->first);
+        const FindResultsStore::Match* match = m_store.Find(clickedLine);
+        if(match) {
+            DoOpenSearchResult(m_store.ToSearchResult(*match), m_sci, match->row);
         }
     }
 }
@@ -278,18 +368,12 @@ void FindResultsTab::NextMatch()
         firstLine = 0;
     }
 
-    // We found the last marker
-    for(int i = firstLine + 1; i < m_sci->GetLineCount(); i++) {
-
-        // Find the next match
-        MatchInfo_t::const_iterator iter = m_matchInfo.find(i);
-        if(iter != m_matchInfo.end()) {
-            SearchResult sr = iter->second;
-
-            // open the new searchresult in the editor
-            DoOpenSearchResult(sr, m_sci, i);
-            return;
-        }
+    // Find the next match
+    const FindResultsStore::Match* match = m_store.FindNext(firstLine);
+    if(match) {
+        // open the new searchresult in the editor
+        DoOpenSearchResult(m_store.ToSearchResult(*match), m_sci, match->row);
+        return;
     }
 
     // if we are here, it means we are the end of the search results list, add a status message
@@ -304,18 +388,12 @@ void FindResultsTab::PrevMatch()
         firstLine = m_sci->GetLineCount();
     }
 
-    // We found the last marker
-    for(int i = firstLine - 1; i >= 0; i--) {
-
-        // Find the next match
-        MatchInfo_t::const_iterator iter = m_matchInfo.find(i);
-        if(iter != m_matchInfo.end()) {
-            SearchResult sr = iter->second;
-
-            // open the new searchresult in the editor
-            DoOpenSearchResult(sr, m_sci, i);
-            return;
-        }
+    // Find the previous match
+    const FindResultsStore::Match* match = m_store.FindPrev(firstLine);
+    if(match) {
+        // open the new searchresult in the editor
+        DoOpenSearchResult(m_store.ToSearchResult(*match), m_sci, match->row);
+        return;
     }
     // if we are here, it means we are the top of the search results list, add a status message
     clMainFrame::Get()->GetStatusBar()->SetMessage(_("Reached the start of the 'Find In Files' results"));
@@ -480,9 +558,7 @@ void FindResultsTab::SaveSearchData()
     entry.searchData = m_searchData;
     entry.title = m_searchTitle;
     entry.matchInfo = m_matchInfo;
-
-    // Save the indicators as well
-    entry.indicators = m_indicators;
+    entry.store = m_store;
 
     // search for an entry with the same title
     if(m_history.Contains(entry.title)) {
@@ -495,17 +571,22 @@ void FindResultsTab::LoadSearch(const History& h)
 {
     m_searchData = h.searchData;
     m_matchInfo = h.matchInfo;
+    m_store = h.store;
+    m_store.ResetPainted();
+    m_flushedMatches = m_store.GetCount();
     m_searchTitle = h.title;
     m_sci->SetEditable(true);
     m_sci->ClearAll();
     m_sci->SetText(h.text);
+    m_sci->SetFirstVisibleLine(0);
+    m_sci->SetEditable(false);
 
     // restore the indicators
-    for (int pos : h.indicators) {
-        m_sci->IndicatorFillRange(pos, h.title.length());
+    if(m_keepFullResults) {
+        PaintIndicators(m_store.GetMatches().begin(), m_store.GetMatches().end());
+    } else {
+        PaintVisibleIndicators();
     }
-    m_sci->SetFirstVisibleLine(0);
-    m_sci->SetEditable(false);
 }
 
 void FindResultsTab::OnRecentSearchesUI(wxUpdateUIEvent& e) { e.Enable(!m_history.IsEmpty() && !m_searchInProgress); }
@@ -540,6 +621,84 @@ void FindResultsTab::BindSearchEvents(wxEvtHandler* binder)
 
 /////////////////////////////////////////////////////////////////////////////////
 
+void FindResultsStore::Clear()
+{
+    m_files.clear();
+    m_fileIds.clear();
+    m_matches.clear();
+}
+
+void FindResultsStore::Add(const SearchResult& result, int row, int offset)
+{
+    uint32_t file_id;
+    auto iter = m_fileIds.find(result.GetFileName());
+    if(iter == m_fileIds.end()) {
+        file_id = m_files.size();
+        m_files.push_back(result.GetFileName());
+        m_fileIds.insert({ result.GetFileName(), file_id });
+    } else {
+        file_id = iter->second;
+    }
+
+    Match match;
+    match.row = row;
+    match.offset = offset;
+    match.file_id = file_id;
+    match.line_number = result.GetLineNumber();
+    match.column = result.GetColumn();
+    match.len = result.GetLen();
+    m_matches.push_back(match);
+}
+
+FindResultsStore::Vec_t::iterator FindResultsStore::LowerBound(int row)
+{
+    return std::lower_bound(m_matches.begin(), m_matches.end(), row,
+                            [](const Match& match, int r) { return match.row < r; });
+}
+
+const FindResultsStore::Match* FindResultsStore::Find(int row) const
+{
+    auto iter = std::lower_bound(m_matches.begin(), m_matches.end(), row,
+                                 [](const Match& match, int r) { return match.row < r; });
+    if(iter == m_matches.end() || iter->row != row) {
+        return nullptr;
+    }
+    return &(*iter);
+}
+
+const FindResultsStore::Match* FindResultsStore::FindNext(int row) const
+{
+    auto iter = std::upper_bound(m_matches.begin(), m_matches.end(), row,
+                                 [](int r, const Match& match) { return r < match.row; });
+    return iter == m_matches.end() ? nullptr : &(*iter);
+}
+
+const FindResultsStore::Match* FindResultsStore::FindPrev(int row) const
+{
+    auto iter = std::lower_bound(m_matches.begin(), m_matches.end(), row,
+                                 [](const Match& match, int r) { return match.row < r; });
+    return iter == m_matches.begin() ? nullptr : &(*(iter - 1));
+}
+
+void FindResultsStore::ResetPainted()
+{
+    for(auto& match : m_matches) {
+        match.painted = false;
+    }
+}
+
+SearchResult FindResultsStore::ToSearchResult(const Match& match) const
+{
+    SearchResult result;
+    result.SetFileName(GetFileName(match));
+    result.SetLineNumber(match.line_number);
+    result.SetColumn(match.column);
+    result.SetLen(match.len);
+    return result;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+
 std::vector<int> EditorDeltasHolder::GetChanges()
 {
     // There may have been net +ve or -ve position changes (i.e. undos) subsequent to a last save
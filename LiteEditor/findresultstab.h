@@ -32,31 +32,109 @@
 #include "search_thread.h"
 #include "wx_ordered_map.h"
 
+#include <cstdint>
 #include <map>
 #include <unordered_map>
 #include <vector>
 #include <wx/aui/auibar.h>
 #include <wx/debug.h>
 #include <wx/stc/stc.h>
+#include <wx/timer.h>
 
 // Map between the line numbers and a search results
 typedef std::map<int, SearchResult> MatchInfo_t;
 
+/**
+ * @brief compact storage for the find in files matches.
+ * File names are interned once and the matched line text lives only in the results view, so a match costs a handful
+ * of integers instead of a full SearchResult. Matches are kept sorted by their row in the results view
+ */
+class FindResultsStore
+{
+public:
+    struct Match {
+        int row = 0;     // the line in the results view
+        int offset = 0;  // offset of the match from the start of the row
+        uint32_t file_id = 0;
+        int line_number = 0;
+        int column = 0;
+        int len = 0;
+        bool painted = false; // is the match indicator drawn?
+    };
+    typedef std::vector<Match> Vec_t;
+
+protected:
+    std::vector<wxString> m_files;
+    std::unordered_map<wxString, uint32_t> m_fileIds;
+    Vec_t m_matches;
+
+public:
+    void Clear();
+    void Add(const SearchResult& result, int row, int offset);
+
+    /**
+     * @brief return the match displayed at `row`, or nullptr
+     */
+    const Match* Find(int row) const;
+
+    /**
+     * @brief return the first match displayed after `row`, or nullptr
+     */
+    const Match* FindNext(int row) const;
+
+    /**
+     * @brief return the last match displayed before `row`, or nullptr
+     */
+    const Match* FindPrev(int row) const;
+
+    /**
+     * @brief return an iterator to the first match with a row greater or equal to `row`
+     */
+    Vec_t::iterator LowerBound(int row);
+    Vec_t& GetMatches() { return m_matches; }
+
+    /**
+     * @brief mark all the indicators as not drawn (e.g. the view text was replaced)
+     */
+    void ResetPainted();
+
+    const wxString& GetFileName(const Match& match) const { return m_files[match.file_id]; }
+    bool IsEmpty() const { return m_matches.empty(); }
+    size_t GetCount() const { return m_matches.size(); }
+    const Match& Back() const { return m_matches.back(); }
+
+    /**
+     * @brief rebuild a SearchResult from a match. Only the location fields are set
+     */
+    SearchResult ToSearchResult(const Match& match) const;
+};
+
 class FindResultsTab : public OutputTabWindow
 {
 protected:
     SearchData m_searchData;
     wxString m_searchTitle;
-    std::vector<int> m_indicators;
+    FindResultsStore m_store;
     bool m_searchInProgress;
     bool m_searchEventsConnected = false;
 
+    // When set, the full SearchResult of every match is kept in m_matchInfo and the match indicators are drawn as
+    // soon as the text is added (the replace panel edits both the results and the view). Otherwise only the compact
+    // store is kept and indicators are drawn for the visible rows only
+    bool m_keepFullResults = false;
+
+    // matches are appended to the view in batches, at a fixed rate
+    wxTimer m_flushTimer;
+    wxString m_pendingText;
+    int m_pendingLines = 0;
+    size_t m_flushedMatches = 0;
+
     struct History {
         wxString title;
         SearchData searchData;
         wxString text;
         MatchInfo_t matchInfo;
-        std::vector<int> indicators;
+        FindResultsStore store;
         typedef wxOrderedMap<wxString, History> Map_t;
     };
 
@@ -68,6 +146,9 @@ protected:
     void BindSearchEvents(wxEvtHandler* binder);
 
     void AppendLine(const wxString& line, bool scroll_to_bottom = true);
+    void FlushPendingMatches();
+    void PaintIndicators(FindResultsStore::Vec_t::iterator begin, FindResultsStore::Vec_t::iterator end);
+    void PaintVisibleIndicators();
     void Clear();
     void SaveSearchData();
     void LoadSearch(const History& h);
@@ -84,6 +165,8 @@ protected:
     virtual void OnRecentSearchesUI(wxUpdateUIEvent& e);
     virtual void OnRepeatOutputUI(wxUpdateUIEvent& e);
     virtual void OnMouseDClick(wxStyledTextEvent& e);
+    void OnViewUpdated(wxStyledTextEvent& e);
+    void OnFlushTimer(wxTimerEvent& e);
 
     virtual void OnStopSearch(wxCommandEvent& e);
     virtual void OnStopSearchUI(wxUpdateUIEvent& e);
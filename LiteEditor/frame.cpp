@@ -54,6 +54,7 @@
 #include "clLocaleManager.hpp"
 #include "clSTCHelper.hpp"
 #include "clSingleChoiceDialog.h"
+#include "clStartupTrace.hpp"
 #include "clThemedTreeCtrl.h"
 #include "clToolBarButtonBase.h"
 #include "clWorkspaceManager.h"
@@ -1700,6 +1701,7 @@ bool clMainFrame::StartSetupWizard(bool firstTime)
 
 void clMainFrame::Bootstrap()
 {
+    clStartupTrace::Scope trace("clMainFrame::Bootstrap");
     if (!clConfig::Get().Read(kConfigBootstrapCompleted, false)) {
         clConfig::Get().Write(kConfigBootstrapCompleted, true);
         if (StartSetupWizard(true)) {
@@ -1959,6 +1961,7 @@ void clMainFrame::OnClose(wxCloseEvent& event)
 
 void clMainFrame::LoadSession(const wxString& sessionName)
 {
+    clStartupTrace::Scope trace("clMainFrame::LoadSession", "session");
     SessionEntry session;
     if (SessionManager::Get().GetSession(sessionName, session)) {
         wxString wspFile = session.GetWorkspaceName();
@@ -3434,6 +3437,8 @@ void clMainFrame::SetFrameFlag(bool set, int flag)
 
 void clMainFrame::CompleteInitialization()
 {
+    clStartupTrace::Scope trace("clMainFrame::CompleteInitialization");
+
     // create indexer to be used by TagsManager
     TagsManagerST::Get()->SetIndexerPath(clStandardPaths::Get().GetBinaryFullPath("codelite_indexer"));
 
@@ -34,6 +34,7 @@
 #include "buildmanager.h"
 #include "clEditorBar.h"
 #include "clInfoBar.h"
+#include "clStartupTrace.hpp"
 #include "clStrings.h"
 #include "cl_config.h"
 #include "cl_standard_paths.h"
@@ -57,6 +58,7 @@
 #include "sessionmanager.h"
 #include "workspacetab.h"
 
+#include <algorithm>
 #include <memory>
 #include <wx/dir.h>
 #include <wx/filename.h>
@@ -101,6 +103,9 @@ void PluginManager::UnLoad()
         clConfig::Get().Write("VisibleOutputTabs", visibleTabs);
     }
 
+    EventNotifier::Get()->Unbind(wxEVT_INIT_DONE, &PluginManager::OnInitDone, this);
+    m_deferredPlugins.clear();
+
     for (auto [__, plugin] : m_plugins) {
         plugin->UnPlug();
         delete plugin;
@@ -124,6 +129,11 @@ PluginManager::PluginManager()
 
 void PluginManager::Load()
 {
+    clStartupTrace::Scope trace("PluginManager::Load");
+
+    // once the startup is completed, load the deferred plugins (if any) and write the startup trace
+    EventNotifier::Get()->Bind(wxEVT_INIT_DONE, &PluginManager::OnInitDone, this);
+
     wxString ext;
 #if defined(__WXGTK__)
     ext = wxT("so");
@@ -258,16 +268,19 @@ void PluginManager::Load()
                 continue;
             }
 
-            // Construct the plugin
-            IPlugin* plugin = pfn((IManager*)this);
-            clDEBUG() << "Loaded plugin:" << plugin->GetLongName() << endl;
-            m_plugins[plugin->GetShortName()] = plugin;
-
-            // Load the toolbar
-            plugin->CreateToolBar(clMainFrame::Get()->GetPluginsToolBar());
-
             // Keep the dynamic load library
             m_dl.push_back(dl);
+
+            if (pluginInfo->HasFlag(PluginInfo::kLoadOnIdle)) {
+                // not needed for the first paint, create it once the startup is completed
+                clDEBUG() << "Plugin:" << pluginInfo->GetName() << "will be loaded on idle time" << endl;
+                m_deferredPlugins.push_back({ pluginInfo->GetName(), pfn });
+                continue;
+            }
+
+            // Construct the plugin and load its toolbar
+            IPlugin* plugin = DoCreatePlugin(pluginInfo->GetName(), pfn);
+            plugin->CreateToolBar(clMainFrame::Get()->GetPluginsToolBar());
         }
         clMainFrame::Get()->GetDockingManager().Update();
 
@@ -330,6 +343,61 @@ void PluginManager::Load()
     }
 }
 
+IPlugin* PluginManager::DoCreatePlugin(const wxString& name, GET_PLUGIN_CREATE_FUNC pfn)
+{
+    clStartupTrace::Scope trace("plugin: " + name, "plugins");
+    IPlugin* plugin = pfn((IManager*)this);
+    clDEBUG() << "Loaded plugin:" << plugin->GetLongName() << endl;
+    m_plugins[plugin->GetShortName()] = plugin;
+    return plugin;
+}
+
+void PluginManager::OnInitDone(wxCommandEvent& event)
+{
+    event.Skip();
+    EventNotifier::Get()->Unbind(wxEVT_INIT_DONE, &PluginManager::OnInitDone, this);
+    if (m_deferredPlugins.empty()) {
+        clStartupTrace::Get().Finish();
+        return;
+    }
+
+    // the main frame is visible and the session is restored: create the deferred plugins, one per event loop
+    // iteration, so the UI stays responsive meanwhile
+    std::reverse(m_deferredPlugins.begin(), m_deferredPlugins.end());
+    LoadNextDeferredPlugin();
+}
+
+void PluginManager::LoadNextDeferredPlugin()
+{
+    if (m_deferredPlugins.empty()) {
+        // the deferred plugins added their menu entries, apply the keyboard shortcuts to them
+        ManagerST::Get()->UpdateMenuAccelerators();
+        clStartupTrace::Get().AddInstant("deferred plugins loaded");
+        clStartupTrace::Get().Finish();
+        return;
+    }
+
+    auto [name, pfn] = m_deferredPlugins.back();
+    m_deferredPlugins.pop_back();
+
+    IPlugin* plugin = DoCreatePlugin(name, pfn);
+    clToolBarGeneric* toolbar = clMainFrame::Get()->GetPluginsToolBar();
+    plugin->CreateToolBar(toolbar);
+    if (toolbar) {
+        toolbar->Realize();
+    }
+
+    wxMenu* pluginsMenu = nullptr;
+    wxMenuItem* menuitem = clMainFrame::Get()->GetMainMenuBar()->FindItem(XRCID("manage_plugins"), &pluginsMenu);
+    if (pluginsMenu && menuitem) {
+        plugin->SetPluginsMenu(pluginsMenu);
+        plugin->CreatePluginMenu(pluginsMenu);
+    }
+    clMainFrame::Get()->GetDockingManager().Update();
+
+    wxTheApp->CallAfter([this]() { LoadNextDeferredPlugin(); });
+}
+
 IEditor* PluginManager::GetActiveEditor()
 {
     if (clMainFrame::Get() && clMainFrame::Get()->GetMainBook()) {
@@ -60,11 +60,17 @@ class PluginManager : public IManager
     std::map<wxString, wxString> m_backticks;
     wxAuiManager* m_dockingManager;
     PluginInfo::PluginMap_t m_installedPlugins;
+    // plugins flagged with PluginInfo::kLoadOnIdle, created after the startup is completed
+    std::vector<std::pair<wxString, GET_PLUGIN_CREATE_FUNC>> m_deferredPlugins;
 
 private:
     PluginManager();
     virtual ~PluginManager();
 
+    IPlugin* DoCreatePlugin(const wxString& name, GET_PLUGIN_CREATE_FUNC pfn);
+    void OnInitDone(wxCommandEvent& event);
+    void LoadNextDeferredPlugin();
+
 public:
     static PluginManager* Get();
 
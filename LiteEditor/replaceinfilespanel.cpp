@@ -37,7 +37,9 @@
 #include "globals.h"
 #include "macros.h"
 #include "manager.h"
+#include "optionsconfig.h"
 
+#include <algorithm>
 #include <vector>
 #include <wx/dcgraph.h>
 #include <wx/dcmemory.h>
@@ -48,7 +50,10 @@
 
 ReplaceInFilesPanel::ReplaceInFilesPanel(wxWindow* parent, int id, const wxString& name)
     : FindResultsTab(parent, id, name)
+    , m_engine(new ReplaceInFilesEngine(this))
 {
+    // replacing needs the full results
+    m_keepFullResults = true;
     Bind(wxEVT_UPDATE_UI, &ReplaceInFilesPanel::OnHoldOpenUpdateUI, this, XRCID("hold_pane_open"));
     wxBoxSizer* horzSizer = new wxBoxSizer(wxHORIZONTAL);
 
@@ -72,6 +77,11 @@ ReplaceInFilesPanel::ReplaceInFilesPanel(wxWindow* parent, int id, const wxStrin
     repl->Bind(wxEVT_BUTTON, &ReplaceInFilesPanel::OnReplace, this);
     repl->Bind(wxEVT_UPDATE_UI, &ReplaceInFilesPanel::OnReplaceUI, this);
 
+    wxButton* undo = new wxButton(this, wxID_ANY, _("Undo Replace"));
+    horzSizer->Add(undo, 0, wxRIGHT | wxLEFT | wxALIGN_CENTER_VERTICAL, 5);
+    undo->Bind(wxEVT_BUTTON, &ReplaceInFilesPanel::OnUndoReplace, this);
+    undo->Bind(wxEVT_UPDATE_UI, &ReplaceInFilesPanel::OnUndoReplaceUI, this);
+
     wxBoxSizer* vertSizer = new wxBoxSizer(wxVERTICAL);
     vertSizer->Add(horzSizer, 0, wxEXPAND | wxTOP | wxBOTTOM);
 
@@ -92,11 +102,14 @@ ReplaceInFilesPanel::ReplaceInFilesPanel(wxWindow* parent, int id, const wxStrin
     mainSizer->Layout();
 }
 
-ReplaceInFilesPanel::~ReplaceInFilesPanel() {}
+ReplaceInFilesPanel::~ReplaceInFilesPanel() { wxDELETE(m_engine); }
 
 void ReplaceInFilesPanel::OnSearchStart(wxCommandEvent& e)
 {
     e.Skip();
+    // the view is about to be cleared, results of a replace that is still running no longer apply to it
+    ++m_replaceId;
+
     // set the "Replace With" field with the user value
     SearchData* data = (SearchData*)e.GetClientData();
     m_replaceWith->SetValue(data->GetReplaceWith());
@@ -157,62 +170,49 @@ void ReplaceInFilesPanel::OnMarkAll(wxCommandEvent& e)
     }
 }
 
-void ReplaceInFilesPanel::OnMarkAllUI(wxUpdateUIEvent& e) { e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress); }
+void ReplaceInFilesPanel::OnMarkAllUI(wxUpdateUIEvent& e)
+{
+    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress && !m_replaceInProgress);
+}
 void ReplaceInFilesPanel::OnUnmarkAll(wxCommandEvent& e) { m_sci->MarkerDeleteAll(0x7); }
 void ReplaceInFilesPanel::OnUnmarkAllUI(wxUpdateUIEvent& e)
 {
-    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress);
+    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress && !m_replaceInProgress);
 }
 
 void ReplaceInFilesPanel::DoSaveResults(wxStyledTextCtrl* sci, MatchInfo_t::iterator begin, MatchInfo_t::iterator end)
 {
     if(!sci || begin == end)
         return;
-    bool ok = true;
-    if(dynamic_cast<clEditor*>(sci) == NULL) {
-        // it's a temp editor, check if we have any changes to save
-        if(sci->GetModify() && !WriteFileWithBackup(begin->second.GetFileName(), sci->GetText(), false)) {
-            wxMessageBox(_("Failed to save file:\n") + begin->second.GetFileName(), _("CodeLite - Replace"),
-                         wxICON_ERROR | wxOK);
-            clDEBUG() << "Replace: Failed to write file" << begin->second.GetFileName();
-            ok = false;
-        }
-
-        if(sci && ok) {
-            // Keep the modified file name
-            m_filesModified.Add(begin->second.GetFileName());
-        }
-
-        delete sci;
-    }
+    // the editor keeps the changes, the user is asked to save them once the replace is done
     for(; begin != end; begin++) {
         if((m_sci->MarkerGet(begin->first) & 7 << 0x7) == 1 << 0x7) {
-            m_sci->MarkerAdd(begin->first, ok ? 0x9 : 0x8);
+            m_sci->MarkerAdd(begin->first, 0x9);
         }
     }
 }
 
 wxStyledTextCtrl* ReplaceInFilesPanel::DoGetEditor(const wxString& fileName)
 {
-    // look for open editor first
-    wxStyledTextCtrl* sci = clMainFrame::Get()->GetMainBook()->FindEditor(fileName);
-    if(sci) {
-        // FIXME: if editor is already modified, the found locations may not be accurate
-        return sci;
-    }
+    // only files opened in an editor are replaced here, the others are handled by the replace engine.
+    // The search reads the file from the disk: if the editor has unsaved changes the locations may not match its
+    // content, so each match is checked against the editor text before it is replaced (see OnReplace)
+    return clMainFrame::Get()->GetMainBook()->FindEditor(fileName);
+}
 
-    // not open for editing, so make our own temp editor
-    wxString content;
-    if(!ReadFileWithConversion(fileName, content)) {
-        wxMessageBox(_("Failed to open file:\n") + fileName, _("CodeLite - Replace"), wxICON_ERROR | wxOK);
-        clDEBUG() << "Replace: Failed to read file" << fileName;
-        return NULL;
+wxString ReplaceInFilesPanel::DoGetMatchedText(const SearchResult& res) const
+{
+    if(res.GetFlags() & wxSD_REGULAREXPRESSION) {
+        // the whole match
+        return res.GetRegexCapture(0);
     }
+    // the found text is the search string, up to the case
+    return res.GetFindWhat();
+}
 
-    sci = new wxStyledTextCtrl(this);
-    sci->Hide();
-    sci->SetText(content);
-    return sci;
+bool ReplaceInFilesPanel::DoIsMatchCase(const SearchResult& res) const
+{
+    return (res.GetFlags() & (wxSD_MATCHCASE | wxSD_REGULAREXPRESSION)) != 0;
 }
 
 wxString ReplaceInFilesPanel::DoGetReplaceWith(const SearchResult& res) const
@@ -254,11 +254,14 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
     }
 
     m_filesModified.clear();
+    m_lastChanges.clear();
     // FIX bug#2770561
     int lineNumber = 0;
+    wxString activeFile;
     clEditor* activeEditor = clMainFrame::Get()->GetMainBook()->GetActiveEditor();
     if(activeEditor) {
         lineNumber = activeEditor->GetCurrentLine();
+        activeFile = activeEditor->GetFileName().GetFullPath();
     }
 
     if(m_replaceWith->FindString(m_replaceWith->GetValue(), true) == wxString::npos) {
@@ -276,6 +279,10 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
     // remembers first entry in the file being updated
     MatchInfo_t::iterator firstInFile = m_matchInfo.begin();
 
+    // files that are not opened in an editor are replaced in the background
+    std::vector<ReplaceInFilesEngine::Job> jobs;
+    bool useEngine = false;
+
     m_progress->SetRange(m_matchInfo.size());
 
     // Disable the 'buffer limit' feature during replace
@@ -293,6 +300,32 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
             lastFile = res.GetFileName();
             lastLine = 0;
             sci = NULL;
+
+            useEngine = DoGetEditor(lastFile) == nullptr;
+            if(useEngine) {
+                jobs.emplace_back();
+                jobs.back().filename = lastFile;
+            }
+        }
+
+        if(useEngine) {
+            if((m_sci->MarkerGet(i->first) & 1 << 0x7) == 0)
+                // not selected for application
+                continue;
+
+            // the engine applies the edits from the end of the file, so the original columns are kept
+            ReplaceInFilesEngine::Edit edit;
+            edit.row = i->first;
+            edit.line = res.GetLineNumber();
+            edit.column = res.GetColumn();
+            edit.len = res.GetLen();
+            edit.find_what = DoGetMatchedText(res);
+            edit.match_case = DoIsMatchCase(res);
+            edit.replace_with = DoGetReplaceWith(res);
+            if(!edit.match_case || edit.find_what != edit.replace_with) {
+                jobs.back().edits.push_back(edit);
+            }
+            continue;
         }
 
         if(res.GetLineNumber() == lastLine) {
@@ -310,9 +343,10 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
         int replaceLenInChars = (int)replaceText.Len();
         int replaceLen = (int)::clUTF8Length(replaceText.ToStdWstring().c_str(), replaceLenInChars);
 
-        // extract originally matched text for safety check later
-        wxString text = res.GetPattern().Mid(res.GetColumnInChars() - deltaInChars, res.GetLenInChars());
-        if(text == replaceText)
+        // originally matched text for safety check later
+        wxString text = DoGetMatchedText(res);
+        bool matchCase = DoIsMatchCase(res);
+        if(matchCase && text == replaceText)
             continue; // no change needed
 
         // need an editor for this file (try only once per file though)
@@ -335,7 +369,8 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
         pos += res.GetColumn();
 
         sci->SetSelection(pos, pos + res.GetLen());
-        if(sci->GetSelectedText() != text) {
+        wxString selection = sci->GetSelectedText();
+        if(matchCase ? selection != text : selection.CmpNoCase(text) != 0) {
             // couldn't locate the original match (file may have been modified)
             m_sci->MarkerAdd(i->first, 0x8);
             continue;
@@ -351,22 +386,97 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
         res.SetLenInChars(replaceLenInChars);
     }
 
-    // hide the progress bar
-    m_progress->SetValue(0);
-    m_progress->Hide();
-    GetSizer()->Layout();
-
     DoSaveResults(sci, firstInFile, m_matchInfo.end());
 
     // Disable the 'buffer limit' feature during replace
     clMainFrame::Get()->GetMainBook()->SetUseBuffereLimit(true);
 
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+                              [](const ReplaceInFilesEngine::Job& job) { return job.edits.empty(); }),
+               jobs.end());
+    if(jobs.empty()) {
+        DoReplaceCompleted(activeFile, lineNumber);
+        return;
+    }
+
+    m_replaceInProgress = true;
+    m_progress->SetRange(jobs.size());
+    m_progress->SetValue(0);
+
+    size_t replaceId = m_replaceId;
+    auto on_progress = [this, replaceId](size_t count, size_t total) {
+        wxUnusedVar(total);
+        if(replaceId == m_replaceId) {
+            m_progress->SetValue(count);
+        }
+    };
+    auto on_done = [this, replaceId, activeFile, lineNumber](ReplaceInFilesEngine::ChangeSet_t&& changes) {
+        OnEngineDone(replaceId, std::move(changes), activeFile, lineNumber);
+    };
+    m_engine->Start(std::move(jobs), EditorConfigST::Get()->GetOptions()->GetFileFontEncoding(),
+                    std::move(on_progress), std::move(on_done));
+}
+
+void ReplaceInFilesPanel::OnEngineDone(size_t replaceId, ReplaceInFilesEngine::ChangeSet_t&& changes,
+                                       const wxString& activeFile, int lineNumber)
+{
+    m_replaceInProgress = false;
+    for(auto& result : changes) {
+        if(!result.error.empty()) {
+            clWARNING() << "Replace:" << result.filename << ":" << result.error << endl;
+        }
+
+        if(replaceId == m_replaceId) {
+            for(int row : result.replaced_rows) {
+                m_sci->MarkerAdd(row, 0x9);
+            }
+            for(int row : result.failed_rows) {
+                m_sci->MarkerAdd(row, 0x8);
+            }
+        }
+
+        if(result.written) {
+            // Keep the modified file name
+            m_filesModified.Add(result.filename);
+            m_lastChanges.push_back(std::move(result));
+        }
+    }
+
+    if(replaceId != m_replaceId) {
+        // a new search replaced the view content while we were busy
+        m_progress->SetValue(0);
+        m_progress->Hide();
+        GetSizer()->Layout();
+        DoNotifyFilesModified();
+        return;
+    }
+    DoReplaceCompleted(activeFile, lineNumber);
+}
+
+void ReplaceInFilesPanel::DoNotifyFilesModified()
+{
+    if(!m_filesModified.IsEmpty()) {
+        // Some files were modified directly on the file system, notify about it to the plugins
+        clFileSystemEvent event(wxEVT_FILES_MODIFIED_REPLACE_IN_FILES);
+        event.SetStrings(m_filesModified);
+        EventNotifier::Get()->AddPendingEvent(event);
+        m_filesModified.clear();
+    }
+}
+
+void ReplaceInFilesPanel::DoReplaceCompleted(const wxString& activeFile, int lineNumber)
+{
+    // hide the progress bar
+    m_progress->SetValue(0);
+    m_progress->Hide();
+    GetSizer()->Layout();
+
     // Step 2: Update the Replace pane
 
     std::set<wxString> updatedEditors;
-    delta = 0;    // offset from old line number to new
-    lastLine = 1; // points to the filename line
-    lastFile.Clear();
+    long delta = 0;    // offset from old line number to new
+    long lastLine = 1; // points to the filename line
+    wxString lastFile;
     m_sci->MarkerDeleteAll(0x7);
     m_sci->SetReadOnly(false);
     m_replaceWith->SetValue(wxEmptyString);
@@ -438,6 +548,7 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
     }
 
     // FIX bug#2770561
+    clEditor* activeEditor = activeFile.empty() ? nullptr : clMainFrame::Get()->GetMainBook()->FindEditor(activeFile);
     if(activeEditor) {
 
         clMainFrame::Get()->GetMainBook()->SelectPage(activeEditor);
@@ -446,20 +557,48 @@ void ReplaceInFilesPanel::OnReplace(wxCommandEvent& e)
         activeEditor->GotoLine(lineNumber);
     }
 
-    if(!m_filesModified.IsEmpty()) {
-        // Some files were modified directly on the file system, notify about it to the plugins
-        clFileSystemEvent event(wxEVT_FILES_MODIFIED_REPLACE_IN_FILES);
-        event.SetStrings(m_filesModified);
-        EventNotifier::Get()->AddPendingEvent(event);
-        m_filesModified.clear();
-    }
+    DoNotifyFilesModified();
 }
 
-void ReplaceInFilesPanel::OnReplaceUI(wxUpdateUIEvent& e) { e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress); }
+void ReplaceInFilesPanel::OnReplaceUI(wxUpdateUIEvent& e)
+{
+    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress && !m_replaceInProgress);
+}
 
 void ReplaceInFilesPanel::OnReplaceWithComboUI(wxUpdateUIEvent& e)
 {
-    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress);
+    e.Enable((m_sci->GetLength() > 0) && !m_searchInProgress && !m_replaceInProgress);
+}
+
+void ReplaceInFilesPanel::OnUndoReplace(wxCommandEvent& e)
+{
+    wxUnusedVar(e);
+    if(::wxMessageBox(wxString() << _("Restore the ") << m_lastChanges.size()
+                                 << _(" file(s) modified on disk by the last replace?"),
+                      _("CodeLite - Replace"), wxICON_QUESTION | wxYES_NO | wxCANCEL, this) != wxYES) {
+        return;
+    }
+
+    wxArrayString restored, failed;
+    ReplaceInFilesEngine::Undo(m_lastChanges, restored, failed);
+    m_lastChanges.clear();
+
+    m_filesModified = restored;
+    DoNotifyFilesModified();
+
+    if(!failed.IsEmpty()) {
+        wxString message;
+        message << _("The following files were modified after the replace and were not restored:\n");
+        for(const auto& file : failed) {
+            message << file << "\n";
+        }
+        ::wxMessageBox(message, _("CodeLite - Replace"), wxICON_WARNING | wxOK, this);
+    }
+}
+
+void ReplaceInFilesPanel::OnUndoReplaceUI(wxUpdateUIEvent& e)
+{
+    e.Enable(!m_lastChanges.empty() && !m_searchInProgress && !m_replaceInProgress);
 }
 
 void ReplaceInFilesPanel::OnHoldOpenUpdateUI(wxUpdateUIEvent& e)
@@ -25,6 +25,7 @@
 #ifndef __replaceinfilespanel__
 #define __replaceinfilespanel__
 
+#include "ReplaceInFilesEngine.h"
 #include "findresultstab.h"
 
 #include <wx/gauge.h>
@@ -37,16 +38,37 @@ protected:
     wxGauge* m_progress;
     wxArrayString m_filesModified;
     bool m_bmpsForDarkTheme = false;
+    ReplaceInFilesEngine* m_engine = nullptr;
+    bool m_replaceInProgress = false;
+    // incremented whenever the view content is replaced by a new search
+    size_t m_replaceId = 0;
+    // the files written by the last replace, kept for "Undo Replace"
+    ReplaceInFilesEngine::ChangeSet_t m_lastChanges;
 
 protected:
     void DoSaveResults(wxStyledTextCtrl* sci, MatchInfo_t::iterator begin, MatchInfo_t::iterator end);
     wxStyledTextCtrl* DoGetEditor(const wxString& fileName);
 
+    /**
+     * @brief update the view once all the replacements were applied and ask the user to save the modified editors
+     */
+    void DoReplaceCompleted(const wxString& activeFile, int lineNumber);
+    void DoNotifyFilesModified();
+    void OnEngineDone(size_t replaceId, ReplaceInFilesEngine::ChangeSet_t&& changes, const wxString& activeFile,
+                      int lineNumber);
+
     /*
      * @brief get replacement text (regular expression backrefs applied)
      */
     wxString DoGetReplaceWith(const SearchResult& res) const;
 
+    /**
+     * @brief the text matched by the search. The pattern of the result is truncated for long lines, so the matched
+     * text is not taken from it
+     */
+    wxString DoGetMatchedText(const SearchResult& res) const;
+    bool DoIsMatchCase(const SearchResult& res) const;
+
     // Event handlers
     virtual void OnSearchStart(wxCommandEvent& e);
     virtual void OnSearchMatch(wxCommandEvent& e);
@@ -56,11 +78,13 @@ protected:
     virtual void OnMarkAll(wxCommandEvent& e);
     virtual void OnUnmarkAll(wxCommandEvent& e);
     virtual void OnReplace(wxCommandEvent& e);
+    void OnUndoReplace(wxCommandEvent& e);
 
     virtual void OnMarkAllUI(wxUpdateUIEvent& e);
     virtual void OnUnmarkAllUI(wxUpdateUIEvent& e);
     virtual void OnReplaceUI(wxUpdateUIEvent& e);
     virtual void OnReplaceWithComboUI(wxUpdateUIEvent& e);
+    void OnUndoReplaceUI(wxUpdateUIEvent& e);
     virtual void OnHoldOpenUpdateUI(wxUpdateUIEvent& e);
     virtual void OnMouseDClick(wxStyledTextEvent& e);
 
@@ -57,6 +57,7 @@ public:
         : m_settings(settings)
         , m_outputLogFileName(wxEmptyString)
         , m_errorList()
+        , m_framePool()
     {
     }
 
@@ -66,6 +67,7 @@ protected:
     MemCheckSettings* m_settings;
     wxString m_outputLogFileName;
     ErrorList m_errorList;
+    MemCheckFramePool m_framePool; ///< owns the frames referred by the errors in m_errorList
 
 public:
     /**
@@ -95,6 +97,24 @@ public:
      * @brief Processes data from external tool (log file) to ErrorList.
      */
     virtual bool Process(const wxString& outputLogFileName = wxEmptyString) = 0;
+
+    /**
+     * @brief Prepares to read the log while the external tool is running. Previous errors and the old log file are
+     * removed.
+     */
+    virtual void StreamBegin() = 0;
+
+    /**
+     * @brief Reads what the external tool appended to the log since the last call.
+     * @return number of new errors
+     */
+    virtual size_t StreamRead() = 0;
+
+    /**
+     * @brief Reads the rest of the log, once the external tool has finished.
+     * @return true if the log was read successfully
+     */
+    virtual bool StreamEnd() = 0;
 };
 
 #endif //_IMEMCHECKPROCESSOR_H_
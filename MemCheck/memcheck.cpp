@@ -52,6 +52,7 @@ MemCheckPlugin::MemCheckPlugin(IManager* manager)
 {
     m_terminal.Bind(wxEVT_TERMINAL_COMMAND_EXIT, &MemCheckPlugin::OnProcessTerminated, this);
     m_terminal.Bind(wxEVT_TERMINAL_COMMAND_OUTPUT, &MemCheckPlugin::OnProcessOutput, this);
+    m_logTimer.Bind(wxEVT_TIMER, &MemCheckPlugin::OnLogTimer, this);
 
     // CL_DEBUG1(PLUGIN_PREFIX("MemCheckPlugin constructor"));
     m_longName = _("Detects memory management problems. Uses Valgrind - memcheck skin.");
@@ -180,6 +181,8 @@ void MemCheckPlugin::UnPlug()
     m_tabHelper.reset(NULL);
     m_terminal.Unbind(wxEVT_TERMINAL_COMMAND_EXIT, &MemCheckPlugin::OnProcessTerminated, this);
     m_terminal.Unbind(wxEVT_TERMINAL_COMMAND_OUTPUT, &MemCheckPlugin::OnProcessOutput, this);
+    m_logTimer.Stop();
+    m_logTimer.Unbind(wxEVT_TIMER, &MemCheckPlugin::OnLogTimer, this);
 
     m_mgr->GetTheApp()->Disconnect(XRCID("memcheck_check_active_project"), wxEVT_COMMAND_MENU_SELECTED,
                                    wxCommandEventHandler(MemCheckPlugin::OnCheckAtiveProject), NULL,
@@ -245,13 +248,12 @@ bool MemCheckPlugin::IsReady(wxUpdateUIEvent& event)
 
 void MemCheckPlugin::ApplySettings(bool loadLastErrors)
 {
+    // the view refers to the errors of the processor
+    m_outputView->Clear();
     wxDELETE(m_memcheckProcessor);
     m_memcheckProcessor = new ValgrindMemcheckProcessor(GetSettings());
     if(loadLastErrors) {
         m_outputView->LoadErrors();
-
-    } else {
-        m_outputView->Clear();
     }
 }
 
@@ -299,7 +301,6 @@ void MemCheckPlugin::CheckProject(const wxString& projectName)
     wxString wd;
     wxString command = PrepareCommand(projectName, wd);
 
-    m_outputView->Clear(); // To reduce the risk of confusion, clear any current errors before running
     DirSaver ds;
     EnvSetter envGuard(m_mgr->GetEnv());
     wxSetWorkingDirectory(path);
@@ -312,7 +313,12 @@ void MemCheckPlugin::CheckProject(const wxString& projectName)
     m_memcheckProcessor->GetExecutionCommand(command, cmd, cmdArgs);
     m_mgr->AppendOutputTabText(kOutputTab_Output, wxString()
                                                       << _("MemCheck command: ") << command << " " << cmdArgs << "\n");
+    // errors are shown as soon as valgrind reports them. The view refers to the errors of the previous run, clear it
+    // before they are released
+    m_outputView->Clear();
+    m_memcheckProcessor->StreamBegin();
     m_terminal.ExecuteConsole(cmd, true, cmdArgs, "", wxString::Format("MemCheck: %s", projectName));
+    m_logTimer.Start(1000);
 }
 
 void MemCheckPlugin::OnImportLog(wxCommandEvent& event)
@@ -324,6 +330,7 @@ void MemCheckPlugin::OnImportLog(wxCommandEvent& event)
     if(openFileDialog.ShowModal() == wxID_CANCEL)
         return;
 
+    m_outputView->Clear();
     wxWindowDisabler disableAll;
     wxBusyInfo wait(BUSY_MESSAGE);
     m_mgr->GetTheApp()->Yield();
@@ -363,14 +370,22 @@ void MemCheckPlugin::OnProcessOutput(clCommandEvent& event)
 void MemCheckPlugin::OnProcessTerminated(clCommandEvent& event)
 {
     m_mgr->AppendOutputTabText(kOutputTab_Output, _("\n-- MemCheck process completed\n"));
+    m_logTimer.Stop();
     wxBusyInfo wait(BUSY_MESSAGE);
     m_mgr->GetTheApp()->Yield();
 
-    m_memcheckProcessor->Process();
+    m_memcheckProcessor->StreamEnd();
     m_outputView->LoadErrors();
     SwitchToMyPage();
 }
 
+void MemCheckPlugin::OnLogTimer(wxTimerEvent& event)
+{
+    if(m_memcheckProcessor->StreamRead() > 0) {
+        m_outputView->AppendErrors();
+    }
+}
+
 void MemCheckPlugin::OnStopProcess(wxCommandEvent& event)
 {
     wxUnusedVar(event);
@@ -40,6 +40,7 @@
 #include "plugin.h"
 
 #include <wx/process.h>
+#include <wx/timer.h>
 
 class MemCheckOutputView;
 
@@ -88,6 +89,7 @@ protected:
     IMemCheckProcessor* m_memcheckProcessor;
     MemCheckSettings* m_settings;
     TerminalEmulator m_terminal;
+    wxTimer m_logTimer; ///< polls the log while the test is running
     MemCheckOutputView* m_outputView; ///< Main plugin UI pane.
     clTabTogglerHelper::Ptr_t m_tabHelper;
 
@@ -140,6 +142,10 @@ protected:
 
     void OnProcessOutput(clCommandEvent& event);
     void OnProcessTerminated(clCommandEvent& event);
+    /**
+     * @brief Reads the errors appended to the log since the last tick, while the test is running.
+     */
+    void OnLogTimer(wxTimerEvent& event);
 
     /**
      * @brief Analyse can be made independent of CodeLite and log can be load from file.
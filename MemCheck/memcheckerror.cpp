@@ -56,6 +56,27 @@ const bool MemCheckErrorLocation::isOutOfWorkspace(const wxString & workspacePat
 
 
 
+MemCheckErrorLocation* MemCheckFramePool::Intern(const MemCheckErrorLocation & location)
+{
+    wxString key = location.toString();
+    std::unordered_map<wxString, MemCheckErrorLocation*>::iterator it = m_index.find(key);
+    if (it != m_index.end())
+        return it->second;
+
+    m_frames.push_back(location);
+    MemCheckErrorLocation* frame = &m_frames.back();
+    m_index.insert(std::make_pair(key, frame));
+    return frame;
+}
+
+void MemCheckFramePool::Clear()
+{
+    m_index.clear();
+    m_frames.clear();
+}
+
+
+
 MemCheckError::MemCheckError(): suppressed(false) {}
 
 const wxString MemCheckError::toString() const
@@ -64,7 +85,7 @@ const wxString MemCheckError::toString() const
     for (ErrorList::const_iterator it = nestedErrors.begin(); it != nestedErrors.end(); ++it)
         string.Append(wxString::Format("\n%s", it->toString()));
     for (LocationList::const_iterator it = locations.begin(); it != locations.end(); ++it)
-        string.Append(wxString::Format("\n%s", it->toString()));
+        string.Append(wxString::Format("\n%s", (*it)->toString()));
     return string;
 }
 
@@ -74,7 +95,7 @@ const wxString MemCheckError::toText(unsigned int indent) const
     for (ErrorList::const_iterator it = nestedErrors.begin(); it != nestedErrors.end(); ++it)
         text.Append(wxString::Format("\n%s%s", wxString(' ', 2 * indent), it->toText(indent + 1)));
     for (LocationList::const_iterator it = locations.begin(); it != locations.end(); ++it)
-        text.Append(wxString::Format("\n%s%s", wxString(' ', 4 * indent), it->toText()));
+        text.Append(wxString::Format("\n%s%s", wxString(' ', 4 * indent), (*it)->toText()));
     return text;
 }
 
@@ -113,7 +134,7 @@ const wxString MemCheckError::getSuppression()
 const bool MemCheckError::hasPath(const wxString & path) const
 {
     for (LocationList::const_iterator it = locations.begin(); it != locations.end(); ++it)
-        if (it->file.StartsWith(path)) return true;
+        if ((*it)->file.StartsWith(path)) return true;
     for (ErrorList::const_iterator it = nestedErrors.begin(); it != nestedErrors.end(); ++it)
         if (it->hasPath(path)) return true;
     return false;
@@ -161,7 +182,7 @@ bool MemCheckIterTools::IterTool::isEqual(MemCheckError & lhs, MemCheckError & r
 MemCheckIterTools::LocationListIterator::LocationListIterator(LocationList & l,
         const IterTool &iterTool) : p(l.begin()), m_end(l.end()), m_iterTool(iterTool)
 {
-    while (p != m_end && m_iterTool.omitNonWorkspace && p->isOutOfWorkspace(m_iterTool.workspacePath))
+    while (p != m_end && m_iterTool.omitNonWorkspace && (*p)->isOutOfWorkspace(m_iterTool.workspacePath))
         ++p;
 }
 
@@ -170,7 +191,7 @@ MemCheckIterTools::LocationListIterator::~LocationListIterator() {}
 LocationList::iterator& MemCheckIterTools::LocationListIterator::operator++()
 {
     ++p;
-    while (p != m_end && m_iterTool.omitNonWorkspace && p->isOutOfWorkspace(m_iterTool.workspacePath))
+    while (p != m_end && m_iterTool.omitNonWorkspace && (*p)->isOutOfWorkspace(m_iterTool.workspacePath))
         ++p;
     return p;
 }
@@ -194,7 +215,7 @@ bool MemCheckIterTools::LocationListIterator::operator!=(const LocationList::ite
 
 MemCheckErrorLocation & MemCheckIterTools::LocationListIterator::operator*()
 {
-    return *p;
+    return **p;
 }
 
 
@@ -206,6 +227,12 @@ MemCheckIterTools::ErrorListIterator::ErrorListIterator(ErrorList & l, const Ite
         ++p;
 }
 
+MemCheckIterTools::ErrorListIterator::ErrorListIterator(ErrorList & l, ErrorList::iterator start,
+        const IterTool & iterTool)
+    : p(start), m_end(l.end()), m_iterTool(iterTool)
+{
+}
+
 MemCheckIterTools::ErrorListIterator::~ErrorListIterator() {}
 
 ErrorList::iterator& MemCheckIterTools::ErrorListIterator::operator++()
@@ -256,6 +283,11 @@ MemCheckIterTools::ErrorListIterator MemCheckIterTools::GetIterator(ErrorList &
     return ErrorListIterator(l, m_iterTool);
 }
 
+MemCheckIterTools::ErrorListIterator MemCheckIterTools::GetIterator(ErrorList & l, ErrorList::iterator start)
+{
+    return ErrorListIterator(l, start, m_iterTool);
+}
+
 MemCheckIterTools::LocationListIterator MemCheckIterTools::GetIterator(LocationList & l)
 {
     return LocationListIterator(l, m_iterTool);
@@ -267,6 +299,12 @@ MemCheckIterTools::ErrorListIterator MemCheckIterTools::Factory(ErrorList & l,
     return MemCheckIterTools(workspacePath, flags).GetIterator(l);
 }
 
+MemCheckIterTools::ErrorListIterator MemCheckIterTools::Factory(ErrorList & l, ErrorList::iterator start,
+        const wxString & workspacePath, unsigned int flags)
+{
+    return MemCheckIterTools(workspacePath, flags).GetIterator(l, start);
+}
+
 MemCheckIterTools::LocationListIterator MemCheckIterTools::Factory(LocationList & l,
         const wxString & workspacePath, unsigned int flags)
 {
@@ -39,14 +39,19 @@
 #include <wx/wx.h>
 #include <wx/tokenzr.h>
 
+#include <deque>
 #include <list>
+#include <unordered_map>
+#include <vector>
 
 #include "memcheckdefs.h"
+#include "wxStringHash.h"
 
 class MemCheckErrorLocation;
 class MemCheckError;
 
-typedef std::list<MemCheckErrorLocation> LocationList;
+/// frames are owned (and shared) by MemCheckFramePool, stacks only keep pointers to them
+typedef std::vector<MemCheckErrorLocation*> LocationList;
 typedef std::list<MemCheckError> ErrorList;
 typedef MemCheckError* MemCheckErrorPtr;
 
@@ -140,6 +145,28 @@ public:
 };
 
 
+/**
+ * @class MemCheckFramePool
+ * @brief Owns all the MemCheckErrorLocation objects of one report.
+ *
+ * Long runs report the same frames over and over again (allocators, common call paths...), so every distinct frame is
+ * stored only once and the stacks (LocationList) refer to it. Pointers remain valid until Clear() is called.
+ */
+class MemCheckFramePool
+{
+    std::deque<MemCheckErrorLocation> m_frames;
+    std::unordered_map<wxString, MemCheckErrorLocation*> m_index;
+
+public:
+    /**
+     * @brief return the pooled frame equal to location, adding it if needed
+     */
+    MemCheckErrorLocation* Intern(const MemCheckErrorLocation& location);
+    void Clear();
+    size_t GetCount() const { return m_frames.size(); }
+};
+
+
 /**
  * @class MemCheckError
  * @brief Represents one error with label, stack trace (location list), and some additional record.
@@ -252,6 +279,7 @@ public:
         IterTool m_iterTool;
     public:
         ErrorListIterator(ErrorList & l, const IterTool & iterTool);
+        ErrorListIterator(ErrorList & l, ErrorList::iterator start, const IterTool & iterTool);
         ~ErrorListIterator();
         ErrorList::iterator& operator++();
         ErrorList::iterator operator++(int);
@@ -269,6 +297,7 @@ protected:
     MemCheckIterTools(const wxString & workspacePath, unsigned int flags);
 
     ErrorListIterator GetIterator(ErrorList & l);
+    ErrorListIterator GetIterator(ErrorList & l, ErrorList::iterator start);
     LocationListIterator GetIterator(LocationList & l);
 
 public:
@@ -282,6 +311,19 @@ public:
      * This method calls MemCheckIterTools constructor and then GetIterator method.
      */
     static ErrorListIterator Factory(ErrorList & l, const wxString & workspacePath, unsigned int flags);
+
+    /**
+     * @brief Creates iterator which resumes an iteration made with the same settings.
+     * @param l list to iterate over
+     * @param start item returned by the previous iteration, the new iterator points to it
+     * @param workspacePath
+     * @param flags MC_IT_OMIT_NONWORKSPACE | MC_IT_OMIT_DUPLICATIONS | MC_IT_OMIT_SUPPRESSED
+     * @return iterator over ErrorList
+     *
+     * Errors are appended to ErrorList while the test is running, this allows to visit only the new ones.
+     */
+    static ErrorListIterator Factory(ErrorList & l, ErrorList::iterator start, const wxString & workspacePath,
+                                     unsigned int flags);
     
     /**
      * @brief Creates iterator with holds settings and does iteration.
@@ -16,6 +16,7 @@
 #include "stringsearcher.h"
 #include "workspace.h"
 
+#include <memory>
 #include <wx/busyinfo.h>
 #include <wx/clipbrd.h>
 #include <wx/stc/stc.h>
@@ -25,6 +26,10 @@ MemCheckOutputView::MemCheckOutputView(wxWindow* parent, MemCheckPlugin* plugin,
     , m_plugin(plugin)
     , m_mgr(mgr)
     , pageValidator(&m_currentPage)
+    , m_totalErrorsView(0)
+    , m_currentPage(0)
+    , m_pageMax(0)
+    , m_countedView(false)
 {
     int col = GetColumnByName(_("Label"));
     if(col == wxNOT_FOUND) {
@@ -83,6 +88,54 @@ void MemCheckOutputView::LoadErrors()
     ApplyFilterSupp(FILTER_CLEAR);
 }
 
+void MemCheckOutputView::AppendErrors()
+{
+    if(!m_countedView) {
+        if(m_mgr->IsWorkspaceOpen())
+            m_workspacePath =
+                m_mgr->GetWorkspace()->GetWorkspaceFileName().GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR);
+        else
+            m_workspacePath = wxEmptyString;
+    }
+
+    ErrorList& errorList = m_plugin->GetProcessor()->GetErrors();
+
+    unsigned int flags = 0;
+    if(m_plugin->GetSettings()->GetOmitNonWorkspace())
+        flags |= MC_IT_OMIT_NONWORKSPACE;
+    if(m_plugin->GetSettings()->GetOmitDuplications())
+        flags |= MC_IT_OMIT_DUPLICATIONS;
+    if(m_plugin->GetSettings()->GetOmitSuppressed())
+        flags |= MC_IT_OMIT_SUPPRESSED;
+
+    // errors with index in [pageStart, pageStop) belong to the current page, which is page 1 until there is one
+    size_t pageSize = m_plugin->GetSettings()->GetResultPageSize();
+    size_t pageStart = m_currentPage ? (m_currentPage - 1) * pageSize : 0;
+    size_t pageStop = pageStart + pageSize;
+
+    MemCheckIterTools::ErrorListIterator it =
+        m_countedView ? MemCheckIterTools::Factory(errorList, m_lastErrorView, m_workspacePath, flags)
+                      : MemCheckIterTools::Factory(errorList, m_workspacePath, flags);
+    if(m_countedView)
+        ++it; // m_lastErrorView was counted by the previous call
+
+    while(it != errorList.end()) {
+        m_lastErrorView = it++;
+        m_countedView = true;
+        if(m_totalErrorsView >= pageStart && m_totalErrorsView < pageStop) {
+            AddTree(wxDataViewItem(0), *m_lastErrorView);
+            m_currentPageIsEmptyView = false;
+        }
+        ++m_totalErrorsView;
+    }
+
+    UpdatePagesView();
+    if(m_currentPage == 0 && m_totalErrorsView) {
+        m_currentPage = 1;
+        pageValidator.TransferToWindow();
+    }
+}
+
 void MemCheckOutputView::ResetItemsView()
 {
     ErrorList& errorList = m_plugin->GetProcessor()->GetErrors();
@@ -96,11 +149,20 @@ void MemCheckOutputView::ResetItemsView()
         flags |= MC_IT_OMIT_SUPPRESSED;
 
     m_totalErrorsView = 0;
+    m_countedView = false;
     for(MemCheckIterTools::ErrorListIterator it = MemCheckIterTools::Factory(errorList, m_workspacePath, flags);
-        it != errorList.end(); ++it) {
+        it != errorList.end();) {
+        m_lastErrorView = it++;
+        m_countedView = true;
         ++m_totalErrorsView;
     }
 
+    UpdatePagesView();
+    itemsInvalidView = false;
+}
+
+void MemCheckOutputView::UpdatePagesView()
+{
     if(m_totalErrorsView)
         m_pageMax = (m_totalErrorsView - 1) / m_plugin->GetSettings()->GetResultPageSize() + 1;
     else
@@ -112,7 +174,6 @@ void MemCheckOutputView::ResetItemsView()
     pageValidator.SetRange(1, m_pageMax);
     m_textCtrlPageNumber->SetValidator(pageValidator);
     pageValidator.SetWindow(m_textCtrlPageNumber);
-    itemsInvalidView = false;
 }
 
 void MemCheckOutputView::ResetItemsSupp()
@@ -131,7 +192,7 @@ void MemCheckOutputView::ResetItemsSupp()
     m_lastToolTipItem = wxNOT_FOUND;
 }
 
-void MemCheckOutputView::ShowPageView(size_t page)
+void MemCheckOutputView::ShowPageView(size_t page, bool showBusy)
 {
     // CL_DEBUG1(PLUGIN_PREFIX("MemCheckOutputView::ShowPage()"));
 
@@ -166,9 +227,13 @@ void MemCheckOutputView::ShowPageView(size_t page)
     if(m_currentPageIsEmptyView)
         return;
 
-    wxWindowDisabler disableAll;
-    wxBusyInfo wait(BUSY_MESSAGE);
-    m_mgr->GetTheApp()->Yield();
+    std::unique_ptr<wxWindowDisabler> disableAll;
+    std::unique_ptr<wxBusyInfo> wait;
+    if(showBusy) {
+        disableAll.reset(new wxWindowDisabler());
+        wait.reset(new wxBusyInfo(BUSY_MESSAGE));
+        m_mgr->GetTheApp()->Yield();
+    }
 
     unsigned int flags = 0;
     if(m_plugin->GetSettings()->GetOmitNonWorkspace())
@@ -1007,8 +1072,21 @@ void MemCheckOutputView::OnSuppPanelUI(wxUpdateUIEvent& event)
 
 void MemCheckOutputView::Clear()
 {
+    // errors panel
     m_dataViewCtrlErrorsModel->Clear();
+    m_currentItem = wxDataViewItem(0);
+    m_currentPageIsEmptyView = true;
+    m_currentPage = 0;
+    m_totalErrorsView = 0;
+    m_countedView = false;
+    UpdatePagesView();
+    m_textCtrlPageNumber->Clear();
+
+    // supp panel
+    m_filterResults.clear();
     m_listCtrlErrors->DeleteAllItems();
+    m_totalErrorsSupp = 0;
+    m_lastToolTipItem = wxNOT_FOUND;
 }
 void MemCheckOutputView::OnStop(wxCommandEvent& event) { m_plugin->StopProcess(); }
 void MemCheckOutputView::OnStopUI(wxUpdateUIEvent& event) { event.Enable(m_plugin->IsRunning()); }
@@ -124,6 +124,9 @@ protected:
     size_t m_totalErrorsView;
     size_t m_currentPage;
     size_t m_pageMax;
+    bool m_countedView; ///< m_lastErrorView is set
+    ErrorList::iterator m_lastErrorView; ///< last error counted in m_totalErrorsView, AppendErrors() counts the errors after it
+    void UpdatePagesView(); ///< update page counter and validator after m_totalErrorsView changed
 
     wxDataViewItem GetTopParent(wxDataViewItem item); ///< get top level item for an item
     wxDataViewItem GetLeaf(const wxDataViewItem &item, bool first); ///< get deepes item for an item(error), first == true means firts from top, first==false means last.
@@ -135,7 +138,7 @@ protected:
     void GetStatusOfErrors(bool& unmarked, bool& marked); // Are there any unmarked, any marked errors?
     unsigned int GetColumnByName(const wxString & name); ///< Finds index of an wxDVC column by its caption
     void JumpToLocation(const wxDataViewItem &item); ///< Opens file specifieed in particular ErrorLocation in editor
-    void ShowPageView(size_t page); ///< Item could be more than is good for wxDVC. So paging is implementetd. This method fills wxDVC with portion of errors.
+    void ShowPageView(size_t page, bool showBusy = true); ///< Item could be more than is good for wxDVC. So paging is implementetd. This method fills wxDVC with portion of errors.
     void AddTree(const wxDataViewItem & parentItem, MemCheckError & error); ///< Adds one error and all its location into wxDVC as tree
     void OnJumpToLocation(wxCommandEvent & event); ///< Callback from wxDVC popupmenu
     void OnMarkAllErrors(wxCommandEvent & event); ///< Callback from wxDVC popupmenu
@@ -172,7 +175,15 @@ public:
      */
     void LoadErrors();
     /**
-     * @brief clear the content
+     * @brief Errors were appended to ErrorList while the test is still running.
+     *
+     * Only the new errors are visited: the page counters are updated and the errors that belong to the current page
+     * are added to it. The supp page is loaded by LoadErrors() once the test ends.
+     */
+    void AppendErrors();
+    /**
+     * @brief clear the content. Both pages refer to the errors held by the processor, this must be called before
+     * the processor releases them
      */
     void Clear();
 };
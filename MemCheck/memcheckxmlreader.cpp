@@ -0,0 +1,199 @@
+/**
+ * @file
+ * @copyright GNU General Public License v2
+ */
+
+#include "memcheckxmlreader.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+/// append the UTF-8 encoding of a code point
+void AppendUTF8(std::string& str, unsigned long cp)
+{
+    if(cp < 0x80) {
+        str += (char)cp;
+    } else if(cp < 0x800) {
+        str += (char)(0xC0 | (cp >> 6));
+        str += (char)(0x80 | (cp & 0x3F));
+    } else if(cp < 0x10000) {
+        str += (char)(0xE0 | (cp >> 12));
+        str += (char)(0x80 | ((cp >> 6) & 0x3F));
+        str += (char)(0x80 | (cp & 0x3F));
+    } else {
+        str += (char)(0xF0 | (cp >> 18));
+        str += (char)(0x80 | ((cp >> 12) & 0x3F));
+        str += (char)(0x80 | ((cp >> 6) & 0x3F));
+        str += (char)(0x80 | (cp & 0x3F));
+    }
+}
+
+bool IsNameEnd(char ch) { return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == '/' || ch == '>'; }
+} // namespace
+
+MemCheckXmlReader::MemCheckXmlReader(Handler* handler)
+    : m_handler(handler)
+    , m_pos(0)
+{
+}
+
+void MemCheckXmlReader::Reset()
+{
+    m_buffer.clear();
+    m_pos = 0;
+    m_text.clear();
+    m_path.clear();
+}
+
+void MemCheckXmlReader::Feed(const char* data, size_t len)
+{
+    m_buffer.append(data, len);
+    Parse();
+
+    // drop what was consumed
+    m_buffer.erase(0, m_pos);
+    m_pos = 0;
+}
+
+void MemCheckXmlReader::AppendText(const char* text, size_t len)
+{
+    const char* end = text + len;
+    while(text < end) {
+        const char* amp = (const char*)std::memchr(text, '&', end - text);
+        if(!amp) {
+            m_text.append(text, end - text);
+            return;
+        }
+        m_text.append(text, amp - text);
+
+        const char* semi = (const char*)std::memchr(amp, ';', end - amp);
+        if(!semi) {
+            // not an entity, keep it as is
+            m_text.append(amp, end - amp);
+            return;
+        }
+
+        std::string entity(amp + 1, semi - amp - 1);
+        if(entity == "lt") {
+            m_text += '<';
+        } else if(entity == "gt") {
+            m_text += '>';
+        } else if(entity == "amp") {
+            m_text += '&';
+        } else if(entity == "quot") {
+            m_text += '"';
+        } else if(entity == "apos") {
+            m_text += '\'';
+        } else if(entity.length() > 1 && entity[0] == '#') {
+            bool hex = entity[1] == 'x' || entity[1] == 'X';
+            unsigned long cp = std::strtoul(entity.c_str() + (hex ? 2 : 1), nullptr, hex ? 16 : 10);
+            AppendUTF8(m_text, cp);
+        } else {
+            m_text.append(amp, semi - amp + 1);
+        }
+        text = semi + 1;
+    }
+}
+
+bool MemCheckXmlReader::IsIncompletePrefix(const char* seq) const
+{
+    size_t avail = m_buffer.size() - m_pos;
+    return avail < std::strlen(seq) && m_buffer.compare(m_pos, avail, seq, avail) == 0;
+}
+
+size_t MemCheckXmlReader::FindTagEnd(size_t from) const
+{
+    char quote = 0;
+    for(size_t i = from; i < m_buffer.size(); ++i) {
+        char ch = m_buffer[i];
+        if(quote) {
+            if(ch == quote) {
+                quote = 0;
+            }
+        } else if(ch == '"' || ch == '\'') {
+            quote = ch;
+        } else if(ch == '>') {
+            return i;
+        }
+    }
+    return std::string::npos;
+}
+
+void MemCheckXmlReader::Parse()
+{
+    while(m_pos < m_buffer.size()) {
+        if(m_buffer[m_pos] != '<') {
+            // text node: it is complete only once we see the next tag (entities can not be split then)
+            size_t lt = m_buffer.find('<', m_pos);
+            if(lt == std::string::npos) {
+                return;
+            }
+            AppendText(m_buffer.c_str() + m_pos, lt - m_pos);
+            m_pos = lt;
+            continue;
+        }
+
+        if(m_buffer.compare(m_pos, 4, "<!--") == 0) {
+            size_t end = m_buffer.find("-->", m_pos + 4);
+            if(end == std::string::npos) {
+                return;
+            }
+            m_pos = end + 3;
+
+        } else if(m_buffer.compare(m_pos, 9, "<![CDATA[") == 0) {
+            size_t end = m_buffer.find("]]>", m_pos + 9);
+            if(end == std::string::npos) {
+                return;
+            }
+            m_text.append(m_buffer, m_pos + 9, end - m_pos - 9);
+            m_pos = end + 3;
+
+        } else if(IsIncompletePrefix("<![CDATA[") || IsIncompletePrefix("<!--")) {
+            // a comment or a CDATA section split in the middle of its opening sequence
+            return;
+
+        } else if(m_buffer.compare(m_pos, 2, "<?") == 0 || m_buffer.compare(m_pos, 2, "<!") == 0) {
+            // processing instruction or DOCTYPE
+            size_t end = FindTagEnd(m_pos + 2);
+            if(end == std::string::npos) {
+                return;
+            }
+            m_pos = end + 1;
+
+        } else if(m_buffer.compare(m_pos, 2, "</") == 0) {
+            size_t end = FindTagEnd(m_pos + 2);
+            if(end == std::string::npos) {
+                return;
+            }
+            if(!m_path.empty()) {
+                m_handler->OnEndElement(m_path, m_text);
+                m_path.pop_back();
+            }
+            m_text.clear();
+            m_pos = end + 1;
+
+        } else {
+            size_t end = FindTagEnd(m_pos + 1);
+            if(end == std::string::npos) {
+                return;
+            }
+
+            size_t nameEnd = m_pos + 1;
+            while(nameEnd < end && !IsNameEnd(m_buffer[nameEnd])) {
+                ++nameEnd;
+            }
+
+            bool selfClosing = m_buffer[end - 1] == '/';
+            m_path.push_back(m_buffer.substr(m_pos + 1, nameEnd - m_pos - 1));
+            m_text.clear();
+            m_handler->OnStartElement(m_path);
+            if(selfClosing) {
+                m_handler->OnEndElement(m_path, m_text);
+                m_path.pop_back();
+            }
+            m_pos = end + 1;
+        }
+    }
+}
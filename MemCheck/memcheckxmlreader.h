@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @copyright GNU General Public License v2
+ */
+
+#ifndef _MEMCHECKXMLREADER_H_
+#define _MEMCHECKXMLREADER_H_
+
+#include <string>
+#include <vector>
+
+/**
+ * @class MemCheckXmlReader
+ * @brief Minimal streaming (SAX-like) XML reader for tool logs.
+ *
+ * The document is fed in chunks of any size, e.g. while the tool is still writing it. Only what is needed for tool
+ * logs is supported: elements, text, CDATA sections and the predefined/numeric entities. Attributes, comments,
+ * processing instructions and DOCTYPE are skipped. Everything is kept as UTF-8, memory use is bounded by the largest
+ * text node, not by the document size.
+ */
+class MemCheckXmlReader
+{
+public:
+    class Handler
+    {
+    public:
+        virtual ~Handler() = default;
+        /**
+         * @brief an element was opened
+         * @param path names of the open elements, path.back() is the new element
+         */
+        virtual void OnStartElement(const std::vector<std::string>& path) = 0;
+        /**
+         * @brief an element was closed
+         * @param path names of the open elements, path.back() is the element being closed
+         * @param text text content of the element (meaningful for leaf elements only)
+         */
+        virtual void OnEndElement(const std::vector<std::string>& path, const std::string& text) = 0;
+    };
+
+    explicit MemCheckXmlReader(Handler* handler);
+
+    /**
+     * @brief parse the next chunk of the document. The chunk may end anywhere, the incomplete part is kept for the
+     * next call
+     */
+    void Feed(const char* data, size_t len);
+
+    /**
+     * @brief forget all the state, ready to read a new document
+     */
+    void Reset();
+
+    /**
+     * @brief number of bytes buffered and not parsed yet
+     */
+    size_t GetPending() const { return m_buffer.size() - m_pos; }
+
+protected:
+    /// parse what is available in m_buffer
+    void Parse();
+    /// append text (with entities) to the current text node
+    void AppendText(const char* text, size_t len);
+    /// find the end of a tag starting at m_buffer[from], honoring quoted attribute values
+    size_t FindTagEnd(size_t from) const;
+    /// true if the unparsed input is a strict prefix of seq (i.e. we need more input to decide)
+    bool IsIncompletePrefix(const char* seq) const;
+
+    Handler* m_handler;
+    std::string m_buffer;
+    size_t m_pos;
+    std::string m_text;
+    std::vector<std::string> m_path;
+};
+
+#endif // _MEMCHECKXMLREADER_H_
@@ -12,11 +12,37 @@
 #include "memchecksettings.h"
 #include "workspace.h"
 
+#include <cstdlib>
+#include <wx/ffile.h>
+#include <wx/filename.h>
 #include <wx/stdpaths.h>
 #include <wx/textfile.h>
 
+namespace
+{
+const size_t READ_CHUNK_SIZE = 1024 * 1024;
+/// upper limit of bytes parsed per StreamRead() call, so the UI stays responsive while the tool is running
+const size_t STREAM_READ_LIMIT = 16 * READ_CHUNK_SIZE;
+
+inline wxString ToWx(const std::string& str) { return wxString::FromUTF8(str.c_str(), str.length()); }
+
+/// true if path ends with "... parent/name"
+inline bool IsElement(const std::vector<std::string>& path, const char* parent, const char* name)
+{
+    size_t n = path.size();
+    return n >= 2 && path[n - 1] == name && path[n - 2] == parent;
+}
+} // namespace
+
 ValgrindMemcheckProcessor::ValgrindMemcheckProcessor(MemCheckSettings* const settings)
     : IMemCheckProcessor(settings)
+    , m_reader(this)
+    , m_readOffset(0)
+    , m_streaming(false)
+    , m_validRoot(false)
+    , m_newErrors(0)
+    , m_hasAuxiliary(false)
+    , m_hasXwhatText(false)
 {
 }
 
@@ -60,6 +86,37 @@ void ValgrindMemcheckProcessor::GetExecutionCommand(const wxString& originalComm
         suppresions, m_settings->GetValgrindSettings().GetOptions(), originalCommand);
 }
 
+void ValgrindMemcheckProcessor::Reset()
+{
+    m_reader.Reset();
+    m_errorList.clear();
+    m_framePool.Clear();
+    m_readOffset = 0;
+    m_validRoot = false;
+    m_newErrors = 0;
+}
+
+wxFileOffset ValgrindMemcheckProcessor::ReadChunk(size_t maxBytes)
+{
+    wxFFile fp(m_outputLogFileName, "rb");
+    if(!fp.IsOpened() || !fp.Seek(m_readOffset)) {
+        return wxInvalidOffset;
+    }
+
+    std::vector<char> buffer(READ_CHUNK_SIZE);
+    wxFileOffset total = 0;
+    while((size_t)total < maxBytes) {
+        size_t count = fp.Read(buffer.data(), buffer.size());
+        if(count == 0) {
+            break;
+        }
+        m_reader.Feed(buffer.data(), count);
+        total += count;
+    }
+    m_readOffset += total;
+    return total;
+}
+
 bool ValgrindMemcheckProcessor::Process(const wxString& outputLogFileName)
 {
     // CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::Process()"));
@@ -67,136 +124,157 @@ bool ValgrindMemcheckProcessor::Process(const wxString& outputLogFileName)
     if(!outputLogFileName.IsEmpty())
         m_outputLogFileName = outputLogFileName;
 
-    wxXmlDocument doc;
-    if(!doc.Load(m_outputLogFileName) || doc.GetRoot()->GetName() != wxT("valgrindoutput")) {
+    m_streaming = false;
+    Reset();
+    if(!wxFileName::FileExists(m_outputLogFileName)) {
         return false;
     }
-    m_errorList.clear();
 
-    int i = 0;
-    wxXmlNode* errorNode = doc.GetRoot()->GetChildren();
-    while(errorNode) {
-        if(errorNode->GetName() == wxT("error")) {
-            m_errorList.push_back(ProcessError(doc, errorNode));
-        }
-        errorNode = errorNode->GetNext();
-
-        if(i < 1000)
-            i++;
-        else {
-            i = 0;
-            // ATTN  m_mgr->GetTheApp()
-            wxTheApp->Yield();
-        }
+    wxFileOffset count = 0;
+    while((count = ReadChunk(READ_CHUNK_SIZE)) > 0) {
+        // ATTN  m_mgr->GetTheApp()
+        wxTheApp->Yield();
+    }
+
+    if(count == wxInvalidOffset || !m_validRoot) {
+        Reset();
+        return false;
     }
     return true;
 }
 
-MemCheckError ValgrindMemcheckProcessor::ProcessError(wxXmlDocument& doc, wxXmlNode* errorNode)
+void ValgrindMemcheckProcessor::StreamBegin()
+{
+    Reset();
+    // valgrind will create it again, make sure we don't read the log of the previous run meanwhile
+    if(!m_outputLogFileName.IsEmpty() && wxFileName::FileExists(m_outputLogFileName)) {
+        wxRemoveFile(m_outputLogFileName);
+    }
+    m_streaming = true;
+}
+
+size_t ValgrindMemcheckProcessor::StreamRead()
 {
-    // CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::ProcessError()"));
+    if(!m_streaming || !wxFileName::FileExists(m_outputLogFileName)) {
+        return 0;
+    }
 
-    bool auxiliary = false;
-    MemCheckError result;
-    result.type = MemCheckError::TYPE_ERROR;
-    MemCheckError auxiliaryResult;
+    m_newErrors = 0;
+    ReadChunk(STREAM_READ_LIMIT);
+    return m_newErrors;
+}
 
-    wxXmlNode* suberrorNode = errorNode->GetChildren();
-    while(suberrorNode) {
+bool ValgrindMemcheckProcessor::StreamEnd()
+{
+    if(!m_streaming) {
+        // we were not following this run (e.g. settings were changed meanwhile), read the whole log
+        return Process();
+    }
+    m_streaming = false;
 
-        // retrieving error label
-        if(suberrorNode->GetName() == wxT("what")) {
-            result.label = suberrorNode->GetNodeContent();
-        } else if(suberrorNode->GetName() == wxT("xwhat")) {
-            wxXmlNode* child = suberrorNode->GetChildren();
-            while(child) {
-                if(child->GetName() == wxT("text")) {
-                    result.label = child->GetNodeContent();
-                    break;
-                }
-                child = child->GetNext();
-            }
-        } else if(suberrorNode->GetName() == wxT("auxwhat")) {
-            auxiliaryResult.label = suberrorNode->GetNodeContent();
-            auxiliaryResult.type = MemCheckError::TYPE_AUXILIARY;
-            auxiliary = true;
-        } else if(suberrorNode->GetName() == wxT("stack")) {
-            wxXmlNode* locationNode = suberrorNode->GetChildren();
-            while(locationNode) {
-                if(locationNode->GetName() == wxT("frame")) {
-                    if(auxiliary) {
-                        auxiliaryResult.locations.push_back(ProcessLocation(doc, locationNode));
-                    } else {
-                        result.locations.push_back(ProcessLocation(doc, locationNode));
-                    }
-                }
-                locationNode = locationNode->GetNext();
-            }
-        } else if(suberrorNode->GetName() == wxT("suppression")) {
-            wxXmlNode* child = suberrorNode->GetChildren();
-            while(child) {
-                if(child->GetName() == wxT("rawtext")) {
-                    result.suppression = child->GetNodeContent();
-                    break;
-                }
-                child = child->GetNext();
-            }
-        }
-        suberrorNode = suberrorNode->GetNext();
+    wxFileOffset count = 0;
+    while((count = ReadChunk(READ_CHUNK_SIZE)) > 0) {
+        wxTheApp->Yield();
     }
 
-    if(!result.suppression)
-        result.suppression = wxT("#Suppresion pattern not present in output log.\n#This plugin requires Valgrind to be "
-                                 "run with '--gen-suppressions=all' option");
+    if(!m_validRoot) {
+        clWARNING() << "MemCheck: log file" << m_outputLogFileName << "is not a valid valgrind xml output" << endl;
+        return false;
+    }
+    if(m_reader.GetPending() > 0) {
+        clDEBUG() << "MemCheck: log file" << m_outputLogFileName << "ends with an incomplete element" << endl;
+    }
+    clDEBUG() << "MemCheck:" << m_errorList.size() << "errors," << m_framePool.GetCount() << "unique frames" << endl;
+    return true;
+}
 
-    if(auxiliary)
-        result.nestedErrors.push_back(auxiliaryResult);
+void ValgrindMemcheckProcessor::OnStartElement(const std::vector<std::string>& path)
+{
+    if(path.size() == 1) {
+        m_validRoot = path[0] == "valgrindoutput";
+        return;
+    }
 
-    // TODO ? add checout ?
-    // add check for empty locationArrays
-    //  CL_DEBUG1(PLUGIN_PREFIX("\t equal #0 and #1 = %s", (errorArray.Item(0) == errorArray.Item(1)?"true":"false") ));
-    //  CL_DEBUG1(PLUGIN_PREFIX("\t equal #1 and #2 = %s", (*(errorArray.Item(2)) ==
-    //  *(errorArray.Item(1))?"true":"false") )); CL_DEBUG1(PLUGIN_PREFIX("\t equal #2 and #3 = %s", (errorArray.Item(2)
-    //  == errorArray.Item(3)?"true":"false") ));
+    if(path.size() == 2 && path[1] == "error") {
+        m_error = MemCheckError();
+        m_error.type = MemCheckError::TYPE_ERROR;
+        m_auxiliary = MemCheckError();
+        m_hasAuxiliary = false;
+        m_hasXwhatText = false;
 
-    // check if required fields was found
-    //  CL_ERROR1(PLUGIN_PREFIX("Broken input, tag <what> or <xwhat> not found, can't continue!"));
-    //  CL_ERROR1(PLUGIN_PREFIX("Broken input, tag <stack> not found, can't continue!"));
-    return result;
+    } else if(IsElement(path, "stack", "frame")) {
+        m_location = MemCheckErrorLocation();
+        m_location.line = -1;
+        m_locationDir.clear();
+        m_locationFile.clear();
+    }
 }
 
-MemCheckErrorLocation ValgrindMemcheckProcessor::ProcessLocation(wxXmlDocument& doc, wxXmlNode* locationNode)
+void ValgrindMemcheckProcessor::OnEndElement(const std::vector<std::string>& path, const std::string& text)
 {
-    // CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::ProcessLocation()"));
+    if(!m_validRoot || path.size() < 2 || path[1] != "error") {
+        return;
+    }
 
-    MemCheckErrorLocation result;
-    result.line = -1;
-    wxString file;
-    wxString dir;
+    const std::string& name = path.back();
+    if(path.size() == 2) {
+        // </error>
+        if(!m_error.suppression)
+            m_error.suppression =
+                wxT("#Suppresion pattern not present in output log.\n#This plugin requires Valgrind to be "
+                    "run with '--gen-suppressions=all' option");
 
-    wxXmlNode* subframeNode = locationNode->GetChildren();
-    while(subframeNode) {
+        if(m_hasAuxiliary)
+            m_error.nestedErrors.push_back(m_auxiliary);
 
-        if(subframeNode->GetName() == wxT("ip")) {
-            // ignoring
-        } else if(subframeNode->GetName() == wxT("obj")) {
-            result.obj = subframeNode->GetNodeContent();
-        } else if(subframeNode->GetName() == wxT("fn")) {
-            result.func = subframeNode->GetNodeContent();
-        } else if(subframeNode->GetName() == wxT("dir")) {
-            dir = subframeNode->GetNodeContent();
-        } else if(subframeNode->GetName() == wxT("file")) {
-            file = subframeNode->GetNodeContent();
-        } else if(subframeNode->GetName() == wxT("line")) {
-            result.line = wxAtoi(subframeNode->GetNodeContent());
+        m_errorList.push_back(MemCheckError());
+        std::swap(m_errorList.back(), m_error);
+        ++m_newErrors;
+
+    } else if(path.size() == 3) {
+        // retrieving error label
+        if(name == "what") {
+            m_error.label = ToWx(text);
+        } else if(name == "auxwhat") {
+            m_auxiliary.label = ToWx(text);
+            m_auxiliary.type = MemCheckError::TYPE_AUXILIARY;
+            m_hasAuxiliary = true;
+        }
+
+    } else if(IsElement(path, "xwhat", "text")) {
+        if(!m_hasXwhatText) {
+            m_error.label = ToWx(text);
+            m_hasXwhatText = true;
         }
-        subframeNode = subframeNode->GetNext();
-    }
 
-    if(!dir.IsEmpty() && !dir.EndsWith(wxT("/")))
-        dir.Append(wxT("/"));
-    result.file = dir + file;
+    } else if(IsElement(path, "suppression", "rawtext")) {
+        m_error.suppression = ToWx(text);
 
-    // TODO ? add checkout ?
-    return result;
+    } else if(IsElement(path, "stack", "frame")) {
+        if(!m_locationDir.IsEmpty() && !m_locationDir.EndsWith(wxT("/")))
+            m_locationDir.Append(wxT("/"));
+        m_location.file = m_locationDir + m_locationFile;
+
+        MemCheckErrorLocation* frame = m_framePool.Intern(m_location);
+        if(m_hasAuxiliary) {
+            m_auxiliary.locations.push_back(frame);
+        } else {
+            m_error.locations.push_back(frame);
+        }
+
+    } else if(path.size() >= 2 && path[path.size() - 2] == "frame") {
+        if(name == "ip") {
+            // ignoring
+        } else if(name == "obj") {
+            m_location.obj = ToWx(text);
+        } else if(name == "fn") {
+            m_location.func = ToWx(text);
+        } else if(name == "dir") {
+            m_locationDir = ToWx(text);
+        } else if(name == "file") {
+            m_locationFile = ToWx(text);
+        } else if(name == "line") {
+            m_location.line = std::atoi(text.c_str());
+        }
+    }
 }
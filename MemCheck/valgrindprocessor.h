@@ -34,7 +34,7 @@
 #define _VALGRINDPROCESSOR_H_
 
 #include "imemcheckprocessor.h"
-#include <wx/xml/xml.h>
+#include "memcheckxmlreader.h"
 
 /**
  * @class ValgrindMemcheckProcessor
@@ -42,7 +42,7 @@
  *
  * Settings for this parset is implemented in global settings. It could be moved here or to own file.
  */
-class ValgrindMemcheckProcessor : public IMemCheckProcessor
+class ValgrindMemcheckProcessor : public IMemCheckProcessor, public MemCheckXmlReader::Handler
 {
 public:
     /**
@@ -74,29 +74,65 @@ public:
      * @param outputLogFileName
      * @return
      *
-     * Loads Valgrind's xml log to wxXmlDocument, and goes trought nodes
+     * Reads Valgrind's xml log in chunks and emits errors as soon as they are complete, the whole document is never
+     * held in memory.
      */
     virtual bool Process(const wxString& outputLogFileName = wxEmptyString);
 
+    /**
+     * @brief interface implementation
+     */
+    virtual void StreamBegin();
+
+    /**
+     * @brief interface implementation
+     */
+    virtual size_t StreamRead();
+
+    /**
+     * @brief interface implementation
+     */
+    virtual bool StreamEnd();
+
 protected:
     /**
-     * @brief creates one MemCheckError object
-     * @param doc whole log document
-     * @param errorNode reference to current processed node in that doc file
-     * @return MemCheckError object
-     *
-     * Auxiliary section is not in subnode. First part of the node describes particular error, second part describes
-     * auxiliary info. For auxiliary is created sub MemCheckError object.
+     * @brief reset the parser and the error list, ready to read a new log
+     */
+    void Reset();
+
+    /**
+     * @brief read (at most maxBytes) new bytes from the log file and feed them to the parser
+     * @return number of bytes read, or wxInvalidOffset on error
      */
-    MemCheckError ProcessError(wxXmlDocument& doc, wxXmlNode* errorNode);
+    wxFileOffset ReadChunk(size_t maxBytes);
 
     /**
-     * @brief creates one MemCheckErrorLocation object
-     * @param doc whole log document
-     * @param locationNode reference to current processed node in that doc file
-     * @return MemCheckErrorLocation object
+     * @brief MemCheckXmlReader::Handler implementation, tracks error and frame elements
      */
-    MemCheckErrorLocation ProcessLocation(wxXmlDocument& doc, wxXmlNode* locationNode);
+    virtual void OnStartElement(const std::vector<std::string>& path);
+
+    /**
+     * @brief MemCheckXmlReader::Handler implementation
+     *
+     * Auxiliary section is not in subnode. First part of the error describes particular error, second part describes
+     * auxiliary info. For auxiliary is created sub MemCheckError object. Frames are interned in the frame pool.
+     */
+    virtual void OnEndElement(const std::vector<std::string>& path, const std::string& text);
+
+    MemCheckXmlReader m_reader;
+    wxFileOffset m_readOffset; ///< how much of the log was read so far
+    bool m_streaming;          ///< true between StreamBegin and StreamEnd
+    bool m_validRoot;          ///< the document root is <valgrindoutput>
+    size_t m_newErrors;        ///< errors emitted since the last StreamRead
+
+    // state of the error being parsed
+    MemCheckError m_error;
+    MemCheckError m_auxiliary;
+    bool m_hasAuxiliary;
+    bool m_hasXwhatText;
+    MemCheckErrorLocation m_location;
+    wxString m_locationDir;
+    wxString m_locationFile;
 };
 
 #endif // _VALGRINDPROCESSOR_H_
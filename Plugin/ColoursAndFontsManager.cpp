@@ -16,8 +16,12 @@
 
 #include <algorithm>
 #include <wx/busyinfo.h>
+#include <wx/datstrm.h>
 #include <wx/dir.h>
+#include <wx/ffile.h>
 #include <wx/filename.h>
+#include <wx/log.h>
+#include <wx/mstream.h>
 #include <wx/msgdlg.h>
 #include <wx/settings.h>
 #include <wx/sstream.h>
@@ -30,6 +34,25 @@ namespace
 {
 constexpr const char* LEXERS_VERSION_STRING = "LexersVersion";
 constexpr int LEXERS_VERSION = 10;
+
+const wxUint32 LEXERS_CACHE_MAGIC = 0x584c4c43; // "CLLX"
+// bump this whenever the binary format of LexerConf changes
+const wxUint32 LEXERS_CACHE_VERSION = 1;
+
+bool ReadFileBytes(const wxFileName& fn, wxMemoryBuffer& buffer)
+{
+    wxLogNull noLog;
+    wxFFile fp(fn.GetFullPath(), "rb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
+    wxFileOffset len = fp.Length();
+    if (len <= 0 || fp.Read(buffer.GetWriteBuf(len), len) != (size_t)len) {
+        return false;
+    }
+    buffer.UngetWriteBuf(len);
+    return true;
+}
 } // namespace
 
 wxDEFINE_EVENT(wxEVT_UPGRADE_LEXERS_START, clCommandEvent);
@@ -288,6 +311,13 @@ wxArrayString ColoursAndFontsManager::GetAvailableThemesForLexer(const wxString&
         themes.Add(lexers[i]->GetThemeName());
     }
 
+    auto lazy_iter = m_lazyLexers.find(lowerCaseName);
+    if (lazy_iter != m_lazyLexers.end()) {
+        for (const auto& lazy : lazy_iter->second) {
+            themes.Add(lazy.theme);
+        }
+    }
+
     // sort the list
     themes.Sort();
     return themes;
@@ -361,6 +391,10 @@ LexerConf::Ptr_t ColoursAndFontsManager::GetLexer(const wxString& lexerName, con
         }
 
     } else {
+        // the requested theme might not be loaded yet
+        auto self = const_cast<ColoursAndFontsManager*>(this);
+        self->DoLoadLazyLexer(iter->first, theme);
+
         const ColoursAndFontsManager::Vec_t& lexers = iter->second;
         LexerConf::Ptr_t themeDefaultLexer = nullptr;
         for (size_t i = 0; i < lexers.size(); ++i) {
@@ -373,12 +407,16 @@ LexerConf::Ptr_t ColoursAndFontsManager::GetLexer(const wxString& lexerName, con
         }
         // We failed to find the requested theme for this language. If we have a DEFAULT_THEME
         // lexer, return it, else use the minimal lexer ("m_defaultLexer")
+        if (!themeDefaultLexer) {
+            themeDefaultLexer = self->DoLoadLazyLexer(iter->first, DEFAULT_THEME);
+        }
         return (themeDefaultLexer ? themeDefaultLexer : m_defaultLexer);
     }
 }
 
 void ColoursAndFontsManager::Save(const wxFileName& lexer_json)
 {
+    DoLoadAllLexers();
     bool for_export = lexer_json.IsOk();
     ColoursAndFontsManager::Map_t::const_iterator iter = m_lexersMap.begin();
     JSON root(cJSON_Array);
@@ -398,6 +436,10 @@ void ColoursAndFontsManager::Save(const wxFileName& lexer_json)
     output_file.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
 
     root.save(output_file);
+    if (!for_export) {
+        SaveCache(output_file);
+    }
+
     // store the global font as well
     if (m_globalFont.IsOk()) {
         clConfig::Get().Write("GlobalThemeFont", m_globalFont);
@@ -560,15 +602,23 @@ void ColoursAndFontsManager::Clear()
 {
     m_allLexers.clear();
     m_lexersMap.clear();
+    m_lazyLexers.clear();
+    m_cacheData = wxMemoryBuffer();
     m_initialized = false;
 }
 
 void ColoursAndFontsManager::SetActiveTheme(const wxString& lexerName, const wxString& themeName)
 {
-    wxArrayString themes = GetAvailableThemesForLexer(lexerName);
-    for (size_t i = 0; i < themes.GetCount(); ++i) {
-        LexerConf::Ptr_t lexer = GetLexer(lexerName, themes.Item(i));
-        if (lexer && lexer->GetName() == lexerName) {
+    // lexers that were not loaded yet are not active, so there is no need to load all the themes
+    DoLoadLazyLexer(lexerName.Lower(), themeName);
+
+    auto iter = m_lexersMap.find(lexerName.Lower());
+    if (iter == m_lexersMap.end()) {
+        return;
+    }
+
+    for (auto lexer : iter->second) {
+        if (lexer->GetName() == lexerName) {
             lexer->SetIsActive(lexer->GetThemeName() == themeName);
         }
     }
@@ -682,6 +732,10 @@ void ColoursAndFontsManager::LoadLexersFromFile()
     m_allLexers.clear();
     m_lexersMap.clear();
 
+    if (m_lexersVersion >= LEXERS_VERSION && fnUserLexers.FileExists() && LoadCache(fnUserLexers)) {
+        return;
+    }
+
     clSYSTEM() << "Loading lexers..." << endl;
     if (m_lexersVersion < LEXERS_VERSION || !fnUserLexers.FileExists()) {
         clSYSTEM() << "Loading default lexers. CodeLite expected version:" << LEXERS_VERSION
@@ -696,6 +750,7 @@ void ColoursAndFontsManager::LoadLexersFromFile()
     if (fnUserLexers.FileExists()) {
         // Any duplicate lexer found here, will override the default lexer
         LoadJSON(fnUserLexers);
+        SaveCache(fnUserLexers);
     }
 
     clSYSTEM() << "Success" << endl;
@@ -1074,6 +1129,32 @@ LexerConf::Ptr_t ColoursAndFontsManager::DoAddLexer(JSONItem json)
     // Upgrade the lexer colours
     UpdateLexerColours(lexer, false);
 
+    if (m_globalFont.IsOk()) {
+        const wxString font_desc = FontUtils::GetFontInfo(m_globalFont);
+        auto& props = lexer->GetLexerProperties();
+        for (auto& prop : props) {
+            prop.SetFontInfoDesc(font_desc);
+        }
+    }
+
+    DoInsertLexer(lexer);
+    return lexer;
+}
+
+void ColoursAndFontsManager::DoInsertLexer(LexerConf::Ptr_t lexer)
+{
+    wxString lexerName = lexer->GetName().Lower();
+
+    // a lexer that is added replaces its cached version
+    auto lazy_iter = m_lazyLexers.find(lexerName);
+    if (lazy_iter != m_lazyLexers.end()) {
+        auto& lazy_lexers = lazy_iter->second;
+        lazy_lexers.erase(std::remove_if(lazy_lexers.begin(),
+                                         lazy_lexers.end(),
+                                         [&](const LazyLexer& lazy) { return lazy.theme == lexer->GetThemeName(); }),
+                          lazy_lexers.end());
+    }
+
     if (m_lexersMap.count(lexerName) == 0) {
         m_lexersMap.insert({ lexerName, ColoursAndFontsManager::Vec_t() });
     }
@@ -1096,15 +1177,6 @@ LexerConf::Ptr_t ColoursAndFontsManager::DoAddLexer(JSONItem json)
     }
     vec.push_back(lexer);
     m_allLexers.push_back(lexer);
-
-    if (m_globalFont.IsOk()) {
-        const wxString font_desc = FontUtils::GetFontInfo(m_globalFont);
-        auto& props = lexer->GetLexerProperties();
-        for (auto& prop : props) {
-            prop.SetFontInfoDesc(font_desc);
-        }
-    }
-    return lexer;
 }
 
 void ColoursAndFontsManager::AddLexer(LexerConf::Ptr_t lexer)
@@ -1116,6 +1188,7 @@ void ColoursAndFontsManager::AddLexer(LexerConf::Ptr_t lexer)
 void ColoursAndFontsManager::SetGlobalFont(const wxFont& font)
 {
     this->m_globalFont = font;
+    DoLoadAllLexers();
 
     // Loop for every lexer and update the font per style
     for (auto lexer : m_allLexers) {
@@ -1137,6 +1210,8 @@ bool ColoursAndFontsManager::ExportThemesToFile(const wxFileName& outputFile, co
         M.insert(names.Item(i).Lower());
     }
 
+    const_cast<ColoursAndFontsManager*>(this)->DoLoadAllLexers();
+
     JSON root(cJSON_Array);
     JSONItem arr = root.toElement();
     std::vector<LexerConf::Ptr_t> Lexers;
@@ -1169,6 +1244,8 @@ bool ColoursAndFontsManager::ImportLexersFile(const wxFileName& inputFile, bool
         }
     }
 
+    DoLoadAllLexers();
+
     std::vector<LexerConf::Ptr_t> Lexers;
     JSONItem arr = root.toElement();
     int arrSize = arr.arraySize();
@@ -1219,6 +1296,11 @@ wxArrayString ColoursAndFontsManager::GetAllThemes() const
     for (const auto& lexer : m_allLexers) {
         themes.insert(lexer->GetThemeName());
     }
+    for (const auto& vt : m_lazyLexers) {
+        for (const auto& lazy : vt.second) {
+            themes.insert(lazy.theme);
+        }
+    }
     wxArrayString arr;
     arr.reserve(themes.size());
     for (const wxString& name : themes) {
@@ -1281,6 +1363,7 @@ void ColoursAndFontsManager::SetThemeTextSelectionColours(const wxString& theme_
                                                           bool useCustomerFgColour)
 {
     wxString theme_name_lc = theme_name.Lower();
+    DoLoadAllLexers();
     for (auto& lexer : m_allLexers) {
         if (lexer->GetThemeName().CmpNoCase(theme_name) == 0) {
             auto& sp = lexer->GetProperty(SEL_TEXT_ATTR_ID);
@@ -1324,6 +1407,7 @@ void ColoursAndFontsManager::LoadLexersFromDb()
 
 void ColoursAndFontsManager::SetGlobalLineNumbersColour(const wxColour& col, bool dark_theme)
 {
+    DoLoadAllLexers();
     // Loop for every lexer and update the font per style
     for (auto lexer : m_allLexers) {
         if ((lexer->IsDark() && dark_theme) || (!lexer->IsDark() && !dark_theme)) {
@@ -1332,3 +1416,210 @@ void ColoursAndFontsManager::SetGlobalLineNumbersColour(const wxColour& col, boo
         }
     }
 }
+
+wxFileName ColoursAndFontsManager::GetCacheFile() const
+{
+    wxFileName fn(clStandardPaths::Get().GetUserDataDir(), "lexers.cache");
+    fn.AppendDir("lexers");
+    return fn;
+}
+
+namespace
+{
+/**
+ * @brief the cache key: the lexers.json content + everything that is applied to the lexers while they are loaded
+ */
+bool GetCacheKey(const wxFileName& lexers_json, const wxFont& global_font, wxUint64& key)
+{
+    wxMemoryBuffer content;
+    if (!ReadFileBytes(lexers_json, content)) {
+        return false;
+    }
+
+    key = FileUtils::GetStableHash(content.GetData(), content.GetDataLen());
+
+    wxString extra;
+    extra << LEXERS_VERSION << ";" << (global_font.IsOk() ? FontUtils::GetFontInfo(global_font) : wxString());
+    key = FileUtils::GetStableHash(extra, key);
+    return true;
+}
+} // namespace
+
+bool ColoursAndFontsManager::LoadCache(const wxFileName& lexers_json)
+{
+    wxUint64 key = 0;
+    if (!GetCacheKey(lexers_json, m_globalFont, key)) {
+        return false;
+    }
+
+    wxMemoryBuffer buffer;
+    if (!ReadFileBytes(GetCacheFile(), buffer) || buffer.GetDataLen() < sizeof(wxUint32)) {
+        return false;
+    }
+
+    wxMemoryInputStream mis(buffer.GetData(), buffer.GetDataLen());
+    wxDataInputStream in(mis);
+    if (in.Read32() != LEXERS_CACHE_MAGIC || in.Read32() != LEXERS_CACHE_VERSION || in.Read64() != key) {
+        clDEBUG() << "Lexers cache is outdated" << endl;
+        return false;
+    }
+
+    struct IndexEntry {
+        wxString name;
+        LazyLexer lazy;
+        bool active = false;
+    };
+
+    wxUint32 count = in.Read32();
+    std::vector<IndexEntry> index;
+    for (wxUint32 i = 0; i < count && mis.IsOk(); ++i) {
+        IndexEntry entry;
+        entry.name = in.ReadString().Lower();
+        entry.lazy.theme = in.ReadString();
+        entry.active = in.Read8() != 0;
+        entry.lazy.offset = in.Read64();
+        entry.lazy.length = in.Read64();
+        index.push_back(std::move(entry));
+    }
+
+    // the lexers data follows the index and the file ends with the magic number
+    size_t base = mis.TellI();
+    size_t data_end = buffer.GetDataLen() - sizeof(wxUint32);
+    wxUint32 trailer = 0;
+    memcpy(&trailer, (const char*)buffer.GetData() + data_end, sizeof(trailer));
+    bool ok = index.size() == count && mis.IsOk() && base <= data_end &&
+              wxUINT32_SWAP_ON_BE(trailer) == LEXERS_CACHE_MAGIC;
+    for (size_t i = 0; ok && i < index.size(); ++i) {
+        auto& lazy = index[i].lazy;
+        lazy.offset += base;
+        ok = lazy.offset <= data_end && lazy.length <= data_end - lazy.offset;
+    }
+
+    if (!ok) {
+        clWARNING() << "Corrupted lexers cache:" << GetCacheFile() << endl;
+        return false;
+    }
+
+    m_allLexers.clear();
+    m_lexersMap.clear();
+    m_lazyLexers.clear();
+    m_cacheData = buffer;
+
+    // load the active themes now. A language without an active theme has all its themes loaded, so
+    // GetLexer() can pick the best match
+    wxStringSet_t has_active;
+    for (const auto& entry : index) {
+        if (entry.active) {
+            has_active.insert(entry.name);
+        }
+    }
+
+    for (const auto& entry : index) {
+        m_lazyLexers[entry.name].push_back(entry.lazy);
+        if (entry.active || has_active.count(entry.name) == 0) {
+            DoLoadLazyLexer(entry.name, entry.lazy.theme);
+        }
+    }
+    clDEBUG() << "Loaded" << m_allLexers.size() << "out of" << count << "lexers from the lexers cache" << endl;
+    return true;
+}
+
+void ColoursAndFontsManager::SaveCache(const wxFileName& lexers_json)
+{
+    wxUint64 key = 0;
+    if (!GetCacheKey(lexers_json, m_globalFont, key)) {
+        return;
+    }
+
+    DoLoadAllLexers();
+
+    // serialize the lexers first, so their offsets are known when the index is written
+    wxMemoryOutputStream data_stream;
+    wxDataOutputStream data(data_stream);
+    std::vector<std::pair<size_t, size_t>> offsets;
+    offsets.reserve(m_allLexers.size());
+    for (const auto& lexer : m_allLexers) {
+        size_t offset = data_stream.GetLength();
+        lexer->ToBinary(data);
+        offsets.push_back({ offset, data_stream.GetLength() - offset });
+    }
+
+    wxMemoryOutputStream mos;
+    wxDataOutputStream out(mos);
+    out.Write32(LEXERS_CACHE_MAGIC);
+    out.Write32(LEXERS_CACHE_VERSION);
+    out.Write64(key);
+    out.Write32(m_allLexers.size());
+    for (size_t i = 0; i < m_allLexers.size(); ++i) {
+        const auto& lexer = m_allLexers[i];
+        out.WriteString(lexer->GetName());
+        out.WriteString(lexer->GetThemeName());
+        out.Write8(lexer->IsActive() ? 1 : 0);
+        out.Write64((wxUint64)offsets[i].first);
+        out.Write64((wxUint64)offsets[i].second);
+    }
+
+    std::string content((const char*)mos.GetOutputStreamBuffer()->GetBufferStart(), mos.GetLength());
+    content.append((const char*)data_stream.GetOutputStreamBuffer()->GetBufferStart(), data_stream.GetLength());
+
+    wxMemoryOutputStream trailer_stream;
+    wxDataOutputStream trailer(trailer_stream);
+    trailer.Write32(LEXERS_CACHE_MAGIC);
+    content.append((const char*)trailer_stream.GetOutputStreamBuffer()->GetBufferStart(), trailer_stream.GetLength());
+
+    if (!FileUtils::WriteFileContentRaw(GetCacheFile(), content)) {
+        clWARNING() << "Failed to write lexers cache:" << GetCacheFile() << endl;
+    }
+}
+
+LexerConf::Ptr_t ColoursAndFontsManager::DoLoadLazyLexer(const wxString& lexerName, const wxString& themeName)
+{
+    auto iter = m_lazyLexers.find(lexerName);
+    if (iter == m_lazyLexers.end()) {
+        return nullptr;
+    }
+
+    auto& lazy_lexers = iter->second;
+    auto where = std::find_if(lazy_lexers.begin(), lazy_lexers.end(),
+                              [&](const LazyLexer& lazy) { return lazy.theme == themeName; });
+    if (where == lazy_lexers.end()) {
+        return nullptr;
+    }
+
+    LazyLexer lazy = *where;
+    lazy_lexers.erase(where);
+
+    wxMemoryInputStream mis((const char*)m_cacheData.GetData() + lazy.offset, lazy.length);
+    wxDataInputStream in(mis);
+    LexerConf::Ptr_t lexer(new LexerConf());
+    lexer->FromBinary(in);
+
+    DoInsertLexer(lexer);
+    if (lazy_lexers.empty()) {
+        m_lazyLexers.erase(iter);
+    }
+    if (m_lazyLexers.empty()) {
+        // everything is loaded, release the cache content
+        m_cacheData = wxMemoryBuffer();
+    }
+    return lexer;
+}
+
+void ColoursAndFontsManager::DoLoadAllLexers()
+{
+    // load them in the cache order, which is the order they were originally loaded in
+    std::vector<std::pair<size_t, std::pair<wxString, wxString>>> lazy_lexers;
+    for (const auto& vt : m_lazyLexers) {
+        for (const auto& lazy : vt.second) {
+            lazy_lexers.push_back({ lazy.offset, { vt.first, lazy.theme } });
+        }
+    }
+    std::sort(lazy_lexers.begin(), lazy_lexers.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    for (const auto& p : lazy_lexers) {
+        DoLoadLazyLexer(p.second.first, p.second.second);
+    }
+    m_lazyLexers.clear();
+    m_cacheData = wxMemoryBuffer();
+}
@@ -32,7 +32,9 @@
 #include "wxStringHash.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
+#include <wx/buffer.h>
 #include <wx/event.h>
 #include <wx/filename.h>
 #include <wx/font.h>
@@ -51,6 +53,15 @@ class WXDLLIMPEXP_SDK ColoursAndFontsManager : public wxEvtHandler
     typedef std::vector<LexerConf::Ptr_t> Vec_t;
     typedef std::unordered_map<wxString, ColoursAndFontsManager::Vec_t> Map_t;
 
+    /**
+     * @brief a lexer that is stored in the lexers cache and was not loaded yet
+     */
+    struct LazyLexer {
+        wxString theme;
+        size_t offset = 0; // in m_cacheData
+        size_t length = 0;
+    };
+
 protected:
     bool m_initialized = false;
     /// Map lexers by name (c++, rust, etc)
@@ -61,12 +72,17 @@ protected:
     LexerConf::Ptr_t m_defaultLexer;
     int m_lexersVersion = wxNOT_FOUND;
     wxFont m_globalFont;
+    /// Lexers not loaded yet from the lexers cache, by lexer name. These are never the active theme
+    std::unordered_map<wxString, std::vector<LazyLexer>> m_lazyLexers;
+    /// The lexers cache content, kept as long as there are lazy lexers
+    wxMemoryBuffer m_cacheData;
 
 private:
     ColoursAndFontsManager();
     virtual ~ColoursAndFontsManager();
 
     LexerConf::Ptr_t DoAddLexer(JSONItem json);
+    void DoInsertLexer(LexerConf::Ptr_t lexer);
     void Clear();
     wxFileName GetConfigFile() const;
     void LoadJSON(const wxFileName& path);
@@ -84,6 +100,26 @@ private:
      */
     void LoadLexersFromDb();
 
+    /**
+     * @brief the lexers cache is a binary copy of the lexers, as they are after being loaded from lexers.json. It is
+     * keyed by the hash of lexers.json, and only the active themes are loaded from it. The other themes are loaded on
+     * demand
+     */
+    wxFileName GetCacheFile() const;
+    bool LoadCache(const wxFileName& lexers_json);
+    void SaveCache(const wxFileName& lexers_json);
+
+    /**
+     * @brief load a lexer from the cache, if it was not loaded yet
+     * @param lexerName lower case lexer name
+     */
+    LexerConf::Ptr_t DoLoadLazyLexer(const wxString& lexerName, const wxString& themeName);
+
+    /**
+     * @brief load all the lexers that are not loaded yet
+     */
+    void DoLoadAllLexers();
+
 protected:
     void OnAdjustTheme(clCommandEvent& event);
 
@@ -13,6 +13,7 @@
 #include "clFileSystemEvent.h"
 #include "clFileSystemWorkspaceView.hpp"
 #include "clFilesCollector.h"
+#include "clFilesSnapshot.h"
 #include "clSFTPEvent.h"
 #include "clShellHelper.hpp"
 #include "clWorkspaceManager.h"
@@ -34,6 +35,7 @@
 #include "wxStringHash.h"
 
 #include <thread>
+#include <unordered_set>
 #include <wx/msgdlg.h>
 #include <wx/tokenzr.h>
 #include <wx/xrc/xmlres.h>
@@ -53,6 +55,9 @@
     }
 
 wxDEFINE_EVENT(wxEVT_FS_SCAN_COMPLETED, clFileSystemEvent);
+wxDEFINE_EVENT(wxEVT_FS_SCAN_UPDATED, clFileSystemEvent);
+wxDEFINE_EVENT(wxEVT_FS_WORKSPACE_FILES_ADDED, clFileSystemEvent);
+wxDEFINE_EVENT(wxEVT_FS_WORKSPACE_FILES_REMOVED, clFileSystemEvent);
 wxDEFINE_EVENT(wxEVT_FS_NEW_WORKSPACE_FILE_CREATED, clFileSystemEvent);
 clFileSystemWorkspace::clFileSystemWorkspace(bool dummy)
     : m_dummy(dummy)
@@ -65,6 +70,7 @@ clFileSystemWorkspace::clFileSystemWorkspace(bool dummy)
         EventNotifier::Get()->Bind(wxEVT_CMD_CREATE_NEW_WORKSPACE, &clFileSystemWorkspace::OnNewWorkspace, this);
         EventNotifier::Get()->Bind(wxEVT_ALL_EDITORS_CLOSED, &clFileSystemWorkspace::OnAllEditorsClosed, this);
         EventNotifier::Get()->Bind(wxEVT_FS_SCAN_COMPLETED, &clFileSystemWorkspace::OnScanCompleted, this);
+        EventNotifier::Get()->Bind(wxEVT_FS_SCAN_UPDATED, &clFileSystemWorkspace::OnScanUpdated, this);
         EventNotifier::Get()->Bind(wxEVT_CMD_RETAG_WORKSPACE, &clFileSystemWorkspace::OnParseWorkspace, this);
         EventNotifier::Get()->Bind(wxEVT_CMD_RETAG_WORKSPACE_FULL, &clFileSystemWorkspace::OnParseWorkspace, this);
         EventNotifier::Get()->Bind(wxEVT_SAVE_SESSION_NEEDED, &clFileSystemWorkspace::OnSaveSession, this);
@@ -94,6 +100,12 @@ clFileSystemWorkspace::clFileSystemWorkspace(bool dummy)
         EventNotifier::Get()->Bind(wxEVT_DBG_UI_START, &clFileSystemWorkspace::OnDebug, this);
 
         EventNotifier::Get()->Bind(wxEVT_FILE_CREATED, &clFileSystemWorkspace::OnFileSystemUpdated, this);
+        EventNotifier::Get()->Bind(wxEVT_FILE_DELETED, &clFileSystemWorkspace::OnFilesDeleted, this);
+        EventNotifier::Get()->Bind(wxEVT_FOLDER_DELETED, &clFileSystemWorkspace::OnFolderDeleted, this);
+        EventNotifier::Get()->Bind(wxEVT_FILE_RENAMED, &clFileSystemWorkspace::OnFileRenamed, this);
+        EventNotifier::Get()->Bind(wxEVT_FS_WORKSPACE_FILES_ADDED, &clFileSystemWorkspace::OnWorkspaceFilesAdded, this);
+        EventNotifier::Get()->Bind(wxEVT_FS_WORKSPACE_FILES_REMOVED, &clFileSystemWorkspace::OnWorkspaceFilesRemoved,
+                                   this);
     }
 }
 
@@ -106,6 +118,7 @@ clFileSystemWorkspace::~clFileSystemWorkspace()
         EventNotifier::Get()->Unbind(wxEVT_CMD_CREATE_NEW_WORKSPACE, &clFileSystemWorkspace::OnNewWorkspace, this);
         EventNotifier::Get()->Unbind(wxEVT_ALL_EDITORS_CLOSED, &clFileSystemWorkspace::OnAllEditorsClosed, this);
         EventNotifier::Get()->Unbind(wxEVT_FS_SCAN_COMPLETED, &clFileSystemWorkspace::OnScanCompleted, this);
+        EventNotifier::Get()->Unbind(wxEVT_FS_SCAN_UPDATED, &clFileSystemWorkspace::OnScanUpdated, this);
         EventNotifier::Get()->Unbind(wxEVT_SAVE_SESSION_NEEDED, &clFileSystemWorkspace::OnSaveSession, this);
 
         // parsing event
@@ -138,6 +151,13 @@ clFileSystemWorkspace::~clFileSystemWorkspace()
         EventNotifier::Get()->Unbind(wxEVT_DBG_UI_START, &clFileSystemWorkspace::OnDebug, this);
 
         EventNotifier::Get()->Unbind(wxEVT_FILE_CREATED, &clFileSystemWorkspace::OnFileSystemUpdated, this);
+        EventNotifier::Get()->Unbind(wxEVT_FILE_DELETED, &clFileSystemWorkspace::OnFilesDeleted, this);
+        EventNotifier::Get()->Unbind(wxEVT_FOLDER_DELETED, &clFileSystemWorkspace::OnFolderDeleted, this);
+        EventNotifier::Get()->Unbind(wxEVT_FILE_RENAMED, &clFileSystemWorkspace::OnFileRenamed, this);
+        EventNotifier::Get()->Unbind(wxEVT_FS_WORKSPACE_FILES_ADDED, &clFileSystemWorkspace::OnWorkspaceFilesAdded,
+                                     this);
+        EventNotifier::Get()->Unbind(wxEVT_FS_WORKSPACE_FILES_REMOVED, &clFileSystemWorkspace::OnWorkspaceFilesRemoved,
+                                     this);
     }
 }
 
@@ -180,52 +200,89 @@ bool clFileSystemWorkspace::IsBuildSupported() const { return true; }
 
 bool clFileSystemWorkspace::IsProjectSupported() const { return false; }
 
+wxFileName clFileSystemWorkspace::GetFilesSnapshotFile() const
+{
+    wxFileName fn(GetFileName());
+    fn.AppendDir(".codelite");
+    fn.SetExt("files");
+    return fn;
+}
+
 void clFileSystemWorkspace::CacheFiles(bool force)
 {
-    // should we force a rescan of the files?
-    if (force) {
-        m_files.Clear();
-    }
-    // sanity
-    if (!m_files.IsEmpty()) {
-        m_files.Clear();
+    // collect the settings here, the scanner thread does not access the workspace
+    wxStringSet_t excludeFolders = { ".git/", ".svn/", ".codelite/", ".ctagsd/" };
+    wxString excludePaths = GetExcludeFolders();
+    wxArrayString paths = StringUtils::BuildArgv(excludePaths);
+    for (wxString& excludePath : paths) {
+        excludePath.Trim().Trim(false);
+        if (excludePath.EndsWith("/") || excludePath.EndsWith("\\")) {
+            excludePath.RemoveLast();
+        }
+        if (excludePath.IsEmpty()) {
+            continue;
+        }
+
+        wxFileName fnpath(excludePath, "");
+        excludeFolders.insert(fnpath.GetPath());
     }
-    std::thread thr(
-        [=](const wxString& rootFolder) {
-            clFilesScanner fs;
+
+    wxString rootFolder = GetDir();
+    wxString filespec = GetFilesMask();
+    wxFileName snapshotFile = GetFilesSnapshotFile();
+    int scanId = ++m_scanId;
+
+    // when the files are already known, only the changes are of interest
+    bool sendCachedFiles = m_files.IsEmpty();
+    std::thread thr([=]() {
+        clFilesSnapshot snapshot(rootFolder, filespec, excludeFolders);
+        bool loaded = !force && snapshot.Load(snapshotFile);
+        if (loaded && sendCachedFiles) {
+            // the files as they were on the previous scan: the consumers can start right away
             std::vector<wxString> files;
-            wxStringSet_t excludeFolders = { ".git/", ".svn/", ".codelite/", ".ctagsd/" };
-
-            wxString excludePaths = GetExcludeFolders();
-            wxArrayString paths = StringUtils::BuildArgv(excludePaths);
-            if (!paths.IsEmpty()) {
-                for (wxString& excludePath : paths) {
-                    excludePath.Trim().Trim(false);
-                    if (excludePath.EndsWith("/") || excludePath.EndsWith("\\")) {
-                        excludePath.RemoveLast();
-                    }
-                    if (excludePath.IsEmpty()) {
-                        continue;
-                    }
-
-                    wxFileName fnpath(excludePath, "");
-                    excludeFolders.insert(fnpath.GetPath());
-                }
-            }
+            snapshot.GetFiles(files);
 
-            fs.Scan(rootFolder, files, GetFilesMask(), "", excludeFolders);
             clFileSystemEvent event(wxEVT_FS_SCAN_COMPLETED);
-            wxArrayString arrfiles;
-            arrfiles.Alloc(files.size());
-            for (const wxString& s : files) {
-                wxFileName f(s);
-                arrfiles.Add(f.GetFullPath());
+            event.SetInt(scanId);
+            event.GetPaths().Alloc(files.size());
+            for (const wxString& file : files) {
+                event.GetPaths().Add(file);
             }
+            EventNotifier::Get()->QueueEvent(event.Clone());
+        }
 
-            event.SetPaths(arrfiles);
+        clFilesSnapshot::Delta delta;
+        size_t foldersRead = snapshot.Update(delta);
+        snapshot.Save(snapshotFile);
+        clDEBUG() << "FSW: files snapshot updated." << foldersRead << "of" << snapshot.GetFoldersCount()
+                  << "folders were read." << delta.added.size() << "files added," << delta.removed.size()
+                  << "files removed" << endl;
+
+        if (loaded) {
+            if (delta.empty()) {
+                return;
+            }
+            clFileSystemEvent event(wxEVT_FS_SCAN_UPDATED);
+            event.SetInt(scanId);
+            for (const wxString& file : delta.added) {
+                event.GetPaths().Add(file);
+            }
+            for (const wxString& file : delta.removed) {
+                event.GetStrings().Add(file);
+            }
             EventNotifier::Get()->QueueEvent(event.Clone());
-        },
-        GetDir());
+
+        } else {
+            // a full scan: everything was added
+            clFileSystemEvent event(wxEVT_FS_SCAN_COMPLETED);
+            event.SetInt(scanId);
+            event.GetPaths().Alloc(delta.added.size());
+            for (const wxString& file : delta.added) {
+                event.GetPaths().Add(file);
+            }
+            EventNotifier::Get()->QueueEvent(event.Clone());
+        }
+    });
     thr.detach();
 }
 
@@ -375,9 +432,11 @@ void clFileSystemWorkspace::DoClose()
     // Store the session
     clGetManager()->StoreWorkspaceSession(m_filename);
 
-    // avoid any file re-cache, we are closing
+    // avoid any file re-cache, we are closing. Scans that are still running are ignored
     Save(false);
     DoClear();
+    m_files.Clear();
+    ++m_scanId;
 
     // Clear the UI
     GetView()->Clear();
@@ -436,6 +495,11 @@ void clFileSystemWorkspace::New(const wxString& folder, const wxString& name) {
 
 void clFileSystemWorkspace::OnScanCompleted(clFileSystemEvent& event)
 {
+    if (event.GetInt() != (int)m_scanId) {
+        clDEBUG() << "FSW: ignoring the result of an outdated scan" << endl;
+        return;
+    }
+
     clDEBUG() << "FSW: CacheFiles completed. Found" << event.GetPaths().size() << "files";
     m_files.Clear();
     m_files.Alloc(event.GetPaths().size());
@@ -452,6 +516,46 @@ void clFileSystemWorkspace::OnScanCompleted(clFileSystemEvent& event)
     EventNotifier::Get()->ProcessEvent(event_scan);
 }
 
+void clFileSystemWorkspace::OnScanUpdated(clFileSystemEvent& event)
+{
+    if (event.GetInt() != (int)m_scanId) {
+        return;
+    }
+
+    // the snapshot might not include the changes that were already applied from the file system events
+    wxArrayString added;
+    for (const wxString& path : event.GetPaths()) {
+        if (m_files.Add(path)) {
+            added.Add(path);
+        }
+    }
+
+    wxArrayString removed;
+    if (!event.GetStrings().empty()) {
+        std::unordered_set<wxString> paths{ event.GetStrings().begin(), event.GetStrings().end() };
+        m_files.Remove([&paths](const wxString& path) { return paths.count(path) > 0; }, removed);
+    }
+
+    clDEBUG() << "FSW: file system changes:" << added.size() << "files added," << removed.size() << "files removed"
+              << endl;
+    NotifyFilesChanged(added, removed);
+}
+
+void clFileSystemWorkspace::NotifyFilesChanged(const wxArrayString& added, const wxArrayString& removed)
+{
+    if (!added.empty()) {
+        clFileSystemEvent event_added(wxEVT_FS_WORKSPACE_FILES_ADDED);
+        event_added.SetPaths(added);
+        EventNotifier::Get()->ProcessEvent(event_added);
+    }
+
+    if (!removed.empty()) {
+        clFileSystemEvent event_removed(wxEVT_FS_WORKSPACE_FILES_REMOVED);
+        event_removed.SetPaths(removed);
+        EventNotifier::Get()->ProcessEvent(event_removed);
+    }
+}
+
 void clFileSystemWorkspace::OnParseWorkspace(wxCommandEvent& event)
 {
     if (!m_isLoaded) {
@@ -912,8 +1016,8 @@ void clFileSystemWorkspace::OnSourceControlPulled(clSourceControlEvent& event)
     clDEBUG() << "Refreshing tree + re-parsing";
     GetView()->RefreshTree();
 
-    // Re-Cache the files and trigger a workspace parse
-    CacheFiles(true);
+    // Update the files and trigger a workspace parse. Only the folders changed by the pull are read again
+    CacheFiles();
 }
 
 void clFileSystemWorkspace::FileSystemUpdated() { CacheFiles(true); }
@@ -1085,13 +1189,97 @@ void clFileSystemWorkspace::OnFileSystemUpdated(clFileSystemEvent& event)
             return;
         }
 
+        wxArrayString added;
         for (const wxString& path : paths) {
-            m_files.Add(path);
+            if (m_files.Add(path)) {
+                added.Add(path);
+            }
         }
+        NotifyFilesChanged(added, {});
+    }
+}
+
+void clFileSystemWorkspace::OnFilesDeleted(clFileSystemEvent& event)
+{
+    event.Skip();
+    CHECK_COND_RET(IsOpen() && !event.GetPaths().empty());
+
+    std::unordered_set<wxString> paths;
+    for (const wxString& path : event.GetPaths()) {
+        paths.insert(wxFileName(path).GetFullPath());
+    }
+
+    wxArrayString removed;
+    m_files.Remove([&paths](const wxString& path) { return paths.count(path) > 0; }, removed);
+    NotifyFilesChanged({}, removed);
+}
+
+void clFileSystemWorkspace::OnFolderDeleted(clFileSystemEvent& event)
+{
+    event.Skip();
+    CHECK_COND_RET(IsOpen() && !event.GetPaths().empty());
+
+    wxArrayString folders;
+    for (const wxString& path : event.GetPaths()) {
+        folders.Add(wxFileName(path, "").GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR));
+    }
 
-        // Parse the newly added files
-        Parse(false);
+    wxArrayString removed;
+    m_files.Remove(
+        [&folders](const wxString& path) {
+            for (const wxString& folder : folders) {
+                if (path.StartsWith(folder)) {
+                    return true;
+                }
+            }
+            return false;
+        },
+        removed);
+    NotifyFilesChanged({}, removed);
+}
+
+void clFileSystemWorkspace::OnFileRenamed(clFileSystemEvent& event)
+{
+    // the rename is performed by the sender, unless the event is processed: always skip it
+    event.Skip();
+    CHECK_COND_RET(IsOpen());
+
+    wxString oldpath = wxFileName(event.GetPath()).GetFullPath();
+    wxFileName newpath(event.GetNewpath());
+
+    wxArrayString removed;
+    m_files.Remove([&oldpath](const wxString& path) { return path == oldpath; }, removed);
+
+    wxArrayString added;
+    if (newpath.GetFullPath().StartsWith(GetDir()) && FileUtils::WildMatch(GetFilesMask(), newpath) &&
+        m_files.Add(newpath)) {
+        added.Add(newpath.GetFullPath());
     }
+    NotifyFilesChanged(added, removed);
+}
+
+void clFileSystemWorkspace::OnWorkspaceFilesAdded(clFileSystemEvent& event)
+{
+    event.Skip();
+    CHECK_COND_RET(IsOpen() && !event.GetPaths().empty());
+
+    // let ctagsd parse the new files, restarting it would drop its in-flight requests and its in-memory indexes
+    clLanguageServerEvent files_event{ wxEVT_LSP_WATCHED_FILES_CHANGED };
+    files_event.SetLspName("ctagsd");
+    files_event.SetCreatedFiles(event.GetPaths());
+    EventNotifier::Get()->AddPendingEvent(files_event);
+}
+
+void clFileSystemWorkspace::OnWorkspaceFilesRemoved(clFileSystemEvent& event)
+{
+    event.Skip();
+    CHECK_COND_RET(IsOpen() && !event.GetPaths().empty());
+
+    // ctagsd owns its tags database: let it purge the symbols of the removed files (and update its name index)
+    clLanguageServerEvent files_event{ wxEVT_LSP_WATCHED_FILES_CHANGED };
+    files_event.SetLspName("ctagsd");
+    files_event.SetDeletedFiles(event.GetPaths());
+    EventNotifier::Get()->AddPendingEvent(files_event);
 }
 
 void clFileSystemWorkspace::CreateCompileFlagsFile()
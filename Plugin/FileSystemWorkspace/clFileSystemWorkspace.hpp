@@ -39,9 +39,16 @@ class WXDLLIMPEXP_SDK clFileSystemWorkspace : public IWorkspace
     clBacktickCache::ptr_t m_backtickCache;
     clShellHelper m_shell_helper;
     std::optional<int> m_indentWidth{ std::nullopt };
+    size_t m_scanId = 0;
 
 protected:
+    /**
+     * @brief update the list of files in the background. The list is read from the snapshot saved by the previous
+     * scan and only the folders that changed since are read again. Pass `force` to ignore the snapshot
+     */
     void CacheFiles(bool force = false);
+    wxFileName GetFilesSnapshotFile() const;
+    void NotifyFilesChanged(const wxArrayString& added, const wxArrayString& removed);
     wxString GetTargetCommand(const wxString& target) const;
     void DoPrintBuildMessage(const wxString& message);
     clEnvList_t GetEnvList();
@@ -64,6 +71,7 @@ protected:
     void OnCloseWorkspace(clCommandEvent& event);
     void OnAllEditorsClosed(wxCommandEvent& event);
     void OnScanCompleted(clFileSystemEvent& event);
+    void OnScanUpdated(clFileSystemEvent& event);
     void OnParseWorkspace(wxCommandEvent& event);
     void OnBuildProcessTerminated(clProcessEvent& event);
     void OnBuildProcessOutput(clProcessEvent& event);
@@ -76,6 +84,11 @@ protected:
     void OnSourceControlPulled(clSourceControlEvent& event);
     void OnDebug(clDebugEvent& event);
     void OnFileSystemUpdated(clFileSystemEvent& event);
+    void OnFilesDeleted(clFileSystemEvent& event);
+    void OnFolderDeleted(clFileSystemEvent& event);
+    void OnFileRenamed(clFileSystemEvent& event);
+    void OnWorkspaceFilesAdded(clFileSystemEvent& event);
+    void OnWorkspaceFilesRemoved(clFileSystemEvent& event);
     void OnReloadWorkspace(clCommandEvent& event);
 
 protected:
@@ -197,5 +210,11 @@ public:
 };
 
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_FS_SCAN_COMPLETED, clFileSystemEvent);
+// Sent by the scanner thread with the difference found between the snapshot and the file system:
+// GetPaths() are the files added, GetStrings() the files removed
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_FS_SCAN_UPDATED, clFileSystemEvent);
+// The workspace files were added / removed after the initial scan (GetPaths() holds the files)
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_FS_WORKSPACE_FILES_ADDED, clFileSystemEvent);
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_FS_WORKSPACE_FILES_REMOVED, clFileSystemEvent);
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_FS_NEW_WORKSPACE_FILE_CREATED, clFileSystemEvent);
 #endif // CLFILESYSTEMWORKSPACE_HPP
@@ -59,6 +59,10 @@ clFileSystemWorkspaceView::clFileSystemWorkspaceView(wxWindow* parent, const wxS
                                this);
     EventNotifier::Get()->Bind(wxEVT_FINDINFILES_DLG_SHOWING, &clFileSystemWorkspaceView::OnFindInFilesShowing, this);
     EventNotifier::Get()->Bind(wxEVT_SYS_COLOURS_CHANGED, &clFileSystemWorkspaceView::OnThemeChanged, this);
+    EventNotifier::Get()->Bind(wxEVT_FS_WORKSPACE_FILES_ADDED, &clFileSystemWorkspaceView::OnWorkspaceFilesChanged,
+                               this);
+    EventNotifier::Get()->Bind(wxEVT_FS_WORKSPACE_FILES_REMOVED, &clFileSystemWorkspaceView::OnWorkspaceFilesChanged,
+                               this);
 }
 
 clFileSystemWorkspaceView::~clFileSystemWorkspaceView()
@@ -75,6 +79,10 @@ clFileSystemWorkspaceView::~clFileSystemWorkspaceView()
                                  this);
     EventNotifier::Get()->Unbind(wxEVT_FINDINFILES_DLG_SHOWING, &clFileSystemWorkspaceView::OnFindInFilesShowing, this);
     EventNotifier::Get()->Unbind(wxEVT_SYS_COLOURS_CHANGED, &clFileSystemWorkspaceView::OnThemeChanged, this);
+    EventNotifier::Get()->Unbind(wxEVT_FS_WORKSPACE_FILES_ADDED, &clFileSystemWorkspaceView::OnWorkspaceFilesChanged,
+                                 this);
+    EventNotifier::Get()->Unbind(wxEVT_FS_WORKSPACE_FILES_REMOVED,
+                                 &clFileSystemWorkspaceView::OnWorkspaceFilesChanged, this);
 }
 
 void clFileSystemWorkspaceView::OnFolderDropped(clCommandEvent& event)
@@ -311,6 +319,12 @@ void clFileSystemWorkspaceView::OnThemeChanged(clCommandEvent& event)
     Refresh();
 }
 
+void clFileSystemWorkspaceView::OnWorkspaceFilesChanged(clFileSystemEvent& event)
+{
+    event.Skip();
+    RefreshFoldersOf(event.GetPaths());
+}
+
 void clFileSystemWorkspaceView::OnRefreshViewUI(wxUpdateUIEvent& event)
 {
     event.Enable(clFileSystemWorkspace::Get().IsOpen());
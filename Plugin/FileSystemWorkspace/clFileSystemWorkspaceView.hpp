@@ -38,6 +38,7 @@ protected:
     void OnFindInFilesShowing(clFindInFilesEvent& event);
     void OnExcludePath(wxCommandEvent& event);
     void OnThemeChanged(clCommandEvent& event);
+    void OnWorkspaceFilesChanged(clFileSystemEvent& event);
 
 protected:
     void DoAddIncludePathsToConfig(clFileSystemWorkspaceConfig::Ptr_t config, const wxArrayString& paths);
@@ -3,6 +3,7 @@
 #include "LSP/CodeActionRequest.hpp"
 #include "LSP/CompletionRequest.h"
 #include "LSP/DidChangeTextDocumentRequest.h"
+#include "LSP/DidChangeWatchedFilesNotification.hpp"
 #include "LSP/DidCloseTextDocumentRequest.h"
 #include "LSP/DidOpenTextDocumentRequest.h"
 #include "LSP/DidSaveTextDocumentRequest.h"
@@ -264,6 +265,7 @@ void LanguageServerProtocol::DoClear()
     m_initializeRequestID = wxNOT_FOUND;
     m_Queue.Clear();
     m_lastCompletionRequestId = wxNOT_FOUND;
+    m_semanticTokensResults.clear();
     // Destroy the current connection
     m_network->Close();
 }
@@ -447,6 +449,7 @@ void LanguageServerProtocol::SendCloseRequest(const wxString& filename)
         LSP::MessageWithParams::MakeRequest(new LSP::DidCloseTextDocumentRequest(filename));
     QueueMessage(req);
     m_filesTracker.erase(filename);
+    m_semanticTokensResults.erase(filename);
 }
 
 void LanguageServerProtocol::SendSaveRequest(IEditor* editor, const wxString& fileContent)
@@ -784,6 +787,9 @@ void LanguageServerProtocol::EventMainLoop(clCommandEvent& event)
                             res["result"]["capabilities"]["semanticTokensProvider"]["legend"]["tokenTypes"]
                                 .toArrayString();
                         LSP_DEBUG() << GetLogPrefix() << "Server semantic tokens are:" << m_semanticTokensTypes << endl;
+                        if (res["result"]["capabilities"]["semanticTokensProvider"]["full"]["delta"].toBool(false)) {
+                            m_providers.insert("textDocument/semanticTokens/full/delta");
+                        }
                     }
 
                     CheckCapability(res, "documentSymbolProvider", "textDocument/documentSymbol");
@@ -904,8 +910,16 @@ void LanguageServerProtocol::SendSemanticTokensRequest(IEditor* editor)
 
     // check if this is implemented by the server
     if (IsSemanticTokensSupported()) {
-        LSP::DidChangeTextDocumentRequest::Ptr_t req =
-            LSP::MessageWithParams::MakeRequest(new LSP::SemanticTokensRquest(filepath));
+        LSP::SemanticTokensRquest* semantic_tokens_request = nullptr;
+        auto iter = m_semanticTokensResults.find(filepath);
+        if (IsSemanticTokensDeltaSupported() && iter != m_semanticTokensResults.end()) {
+            // only ask for the changes since the previous result
+            semantic_tokens_request =
+                new LSP::SemanticTokensRquest(filepath, iter->second.result_id, iter->second.data);
+        } else {
+            semantic_tokens_request = new LSP::SemanticTokensRquest(filepath);
+        }
+        LSP::DidChangeTextDocumentRequest::Ptr_t req = LSP::MessageWithParams::MakeRequest(semantic_tokens_request);
         QueueMessage(req);
 
     } else if (IsDocumentSymbolsSupported()) {
@@ -917,6 +931,10 @@ void LanguageServerProtocol::SendSemanticTokensRequest(IEditor* editor)
 void LanguageServerProtocol::HandleResponseError(LSP::ResponseMessage& response, LSP::MessageWithParams::Ptr_t msg_ptr)
 {
     LSP_DEBUG() << GetLogPrefix() << "received an error message:" << response.ToString() << endl;
+    if (msg_ptr && msg_ptr->As<LSP::SemanticTokensRquest>()) {
+        // the server may have dropped the previous result, ask for all the tokens next time
+        m_semanticTokensResults.erase(msg_ptr->As<LSP::SemanticTokensRquest>()->GetFilename());
+    }
     LSP::ResponseError errMsg(response.ToString());
     switch (errMsg.GetErrorCode()) {
     case LSP::ResponseError::kErrorCodeInternalError:
@@ -980,6 +998,18 @@ void LanguageServerProtocol::HandleResponse(LSP::ResponseMessage& response, LSP:
         LSP_TRACE() << response.ToString() << endl;
         preq->OnResponse(response, m_cluster);
 
+        auto semantic_tokens_request = preq->As<LSP::SemanticTokensRquest>();
+        if (semantic_tokens_request) {
+            // keep the result, so the next request for this file can be a delta request
+            if (semantic_tokens_request->GetResultId().empty() || !IsSemanticTokensDeltaSupported()) {
+                m_semanticTokensResults.erase(semantic_tokens_request->GetFilename());
+            } else {
+                auto& result = m_semanticTokensResults[semantic_tokens_request->GetFilename()];
+                result.result_id = semantic_tokens_request->GetResultId();
+                result.data.swap(semantic_tokens_request->GetData());
+            }
+        }
+
     } else if (response.IsPushDiagnostics()) {
         // Get the URI
         LSP_DEBUG() << "Received diagnostic message:" << endl;
@@ -996,12 +1026,14 @@ void LanguageServerProtocol::HandleResponse(LSP::ResponseMessage& response, LSP:
             eventSetDiags.SetFileName(fn);
             eventSetDiags.GetLocation().SetPath(fn);
             eventSetDiags.SetDiagnostics(diags);
+            eventSetDiags.SetDiagnosticsVersion(response.GetDiagnosticsVersion());
             EventNotifier::Get()->AddPendingEvent(eventSetDiags);
         } else if (diags.empty()) {
             // clear all diagnostics
             LSPEvent eventClearDiags(wxEVT_LSP_CLEAR_DIAGNOSTICS);
             eventClearDiags.SetFileName(fn);
             eventClearDiags.GetLocation().SetPath(fn);
+            eventClearDiags.SetDiagnosticsVersion(response.GetDiagnosticsVersion());
             EventNotifier::Get()->AddPendingEvent(eventClearDiags);
         }
     }
@@ -1119,6 +1151,11 @@ bool LanguageServerProtocol::IsSemanticTokensSupported() const
     return IsCapabilitySupported("textDocument/semanticTokens/full");
 }
 
+bool LanguageServerProtocol::IsSemanticTokensDeltaSupported() const
+{
+    return IsCapabilitySupported("textDocument/semanticTokens/full/delta");
+}
+
 void LanguageServerProtocol::SetStartedCallback(LSPOnConnectedCallback_t&& cb)
 {
     m_onServerStartedCallback = std::move(cb);
@@ -1211,6 +1248,19 @@ bool LanguageServerProtocol::IsRenameSupported() const { return IsCapabilitySupp
 
 bool LanguageServerProtocol::IsIncrementalChangeSupported() const { return m_incrementalChangeSupported; }
 
+void LanguageServerProtocol::SendWatchedFilesChanged(const wxArrayString& created, const wxArrayString& deleted)
+{
+    if (created.empty() && deleted.empty()) {
+        return;
+    }
+
+    LSP_DEBUG() << GetLogPrefix() << "Sending `workspace/didChangeWatchedFiles`." << created.size() << "created,"
+                << deleted.size() << "deleted" << endl;
+    LSP::MessageWithParams::Ptr_t req =
+        LSP::MessageWithParams::MakeRequest(new LSP::DidChangeWatchedFilesNotification(created, deleted));
+    QueueMessage(req);
+}
+
 void LanguageServerProtocol::SendWorkspaceExecuteCommand(const wxString& filepath, const LSP::Command& command)
 {
     auto editor = clGetManager()->FindEditor(filepath);
@@ -83,6 +83,13 @@ class WXDLLIMPEXP_SDK LanguageServerProtocol : public wxEvtHandler
     bool m_displayDiagnostics = true;
     int m_lastCompletionRequestId = wxNOT_FOUND;
     wxArrayString m_semanticTokensTypes;
+    // the last semantic tokens result of each file. When the server supports it, we only ask for the changes since
+    // this result ("textDocument/semanticTokens/full/delta")
+    struct SemanticTokensResult {
+        wxString result_id;
+        std::vector<int> data;
+    };
+    std::unordered_map<wxString, SemanticTokensResult> m_semanticTokensResults;
     LSPOnConnectedCallback_t m_onServerStartedCallback = nullptr;
     bool m_incrementalChangeSupported = false;
 
@@ -309,10 +316,17 @@ public:
      */
     void SendCodeActionRequest(IEditor* editor, const std::vector<LSP::Diagnostic>& diags);
 
+    /**
+     * @brief report files created or deleted outside of the editors (`workspace/didChangeWatchedFiles`). Dropped
+     * when the server is not initialized yet: it scans the workspace when it starts
+     */
+    void SendWatchedFilesChanged(const wxArrayString& created, const wxArrayString& deleted);
+
     // helpers
     bool IsCapabilitySupported(const wxString& name) const;
     bool IsDocumentSymbolsSupported() const;
     bool IsSemanticTokensSupported() const;
+    bool IsSemanticTokensDeltaSupported() const;
     bool IsIncrementalChangeSupported() const;
     bool IsDeclarationSupported() const;
     bool IsReferencesSupported() const;
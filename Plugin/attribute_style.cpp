@@ -59,6 +59,28 @@ JSONItem StyleProperty::ToJSON(bool portable) const
     return json;
 }
 
+void StyleProperty::ToBinary(wxDataOutputStream& out) const
+{
+    out.Write32((wxUint32)m_id);
+    out.WriteString(m_name);
+    out.Write64((wxUint64)m_flags);
+    out.WriteString(m_fontDesc);
+    out.WriteString(m_fgColour);
+    out.WriteString(m_bgColour);
+    out.Write32((wxUint32)m_fontSize);
+}
+
+void StyleProperty::FromBinary(wxDataInputStream& in)
+{
+    m_id = (wxInt32)in.Read32();
+    m_name = in.ReadString();
+    m_flags = in.Read64();
+    m_fontDesc = in.ReadString();
+    m_fgColour = in.ReadString();
+    m_bgColour = in.ReadString();
+    m_fontSize = (wxInt32)in.Read32();
+}
+
 void StyleProperty::FromAttributes(wxFont* font) const
 {
     CHECK_PTR_RET(font);
@@ -32,6 +32,7 @@
 #include <map>
 #include <vector>
 #include <wx/colour.h>
+#include <wx/datstrm.h>
 #include <wx/stc/stc.h>
 #include <wx/string.h>
 
@@ -104,6 +105,12 @@ public:
      */
     JSONItem ToJSON(bool portable = false) const;
 
+    /**
+     * @brief binary serialization, used by the lexers cache
+     */
+    void ToBinary(wxDataOutputStream& out) const;
+    void FromBinary(wxDataInputStream& in);
+
     // Accessors
 
     bool IsNull() const { return m_id == STYLE_PROPERTY_NULL_ID; }
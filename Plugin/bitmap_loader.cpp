@@ -26,6 +26,7 @@
 
 #include "Zip/clZipReader.h"
 #include "clFilesCollector.h"
+#include "clStartupTrace.hpp"
 #include "clSystemSettings.h"
 #include "cl_standard_paths.h"
 #include "editor_config.h"
@@ -40,9 +41,13 @@
 #include <array>
 #include <unordered_map>
 #include <wx/app.h>
+#include <wx/datstrm.h>
 #include <wx/dcscreen.h>
 #include <wx/dir.h>
 #include <wx/ffile.h>
+#include <wx/log.h>
+#include <wx/math.h>
+#include <wx/mstream.h>
 #include <wx/msgdlg.h>
 #include <wx/settings.h>
 #include <wx/stdpaths.h>
@@ -50,18 +55,228 @@
 
 namespace
 {
-std::unordered_map<wxString, wxBitmapBundle> DARK_THEME_BMPBUNLES;
-std::unordered_map<wxString, wxBitmapBundle> LIGHT_THEME_BMPBUNLES;
-}; // namespace
+const wxUint32 BITMAPS_CACHE_MAGIC = 0x534c5441; // "ATLS"
+// bump this whenever the cache format or the way the SVG files are rasterized changes
+const wxUint32 BITMAPS_CACHE_VERSION = 1;
+const int BITMAP_SIZE = 16;
 
-BitmapLoader::~BitmapLoader() {}
+bool HashFile(const wxString& path, wxUint64& hash)
+{
+    wxLogNull noLog;
+    wxFFile fp(path, "rb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
 
-BitmapLoader::BitmapLoader(bool darkTheme) { Initialize(darkTheme); }
+    hash = 0;
+    char buffer[4096];
+    size_t count = 0;
+    while ((count = fp.Read(buffer, sizeof(buffer))) > 0) {
+        hash = FileUtils::GetStableHash(buffer, count, hash);
+    }
+    return !fp.Error();
+}
+
+/**
+ * @brief rasterized bitmaps stored on the disk, keyed by the bitmap name and its size in pixels (i.e. the DPI).
+ * Each entry records the hash of the SVG file it was rasterized from, so an updated SVG file is rasterized again
+ */
+class BitmapsCache
+{
+    struct Entry {
+        wxUint64 svg_hash = 0;
+        wxUint32 width = 0;
+        wxUint32 height = 0;
+        double scale = 1.0;
+        std::vector<unsigned char> rgb;
+        std::vector<unsigned char> alpha;
+    };
+
+    wxFileName m_file;
+    std::unordered_map<wxString, Entry> m_entries;
+    bool m_loaded = false;
+    bool m_dirty = false;
+
+    static wxString GetKey(const wxString& name, int size) { return wxString() << name << "@" << size; }
+
+    void Load()
+    {
+        m_loaded = true;
+        wxLogNull noLog;
+        wxMemoryBuffer buffer;
+        {
+            wxFFile fp(m_file.GetFullPath(), "rb");
+            if (!fp.IsOpened()) {
+                return;
+            }
+            wxFileOffset len = fp.Length();
+            if (len <= 0 || fp.Read(buffer.GetWriteBuf(len), len) != (size_t)len) {
+                return;
+            }
+            buffer.UngetWriteBuf(len);
+        }
+
+        wxMemoryInputStream mis(buffer.GetData(), buffer.GetDataLen());
+        wxDataInputStream in(mis);
+        if (in.Read32() != BITMAPS_CACHE_MAGIC || in.Read32() != BITMAPS_CACHE_VERSION) {
+            clDEBUG() << "Ignoring outdated bitmaps cache:" << m_file << endl;
+            return;
+        }
+
+        wxUint32 count = in.Read32();
+        for (wxUint32 i = 0; i < count && mis.IsOk(); ++i) {
+            wxString key = in.ReadString();
+            Entry entry;
+            entry.svg_hash = in.Read64();
+            entry.width = in.Read32();
+            entry.height = in.Read32();
+            entry.scale = in.ReadDouble();
+            bool has_alpha = in.Read8() != 0;
+
+            size_t pixels = (size_t)entry.width * entry.height;
+            if (!mis.IsOk() || pixels == 0 || pixels * 4 > mis.GetLength()) {
+                break;
+            }
+            entry.rgb.resize(pixels * 3);
+            in.Read8(entry.rgb.data(), entry.rgb.size());
+            if (has_alpha) {
+                entry.alpha.resize(pixels);
+                in.Read8(entry.alpha.data(), entry.alpha.size());
+            }
+            m_entries.insert({ key, std::move(entry) });
+        }
+
+        // the file ends with the magic number, so a truncated file is detected
+        if (m_entries.size() != count || !mis.IsOk() || in.Read32() != BITMAPS_CACHE_MAGIC) {
+            clWARNING() << "Corrupted bitmaps cache:" << m_file << endl;
+            m_entries.clear();
+        }
+    }
+
+public:
+    void SetFile(const wxFileName& file) { m_file = file; }
+
+    bool Get(const wxString& name, int size, wxUint64 svg_hash, wxBitmap& bmp)
+    {
+        if (!m_loaded) {
+            Load();
+        }
+
+        auto iter = m_entries.find(GetKey(name, size));
+        if (iter == m_entries.end() || iter->second.svg_hash != svg_hash) {
+            return false;
+        }
 
-std::unordered_map<wxString, wxBitmapBundle>* BitmapLoader::GetBundles(bool darkTheme) const
+        const Entry& entry = iter->second;
+        wxImage img(entry.width, entry.height, false);
+        std::copy(entry.rgb.begin(), entry.rgb.end(), img.GetData());
+        if (!entry.alpha.empty()) {
+            img.SetAlpha();
+            std::copy(entry.alpha.begin(), entry.alpha.end(), img.GetAlpha());
+        }
+        bmp = wxBitmap(img, wxBITMAP_SCREEN_DEPTH, entry.scale);
+        return bmp.IsOk();
+    }
+
+    void Put(const wxString& name, int size, wxUint64 svg_hash, const wxBitmap& bmp)
+    {
+        if (!m_loaded) {
+            Load();
+        }
+
+        wxImage img = bmp.ConvertToImage();
+        if (!img.IsOk()) {
+            return;
+        }
+
+        Entry entry;
+        entry.svg_hash = svg_hash;
+        entry.width = img.GetWidth();
+        entry.height = img.GetHeight();
+        entry.scale = bmp.GetScaleFactor();
+
+        size_t pixels = (size_t)entry.width * entry.height;
+        entry.rgb.assign(img.GetData(), img.GetData() + pixels * 3);
+        if (img.HasAlpha()) {
+            entry.alpha.assign(img.GetAlpha(), img.GetAlpha() + pixels);
+        }
+        m_entries[GetKey(name, size)] = std::move(entry);
+        m_dirty = true;
+    }
+
+    void Save()
+    {
+        if (!m_dirty) {
+            return;
+        }
+        m_dirty = false;
+
+        wxMemoryOutputStream mos;
+        wxDataOutputStream out(mos);
+        out.Write32(BITMAPS_CACHE_MAGIC);
+        out.Write32(BITMAPS_CACHE_VERSION);
+        out.Write32(m_entries.size());
+        for (const auto& vt : m_entries) {
+            const Entry& entry = vt.second;
+            out.WriteString(vt.first);
+            out.Write64(entry.svg_hash);
+            out.Write32(entry.width);
+            out.Write32(entry.height);
+            out.WriteDouble(entry.scale);
+            out.Write8(entry.alpha.empty() ? 0 : 1);
+            out.Write8(entry.rgb.data(), entry.rgb.size());
+            if (!entry.alpha.empty()) {
+                out.Write8(entry.alpha.data(), entry.alpha.size());
+            }
+        }
+        out.Write32(BITMAPS_CACHE_MAGIC);
+
+        m_file.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+        std::string content((const char*)mos.GetOutputStreamBuffer()->GetBufferStart(), mos.GetLength());
+        if (!FileUtils::WriteFileContentRaw(m_file, content)) {
+            clWARNING() << "Failed to write bitmaps cache:" << m_file << endl;
+        }
+    }
+};
+
+/**
+ * @brief the SVG files of a theme. Bundles are created (i.e. the SVG file is parsed) upon request
+ */
+struct ThemeBitmaps {
+    bool scanned = false;
+    std::unordered_map<wxString, wxString> svg_files;
+    std::unordered_map<wxString, wxBitmapBundle> bundles;
+    BitmapsCache cache;
+};
+
+ThemeBitmaps DARK_THEME_BITMAPS;
+ThemeBitmaps LIGHT_THEME_BITMAPS;
+
+ThemeBitmaps& GetThemeBitmaps(bool darkTheme) { return darkTheme ? DARK_THEME_BITMAPS : LIGHT_THEME_BITMAPS; }
+
+const wxBitmapBundle* FindBundle(ThemeBitmaps& theme, const wxString& name)
 {
-    return darkTheme ? &DARK_THEME_BMPBUNLES : &LIGHT_THEME_BMPBUNLES;
+    auto bundle = theme.bundles.find(name);
+    if (bundle != theme.bundles.end()) {
+        return &bundle->second;
+    }
+
+    auto svg_file = theme.svg_files.find(name);
+    if (svg_file == theme.svg_files.end()) {
+        return nullptr;
+    }
+
+    auto bmpbundle = wxBitmapBundle::FromSVGFile(svg_file->second, wxSize(BITMAP_SIZE, BITMAP_SIZE));
+    if (!bmpbundle.IsOk()) {
+        return nullptr;
+    }
+    return &theme.bundles.insert({ name, bmpbundle }).first->second;
 }
+}; // namespace
+
+BitmapLoader::~BitmapLoader() {}
+
+BitmapLoader::BitmapLoader(bool darkTheme) { Initialize(darkTheme); }
 
 const wxBitmap& BitmapLoader::LoadBitmap(const wxString& name, int requestedSize)
 {
@@ -69,11 +284,63 @@ const wxBitmap& BitmapLoader::LoadBitmap(const wxString& name, int requestedSize
     wxUnusedVar(requestedSize);
     wxString newName = name.AfterLast('/');
 
-    if (m_toolbarsBitmaps.count(newName) == 0) {
+    auto iter = m_toolbarsBitmaps.find(newName);
+    if (iter != m_toolbarsBitmaps.end()) {
+        return iter->second;
+    }
+
+    wxBitmap bmp = DoRasterize(newName);
+    if (!bmp.IsOk()) {
         LOG_IF_WARN { clWARNING() << "requested image:" << newName << "does not exist" << endl; }
         return wxNullBitmap;
     }
-    return m_toolbarsBitmaps.find(newName)->second;
+    return m_toolbarsBitmaps.insert({ newName, bmp }).first->second;
+}
+
+wxBitmap BitmapLoader::DoRasterize(const wxString& name)
+{
+    ThemeBitmaps& theme = GetThemeBitmaps(m_darkTheme);
+    auto svg_file = theme.svg_files.find(name);
+    if (svg_file == theme.svg_files.end()) {
+        return wxNullBitmap;
+    }
+
+    wxWindow* win = wxTheApp ? wxTheApp->GetTopWindow() : nullptr;
+    int size = wxRound(BITMAP_SIZE * (win ? win->GetDPIScaleFactor() : 1.0));
+
+    wxUint64 svg_hash = 0;
+    bool hashed = HashFile(svg_file->second, svg_hash);
+
+    wxBitmap bmp;
+    if (hashed && theme.cache.Get(name, size, svg_hash, bmp)) {
+        return bmp;
+    }
+
+    const wxBitmapBundle* bundle = FindBundle(theme, name);
+    if (!bundle) {
+        return wxNullBitmap;
+    }
+
+    bmp = win ? bundle->GetBitmapFor(win) : bundle->GetBitmap(wxSize(size, size));
+    if (!bmp.IsOk() || !hashed) {
+        return bmp;
+    }
+
+    // store the new bitmap, the cache is written once the current batch of bitmaps was rasterized
+    theme.cache.Put(name, size, svg_hash, bmp);
+    if (!m_saveCachePending) {
+        m_saveCachePending = true;
+        if (wxTheApp) {
+            CallAfter([this]() {
+                m_saveCachePending = false;
+                GetThemeBitmaps(m_darkTheme).cache.Save();
+            });
+        } else {
+            m_saveCachePending = false;
+            theme.cache.Save();
+        }
+    }
+    return bmp;
 }
 
 int BitmapLoader::GetMimeImageId(int type, bool disabled) { return GetMimeBitmaps().GetIndex(type, disabled); }
@@ -90,16 +357,9 @@ wxIcon BitmapLoader::GetIcon(const wxBitmap& bmp) const
     return icn;
 }
 
-void BitmapLoader::AddBitmapInternal(const wxBitmapBundle& bundle, const wxString& base_name)
-{
-    wxBitmap bmp = bundle.GetBitmapFor(wxTheApp->GetTopWindow());
-    if (bmp.IsOk()) {
-        m_toolbarsBitmaps.insert({ base_name, bmp });
-    }
-}
-
 void BitmapLoader::LoadSVGFiles(bool darkTheme)
 {
+    clStartupTrace::Scope trace("BitmapLoader::LoadSVGFiles", "themes");
     // Load the bitmaps based on the current theme background colour
     wxFileName svg_path{ clStandardPaths::Get().GetDataDir(), wxEmptyString };
     svg_path.AppendDir("svgs");
@@ -109,37 +369,34 @@ void BitmapLoader::LoadSVGFiles(bool darkTheme)
         clWARNING() << "Unable to load SVG images. Broken installation" << endl;
         return;
     }
-    auto bitmap_bundle_cache = GetBundles(darkTheme);
+    ThemeBitmaps& theme = GetThemeBitmaps(darkTheme);
 
-    // load the cache
-    if (bitmap_bundle_cache->empty()) {
+    // register the files
+    if (!theme.scanned) {
+        theme.scanned = true;
         clFilesScanner scanner;
-        clDEBUG() << "Loading SVG files from:" << svg_path.GetPath() << endl;
+        clDEBUG() << "Registering SVG files from:" << svg_path.GetPath() << endl;
         scanner.ScanWithCallbacks(svg_path.GetPath(), nullptr, [&](const wxArrayString& files) -> bool {
             for (const wxString& filepath : files) {
-                auto bmpbundle = wxBitmapBundle::FromSVGFile(filepath, wxSize(16, 16));
-                if (bmpbundle.IsOk()) {
-                    bitmap_bundle_cache->insert({ wxFileName(filepath).GetName(), bmpbundle });
-                }
+                theme.svg_files.insert({ wxFileName(filepath).GetName(), filepath });
             }
             return true;
         });
+
+        wxFileName cache_file{ clStandardPaths::Get().GetUserDataDir(),
+                               darkTheme ? "bitmaps-dark.cache" : "bitmaps-light.cache" };
+        cache_file.AppendDir("cache");
+        theme.cache.SetFile(cache_file);
     }
 }
 
 void BitmapLoader::Initialize(bool darkTheme)
 {
+    m_darkTheme = darkTheme;
     LoadSVGFiles(darkTheme);
-    auto bitmap_bundle_cache = GetBundles(darkTheme);
-
     m_toolbarsBitmaps.clear();
-    m_toolbarsBitmaps.reserve(bitmap_bundle_cache->size());
-
-    for (const auto& vt : *bitmap_bundle_cache) {
-        AddBitmapInternal(vt.second, vt.first);
-    }
 
-    // Create the mime-list
+    // Create the mime-list. Only the bitmaps it uses are rasterized
     CreateMimeList();
 }
 
@@ -246,14 +503,10 @@ const wxBitmapBundle& BitmapLoader::GetBundle(const wxString& name) const
 {
     static wxBitmapBundle NullBundle;
     bool darkTheme = clSystemSettings::Get().IsDark();
-    auto bitmap_bundle_cache = GetBundles(darkTheme);
+    const_cast<BitmapLoader*>(this)->LoadSVGFiles(darkTheme);
 
-    auto bundle = bitmap_bundle_cache->find(name);
-    if (bundle == bitmap_bundle_cache->end()) {
-        return NullBundle;
-    } else {
-        return bundle->second;
-    }
+    const wxBitmapBundle* bundle = FindBundle(GetThemeBitmaps(darkTheme), name);
+    return bundle ? *bundle : NullBundle;
 }
 
 //===---------------------------
@@ -358,18 +611,19 @@ clBitmaps& clBitmaps::Get()
 
 BitmapLoader* clBitmaps::GetLoader() { return m_activeBitmaps; }
 
-void clBitmaps::Initialise()
-{
-    m_darkBitmaps = new BitmapLoader(true);
-    m_lightBitmaps = new BitmapLoader(false);
-    SysColoursChanged();
-}
+void clBitmaps::Initialise() { SysColoursChanged(); }
 
 void clBitmaps::SysColoursChanged()
 {
     auto old_ptr = m_activeBitmaps;
     bool isDark = clSystemSettings::IsDark();
-    m_activeBitmaps = isDark ? m_darkBitmaps : m_lightBitmaps;
+
+    // the loader of a theme is created the first time the theme is used
+    BitmapLoader*& loader = isDark ? m_darkBitmaps : m_lightBitmaps;
+    if (!loader) {
+        loader = new BitmapLoader(isDark);
+    }
+    m_activeBitmaps = loader;
 
     if (old_ptr != m_activeBitmaps) {
         // change was made, fire an event
@@ -548,13 +802,14 @@ const wxString& clBitmapList::GetBitmapName(size_t index) const
 
 bool BitmapLoader::GetIconBundle(const wxString& name, wxIconBundle* bundle)
 {
-    LoadSVGFiles(clSystemSettings::IsDark());
-    auto bundles = GetBundles(clSystemSettings::IsDark());
-    if (bundles->count(name) == 0) {
+    bool darkTheme = clSystemSettings::IsDark();
+    LoadSVGFiles(darkTheme);
+    const wxBitmapBundle* bundle = FindBundle(GetThemeBitmaps(darkTheme), name);
+    if (!bundle) {
         return false;
     }
 
-    const auto& bmp_bundle = bundles->find(name)->second;
+    const auto& bmp_bundle = *bundle;
     std::array<int, 5> sizes = { 24, 32, 64, 128, 256 };
     for (int size : sizes) {
         size = wxTheApp->GetTopWindow()->FromDIP(size);
@@ -142,6 +142,9 @@ public:
 
 protected:
     wxFileName m_zipPath;
+    bool m_darkTheme = false;
+    bool m_saveCachePending = false;
+    /// The rasterized bitmaps, by name. Created upon request
     std::unordered_map<wxString, wxBitmap> m_toolbarsBitmaps;
     std::unordered_map<wxString, wxString> m_manifest;
     std::unordered_map<int, int> m_fileIndexMap;
@@ -154,7 +157,11 @@ private:
     BitmapLoader(bool darkTheme);
     virtual ~BitmapLoader();
 
-    void AddBitmapInternal(const wxBitmapBundle& bundle, const wxString& base_name);
+    /**
+     * @brief rasterize a bitmap for the top level window DPI. The bitmap is taken from the on-disk cache when
+     * possible, otherwise the SVG file is parsed and the result is added to the cache
+     */
+    wxBitmap DoRasterize(const wxString& name);
 
 public:
     clMimeBitmaps& GetMimeBitmaps() { return m_mimeBitmaps; }
@@ -198,8 +205,10 @@ protected:
 
 private:
     void Initialize(bool darkTheme);
+    /**
+     * @brief register the SVG files of a theme by their name. The files are not parsed
+     */
     void LoadSVGFiles(bool darkTheme);
-    std::unordered_map<wxString, wxBitmapBundle>* GetBundles(bool darkTheme) const;
 
 public:
     const wxBitmap& LoadBitmap(const wxString& name, int requestedSize = 16);
@@ -90,6 +90,11 @@ public:
      */
     bool Load(const wxString& version, const wxString& xmlFilePath = "");
 
+    /**
+     * @brief the build_settings.xml file that was loaded
+     */
+    const wxFileName& GetFileName() const { return m_fileName; }
+
     /**
      * @brief delete all compilers
      */
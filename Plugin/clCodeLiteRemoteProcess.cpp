@@ -13,6 +13,7 @@
 #include "globals.h"
 
 #include <cJSON.h>
+#include <cstdio>
 #include <functional>
 #include <unordered_map>
 #include <wx/event.h>
@@ -35,8 +36,12 @@ wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_LIST_LSPS, clCommandEvent);
 wxDEFINE_EVENT(wxEVT_CODELITE_REMOTE_LIST_LSPS_DONE, clCommandEvent);
 namespace
 {
-const char msg_terminator[] = ">>codelite-remote-msg-end<<\n";
-size_t msg_terminator_len = sizeof(msg_terminator) - 1;
+// every reply frame starts with a header line: "@@clr <request-id> <type> <payload-length>\n"
+// followed by exactly <payload-length> bytes. <type> is 'o' for output or 'e' for end of reply
+const char frame_prefix[] = "@@clr ";
+constexpr size_t frame_prefix_len = sizeof(frame_prefix) - 1;
+// compact the input buffer once we consumed this many bytes from its head
+constexpr size_t compact_threshold = 64 * 1024;
 } // namespace
 
 namespace
@@ -234,7 +239,7 @@ void clCodeLiteRemoteProcess::StartInteractive(const SSHAccountInfo& account,
 
 void clCodeLiteRemoteProcess::OnProcessOutput(clProcessEvent& e)
 {
-    m_outputRead << e.GetOutput();
+    m_outputRead.append(e.GetOutputRaw());
     ProcessOutput();
 }
 
@@ -265,75 +270,155 @@ void clCodeLiteRemoteProcess::Stop()
 
 void clCodeLiteRemoteProcess::Cleanup()
 {
-    while (!m_completionCallbacks.empty()) {
-        m_completionCallbacks.pop_back();
-    }
+    m_completionCallbacks.clear();
+    m_fif_counters.clear();
+    m_outputRead.clear();
+    m_outputReadPos = 0;
     m_process.reset();
 }
 
-bool clCodeLiteRemoteProcess::GetNextBuffer(wxString& raw_input_buffer, wxString& buffer, bool& is_completed)
+bool clCodeLiteRemoteProcess::GetNextFrame(size_t& request_id, wxString& output, bool& is_completed)
 {
-    size_t separator_len = msg_terminator_len;
-    size_t where = raw_input_buffer.find(msg_terminator);
-    if (where == wxString::npos) {
-        // locate the \n from the end
-        is_completed = false;
-        where = raw_input_buffer.rfind("\n");
-        separator_len = 1;
-    } else {
-        is_completed = true;
-    }
+    while (m_outputReadPos < m_outputRead.size()) {
+        size_t header_start = m_outputRead.find(frame_prefix, m_outputReadPos);
+        if (header_start == std::string::npos) {
+            // no frame header. Keep the tail of the buffer in case it contains a partial prefix
+            size_t keep_from = m_outputRead.size() > frame_prefix_len ? m_outputRead.size() - frame_prefix_len : 0;
+            if (keep_from > m_outputReadPos) {
+                clDEBUG() << "codelite-remote: discarding" << (keep_from - m_outputReadPos)
+                          << "bytes of unframed output" << endl;
+                m_outputRead.erase(0, keep_from);
+                m_outputReadPos = 0;
+            }
+            break;
+        }
 
-    if (where != wxString::npos) {
-        size_t length_to_take = where;
-        if (separator_len == 1) {
-            length_to_take += 1;
+        if (header_start != m_outputReadPos) {
+            clDEBUG() << "codelite-remote: discarding" << (header_start - m_outputReadPos) << "bytes of unframed output"
+                      << endl;
+            m_outputReadPos = header_start;
         }
-        buffer = raw_input_buffer.Mid(0, length_to_take);
-        raw_input_buffer.erase(0, where + separator_len);
-    }
-    return where != wxString::npos;
-}
 
-void clCodeLiteRemoteProcess::ProcessOutput()
-{
-    bool is_completed = false;
-    wxString buffer;
+        size_t header_end = m_outputRead.find('\n', header_start);
+        if (header_end == std::string::npos) {
+            // incomplete header
+            break;
+        }
 
-    while (GetNextBuffer(m_outputRead, buffer, is_completed)) {
-        if (m_completionCallbacks.empty()) {
-            clDEBUG() << "Read: [" << buffer << "]. But there are no completion callback" << endl;
+        std::string header =
+            m_outputRead.substr(header_start + frame_prefix_len, header_end - header_start - frame_prefix_len);
+        unsigned long long id = 0;
+        unsigned long long length = 0;
+        char frame_type = 0;
+        if (sscanf(header.c_str(), "%llu %c %llu", &id, &frame_type, &length) != 3) {
+            clWARNING() << "codelite-remote: malformed frame header:" << header << endl;
+            m_outputReadPos = header_end + 1;
             continue;
         }
 
-        auto p = m_completionCallbacks.front();
-        if (p.user_callback != nullptr) {
-            p.aggregated_output << buffer;
-            if (is_completed) {
-                p.user_callback(p.aggregated_output);
-            }
-        } else if (p.handler) {
-            auto handler = static_cast<CodeLiteRemoteProcess*>(p.handler);
-            handler->PostOutputEvent(buffer);
-            if (is_completed) {
-                handler->PostTerminateEvent();
+        size_t payload_start = header_end + 1;
+        if (m_outputRead.size() - payload_start < length) {
+            // wait for the rest of the payload
+            break;
+        }
 
-                // when using callback the handler is handled internally
-                if (handler->IsUsingCallback()) {
-                    delete handler;
-                }
+        if (length > 0) {
+            const char* payload = m_outputRead.data() + payload_start;
+            output = wxString::FromUTF8(payload, length);
+            if (output.empty()) {
+                output = wxString::From8BitData(payload, length);
             }
-        } else if (p.func) {
-            (this->*p.func)(buffer, is_completed);
+        } else {
+            output.clear();
         }
 
+        request_id = id;
+        is_completed = frame_type == 'e';
+        m_outputReadPos = payload_start + length;
+        if (m_outputReadPos >= m_outputRead.size()) {
+            m_outputRead.clear();
+            m_outputReadPos = 0;
+        } else if (m_outputReadPos >= compact_threshold && m_outputReadPos * 2 >= m_outputRead.size()) {
+            m_outputRead.erase(0, m_outputReadPos);
+            m_outputReadPos = 0;
+        }
+        return true;
+    }
+    return false;
+}
+
+void clCodeLiteRemoteProcess::DispatchOutput(size_t request_id,
+                                             CallbackOptions& cb,
+                                             const wxString& buffer,
+                                             bool is_completed)
+{
+    if (cb.user_callback != nullptr) {
+        cb.aggregated_output << buffer;
+        if (is_completed) {
+            cb.user_callback(cb.aggregated_output);
+        }
+    } else if (cb.handler) {
+        auto handler = static_cast<CodeLiteRemoteProcess*>(cb.handler);
+        handler->PostOutputEvent(buffer);
         if (is_completed) {
-            m_completionCallbacks.pop_front();
-            ResetStates();
+            handler->PostTerminateEvent();
+
+            // when using callback the handler is handled internally
+            if (handler->IsUsingCallback()) {
+                delete handler;
+            }
         }
+    } else if (cb.func) {
+        (this->*cb.func)(request_id, buffer, is_completed);
+    }
+}
+
+void clCodeLiteRemoteProcess::ProcessFrame(size_t request_id, const wxString& buffer, bool is_completed)
+{
+    auto iter = m_completionCallbacks.find(request_id);
+    if (iter == m_completionCallbacks.end()) {
+        clDEBUG() << "Read: [" << buffer << "] for request" << request_id << ". But there is no completion callback"
+                  << endl;
+        return;
+    }
+
+    if (is_completed) {
+        // remove the request before calling the handler, the handler might issue new requests
+        CallbackOptions cb = std::move(iter->second);
+        m_completionCallbacks.erase(iter);
+        DispatchOutput(request_id, cb, buffer, true);
+    } else {
+        DispatchOutput(request_id, iter->second, buffer, false);
+    }
+}
+
+void clCodeLiteRemoteProcess::ProcessOutput()
+{
+    bool is_completed = false;
+    size_t request_id = 0;
+    wxString buffer;
+
+    while (GetNextFrame(request_id, buffer, is_completed)) {
+        ProcessFrame(request_id, buffer, is_completed);
     }
 }
 
+size_t clCodeLiteRemoteProcess::SendCommand(JSONItem& item, CallbackOptions cb)
+{
+    if (!m_process) {
+        return 0;
+    }
+
+    size_t request_id = ++m_nextRequestId;
+    item.addProperty("id", request_id);
+
+    wxString command = item.format(false);
+    LOG_IF_TRACE { clDEBUG1() << "codelite-remote: sending command:" << command << endl; }
+    m_process->Write(command + "\n");
+    m_completionCallbacks.insert({ request_id, std::move(cb) });
+    return request_id;
+}
+
 void clCodeLiteRemoteProcess::ListLSPs()
 {
     if (!m_process) {
@@ -344,10 +429,7 @@ void clCodeLiteRemoteProcess::ListLSPs()
     JSON root(cJSON_Object);
     auto item = root.toElement();
     item.addProperty("command", "list_lsps");
-    m_process->Write(item.format(false) + "\n");
-
-    // push a callback
-    m_completionCallbacks.push_back({ &clCodeLiteRemoteProcess::OnListLSPsOutput, nullptr, nullptr });
+    SendCommand(item, { &clCodeLiteRemoteProcess::OnListLSPsOutput, nullptr, nullptr });
 }
 
 void clCodeLiteRemoteProcess::ListFiles(const wxString& root_dir,
@@ -367,11 +449,7 @@ void clCodeLiteRemoteProcess::ListFiles(const wxString& root_dir,
     item.addProperty("file_extensions", ::wxStringTokenize(extensions, ",; |", wxTOKEN_STRTOK));
     item.addProperty("exclude_extensions", ::wxStringTokenize(exclude_extensions, ",; |", wxTOKEN_STRTOK));
     item.addProperty("exclude_patterns", ::wxStringTokenize(exclude_patterns, ",; |", wxTOKEN_STRTOK));
-    LOG_IF_TRACE { clDEBUG1() << "ListFiles: sending command:" << item.format(false) << endl; }
-    m_process->Write(item.format(false) + "\n");
-
-    // push a callback
-    m_completionCallbacks.push_back({ &clCodeLiteRemoteProcess::OnListFilesOutput, nullptr, nullptr });
+    SendCommand(item, { &clCodeLiteRemoteProcess::OnListFilesOutput, nullptr, nullptr });
 }
 
 void clCodeLiteRemoteProcess::Search(const wxString& root_dir,
@@ -395,13 +473,10 @@ void clCodeLiteRemoteProcess::Search(const wxString& root_dir,
     item.addProperty("exclude_patterns", ::wxStringTokenize(exclude_patterns, ",; |", wxTOKEN_STRTOK));
     item.addProperty("icase", icase);
     item.addProperty("whole_word", whole_word);
-
-    wxString command = item.format(false);
-    m_process->Write(command + "\n");
-    LOG_IF_TRACE { clDEBUG1() << command << endl; }
-
-    // push a callback
-    m_completionCallbacks.push_back({ &clCodeLiteRemoteProcess::OnFindOutput, nullptr, nullptr });
+    size_t request_id = SendCommand(item, { &clCodeLiteRemoteProcess::OnFindOutput, nullptr, nullptr });
+    if (request_id != 0) {
+        m_fif_counters.insert({ request_id, FindInFilesCounters() });
+    }
 }
 
 void clCodeLiteRemoteProcess::Locate(const wxString& path,
@@ -431,12 +506,7 @@ void clCodeLiteRemoteProcess::Locate(const wxString& path,
 
     item.addProperty("versions", v);
 
-    wxString command = item.format(false);
-    m_process->Write(command + "\n");
-    LOG_IF_TRACE { clDEBUG1() << command << endl; }
-
-    // push a callback
-    m_completionCallbacks.push_back({ &clCodeLiteRemoteProcess::OnLocateOutput, nullptr, nullptr });
+    SendCommand(item, { &clCodeLiteRemoteProcess::OnLocateOutput, nullptr, nullptr });
 }
 
 void clCodeLiteRemoteProcess::FindPath(const wxString& path)
@@ -451,25 +521,14 @@ void clCodeLiteRemoteProcess::FindPath(const wxString& path)
     item.addProperty("command", "find_path");
     item.addProperty("path", path);
 
-    wxString command = item.format(false);
-    m_process->Write(command + "\n");
-    LOG_IF_TRACE { clDEBUG1() << command << endl; }
-
-    // push a callback
-    m_completionCallbacks.push_back({ &clCodeLiteRemoteProcess::OnFindPathOutput, nullptr, nullptr });
-}
-
-void clCodeLiteRemoteProcess::ResetStates()
-{
-    m_fif_matches_count = 0;
-    m_fif_files_scanned = 0;
+    SendCommand(item, { &clCodeLiteRemoteProcess::OnFindPathOutput, nullptr, nullptr });
 }
 
-bool clCodeLiteRemoteProcess::DoExec(
+size_t clCodeLiteRemoteProcess::DoExec(
     const wxString& cmd, const wxString& working_directory, const clEnvList_t& env, IProcess* handler, UserCallback cb)
 {
     if (!m_process) {
-        return false;
+        return 0;
     }
 
     // build the command and send it
@@ -486,12 +545,7 @@ bool clCodeLiteRemoteProcess::DoExec(
         entry.addProperty("value", p.second);
     }
 
-    wxString command = item.format(false);
-    m_process->Write(command + "\n");
-
-    // push a callback
-    m_completionCallbacks.push_back({ &clCodeLiteRemoteProcess::OnExecOutput, handler, cb });
-    return true;
+    return SendCommand(item, { &clCodeLiteRemoteProcess::OnExecOutput, handler, std::move(cb) });
 }
 
 void clCodeLiteRemoteProcess::Exec(const wxArrayString& args, const wxString& working_directory, const clEnvList_t& env)
@@ -564,7 +618,7 @@ void clCodeLiteRemoteProcess::CreateAsyncProcessCB(const wxString& cmd,
 // -------------------------------------------------------------------------------------
 // -------------------------------------------------------------------------------------
 
-void clCodeLiteRemoteProcess::OnListLSPsOutput(const wxString& output, bool is_completed)
+void clCodeLiteRemoteProcess::OnListLSPsOutput(size_t request_id, const wxString& output, bool is_completed)
 {
     clCommandEvent event(wxEVT_CODELITE_REMOTE_LIST_LSPS);
 
@@ -578,7 +632,7 @@ void clCodeLiteRemoteProcess::OnListLSPsOutput(const wxString& output, bool is_c
     }
 }
 
-void clCodeLiteRemoteProcess::OnListFilesOutput(const wxString& output, bool is_completed)
+void clCodeLiteRemoteProcess::OnListFilesOutput(size_t request_id, const wxString& output, bool is_completed)
 {
     clCommandEvent event(wxEVT_CODELITE_REMOTE_LIST_FILES);
 
@@ -595,7 +649,7 @@ void clCodeLiteRemoteProcess::OnListFilesOutput(const wxString& output, bool is_
     }
 }
 
-void clCodeLiteRemoteProcess::OnFindPathOutput(const wxString& output, bool is_completed)
+void clCodeLiteRemoteProcess::OnFindPathOutput(size_t request_id, const wxString& output, bool is_completed)
 {
     clCommandEvent event(wxEVT_CODELITE_REMOTE_FINDPATH);
 
@@ -612,7 +666,7 @@ void clCodeLiteRemoteProcess::OnFindPathOutput(const wxString& output, bool is_c
     }
 }
 
-void clCodeLiteRemoteProcess::OnLocateOutput(const wxString& output, bool is_completed)
+void clCodeLiteRemoteProcess::OnLocateOutput(size_t request_id, const wxString& output, bool is_completed)
 {
     clCommandEvent event(wxEVT_CODELITE_REMOTE_LOCATE);
 
@@ -646,7 +700,7 @@ bool split_line(wxString& line, wxString* filename, long* line_number, wxString*
 }
 } // namespace
 
-void clCodeLiteRemoteProcess::OnReplaceOutput(const wxString& output, bool is_completed)
+void clCodeLiteRemoteProcess::OnReplaceOutput(size_t request_id, const wxString& output, bool is_completed)
 {
     wxArrayString lines = ::wxStringTokenize(output, "\r\n", wxTOKEN_STRTOK);
     if (lines.empty()) {
@@ -664,7 +718,7 @@ void clCodeLiteRemoteProcess::OnReplaceOutput(const wxString& output, bool is_co
     }
 }
 
-void clCodeLiteRemoteProcess::OnFindOutput(const wxString& output, bool is_completed)
+void clCodeLiteRemoteProcess::OnFindOutput(size_t request_id, const wxString& output, bool is_completed)
 {
     wxArrayString lines = ::wxStringTokenize(output, "\r\n", wxTOKEN_STRTOK);
     if (!lines.empty()) {
@@ -692,7 +746,7 @@ void clCodeLiteRemoteProcess::OnFindOutput(const wxString& output, bool is_compl
             loc.column_end = 0;
             loc.column_start = 0;
             match.locations.emplace_back(loc);
-            ++m_fif_matches_count;
+            ++m_fif_counters[request_id].matches_count;
         }
 
         if (!match.file.empty() && !match.locations.empty()) {
@@ -708,13 +762,17 @@ void clCodeLiteRemoteProcess::OnFindOutput(const wxString& output, bool is_compl
     }
 
     if (is_completed) {
+        clDEBUG() << "codelite-remote: search" << request_id << "completed with"
+                  << m_fif_counters[request_id].matches_count << "matches" << endl;
+        m_fif_counters.erase(request_id);
+
         clFindInFilesEvent event_done(wxEVT_CODELITE_REMOTE_FIND_RESULTS_DONE);
         event_done.SetInt(0);
         AddPendingEvent(event_done);
     }
 }
 
-void clCodeLiteRemoteProcess::OnExecOutput(const wxString& buffer, bool is_completed)
+void clCodeLiteRemoteProcess::OnExecOutput(size_t request_id, const wxString& buffer, bool is_completed)
 {
     if (!buffer.empty()) {
         clProcessEvent output_event(wxEVT_CODELITE_REMOTE_EXEC_OUTPUT);
@@ -733,10 +791,6 @@ bool clCodeLiteRemoteProcess::SyncExec(const wxString& cmd,
                                        const clEnvList_t& env,
                                        wxString* output)
 {
-    if (!m_completionCallbacks.empty()) {
-        clWARNING() << "unable to run SyncExec() for command:" << cmd << "async queue is not empty" << endl;
-        return false;
-    }
     if (!m_process) {
         clWARNING() << "unable to run SyncExec() for command:" << cmd << "no process" << endl;
         return false;
@@ -744,35 +798,49 @@ bool clCodeLiteRemoteProcess::SyncExec(const wxString& cmd,
     // disable the background reader thread
     m_process->SuspendAsyncReads();
 
-    if (!DoExec(cmd, working_directory, env)) {
+    size_t request_id = DoExec(cmd, working_directory, env);
+    if (request_id == 0) {
+        m_process->ResumeAsyncReads();
         return false;
     }
 
-    // DoExec pushes a callback to the queue - pop it
-    // as we dont really need it
-    m_completionCallbacks.pop_back();
+    // we read the reply ourselves, we don't need the callback
+    m_completionCallbacks.erase(request_id);
 
     // read
     wxString buff_out, buff_err;
     std::string raw_buff, raw_buff_err;
-    m_outputRead.clear();
 
     wxString complete_output;
-    while (m_process->Read(buff_out, buff_err, raw_buff, raw_buff_err)) {
-        m_outputRead << buff_out;
-        size_t where = m_outputRead.find(msg_terminator);
-        if (where == wxString::npos) {
-            continue;
+    while (true) {
+        raw_buff.clear();
+        raw_buff_err.clear();
+        if (!m_process->Read(buff_out, buff_err, raw_buff, raw_buff_err)) {
+            break;
         }
+        m_outputRead.append(raw_buff);
+
+        size_t frame_id = 0;
+        bool is_completed = false;
+        wxString payload;
+        while (GetNextFrame(frame_id, payload, is_completed)) {
+            if (frame_id != request_id) {
+                // replies to other requests that are running concurrently
+                ProcessFrame(frame_id, payload, is_completed);
+                continue;
+            }
 
-        // strip the terminator and make it our output
-        *output = m_outputRead.Mid(0, where);
-        LOG_IF_TRACE { clDEBUG1() << "SyncExec(" << cmd << "):" << *output << endl; }
+            complete_output << payload;
+            if (is_completed) {
+                *output = complete_output;
+                LOG_IF_TRACE { clDEBUG1() << "SyncExec(" << cmd << "):" << *output << endl; }
 
-        m_outputRead.clear();
-        // resume the async nature of the process
-        m_process->ResumeAsyncReads();
-        return true;
+                // resume the async nature of the process and handle any frames that arrived after ours
+                m_process->ResumeAsyncReads();
+                ProcessOutput();
+                return true;
+            }
+        }
     }
 
     // process terminated
@@ -805,10 +873,5 @@ void clCodeLiteRemoteProcess::Replace(const wxString& root_dir,
     item.addProperty("icase", icase);
     item.addProperty("whole_word", whole_word);
 
-    wxString command = item.format(false);
-    m_process->Write(command + "\n");
-    LOG_IF_TRACE { clDEBUG1() << command << endl; }
-
-    // push a callback
-    m_completionCallbacks.push_back({ &clCodeLiteRemoteProcess::OnReplaceOutput, nullptr, nullptr });
+    SendCommand(item, { &clCodeLiteRemoteProcess::OnReplaceOutput, nullptr, nullptr });
 }
\ No newline at end of file
@@ -2,13 +2,15 @@
 #define CLCODELITEREMOTEPROCESS_HPP
 
 #include "AsyncProcess/asyncprocess.h"
+#include "JSON.h"
 #include "cl_command_event.h"
 #include "codelite_exports.h"
 #include "ssh/ssh_account_info.h"
 
-#include <deque>
 #include <functional>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 #include <wx/arrstr.h>
 #include <wx/event.h>
@@ -17,7 +19,7 @@
 class WXDLLIMPEXP_SDK clCodeLiteRemoteProcess : public wxEvtHandler
 {
 protected:
-    typedef void (clCodeLiteRemoteProcess::*CallbackFunc)(const wxString&, bool);
+    typedef void (clCodeLiteRemoteProcess::*CallbackFunc)(size_t request_id, const wxString&, bool);
     typedef std::function<void(const wxString&)> UserCallback;
     struct CallbackOptions {
         CallbackFunc func = nullptr;
@@ -37,10 +39,18 @@ protected:
 
 protected:
     std::unique_ptr<IProcess> m_process;
-    std::deque<CallbackOptions> m_completionCallbacks;
-    wxString m_outputRead;
-    size_t m_fif_matches_count = 0;
-    size_t m_fif_files_scanned = 0;
+    // pending requests, keyed by their request id
+    std::map<size_t, CallbackOptions> m_completionCallbacks;
+    size_t m_nextRequestId = 0;
+    // raw bytes read from the remote process. Bytes before m_outputReadPos were already consumed
+    std::string m_outputRead;
+    size_t m_outputReadPos = 0;
+    struct FindInFilesCounters {
+        size_t matches_count = 0;
+        size_t files_scanned = 0;
+    };
+    // searches may run concurrently, their counters are keyed by the request id
+    std::map<size_t, FindInFilesCounters> m_fif_counters;
     bool m_going_down = false;
     wxString m_context;
     SSHAccountInfo m_account;
@@ -51,22 +61,35 @@ protected:
     void OnProcessTerminated(clProcessEvent& e);
     void Cleanup();
     void ProcessOutput();
-    bool GetNextBuffer(wxString& raw_input_buffer, wxString& output, bool& is_completed);
-    void ResetStates();
+    /**
+     * @brief extract the next complete frame from the input buffer
+     * @param request_id [output] the request this frame belongs to
+     * @param output [output] the frame payload
+     * @param is_completed [output] set to true if this is the last frame of the reply
+     * @return true if a complete frame was found, false if more input is needed
+     */
+    bool GetNextFrame(size_t& request_id, wxString& output, bool& is_completed);
+    void ProcessFrame(size_t request_id, const wxString& buffer, bool is_completed);
+    void DispatchOutput(size_t request_id, CallbackOptions& cb, const wxString& buffer, bool is_completed);
+    /**
+     * @brief send a command to the remote process and register its completion callback
+     * @return the request id (0 on error)
+     */
+    size_t SendCommand(JSONItem& item, CallbackOptions cb);
 
     // prepare an event from list command output
-    void OnListFilesOutput(const wxString& output, bool is_completed);
-    void OnListLSPsOutput(const wxString& output, bool is_completed);
-    void OnFindOutput(const wxString& buffer, bool is_completed);
-    void OnReplaceOutput(const wxString& buffer, bool is_completed);
-    void OnLocateOutput(const wxString& buffer, bool is_completed);
-    void OnFindPathOutput(const wxString& buffer, bool is_completed);
-    void OnExecOutput(const wxString& buffer, bool is_completed);
-    bool DoExec(const wxString& cmd,
-                const wxString& working_directory,
-                const clEnvList_t& env,
-                IProcess* handler = nullptr,
-                UserCallback cb = nullptr);
+    void OnListFilesOutput(size_t request_id, const wxString& output, bool is_completed);
+    void OnListLSPsOutput(size_t request_id, const wxString& output, bool is_completed);
+    void OnFindOutput(size_t request_id, const wxString& buffer, bool is_completed);
+    void OnReplaceOutput(size_t request_id, const wxString& buffer, bool is_completed);
+    void OnLocateOutput(size_t request_id, const wxString& buffer, bool is_completed);
+    void OnFindPathOutput(size_t request_id, const wxString& buffer, bool is_completed);
+    void OnExecOutput(size_t request_id, const wxString& buffer, bool is_completed);
+    size_t DoExec(const wxString& cmd,
+                  const wxString& working_directory,
+                  const clEnvList_t& env,
+                  IProcess* handler = nullptr,
+                  UserCallback cb = nullptr);
 
     template <typename Container>
     wxString GetCmdString(const Container& args) const
@@ -240,7 +240,7 @@ void clDataViewListCtrl::DeleteAllItems(const std::function<void(wxUIntPtr)>& de
 {
     // If a deleter was provided, call it per user's item data
     if(deleterFunc && m_model.GetRoot()) {
-        clRowEntry::Vec_t& children = m_model.GetRoot()->GetChildren();
+        const clRowEntry::Vec_t& children = m_model.GetRoot()->GetChildren();
         for(size_t i = 0; i < children.size(); ++i) {
             wxUIntPtr userData = children[i]->GetData();
             if(userData) {
@@ -472,7 +472,7 @@ void clDataViewListCtrl::SetSortFunction(const clSortFunc_t& CompareFunc)
 
     // This list ctrl is composed of a hidden root + its children
     // Step 1:
-    clRowEntry::Vec_t& children = root->GetChildren();
+    const clRowEntry::Vec_t& children = root->GetChildren();
     for(size_t i = 0; i < children.size(); ++i) {
         clRowEntry* child = children[i];
         child->SetNext(nullptr);
@@ -483,7 +483,7 @@ void clDataViewListCtrl::SetSortFunction(const clSortFunc_t& CompareFunc)
     root->SetNext(nullptr);
 
     // Step 3: sort the children
-    std::sort(children.begin(), children.end(), CompareFunc);
+    root->SortChildren(CompareFunc);
 
     // Now, reconnect the children, starting with the root
     clRowEntry* prev = root;
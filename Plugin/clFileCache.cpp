@@ -1,12 +1,29 @@
 #include "clFileCache.hpp"
 
-void clFileCache::Add(const wxFileName& fn)
+#include <algorithm>
+
+bool clFileCache::Add(const wxFileName& fn)
 {
-    if(Contains(fn)) {
-        return;
+    if(!m_filesSet.insert(fn.GetFullPath()).second) {
+        return false;
     }
     m_files.push_back(fn);
-    m_filesSet.insert(fn.GetFullPath());
+    return true;
+}
+
+void clFileCache::Remove(const std::function<bool(const wxString&)>& pred, wxArrayString& removed)
+{
+    // a single pass keeps the removal linear, no matter how many files are removed
+    auto iter = std::remove_if(m_files.begin(), m_files.end(), [&](const wxFileName& fn) {
+        wxString fullpath = fn.GetFullPath();
+        if(!pred(fullpath)) {
+            return false;
+        }
+        m_filesSet.erase(fullpath);
+        removed.Add(fullpath);
+        return true;
+    });
+    m_files.erase(iter, m_files.end());
 }
 
 void clFileCache::Clear()
@@ -4,8 +4,10 @@
 #include "codelite_exports.h"
 #include "wxStringHash.h"
 
+#include <functional>
 #include <unordered_set>
 #include <vector>
+#include <wx/arrstr.h>
 #include <wx/filename.h>
 
 class WXDLLIMPEXP_SDK clFileCache
@@ -26,7 +28,15 @@ public:
     const_iterator end() const { return m_files.end(); }
 
     void Alloc(size_t size);
-    void Add(const wxFileName& fn);
+    /**
+     * @brief add a file. Return false if the file is already in the cache
+     */
+    bool Add(const wxFileName& fn);
+
+    /**
+     * @brief remove the files for which `pred` returns true. Their paths are appended to `removed`
+     */
+    void Remove(const std::function<bool(const wxString&)>& pred, wxArrayString& removed);
     void Clear();
     bool Contains(const wxFileName& fn) const;
     size_t GetSize() const { return m_files.size(); }
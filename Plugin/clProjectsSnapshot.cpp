@@ -0,0 +1,127 @@
+#include "clProjectsSnapshot.hpp"
+
+#include "file_logger.h"
+#include "fileutils.h"
+
+#include <wx/datstrm.h>
+#include <wx/ffile.h>
+#include <wx/log.h>
+#include <wx/mstream.h>
+
+namespace
+{
+const wxUint32 SNAPSHOT_MAGIC = 0x53504c43; // "CLPS"
+// bump this whenever the format or the way the projects build their cache changes
+const wxUint32 SNAPSHOT_VERSION = 1;
+} // namespace
+
+bool clProjectsSnapshot::Entry::IsValidFor(const wxFileName& project_file) const
+{
+    return mtime != 0 && mtime == FileUtils::GetFileModificationTime(project_file) &&
+           size == FileUtils::GetFileSize(project_file);
+}
+
+void clProjectsSnapshot::Entry::Reset(const wxFileName& project_file)
+{
+    nodes.clear();
+    mtime = FileUtils::GetFileModificationTime(project_file);
+    size = FileUtils::GetFileSize(project_file);
+}
+
+bool clProjectsSnapshot::Load(const wxFileName& file)
+{
+    m_entries.clear();
+
+    wxLogNull noLog;
+    wxMemoryBuffer buffer;
+    {
+        wxFFile fp(file.GetFullPath(), "rb");
+        if (!fp.IsOpened()) {
+            return false;
+        }
+        wxFileOffset len = fp.Length();
+        if (len <= 0 || fp.Read(buffer.GetWriteBuf(len), len) != (size_t)len) {
+            return false;
+        }
+        buffer.UngetWriteBuf(len);
+    }
+
+    wxMemoryInputStream mis(buffer.GetData(), buffer.GetDataLen());
+    wxDataInputStream in(mis);
+    if (in.Read32() != SNAPSHOT_MAGIC || in.Read32() != SNAPSHOT_VERSION) {
+        clDEBUG() << "Ignoring outdated projects snapshot:" << file << endl;
+        return false;
+    }
+
+    wxUint32 count = in.Read32();
+    for (wxUint32 i = 0; i < count && mis.IsOk(); ++i) {
+        wxString project_file = in.ReadString();
+        Entry entry;
+        entry.mtime = in.Read64();
+        entry.size = in.Read64();
+        wxUint32 nodes_count = in.Read32();
+        if (!mis.IsOk() || nodes_count > mis.GetLength()) {
+            break;
+        }
+
+        entry.nodes.resize(nodes_count);
+        for (auto& node : entry.nodes) {
+            node.is_file = in.Read8() != 0;
+            node.name = in.ReadString();
+            if (node.is_file) {
+                node.filename = in.ReadString();
+                node.flags = in.Read64();
+                node.exclude_configs = in.ReadString();
+            }
+        }
+        m_entries.insert({ project_file, std::move(entry) });
+    }
+
+    // the file ends with the magic number, so a truncated file is detected
+    if (m_entries.size() != count || !mis.IsOk() || in.Read32() != SNAPSHOT_MAGIC) {
+        clWARNING() << "Corrupted projects snapshot:" << file << endl;
+        m_entries.clear();
+        return false;
+    }
+    return true;
+}
+
+bool clProjectsSnapshot::Save(const wxFileName& file) const
+{
+    wxMemoryOutputStream mos;
+    wxDataOutputStream out(mos);
+    out.Write32(SNAPSHOT_MAGIC);
+    out.Write32(SNAPSHOT_VERSION);
+    out.Write32(m_entries.size());
+    for (const auto& vt : m_entries) {
+        const Entry& entry = vt.second;
+        out.WriteString(vt.first);
+        out.Write64((wxUint64)entry.mtime);
+        out.Write64((wxUint64)entry.size);
+        out.Write32(entry.nodes.size());
+        for (const auto& node : entry.nodes) {
+            out.Write8(node.is_file ? 1 : 0);
+            out.WriteString(node.name);
+            if (node.is_file) {
+                out.WriteString(node.filename);
+                out.Write64((wxUint64)node.flags);
+                out.WriteString(node.exclude_configs);
+            }
+        }
+    }
+    out.Write32(SNAPSHOT_MAGIC);
+
+    std::string content((const char*)mos.GetOutputStreamBuffer()->GetBufferStart(), mos.GetLength());
+    return FileUtils::WriteFileContentRaw(file, content);
+}
+
+bool clProjectsSnapshot::Take(const wxString& project_file, Entry& entry)
+{
+    auto iter = m_entries.find(project_file);
+    if (iter == m_entries.end()) {
+        return false;
+    }
+    entry = std::move(iter->second);
+    m_entries.erase(iter);
+    return true;
+}
@@ -0,0 +1,76 @@
+#ifndef CLPROJECTSSNAPSHOT_HPP
+#define CLPROJECTSSNAPSHOT_HPP
+
+#include "codelite_exports.h"
+#include "wxStringHash.h"
+
+#include <ctime>
+#include <unordered_map>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+/**
+ * @brief a binary snapshot of the files and virtual folders tables of the workspace projects.
+ * Each entry is keyed by the project file modification time and size, so a project that did not change since the
+ * snapshot was taken restores its tables without building them from its XML nodes
+ */
+class WXDLLIMPEXP_SDK clProjectsSnapshot
+{
+public:
+    /**
+     * @brief a "File" or a "VirtualDirectory" XML node, in the order they are visited when the cache is built
+     */
+    struct Node {
+        bool is_file = false;
+        wxString name; // the "Name" attribute
+        wxString filename;
+        size_t flags = 0;
+        wxString exclude_configs;
+    };
+
+    struct Entry {
+        time_t mtime = 0;
+        size_t size = 0;
+        std::vector<Node> nodes;
+
+        /**
+         * @brief return true if this entry was taken from the current content of `project_file`
+         */
+        bool IsValidFor(const wxFileName& project_file) const;
+
+        /**
+         * @brief clear the nodes and key the entry by the current state of `project_file`
+         */
+        void Reset(const wxFileName& project_file);
+    };
+
+    typedef std::unordered_map<wxString, Entry> Map_t;
+
+protected:
+    Map_t m_entries;
+
+public:
+    clProjectsSnapshot() {}
+    ~clProjectsSnapshot() {}
+
+    /**
+     * @brief load the snapshot from the disk. A corrupted or outdated file loads an empty snapshot
+     */
+    bool Load(const wxFileName& file);
+
+    /**
+     * @brief write the snapshot to the disk, atomically
+     */
+    bool Save(const wxFileName& file) const;
+
+    /**
+     * @brief remove the entry of a project (by its full path) and return it
+     */
+    bool Take(const wxString& project_file, Entry& entry);
+    void Set(const wxString& project_file, Entry&& entry) { m_entries[project_file] = std::move(entry); }
+    void Clear() { m_entries.clear(); }
+    size_t GetCount() const { return m_entries.size(); }
+};
+
+#endif // CLPROJECTSSNAPSHOT_HPP
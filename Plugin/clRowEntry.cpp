@@ -135,8 +135,70 @@ void DrawButton(wxWindow* win, wxDC& dc, const wxRect& button_rect, const clCell
     DrawingUtils::DrawButton(dc, win, button_rect, cell.GetButtonUnicodeSymbol(), wxNullBitmap, eButtonKind::kNormal,
                              cell.GetButtonState());
 }
+
+inline size_t LowBit(size_t i) { return i & (~i + 1); }
 } // namespace
 
+//------------------------------------------------
+// clRowCountTree
+//------------------------------------------------
+
+void clRowCountTree::Build(const std::vector<int>& counts)
+{
+    m_tree.assign(counts.begin(), counts.end());
+    for (size_t i = 1; i <= m_tree.size(); ++i) {
+        size_t parent = i + LowBit(i);
+        if (parent <= m_tree.size()) {
+            m_tree[parent - 1] += m_tree[i - 1];
+        }
+    }
+}
+
+void clRowCountTree::Append(int count)
+{
+    // the new entry covers the range (i - LowBit(i), i]
+    size_t i = m_tree.size() + 1;
+    m_tree.push_back(count + Prefix(i - 1) - Prefix(i - LowBit(i)));
+}
+
+void clRowCountTree::Add(size_t index, int delta)
+{
+    for (size_t i = index + 1; i <= m_tree.size(); i += LowBit(i)) {
+        m_tree[i - 1] += delta;
+    }
+}
+
+int clRowCountTree::Prefix(size_t count) const
+{
+    int sum = 0;
+    for (size_t i = std::min(count, m_tree.size()); i > 0; i -= LowBit(i)) {
+        sum += m_tree[i - 1];
+    }
+    return sum;
+}
+
+size_t clRowCountTree::Find(int& rank) const
+{
+    size_t step = 1;
+    while (step * 2 <= m_tree.size()) {
+        step *= 2;
+    }
+
+    // find the largest `pos` with Prefix(pos) <= rank
+    size_t pos = 0;
+    for (; step > 0; step /= 2) {
+        if (pos + step <= m_tree.size() && m_tree[pos + step - 1] <= rank) {
+            pos += step;
+            rank -= m_tree[pos - 1];
+        }
+    }
+    return pos;
+}
+
+//------------------------------------------------
+// clRowEntry
+//------------------------------------------------
+
 #ifdef __WXMSW__
 int clRowEntry::X_SPACER = 4;
 int clRowEntry::Y_SPACER = 2;
@@ -262,6 +324,20 @@ void clRowEntry::InsertChild(clRowEntry* child, clRowEntry* prev)
     }
 
     // iterCur points to the newly added `child` element in the array
+    size_t index = std::distance(m_children.begin(), iterCur);
+    if (index + 1 == m_children.size()) {
+        child->m_indexInParent = index;
+        if (!m_childrenRowsIndexDirty) {
+            m_childrenRowsIndex.Append(child->m_rowsCount);
+        }
+    } else {
+        // the index is rebuilt on demand
+        SetChildrenIndexes(index);
+        m_childrenRowsIndexDirty = true;
+    }
+    m_childrenRows += child->m_rowsCount;
+    UpdateRowsCount();
+
     clRowEntry* nodeBefore = nullptr;
 
     // Find the item before and after
@@ -308,18 +384,152 @@ void clRowEntry::DeleteChild(clRowEntry* child)
     // Now disconnect this child from this node
     if (child == m_children.back()) { // Fast track for DeleteAllChildren().
         m_children.pop_back();
+        if (!m_childrenRowsIndexDirty) {
+            m_childrenRowsIndex.PopBack();
+        }
     } else {
-        clRowEntry::Vec_t::iterator iter =
-            std::find_if(m_children.begin(), m_children.end(), [&](clRowEntry* c) { return c == child; });
-        if (iter != m_children.end()) {
-            m_children.erase(iter);
+        size_t index = child->m_indexInParent;
+        if (index >= m_children.size() || m_children[index] != child) {
+            // should not happen: the children are only re-ordered by SortChildren()
+            index = std::distance(m_children.begin(), std::find(m_children.begin(), m_children.end(), child));
+        }
+        if (index < m_children.size()) {
+            m_children.erase(m_children.begin() + index);
+            SetChildrenIndexes(index);
+            m_childrenRowsIndexDirty = true;
         }
     }
+    m_childrenRows -= child->m_rowsCount;
+    UpdateRowsCount();
     wxDELETE(child);
 }
 
+void clRowEntry::SortChildren(const std::function<bool(clRowEntry*, clRowEntry*)>& CompareFunc)
+{
+    std::sort(m_children.begin(), m_children.end(), CompareFunc);
+    SetChildrenIndexes(0);
+    m_childrenRowsIndexDirty = true;
+}
+
+void clRowEntry::SetChildrenIndexes(size_t from)
+{
+    for (size_t i = from; i < m_children.size(); ++i) {
+        m_children[i]->m_indexInParent = i;
+    }
+}
+
+const clRowCountTree& clRowEntry::GetChildrenRowsIndex() const
+{
+    if (m_childrenRowsIndexDirty) {
+        std::vector<int> counts;
+        counts.reserve(m_children.size());
+        for (clRowEntry* child : m_children) {
+            counts.push_back(child->m_rowsCount);
+        }
+        m_childrenRowsIndex.Build(counts);
+        m_childrenRowsIndexDirty = false;
+    }
+    return m_childrenRowsIndex;
+}
+
+void clRowEntry::UpdateRowsCount()
+{
+    int count = (IsHidden() ? 0 : 1) + (IsExpanded() ? m_childrenRows : 0);
+    int delta = count - m_rowsCount;
+    if (delta == 0) {
+        return;
+    }
+    m_rowsCount = count;
+    if (m_parent) {
+        m_parent->ChildRowsChanged(this, delta);
+    }
+}
+
+void clRowEntry::ChildRowsChanged(clRowEntry* child, int delta)
+{
+    if (!m_childrenRowsIndexDirty) {
+        m_childrenRowsIndex.Add(child->m_indexInParent, delta);
+    }
+    m_childrenRows += delta;
+    UpdateRowsCount();
+}
+
+int clRowEntry::GetRowIndex() const
+{
+    // collect the path from the root to this node
+    std::vector<const clRowEntry*> path;
+    for (const clRowEntry* node = this; node; node = node->m_parent) {
+        path.push_back(node);
+    }
+
+    // the rows before this node are its visible ancestors and the preceding siblings (of this node and of its
+    // ancestors) whose parents are visible and expanded
+    int index = 0;
+    bool expanded = true; // are all the ancestors expanded?
+    for (size_t i = path.size() - 1; i > 0; --i) {
+        const clRowEntry* parent = path[i];
+        const clRowEntry* child = path[i - 1];
+        if (expanded && !parent->IsHidden()) {
+            ++index;
+        }
+        expanded = expanded && parent->IsExpanded();
+        if (expanded) {
+            index += parent->GetChildrenRowsIndex().Prefix(child->m_indexInParent);
+        }
+    }
+    return index;
+}
+
+clRowEntry* clRowEntry::GetRowAt(int index) const
+{
+    const clRowEntry* node = this;
+    while (node) {
+        if (index < 0 || index >= node->m_rowsCount) {
+            return nullptr;
+        }
+        if (!node->IsHidden()) {
+            if (index == 0) {
+                return const_cast<clRowEntry*>(node);
+            }
+            --index;
+        }
+
+        // index is now relative to the children rows
+        size_t pos = node->GetChildrenRowsIndex().Find(index);
+        if (pos >= node->m_children.size()) {
+            return nullptr;
+        }
+        node = node->m_children[pos];
+    }
+    return nullptr;
+}
+
+clRowEntry* clRowEntry::GetNextAfterSubtree() const
+{
+    const clRowEntry* last = this;
+    while (last->HasChildren()) {
+        last = last->GetLastChild();
+    }
+    return last->m_next;
+}
+
+clRowEntry* clRowEntry::GetCollapsedAncestor() const
+{
+    clRowEntry* collapsed = nullptr;
+    for (clRowEntry* parent = m_parent; parent; parent = parent->m_parent) {
+        if (!parent->IsExpanded()) {
+            collapsed = parent;
+        }
+    }
+    return collapsed;
+}
+
 int clRowEntry::GetExpandedLines() const
 {
+    if (IsRoot()) {
+        return m_rowsCount;
+    }
+
     clRowEntry* node = const_cast<clRowEntry*>(this);
     int counter = 0;
     while (node) {
@@ -340,7 +550,12 @@ void clRowEntry::GetNextItems(int count, clRowEntry::Vec_t& items, bool selfIncl
     if (!this->IsHidden() && selfIncluded) {
         items.push_back(this);
     }
-    clRowEntry* next = GetNext();
+    // the children of a collapsed node are never visible, jump over them
+    auto get_next = [](clRowEntry* node) {
+        return (node->HasChildren() && !node->IsExpanded()) ? node->GetNextAfterSubtree() : node->GetNext();
+    };
+
+    clRowEntry* next = get_next(this);
     while (next) {
         if (next->IsVisible() && !next->IsHidden()) {
             items.push_back(next);
@@ -348,7 +563,7 @@ void clRowEntry::GetNextItems(int count, clRowEntry::Vec_t& items, bool selfIncl
         if ((int)items.size() == count) {
             return;
         }
-        next = next->GetNext();
+        next = get_next(next);
     }
 }
 
@@ -363,6 +578,11 @@ void clRowEntry::GetPrevItems(int count, clRowEntry::Vec_t& items, bool selfIncl
     }
     clRowEntry* prev = GetPrev();
     while (prev) {
+        // inside a collapsed subtree: the only visible row is the collapsed node itself
+        clRowEntry* collapsed = prev->GetCollapsedAncestor();
+        if (collapsed) {
+            prev = collapsed;
+        }
         if (prev->IsVisible() && !prev->IsHidden()) {
             items.insert(items.begin(), prev);
         }
@@ -405,6 +625,7 @@ bool clRowEntry::SetExpanded(bool b)
     if (IsHidden()) {
         // Hidden node do not fire events
         SetFlag(kNF_Expanded, b);
+        UpdateRowsCount();
         return true;
     }
 
@@ -422,6 +643,7 @@ bool clRowEntry::SetExpanded(bool b)
     }
 
     SetFlag(kNF_Expanded, b);
+    UpdateRowsCount();
     m_model->NodeExpanded(this, b);
     return true;
 }
@@ -879,6 +1101,7 @@ void clRowEntry::SetHidden(bool b)
     } else {
         m_indentsCount = 0;
     }
+    UpdateRowsCount();
 }
 
 int clRowEntry::CalcItemWidth(wxDC& dc, int rowHeight, size_t col)
@@ -6,6 +6,7 @@
 #include "codelite_exports.h"
 
 #include <array>
+#include <functional>
 #include <unordered_map>
 #include <vector>
 #include <wx/colour.h>
@@ -51,6 +52,46 @@ struct WXDLLIMPEXP_SDK clMatchResult {
     void Clear() { matches.clear(); }
 };
 
+/**
+ * @brief a Fenwick tree over the visible rows count of a node's children.
+ * Answers "how many visible rows are before child N" and "which child contains visible row N" in O(log n)
+ */
+class WXDLLIMPEXP_SDK clRowCountTree
+{
+    std::vector<int> m_tree; // 1 based
+
+public:
+    void Clear() { m_tree.clear(); }
+    size_t GetCount() const { return m_tree.size(); }
+
+    /**
+     * @brief rebuild the tree from the children rows count in O(n)
+     */
+    void Build(const std::vector<int>& counts);
+
+    /**
+     * @brief add an entry at the end
+     */
+    void Append(int count);
+    void PopBack() { m_tree.pop_back(); }
+
+    /**
+     * @brief add `delta` to the entry at `index`
+     */
+    void Add(size_t index, int delta);
+
+    /**
+     * @brief return the sum of the first `count` entries
+     */
+    int Prefix(size_t count) const;
+
+    /**
+     * @brief return the index of the entry that contains `rank` (0 based) and update `rank` to be relative to that
+     * entry
+     */
+    size_t Find(int& rank) const;
+};
+
 class WXDLLIMPEXP_SDK clRowEntry
 {
 public:
@@ -70,6 +111,14 @@ protected:
     clRowEntry* m_next = nullptr;
     clRowEntry* m_prev = nullptr;
     int m_indentsCount = 0;
+    // position of this node in its parent children array
+    size_t m_indexInParent = 0;
+    // number of visible rows in this subtree, including this node (when it is not hidden)
+    int m_rowsCount = 1;
+    // total rows count of the children, visible or not (i.e. if this node was expanded)
+    int m_childrenRows = 0;
+    mutable clRowCountTree m_childrenRowsIndex;
+    mutable bool m_childrenRowsIndexDirty = false;
     wxRect m_rowRect;
     wxRect m_buttonRect;
     clMatchResult m_higlightInfo;
@@ -90,6 +139,24 @@ protected:
      * @brief return the nth visible item
      */
     clRowEntry* GetVisibleItem(int index);
+
+    /**
+     * @brief recalculate the rows count of this node and notify the parent on change
+     */
+    void UpdateRowsCount();
+    void ChildRowsChanged(clRowEntry* child, int delta);
+    const clRowCountTree& GetChildrenRowsIndex() const;
+    void SetChildrenIndexes(size_t from);
+
+    /**
+     * @brief return the node that follows this subtree in the list of nodes
+     */
+    clRowEntry* GetNextAfterSubtree() const;
+
+    /**
+     * @brief return the top most collapsed ancestor, or nullptr if all the ancestors are expanded
+     */
+    clRowEntry* GetCollapsedAncestor() const;
     void DrawSimpleSelection(wxWindow* win, wxDC& dc, const wxRect& rect, const clColours& colours);
     void RenderText(wxWindow* win, wxDC& dc, const clColours& colours, const wxString& text, int x, int y, size_t col);
     void RenderTextSimple(wxWindow* win, wxDC& dc, const clColours& colours, const wxString& text, int x, int y,
@@ -227,7 +294,11 @@ public:
     const wxString& GetLabel(size_t col = 0) const;
 
     const std::vector<clRowEntry*>& GetChildren() const { return m_children; }
-    std::vector<clRowEntry*>& GetChildren() { return m_children; }
+    /**
+     * @brief sort the children array and update their index. The list of nodes (next/prev) is not modified, the
+     * caller is expected to reconnect it
+     */
+    void SortChildren(const std::function<bool(clRowEntry*, clRowEntry*)>& CompareFunc);
     wxTreeItemData* GetClientObject() const { return m_clientObject; }
     void SetParent(clRowEntry* parent);
     clRowEntry* GetParent() const { return m_parent; }
@@ -239,6 +310,22 @@ public:
     }
     size_t GetChildrenCount(bool recurse) const;
     int GetExpandedLines() const;
+
+    /**
+     * @brief return the number of visible rows in this subtree (this node included, unless hidden). O(1)
+     */
+    int GetRowsCount() const { return m_rowsCount; }
+
+    /**
+     * @brief return the index of this node among the visible rows of the tree, O(depth * log(children)).
+     * For an item that is not visible, return the number of visible rows before it
+     */
+    int GetRowIndex() const;
+
+    /**
+     * @brief return the visible row at `index` in this subtree, O(depth * log(children))
+     */
+    clRowEntry* GetRowAt(int index) const;
     void GetNextItems(int count, clRowEntry::Vec_t& items, bool selfIncluded = true);
     void GetPrevItems(int count, clRowEntry::Vec_t& items, bool selfIncluded = true);
     void SetIndentsCount(int count) { this->m_indentsCount = count; }
@@ -3,6 +3,7 @@
 
 #include "SFTPClientData.hpp"
 #include "StringUtils.h"
+#include "clFilesCollector.h"
 #include "clSFTPEvent.h"
 #include "clSSHChannelCommon.hpp"
 #include "clTempFile.hpp"
@@ -23,12 +24,16 @@
 #include <future>
 #include <mutex>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 #include <wx/debug.h>
 #include <wx/event.h>
+#include <wx/ffile.h>
 #include <wx/msgdlg.h>
 #include <wx/stc/stc.h>
+#include <wx/stopwatch.h>
 #include <wx/thread.h>
+#include <wx/tokenzr.h>
 #include <wx/utils.h>
 
 wxDEFINE_EVENT(wxEVT_SFTP_ASYNC_SAVE_COMPLETED, clCommandEvent);
@@ -862,6 +867,225 @@ bool clSFTPManager::AwaitReadFile(const wxString& remotePath, const wxString& ac
     return DoSyncReadFile(remotePath, accountName, content);
 }
 
+clSFTP::Ptr_t clSFTPManager::DoOpenSession(const SSHAccountInfo& account) const
+{
+    clSSH::Ptr_t ssh(new clSSH(account.GetHost(), account.GetUsername(), account.GetPassword(), account.GetKeyFiles(),
+                               account.GetPort()));
+    ssh->Open();
+    wxString message;
+    if (!ssh->AuthenticateServer(message)) {
+        // we only get here after the main connection for this account was established, i.e. the user already
+        // accepted this server
+        throw clException(wxString() << "Server authentication failed for account: " << account.GetAccountName()
+                                     << ". " << message);
+    }
+    ssh->Login();
+    clSFTP::Ptr_t sftp(new clSFTP(ssh));
+    sftp->Initialize();
+    sftp->SetAccount(account.GetAccountName());
+    return sftp;
+}
+
+bool clSFTPManager::DoParallelTransfer(const std::vector<std::pair<wxString, wxString>>& files,
+                                       const wxString& accountName, bool upload, size_t max_sessions)
+{
+    m_lastTransferStats = clSFTPTransferStats();
+    if (files.empty()) {
+        return true;
+    }
+
+    // ensure we have a connection for this account. This also takes care of prompting the user to accept the server
+    auto conn = GetConnectionPtrAddIfMissing(accountName);
+    CHECK_PTR_RET_FALSE(conn);
+    SSHAccountInfo account = GetConnectionPair(accountName).first;
+
+    wxBusyCursor bc;
+    EnvSetter env;
+    wxStopWatch sw;
+
+    // each session runs on its own thread and picks the next file from the list once it is done with the current one
+    size_t sessions_count = wxMax((size_t)1, wxMin(max_sessions, files.size()));
+    std::atomic_size_t next_file{ 0 };
+    std::atomic_bool failed{ false };
+    std::mutex m;
+    clSFTPTransferStats total_stats;
+    wxString error_message;
+
+    auto set_error = [&](const wxString& msg) {
+        std::lock_guard lk{ m };
+        if (error_message.empty()) {
+            error_message = msg;
+        }
+        failed.store(true);
+    };
+
+    auto transfer_func = [&]() {
+        clSFTP::Ptr_t sftp;
+        try {
+            sftp = DoOpenSession(account);
+        } catch (const clException& e) {
+            set_error(e.What());
+            return;
+        }
+
+        clSFTPTransferStats session_stats;
+        std::unordered_set<wxString> known_folders;
+        while (!failed.load()) {
+            size_t index = next_file.fetch_add(1);
+            if (index >= files.size()) {
+                break;
+            }
+
+            const auto& [source, target] = files[index];
+            try {
+                if (upload) {
+                    wxString remote_folder = target.BeforeLast('/');
+                    if (!remote_folder.empty() && known_folders.insert(remote_folder).second) {
+                        sftp->Mkpath(remote_folder);
+                    }
+                    sftp->Write(wxFileName(source), target);
+
+                } else {
+                    wxMemoryBuffer buffer;
+                    sftp->Read(source, buffer);
+
+                    wxFileName local_file(target);
+                    if (known_folders.insert(local_file.GetPath()).second) {
+                        local_file.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+                    }
+                    wxFFile fp(target, "w+b");
+                    if (!fp.IsOpened() || fp.Write(buffer.GetData(), buffer.GetDataLen()) != buffer.GetDataLen()) {
+                        throw clException(wxString() << "failed to write local file: " << target);
+                    }
+                }
+                session_stats.Merge(sftp->GetLastTransferStats());
+
+            } catch (const clException& e) {
+                set_error(wxString() << (upload ? "upload" : "download") << " of " << source << " failed. "
+                                     << e.What());
+            }
+        }
+
+        std::lock_guard lk{ m };
+        total_stats.Merge(session_stats);
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(sessions_count);
+    for (size_t i = 0; i < sessions_count; ++i) {
+        threads.emplace_back(transfer_func);
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    total_stats.elapsed_ms = sw.Time();
+    m_lastTransferStats = total_stats;
+    clDEBUG() << "SFTP Manager:" << (upload ? "upload" : "download") << "of" << files.size() << "files using"
+              << sessions_count << "sessions completed." << m_lastTransferStats.ToString() << endl;
+
+    if (failed.load()) {
+        m_lastError = error_message;
+        clERROR() << "SFTP Manager:" << m_lastError << endl;
+        return false;
+    }
+    return true;
+}
+
+bool clSFTPManager::AwaitUploadFiles(const std::vector<std::pair<wxString, wxString>>& files,
+                                     const wxString& accountName, size_t max_sessions)
+{
+    return DoParallelTransfer(files, accountName, true, max_sessions);
+}
+
+bool clSFTPManager::AwaitDownloadFiles(const std::vector<std::pair<wxString, wxString>>& files,
+                                       const wxString& accountName, size_t max_sessions)
+{
+    return DoParallelTransfer(files, accountName, false, max_sessions);
+}
+
+bool clSFTPManager::AwaitUploadFolder(const wxString& localFolder, const wxString& remoteFolder,
+                                      const wxString& accountName, size_t max_sessions)
+{
+    std::vector<wxString> local_files;
+    clFilesScanner scanner;
+    scanner.Scan(localFolder, local_files);
+
+    wxString remote_root = remoteFolder;
+    if (!remote_root.EndsWith("/")) {
+        remote_root << "/";
+    }
+
+    std::vector<std::pair<wxString, wxString>> files;
+    files.reserve(local_files.size());
+    for (const auto& local_file : local_files) {
+        wxFileName fn(local_file);
+        fn.MakeRelativeTo(localFolder);
+        files.push_back({ local_file, remote_root + fn.GetFullPath(wxPATH_UNIX) });
+    }
+    return DoParallelTransfer(files, accountName, true, max_sessions);
+}
+
+bool clSFTPManager::AwaitDownloadFolder(const wxString& remoteFolder, const wxString& localFolder,
+                                        const wxString& accountName, size_t max_sessions)
+{
+    auto conn = GetConnectionPtrAddIfMissing(accountName);
+    CHECK_PTR_RET_FALSE(conn);
+
+    wxString remote_root = remoteFolder;
+    if (!remote_root.EndsWith("/")) {
+        remote_root << "/";
+    }
+
+    // collect the remote files using the main connection
+    std::vector<std::pair<wxString, wxString>> files;
+    std::promise<bool> promise;
+    auto future = promise.get_future();
+    auto func = [conn, remote_root, localFolder, &files, &promise]() {
+        try {
+            std::vector<wxString> folders = { remote_root };
+            while (!folders.empty()) {
+                wxString folder = folders.back();
+                folders.pop_back();
+
+                auto entries = conn->List(folder, clSFTP::SFTP_BROWSE_FILES | clSFTP::SFTP_BROWSE_FOLDERS);
+                for (const auto& entry : entries) {
+                    if (entry->GetName() == "." || entry->GetName() == "..") {
+                        continue;
+                    }
+                    wxString fullpath = folder + entry->GetName();
+                    if (entry->IsFolder()) {
+                        // do not follow symlinks to avoid loops
+                        if (!entry->IsSymlink()) {
+                            folders.push_back(fullpath + "/");
+                        }
+                    } else if (entry->IsFile()) {
+                        wxString relative_path = fullpath.Mid(remote_root.length());
+                        wxFileName local_file(localFolder, "");
+                        local_file.SetFullName(relative_path.AfterLast('/'));
+                        if (relative_path.Contains("/")) {
+                            for (const auto& dir : ::wxStringTokenize(relative_path.BeforeLast('/'), "/")) {
+                                local_file.AppendDir(dir);
+                            }
+                        }
+                        files.push_back({ fullpath, local_file.GetFullPath() });
+                    }
+                }
+            }
+            promise.set_value(true);
+        } catch (const clException& e) {
+            clERROR() << "AwaitDownloadFolder() error." << e.What() << endl;
+            promise.set_value(false);
+        }
+    };
+    m_q.push_back(std::move(func));
+    if (!future.get()) {
+        return false;
+    }
+    return DoParallelTransfer(files, accountName, false, max_sessions);
+}
+
 #define QUEUE_ERROR_EVENT(msg)                                  \
     {                                                           \
         clSFTPEvent event_error{ wxEVT_SFTP_ASYNC_EXEC_ERROR }; \
@@ -44,6 +44,7 @@ protected:
     std::atomic_bool m_shutdown;
     wxString m_lastError;
     std::unordered_map<wxString, saved_file> m_downloadedFileToAccount;
+    clSFTPTransferStats m_lastTransferStats;
 
 protected:
     std::pair<SSHAccountInfo, clSFTP::Ptr_t> GetConnectionPair(const wxString& account) const;
@@ -74,6 +75,18 @@ protected:
     bool DoSyncSaveFileWithConn(clSFTP::Ptr_t conn, const wxString& localPath, const wxString& remotePath,
                                 bool delete_local);
 
+    /**
+     * @brief open a new, non interactive, SFTP session for a given account
+     * @throws clException
+     */
+    clSFTP::Ptr_t DoOpenSession(const SSHAccountInfo& account) const;
+
+    /**
+     * @brief transfer a list of files using up to `max_sessions` SFTP sessions running in parallel
+     */
+    bool DoParallelTransfer(const std::vector<std::pair<wxString, wxString>>& files, const wxString& accountName,
+                            bool upload, size_t max_sessions);
+
 public:
     clSFTPManager();
     virtual ~clSFTPManager();
@@ -182,6 +195,40 @@ public:
      */
     bool AwaitWriteFile(clSFTP::Ptr_t sftp, const wxString& content, const wxString& remotePath);
 
+    /**
+     * @brief upload a list of files to the remote machine. The files are distributed over up to `max_sessions` SFTP
+     * sessions that run in parallel, while each session pipelines its own read/write requests. This function is sync
+     * @param files list of pairs: local path -> remote path. Missing remote folders are created
+     * @param accountName the account name to use
+     * @return true if all the files were uploaded successfully
+     */
+    bool AwaitUploadFiles(const std::vector<std::pair<wxString, wxString>>& files, const wxString& accountName,
+                          size_t max_sessions = 4);
+
+    /**
+     * @brief download a list of files from the remote machine. Same as AwaitUploadFiles, but in the other direction
+     * @param files list of pairs: remote path -> local path. Missing local folders are created
+     */
+    bool AwaitDownloadFiles(const std::vector<std::pair<wxString, wxString>>& files, const wxString& accountName,
+                            size_t max_sessions = 4);
+
+    /**
+     * @brief upload the content of a local folder (recursively) into a remote folder
+     */
+    bool AwaitUploadFolder(const wxString& localFolder, const wxString& remoteFolder, const wxString& accountName,
+                           size_t max_sessions = 4);
+
+    /**
+     * @brief download the content of a remote folder (recursively) into a local folder
+     */
+    bool AwaitDownloadFolder(const wxString& remoteFolder, const wxString& localFolder, const wxString& accountName,
+                             size_t max_sessions = 4);
+
+    /**
+     * @brief return the statistics (throughput, latency) of the last bulk transfer
+     */
+    const clSFTPTransferStats& GetLastTransferStats() const { return m_lastTransferStats; }
+
     /**
      * @brief delete a connection
      * if promptUser is set to true and any un-saved files belonged to the connection
@@ -0,0 +1,143 @@
+#include "clStartupTrace.hpp"
+
+#include "JSON.h"
+#include "cl_standard_paths.h"
+#include "file_logger.h"
+
+#include <algorithm>
+
+clStartupTrace::Scope::Scope(const wxString& name, const wxString& category)
+    : m_enabled(clStartupTrace::Get().IsEnabled())
+{
+    if (m_enabled) {
+        m_name = name;
+        m_category = category;
+        m_start = Clock_t::now();
+    }
+}
+
+clStartupTrace::Scope::~Scope()
+{
+    if (m_enabled) {
+        clStartupTrace::Get().AddComplete(m_name, m_category, m_start);
+    }
+}
+
+clStartupTrace::clStartupTrace()
+    : m_origin(Clock_t::now())
+{
+    m_events.reserve(256);
+}
+
+clStartupTrace::~clStartupTrace() {}
+
+clStartupTrace& clStartupTrace::Get()
+{
+    static clStartupTrace trace;
+    return trace;
+}
+
+size_t clStartupTrace::ToMicroseconds(const Clock_t::time_point& tp) const
+{
+    if (tp <= m_origin) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(tp - m_origin).count();
+}
+
+size_t clStartupTrace::GetThreadIndex(std::thread::id id)
+{
+    // small, stable thread numbers read better in the trace viewers than the native thread ids.
+    // The first thread seen is the main thread
+    auto iter = std::find(m_threads.begin(), m_threads.end(), id);
+    if (iter != m_threads.end()) {
+        return std::distance(m_threads.begin(), iter) + 1;
+    }
+    m_threads.push_back(id);
+    return m_threads.size();
+}
+
+void clStartupTrace::AddEvent(Event&& event, std::thread::id id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_enabled) {
+        return;
+    }
+    event.tid = GetThreadIndex(id);
+    m_events.push_back(std::move(event));
+}
+
+void clStartupTrace::AddComplete(const wxString& name, const wxString& category, const Clock_t::time_point& start)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.phase = 'X';
+    event.start = ToMicroseconds(start);
+    event.duration = ToMicroseconds(Clock_t::now()) - event.start;
+    AddEvent(std::move(event), std::this_thread::get_id());
+}
+
+void clStartupTrace::AddInstant(const wxString& name, const wxString& category)
+{
+    if (!m_enabled) {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.phase = 'i';
+    event.start = ToMicroseconds(Clock_t::now());
+    AddEvent(std::move(event), std::this_thread::get_id());
+}
+
+wxFileName clStartupTrace::GetTraceFile()
+{
+    return wxFileName(clStandardPaths::Get().GetUserDataDir(), "startup-trace.json");
+}
+
+void clStartupTrace::Finish()
+{
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enabled) {
+            return;
+        }
+        m_enabled = false;
+        events.swap(m_events);
+    }
+
+    JSON root(cJSON_Object);
+    JSONItem json = root.toElement();
+    JSONItem traceEvents = json.AddArray("traceEvents");
+    size_t total = 0;
+    for (const auto& event : events) {
+        JSONItem item = JSONItem::createObject();
+        item.addProperty("name", event.name)
+            .addProperty("cat", event.category)
+            .addProperty("ph", wxString(event.phase))
+            .addProperty("ts", event.start)
+            .addProperty("pid", 1)
+            .addProperty("tid", event.tid);
+        if (event.phase == 'X') {
+            item.addProperty("dur", event.duration);
+            total = std::max(total, event.start + event.duration);
+        } else {
+            // instant events are drawn across the process
+            item.addProperty("s", wxString("p"));
+        }
+        traceEvents.arrayAppend(item);
+    }
+    json.addProperty("displayTimeUnit", wxString("ms"));
+
+    wxFileName fn = GetTraceFile();
+    root.save(fn);
+    clDEBUG() << "Startup trace:" << events.size() << "events," << (total / 1000) << "ms. Written to:" << fn
+              << endl;
+}
@@ -0,0 +1,92 @@
+#ifndef CLSTARTUPTRACE_HPP
+#define CLSTARTUPTRACE_HPP
+
+#include "codelite_exports.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+/**
+ * @brief records the startup critical path as "Trace Event Format" events (the format used by chrome://tracing and
+ * https://ui.perfetto.dev). Timers are placed with clStartupTrace::Scope, the trace is written to
+ * <user-data-dir>/startup-trace.json once the startup is completed (see Finish()). Recording stops afterwards, so
+ * scopes that are reached later on cost a single boolean check
+ */
+class WXDLLIMPEXP_SDK clStartupTrace
+{
+public:
+    typedef std::chrono::steady_clock Clock_t;
+
+    /**
+     * @brief a scoped timer. Records a "complete" event from its construction to its destruction
+     */
+    class WXDLLIMPEXP_SDK Scope
+    {
+        wxString m_name;
+        wxString m_category;
+        Clock_t::time_point m_start;
+        bool m_enabled = false;
+
+    public:
+        Scope(const wxString& name, const wxString& category = "startup");
+        ~Scope();
+    };
+
+protected:
+    struct Event {
+        wxString name;
+        wxString category;
+        char phase = 'X';
+        size_t start = 0;    // microseconds since the trace was started
+        size_t duration = 0; // microseconds
+        size_t tid = 0;
+    };
+
+    Clock_t::time_point m_origin;
+    std::vector<Event> m_events;
+    std::vector<std::thread::id> m_threads;
+    std::mutex m_mutex;
+    bool m_enabled = true;
+
+protected:
+    clStartupTrace();
+    ~clStartupTrace();
+
+    size_t ToMicroseconds(const Clock_t::time_point& tp) const;
+    size_t GetThreadIndex(std::thread::id id);
+    void AddEvent(Event&& event, std::thread::id id);
+
+public:
+    static clStartupTrace& Get();
+
+    /**
+     * @brief is the trace still recording?
+     */
+    bool IsEnabled() const { return m_enabled; }
+
+    /**
+     * @brief record a "complete" event that started at `start` and ends now
+     */
+    void AddComplete(const wxString& name, const wxString& category, const Clock_t::time_point& start);
+
+    /**
+     * @brief record a point in time (e.g. "main frame shown")
+     */
+    void AddInstant(const wxString& name, const wxString& category = "startup");
+
+    /**
+     * @brief stop recording and write the trace file. Calling this more than once does nothing
+     */
+    void Finish();
+
+    /**
+     * @brief the trace file path
+     */
+    static wxFileName GetTraceFile();
+};
+
+#endif // CLSTARTUPTRACE_HPP
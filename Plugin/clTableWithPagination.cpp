@@ -5,6 +5,8 @@
 #include "globals.h"
 #include "macros.h"
 
+#include <algorithm>
+#include <iterator>
 #include <wx/dataview.h>
 #include <wx/sizer.h>
 
@@ -66,13 +68,38 @@ void clTableWithPagination::SetColumns(const wxArrayString& columns)
 void clTableWithPagination::SetData(std::vector<wxArrayString>& data)
 {
     m_data.clear();
-    m_data.swap(data);
+    m_data.insert(m_data.end(), std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
+    data.clear();
+    m_complete = true;
     ShowPage(0);
 }
 
+void clTableWithPagination::AppendData(std::vector<wxArrayString>& data)
+{
+    int startIndex = (m_currentPage * m_linesPerPage);
+    bool pageFull = (startIndex + m_linesPerPage) <= (int)m_data.size();
+
+    m_data.insert(m_data.end(), std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
+    data.clear();
+    if(!pageFull) {
+        ShowPage(m_currentPage);
+    } else {
+        UpdateLabel(startIndex, startIndex + m_linesPerPage - 1);
+    }
+}
+
+void clTableWithPagination::SetComplete(bool complete)
+{
+    m_complete = complete;
+    int startIndex = (m_currentPage * m_linesPerPage);
+    UpdateLabel(startIndex, std::min(startIndex + m_linesPerPage, (int)m_data.size()) - 1);
+}
+
 void clTableWithPagination::ClearAll()
 {
     m_data.clear();
+    m_complete = true;
+    m_currentPage = 0;
     m_ctrl->DeleteAllItems();
     m_ctrl->ClearColumns();
 }
@@ -80,9 +107,13 @@ void clTableWithPagination::ClearAll()
 void clTableWithPagination::ShowPage(int nPage)
 {
     m_ctrl->DeleteAllItems();
+    int startIndex = (nPage * m_linesPerPage);
+    if(!m_complete && m_fetchMore && (startIndex + 2 * m_linesPerPage) > (int)m_data.size()) {
+        // keep a page ahead of the displayed one
+        m_fetchMore();
+    }
     if(m_data.empty())
         return;
-    int startIndex = (nPage * m_linesPerPage);
     int lastIndex = startIndex + m_linesPerPage - 1; // last index, including
     if(lastIndex >= (int)m_data.size()) {
         lastIndex = (m_data.size() - 1);
@@ -99,8 +130,17 @@ void clTableWithPagination::ShowPage(int nPage)
         m_ctrl->AppendItem(cols, (wxUIntPtr)&items);
     }
     m_ctrl->Commit();
+    UpdateLabel(startIndex, lastIndex);
+}
+
+void clTableWithPagination::UpdateLabel(int startIndex, int lastIndex)
+{
+    if(m_data.empty()) {
+        m_staticText->SetLabel(wxEmptyString);
+        return;
+    }
     m_staticText->SetLabel(wxString() << _("Showing entries from: ") << startIndex << _(":") << lastIndex
-                                      << " Total of: " << m_data.size() << _(" entries"));
+                                      << " Total of: " << m_data.size() << (m_complete ? "" : "+") << _(" entries"));
 }
 
 bool clTableWithPagination::CanNext() const
@@ -3,6 +3,8 @@
 
 #include "codelite_exports.h"
 
+#include <deque>
+#include <functional>
 #include <vector>
 #include <wx/arrstr.h>
 #include <wx/button.h>
@@ -15,16 +17,20 @@ class WXDLLIMPEXP_SDK clTableWithPagination : public wxPanel
 {
     int m_linesPerPage;
     int m_currentPage;
-    std::vector<wxArrayString> m_data;
+    // a deque keeps the rows in place when more rows are appended: the displayed items point to them
+    std::deque<wxArrayString> m_data;
     wxArrayString m_columns;
     clThemedListCtrl* m_ctrl = nullptr;
     wxButton* m_btnNextPage = nullptr;
     wxButton* m_btnPrevPage = nullptr;
     wxStaticText* m_staticText = nullptr;
+    bool m_complete = true;
+    std::function<void()> m_fetchMore;
 
 protected:
     bool CanNext() const;
     bool CanPrev() const;
+    void UpdateLabel(int startIndex, int lastIndex);
 
     void ClearAllItems();
     wxString MakeDisplayString(const wxString& str) const;
@@ -37,6 +43,7 @@ public:
     virtual ~clTableWithPagination();
 
     void SetLinesPerPage(int numLines);
+    int GetLinesPerPage() const { return m_linesPerPage; }
 
     /**
      * @brief define the columns for this table
@@ -50,6 +57,23 @@ public:
      */
     void SetData(std::vector<wxArrayString>& data);
 
+    /**
+     * @brief append rows to the table. The current page is refreshed only if it was not full
+     */
+    void AppendData(std::vector<wxArrayString>& data);
+
+    /**
+     * @brief when the data is added with AppendData(), mark whether more rows are expected
+     */
+    void SetComplete(bool complete);
+    bool IsComplete() const { return m_complete; }
+
+    /**
+     * @brief called when the user reaches the last page loaded, while more rows are expected.
+     * Use it to fetch the rows of the next page
+     */
+    void SetFetchMoreCallback(std::function<void()> callback) { m_fetchMore = std::move(callback); }
+
     /**
      * @brief clear all data and columns from the table
      */
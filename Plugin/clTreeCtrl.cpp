@@ -335,7 +335,7 @@ namespace
 {
 void HideControls(clRowEntry* r)
 {
-    auto& children = r->GetChildren();
+    const auto& children = r->GetChildren();
     for (auto c : children) {
         for (size_t i = 0; i < c->GetColumnCount(); ++i) {
             auto& cell = c->GetColumn(i);
@@ -358,18 +358,7 @@ int clTreeCtrlModel::GetItemIndex(clRowEntry* item) const
     if(!m_root) {
         return wxNOT_FOUND;
     }
-    int counter = 0;
-    clRowEntry* current = m_root;
-    while(current) {
-        if(current == item) {
-            return counter;
-        }
-        if(current->IsVisible()) {
-            ++counter;
-        }
-        current = current->GetNext();
-    }
-    return wxNOT_FOUND;
+    return item->GetRowIndex();
 }
 
 bool clTreeCtrlModel::GetRange(clRowEntry* from, clRowEntry* to, clRowEntry::Vec_t& items) const
@@ -415,7 +404,7 @@ size_t clTreeCtrlModel::GetExpandedLines() const
     if(!GetRoot()) {
         return 0;
     }
-    return m_root->GetExpandedLines();
+    return m_root->GetRowsCount();
 }
 
 clRowEntry* clTreeCtrlModel::GetItemFromIndex(int index) const
@@ -426,18 +415,7 @@ clRowEntry* clTreeCtrlModel::GetItemFromIndex(int index) const
     if(!m_root) {
         return nullptr;
     }
-    int curIndex = -1;
-    clRowEntry* current = m_root;
-    while(current) {
-        if(current->IsVisible()) {
-            ++curIndex;
-        }
-        if(curIndex == index) {
-            return current;
-        }
-        current = current->GetNext();
-    }
-    return nullptr;
+    return m_root->GetRowAt(index);
 }
 
 void clTreeCtrlModel::SelectChildren(const wxTreeItemId& item)
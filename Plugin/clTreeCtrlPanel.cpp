@@ -14,6 +14,7 @@
 #include "ieditor.h"
 #include "imanager.h"
 #include "macros.h"
+#include "wxStringHash.h"
 
 #include <wx/app.h>
 #include <wx/dir.h>
@@ -1200,6 +1201,57 @@ void clTreeCtrlPanel::RefreshTree()
     }
 }
 
+wxTreeItemId clTreeCtrlPanel::FindLoadedFolder(const wxString& folder)
+{
+    wxArrayString topFolders;
+    wxArrayTreeItemIds topFoldersItems;
+    GetTopLevelFolders(topFolders, topFoldersItems);
+
+    wxString fullpath = wxFileName(folder, "").GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR);
+    for (size_t i = 0; i < topFolders.size(); ++i) {
+        wxString topFolder = wxFileName(topFolders.Item(i), "").GetPath(wxPATH_GET_VOLUME | wxPATH_GET_SEPARATOR);
+        if (!fullpath.StartsWith(topFolder)) {
+            continue;
+        }
+
+        // walk down the folders that were already expanded, do not load new ones
+        wxTreeItemId item = topFoldersItems.Item(i);
+        wxArrayString parts = wxFileName(fullpath.Mid(topFolder.length()), "").GetDirs();
+        for (const wxString& part : parts) {
+            clTreeCtrlData* d = GetItemData(item);
+            if (!d || !d->GetIndex()) {
+                return wxTreeItemId();
+            }
+            item = d->GetIndex()->Find(part);
+            if (!item.IsOk()) {
+                return wxTreeItemId();
+            }
+        }
+        return item;
+    }
+    return wxTreeItemId();
+}
+
+void clTreeCtrlPanel::RefreshFoldersOf(const wxArrayString& paths)
+{
+    wxStringSet_t folders;
+    for (const wxString& path : paths) {
+        wxFileName folder(path);
+        // a removed folder: refresh its closest parent that still exists
+        while (folder.GetDirCount() && !folder.DirExists()) {
+            folder.RemoveLastDir();
+        }
+        folders.insert(folder.GetPath());
+    }
+
+    for (const wxString& folder : folders) {
+        wxTreeItemId item = FindLoadedFolder(folder);
+        if (item.IsOk()) {
+            RefreshNonTopLevelFolder(item);
+        }
+    }
+}
+
 void clTreeCtrlPanel::OnFilesCreated(clFileSystemEvent& event)
 {
     event.Skip();
@@ -60,6 +60,10 @@ protected:
 protected:
     void ToggleView();
     void RefreshNonTopLevelFolder(const wxTreeItemId& item);
+    /**
+     * @brief return the item of `folder`, if it was already loaded in the tree
+     */
+    wxTreeItemId FindLoadedFolder(const wxString& folder);
     virtual void OnLinkEditor(wxCommandEvent& event);
     virtual void OnLinkEditorUI(wxUpdateUIEvent& event);
     void OnFilesCreated(clFileSystemEvent& event);
@@ -148,6 +152,12 @@ public:
      */
     void RefreshSelections();
 
+    /**
+     * @brief reload the folders that contain `paths` (files added or removed outside of this view). Folders that
+     * were not loaded yet are skipped, their content is read when they are expanded
+     */
+    void RefreshFoldersOf(const wxArrayString& paths);
+
 protected:
     void UpdateItemDeleted(const wxTreeItemId& item);
     void GetTopLevelFolders(wxArrayString& paths, wxArrayTreeItemIds& items) const;
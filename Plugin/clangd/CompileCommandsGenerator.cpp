@@ -49,10 +49,22 @@ void CompileCommandsGenerator::OnProcessTerminated(clProcessEvent& event)
     wxArrayString generated_paths = ::wxStringTokenize(m_capturedOutput, "\n\r", wxTOKEN_STRTOK);
     m_capturedOutput.clear();
 
-    static std::unordered_map<wxString, CheckSum_t> m_checksumCache;
+    if(generated_paths.empty()) {
+        clDEBUG() << "compile_commands.json was not modified" << endl;
+        return;
+    }
 
     bool generateCompileCommands = true;
     generateCompileCommands = clConfig::Get().Read(wxString("GenerateCompileCommands"), generateCompileCommands);
+    if(generateCompileCommands) {
+        // codelite-make only reports compile_commands.json when its content was modified
+        clCommandEvent eventCompileCommandsGenerated(wxEVT_COMPILE_COMMANDS_JSON_GENERATED);
+        eventCompileCommandsGenerated.SetStrings(generated_paths);
+        EventNotifier::Get()->AddPendingEvent(eventCompileCommandsGenerated);
+        return;
+    }
+
+    static std::unordered_map<wxString, CheckSum_t> m_checksumCache;
 
     // Process the compile_flags.txt files starting from the "compile_commands.json" root folder
     // Notify about completion
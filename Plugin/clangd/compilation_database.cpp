@@ -339,10 +339,9 @@ void CompilationDatabase::ProcessCMakeCompilationDatabase(const wxFileName& comp
         wxSQLite3Statement st = m_db->PrepareStatement(sql);
         m_db->ExecuteUpdate("BEGIN");
 
-        for(int i = 0; i < arr.arraySize(); ++i) {
+        for(const auto& element : arr) {
             // Each object has 3 properties:
             // directory, command, file
-            JSONItem element = arr.arrayItem(i);
             if(element.hasNamedObject("file") && element.hasNamedObject("directory") &&
                element.hasNamedObject("command")) {
                 wxString cmd = element.namedObject("command").toString();
@@ -434,11 +433,9 @@ wxArrayString CompilationDatabase::FindIncludePaths(const wxString& rootFolder,
     wxStringSet_t paths;
     JSON root(compile_commands);
     JSONItem arr = root.toElement();
-    const int file_size = arr.arraySize();
-    for(int i = 0; i < file_size; ++i) {
+    for(const auto& element : arr) {
         // Each object has 3 properties:
         // directory, command, file
-        JSONItem element = arr.arrayItem(i);
         if(element.hasNamedObject("file") && element.hasNamedObject("directory") && element.hasNamedObject("command")) {
             wxString cmd = element.namedObject("command").toString();
             wxString cwd = element.namedObject("directory").toString();
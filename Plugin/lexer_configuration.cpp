@@ -511,6 +511,53 @@ void LexerConf::FromJSON(const JSONItem& json)
     }
 }
 
+void LexerConf::ToBinary(wxDataOutputStream& out) const
+{
+    out.WriteString(m_name);
+    out.WriteString(m_themeName);
+    out.Write64((wxUint64)m_flags);
+    out.Write32((wxUint32)m_lexerId);
+    for (const wxString& keywords : m_keyWords) {
+        out.WriteString(keywords);
+    }
+    out.WriteString(m_extension);
+    out.Write32((wxUint32)m_substyleBase);
+    for (const auto& word_set : m_wordSets) {
+        out.Write32((wxUint32)word_set.index);
+        out.Write8(word_set.is_substyle ? 1 : 0);
+    }
+
+    out.Write32(m_properties.size());
+    for (const auto& sp : m_properties) {
+        sp.ToBinary(out);
+    }
+}
+
+void LexerConf::FromBinary(wxDataInputStream& in)
+{
+    m_name = in.ReadString();
+    m_themeName = in.ReadString();
+    m_flags = in.Read64();
+    m_lexerId = (wxInt32)in.Read32();
+    // the keywords were already normalized by SetKeyWords()
+    for (wxString& keywords : m_keyWords) {
+        keywords = in.ReadString();
+    }
+    m_extension = in.ReadString();
+    m_substyleBase = (wxInt32)in.Read32();
+    for (auto& word_set : m_wordSets) {
+        word_set.index = (wxInt32)in.Read32();
+        word_set.is_substyle = in.Read8() != 0;
+    }
+
+    wxUint32 count = in.Read32();
+    m_properties.clear();
+    m_properties.resize(count);
+    for (auto& sp : m_properties) {
+        sp.FromBinary(in);
+    }
+}
+
 void LexerConf::SetKeyWords(const wxString& keywords, int set)
 {
     wxString content = keywords;
@@ -564,6 +611,50 @@ void LexerConf::ApplyWordSet(wxStyledTextCtrl* ctrl, eWordSetIndex index, const
     }
 }
 
+int LexerConf::GetWordSetStyle(wxStyledTextCtrl* ctrl, eWordSetIndex index) const
+{
+    const WordSetIndex& word_set = m_wordSets[index];
+    if (!ctrl || !word_set.is_ok()) {
+        return wxNOT_FOUND;
+    }
+
+    if (word_set.is_substyle) {
+        if (!IsSubstyleSupported() || ctrl->GetSubStylesLength(GetSubStyleBase()) == 0) {
+            return wxNOT_FOUND;
+        }
+        return ctrl->GetSubStylesStart(GetSubStyleBase()) + word_set.index;
+    }
+
+    // the style that the lexer assigns to the keywords of this keyword set
+    switch (GetLexerId()) {
+    case wxSTC_LEX_CPP:
+        switch (word_set.index) {
+        case 0:
+            return wxSTC_C_WORD;
+        case 1:
+            return wxSTC_C_WORD2;
+        case 3:
+            return wxSTC_C_GLOBALCLASS;
+        default:
+            return wxNOT_FOUND;
+        }
+    case wxSTC_LEX_RUST:
+        // wxSTC_RUST_WORD ... wxSTC_RUST_WORD7
+        return word_set.index < 7 ? wxSTC_RUST_WORD + word_set.index : wxNOT_FOUND;
+    case wxSTC_LEX_PYTHON:
+        switch (word_set.index) {
+        case 0:
+            return wxSTC_P_WORD;
+        case 1:
+            return wxSTC_P_WORD2;
+        default:
+            return wxNOT_FOUND;
+        }
+    default:
+        return wxNOT_FOUND;
+    }
+}
+
 void LexerConf::ApplyFont(wxWindow* cb)
 {
     auto font = GetFontForStyle(0, cb);
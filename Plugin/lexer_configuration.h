@@ -48,6 +48,11 @@
 #define INDICATOR_HYPERLINK 4
 #define INDICATOR_FIND_BAR_WORD_HIGHLIGHT 5
 #define INDICATOR_CONTEXT_WORD_HIGHLIGHT 6
+// semantic tokens: one indicator per LexerConf::eWordSetIndex, in the same order
+#define INDICATOR_SEMANTIC_CLASS 14
+#define INDICATOR_SEMANTIC_FUNCTIONS 15
+#define INDICATOR_SEMANTIC_VARIABLES 16
+#define INDICATOR_SEMANTIC_OTHERS 17
 
 struct WXDLLIMPEXP_SDK WordSetIndex {
     int index = wxNOT_FOUND;
@@ -159,10 +164,21 @@ public:
      */
     void FromJSON(const JSONItem& json);
 
+    /**
+     * @brief binary serialization, used by the lexers cache. Unlike the JSON format, this is not meant to be portable
+     */
+    void ToBinary(wxDataOutputStream& out) const;
+    void FromBinary(wxDataInputStream& in);
+
     void SetWordSet(eWordSetIndex index, const WordSetIndex& word_set) { this->m_wordSets[index] = word_set; }
     const WordSetIndex& GetWordSet(eWordSetIndex index) const { return m_wordSets[index]; }
     void ApplyWordSet(wxStyledTextCtrl* ctrl, eWordSetIndex index, const wxString& keywords);
 
+    /**
+     * @brief return the style used to colour the words of a given word set, or wxNOT_FOUND if it is not known
+     */
+    int GetWordSetStyle(wxStyledTextCtrl* ctrl, eWordSetIndex index) const;
+
 public:
     LexerConf();
     virtual ~LexerConf();
@@ -39,6 +39,8 @@ public:
     enum eFlags {
         kNone = 0,
         kDisabledByDefault = (1 << 0),
+        // the plugin is not needed to show the main frame: create it once the startup is completed (on idle time)
+        kLoadOnIdle = (1 << 1),
     };
 
 protected:
@@ -118,6 +118,22 @@ bool Project::Create(const wxString& name, const wxString& description, const wx
 
 bool Project::Load(const wxString& path)
 {
+    bool restored = false;
+    return DoLoadXml(path, nullptr, restored) && DoLoadComplete();
+}
+
+bool Project::DoLoadXml(const wxString& path, clProjectsSnapshot::Entry* snapshot, bool& restored)
+{
+    restored = false;
+
+    // check the snapshot before parsing the file, so a change made while we parse it invalidates the snapshot
+    wxFileName fn(path);
+    fn.MakeAbsolute();
+    bool use_snapshot = snapshot && snapshot->IsValidFor(fn);
+    if (snapshot && !use_snapshot) {
+        snapshot->Reset(fn);
+    }
+
     if (!m_doc.Load(path)) {
         return false;
     }
@@ -128,11 +144,24 @@ bool Project::Load(const wxString& path)
     GetAllPluginsData(pluginsData);
     SetAllPluginsData(pluginsData, false);
 
-    m_fileName = path;
-    m_fileName.MakeAbsolute();
+    m_fileName = fn;
     m_projectPath = m_fileName.GetPath();
 
-    DoBuildCacheFromXml();
+    if (use_snapshot && DoBuildCacheFromSnapshot(*snapshot)) {
+        restored = true;
+        return true;
+    }
+
+    if (snapshot) {
+        // keep the key taken before the file was parsed
+        snapshot->nodes.clear();
+    }
+    DoBuildCacheFromXml(snapshot);
+    return true;
+}
+
+bool Project::DoLoadComplete()
+{
     SetModified(true);
     SetProjectLastModifiedTime(GetFileLastModifiedTime());
 
@@ -581,7 +610,7 @@ clProjectFile::Ptr_t Project::FileFromXml(wxXmlNode* node, const wxString& vd)
     return file;
 }
 
-void Project::DoBuildCacheFromXml()
+void Project::DoBuildCacheFromXml(clProjectsSnapshot::Entry* snapshot)
 {
     m_filesTable.clear();
     m_virtualFoldersTable.clear();
@@ -598,6 +627,17 @@ void Project::DoBuildCacheFromXml()
         while (child) {
             if (child->GetName() == "File" && folder) {
                 clProjectFile::Ptr_t file = FileFromXml(child, folder->GetFullpath());
+                if (snapshot) {
+                    clProjectsSnapshot::Node node;
+                    node.is_file = true;
+                    node.name = file->GetFilenameRelpath();
+                    node.filename = file->GetFilename();
+                    node.flags = file->GetFlags();
+                    for (const wxString& config : file->GetExcludeConfigs()) {
+                        node.exclude_configs << config << ";";
+                    }
+                    snapshot->nodes.push_back(std::move(node));
+                }
                 // Cache the file
                 m_filesTable.insert({ file->GetFilename(), file });
                 // Add this file to the folder
@@ -605,6 +645,11 @@ void Project::DoBuildCacheFromXml()
 
             } else if (child->GetName() == "VirtualDirectory") {
                 wxString folderName = child->GetAttribute("Name", wxEmptyString);
+                if (snapshot) {
+                    clProjectsSnapshot::Node node;
+                    node.name = folderName;
+                    snapshot->nodes.push_back(std::move(node));
+                }
                 clProjectFolder::Ptr_t newFolder(new clProjectFolder(
                     folder->GetFullpath().IsEmpty() ? folderName : folder->GetFullpath() + ":" + folderName, child));
                 // Cache this folder
@@ -616,6 +661,79 @@ void Project::DoBuildCacheFromXml()
     }
 }
 
+bool Project::DoBuildCacheFromSnapshot(const clProjectsSnapshot::Entry& snapshot)
+{
+    m_filesTable.clear();
+    m_virtualFoldersTable.clear();
+
+    // Visit the XML nodes in the same order as DoBuildCacheFromXml() does. The XML nodes are only matched by their
+    // name, the (costly) path normalization of each file is taken from the snapshot
+    size_t index = 0;
+    bool match = true;
+    std::queue<std::pair<wxXmlNode*, clProjectFolder::Ptr_t>> Q;
+    Q.push({ m_doc.GetRoot(), GetRootFolder() });
+    while (match && !Q.empty()) {
+        wxXmlNode* node = Q.front().first;
+        clProjectFolder::Ptr_t folder = Q.front().second;
+        Q.pop();
+
+        for (wxXmlNode* child = node->GetChildren(); match && child; child = child->GetNext()) {
+            bool is_file = child->GetName() == "File";
+            if (!is_file && child->GetName() != "VirtualDirectory") {
+                continue;
+            }
+
+            if (index >= snapshot.nodes.size()) {
+                match = false;
+                break;
+            }
+
+            const clProjectsSnapshot::Node& snapshotNode = snapshot.nodes[index++];
+            wxString name = child->GetAttribute("Name", wxEmptyString);
+            // FileFromXml() converts the file names to unix format (in the XML as well), so does the snapshot
+            if (is_file && name.Replace("\\", "/") > 0) {
+                child->DeleteAttribute("Name");
+                child->AddAttribute("Name", name);
+            }
+            if (snapshotNode.is_file != is_file || name != snapshotNode.name) {
+                match = false;
+                break;
+            }
+
+            if (is_file) {
+                clProjectFile::Ptr_t file(new clProjectFile());
+                file->SetFilenameRelpath(snapshotNode.name);
+                file->SetFilename(snapshotNode.filename);
+                file->SetFlags(snapshotNode.flags);
+                file->SetXmlNode(child);
+                if (!snapshotNode.exclude_configs.empty()) {
+                    file->SetExcludeConfigs(this,
+                                            ::wxStringTokenize(snapshotNode.exclude_configs, ";", wxTOKEN_STRTOK));
+                }
+                file->SetVirtualFolder(folder->GetFullpath());
+                m_filesTable.insert({ file->GetFilename(), file });
+                folder->GetFiles().insert(file->GetFilename());
+
+            } else {
+                clProjectFolder::Ptr_t newFolder(new clProjectFolder(
+                    folder->GetFullpath().IsEmpty() ? snapshotNode.name
+                                                    : folder->GetFullpath() + ":" + snapshotNode.name,
+                    child));
+                m_virtualFoldersTable.insert({ newFolder->GetFullpath(), newFolder });
+                Q.push({ child, newFolder });
+            }
+        }
+    }
+
+    if (!match || index != snapshot.nodes.size()) {
+        m_filesTable.clear();
+        m_virtualFoldersTable.clear();
+        m_excludeFiles.clear();
+        return false;
+    }
+    return true;
+}
+
 void Project::SetFiles(ProjectPtr src)
 {
     // first remove all the virtual directories from this project
@@ -1234,6 +1352,29 @@ wxString GetExtraFlags(CompilerPtr compiler)
     }
     return extra_flags;
 }
+
+void HashUpdate(wxUint64& hash, const wxString& str)
+{
+    // include the terminating null, so "ab" + "c" and "a" + "bc" hash differently
+    const wxScopedCharBuffer utf8 = str.utf8_str();
+    hash = FileUtils::GetStableHash(utf8.data(), utf8.length() + 1, hash);
+}
+
+bool HashFileContent(wxUint64& hash, const wxFileName& filename)
+{
+    wxLogNull noLog;
+    wxFFile fp(filename.GetFullPath(), "rb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
+
+    char buffer[4096];
+    size_t count = 0;
+    while ((count = fp.Read(buffer, sizeof(buffer))) > 0) {
+        hash = FileUtils::GetStableHash(buffer, count, hash);
+    }
+    return !fp.Error();
+}
 } // namespace
 
 wxString Project::GetCompileLineForCXXFile(const wxStringMap_t& compilersGlobalPaths, BuildConfigPtr buildConf,
@@ -1405,6 +1546,55 @@ void Project::CreateCompileCommandsJSON(JSONItem& compile_commands, const wxStri
     }
 }
 
+wxString Project::GetCompileCommandsFingerprint(const wxStringMap_t& compilersGlobalPaths)
+{
+    BuildConfigPtr buildConf = GetBuildConfiguration();
+    if (!buildConf) {
+        return wxEmptyString;
+    }
+
+    wxUint64 hash = 0;
+
+    // the project file holds the files list and the build settings of all the configurations
+    if (!HashFileContent(hash, m_fileName)) {
+        return wxEmptyString;
+    }
+    HashUpdate(hash, buildConf->GetName());
+    HashUpdate(hash, buildConf->GetCompilerType());
+    if (compilersGlobalPaths.count(buildConf->GetCompilerType())) {
+        HashUpdate(hash, compilersGlobalPaths.find(buildConf->GetCompilerType())->second);
+    }
+
+    {
+        // the environment the compile lines are expanded with (global + workspace + project variables)
+        EnvSetter es(NULL, NULL, GetName(), buildConf->GetName());
+        wxEnvVariableHashMap envMap;
+        ::wxGetEnvMap(&envMap);
+        std::vector<wxString> envVars;
+        envVars.reserve(envMap.size());
+        for (const auto& vt : envMap) {
+            envVars.push_back(vt.first + "=" + vt.second);
+        }
+        std::sort(envVars.begin(), envVars.end());
+        for (const wxString& envVar : envVars) {
+            HashUpdate(hash, envVar);
+        }
+
+        // the output of the backticks. The expansions are cached by the workspace, so a command shared by several
+        // projects (e.g. `pkg-config --cflags gtk+-3.0`) runs once
+        wxString options;
+        options << buildConf->GetCompileOptions() << ";" << buildConf->GetCCompileOptions();
+        wxArrayString optionsArr = ::wxStringTokenize(options, ";", wxTOKEN_STRTOK);
+        for (wxString& option : optionsArr) {
+            option.Trim().Trim(false);
+            if (option.StartsWith("`") || option.StartsWith("$(shell ")) {
+                HashUpdate(hash, DoExpandBacktick(option));
+            }
+        }
+    }
+    return wxULongLong(hash).ToString();
+}
+
 BuildConfigPtr Project::GetBuildConfiguration(const wxString& configName) const
 {
     BuildMatrixPtr matrix = GetWorkspace()->GetBuildMatrix();
@@ -26,6 +26,7 @@
 #define PROJECT_H
 
 #include "JSON.h"
+#include "clProjectsSnapshot.hpp"
 #include "codelite_exports.h"
 #include "localworkspace.h"
 #include "macros.h"
@@ -334,7 +335,28 @@ private:
 
 private:
     void DoUpdateProjectSettings();
-    void DoBuildCacheFromXml();
+    /**
+     * @brief build the files and virtual folders tables from the XML. When `snapshot` is provided, the visited nodes
+     * are recorded into it
+     */
+    void DoBuildCacheFromXml(clProjectsSnapshot::Entry* snapshot = nullptr);
+    /**
+     * @brief restore the files and virtual folders tables from a snapshot, binding them to the XML nodes.
+     * Return false (and leave the tables empty) if the snapshot does not match the XML
+     */
+    bool DoBuildCacheFromSnapshot(const clProjectsSnapshot::Entry& snapshot);
+    /**
+     * @brief the first part of Load(): parse the project file and build the files table. This part does not touch any
+     * global state, so projects can be loaded in parallel
+     * @param snapshot when not null, the tables are restored from it if it is still valid. Otherwise it is rebuilt
+     * @param restored set to true if the tables were restored from the snapshot
+     */
+    bool DoLoadXml(const wxString& path, clProjectsSnapshot::Entry* snapshot, bool& restored);
+    /**
+     * @brief the second part of Load(): load the settings and upgrade the project file if needed. Must be called from
+     * the main thread
+     */
+    bool DoLoadComplete();
     clProjectFile::Ptr_t FileFromXml(wxXmlNode* node, const wxString& vd);
     wxArrayString DoGetCompilerOptions(bool cxxOptions, bool clearCache = false, bool noDefines = true,
                                        bool noIncludePaths = true);
@@ -756,6 +778,13 @@ public:
     void CreateCompileCommandsJSON(JSONItem& compile_commands, const wxStringMap_t& compilersGlobalPaths,
                                    bool createCompileFlagsTxt);
 
+    /**
+     * @brief return a fingerprint of everything the compile_commands.json entries of this project are generated from:
+     * the project file, the selected configuration, the compiler global paths, the environment and the backticks
+     * output. An empty string is returned when the fingerprint can not be computed
+     */
+    wxString GetCompileCommandsFingerprint(const wxStringMap_t& compilersGlobalPaths);
+
     /**
      * @brief create compile_flags.txt file for this project
      * @param compilersGlobalPaths
@@ -39,10 +39,14 @@
 #include "localworkspace.h"
 #include "macromanager.h"
 #include "macros.h"
+#include "md5/wxmd5.h"
 #include "plugin.h"
 #include "project.h"
 #include "xmlutils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <wx/app.h>
 #include <wx/log.h>
 #include <wx/msgdlg.h>
@@ -1029,9 +1033,20 @@ wxFileName clCxxWorkspace::GetTagsFileName() const
     return fn_tags;
 }
 
-cJSON* clCxxWorkspace::CreateCompileCommandsJSON(bool createCompileFlagsTxt, wxArrayString* generated_paths) const
+wxFileName clCxxWorkspace::GetProjectsSnapshotFileName() const
+{
+    if(!IsOpen()) {
+        return wxFileName();
+    }
+
+    wxFileName fn_snapshot(GetPrivateFolder(), GetWorkspaceFileName().GetFullName());
+    fn_snapshot.SetName(fn_snapshot.GetName() + "-projects");
+    fn_snapshot.SetExt("snapshot");
+    return fn_snapshot;
+}
+
+wxStringMap_t clCxxWorkspace::DoGetCompilersGlobalPaths() const
 {
-    // Build the global compiler paths, we will need this later on...
     wxStringMap_t compilersGlobalPaths;
     std::unordered_map<wxString, wxArrayString> pathsMap = BuildSettingsConfigST::Get()->GetCompilersGlobalPaths();
     for(const auto& vt : pathsMap) {
@@ -1047,6 +1062,13 @@ cJSON* clCxxWorkspace::CreateCompileCommandsJSON(bool createCompileFlagsTxt, wxA
         }
         compilersGlobalPaths.insert({ compiler_name, paths });
     }
+    return compilersGlobalPaths;
+}
+
+cJSON* clCxxWorkspace::CreateCompileCommandsJSON(bool createCompileFlagsTxt, wxArrayString* generated_paths) const
+{
+    // Build the global compiler paths, we will need this later on...
+    wxStringMap_t compilersGlobalPaths = DoGetCompilersGlobalPaths();
 
     // Check if the active project is using custom build
     ProjectPtr activeProject = GetActiveProject();
@@ -1081,6 +1103,188 @@ cJSON* clCxxWorkspace::CreateCompileCommandsJSON(bool createCompileFlagsTxt, wxA
     return createCompileFlagsTxt ? nullptr : compile_commands.release();
 }
 
+namespace
+{
+// bump this whenever the fingerprints file format changes
+const int COMPILE_COMMANDS_FINGERPRINTS_VERSION = 1;
+
+struct ProjectFingerprint {
+    wxString fingerprint;
+    wxArrayString files; // the "file" of the entries this project added
+};
+} // namespace
+
+bool clCxxWorkspace::UpdateCompileCommandsJSON(const wxFileName& compile_commands_file) const
+{
+    // Check if the active project is using custom build
+    ProjectPtr activeProject = GetActiveProject();
+    if(activeProject) {
+        BuildConfigPtr buildConf = activeProject->GetBuildConfiguration();
+        if(buildConf && buildConf->IsCustomBuild()) {
+            return false;
+        }
+    }
+
+    wxStringMap_t compilersGlobalPaths = DoGetCompilersGlobalPaths();
+
+    // a change in the compilers definitions affects all the entries
+    wxString global_fingerprint = wxMD5::GetDigest(BuildSettingsConfigST::Get()->GetFileName());
+
+    // Load the fingerprints of the previous run. They are only usable if compile_commands.json was not modified
+    // since it was written by us
+    wxFileName fingerprints_file(GetPrivateFolder(), "compile_commands.fingerprints.json");
+    std::unordered_map<wxString, ProjectFingerprint> previous;
+    bool full = true;
+    if(compile_commands_file.FileExists() && fingerprints_file.FileExists()) {
+        JSON root(fingerprints_file);
+        JSONItem json = root.toElement();
+        if(root.isOk() && json["version"].toInt() == COMPILE_COMMANDS_FINGERPRINTS_VERSION &&
+           json["global"].toString() == global_fingerprint &&
+           json["mtime"].toSize_t() == (size_t)FileUtils::GetFileModificationTime(compile_commands_file) &&
+           json["size"].toSize_t() == FileUtils::GetFileSize(compile_commands_file)) {
+            for(const JSONItem& project : json["projects"].GetAsVector()) {
+                ProjectFingerprint entry;
+                entry.fingerprint = project["fingerprint"].toString();
+                entry.files = project["files"].toArrayString();
+                previous.insert({ project["name"].toString(), entry });
+            }
+            full = false;
+        }
+    }
+
+    // Compute the current fingerprints and collect the projects that need to be generated again
+    std::unordered_map<wxString, ProjectFingerprint> current;
+    std::vector<ProjectPtr> changed;
+    for(const auto& vt : m_projects) {
+        BuildConfigPtr buildConf = vt.second->GetBuildConfiguration();
+        if(!buildConf || !buildConf->IsProjectEnabled() || buildConf->IsCustomBuild() ||
+           !buildConf->IsCompilerRequired()) {
+            continue;
+        }
+
+        ProjectFingerprint entry;
+        entry.fingerprint = vt.second->GetCompileCommandsFingerprint(compilersGlobalPaths);
+        auto iter = previous.find(vt.first);
+        if(!full && !entry.fingerprint.empty() && iter != previous.end() &&
+           iter->second.fingerprint == entry.fingerprint) {
+            // unchanged, keep its entries
+            entry.files.swap(iter->second.files);
+            previous.erase(iter);
+        } else {
+            changed.push_back(vt.second);
+        }
+        current.insert({ vt.first, entry });
+    }
+
+    // the projects left in `previous` were modified, removed or disabled: their entries are dropped
+    if(!full && changed.empty() && previous.empty()) {
+        clDEBUG() << "compile_commands.json is up to date" << endl;
+        return false;
+    }
+
+    JSON json(cJSON_Array);
+    JSONItem compile_commands = json.toElement();
+    auto add_entry = [&compile_commands](const wxString& file, const wxString& directory, const wxString& command) {
+        JSONItem item = JSONItem::createObject();
+        item.addProperty("file", file);
+        item.addProperty("directory", directory);
+        item.addProperty("command", command);
+        compile_commands.arrayAppend(item);
+    };
+
+    if(!full) {
+        wxStringSet_t dropped_files;
+        for(const auto& vt : previous) {
+            dropped_files.insert(vt.second.files.begin(), vt.second.files.end());
+        }
+
+        // the entries are identified by their file only: when an unchanged project compiles one of the dropped
+        // files, its entry is dropped as well, so that project is generated again (and its other entries dropped)
+        wxStringSet_t changed_names;
+        for(ProjectPtr project : changed) {
+            changed_names.insert(project->GetName());
+        }
+
+        bool dropped_more = true;
+        while(dropped_more) {
+            dropped_more = false;
+            for(auto& vt : current) {
+                if(changed_names.count(vt.first)) {
+                    continue;
+                }
+
+                const wxArrayString& files = vt.second.files;
+                auto is_dropped = [&dropped_files](const wxString& file) { return dropped_files.count(file) > 0; };
+                bool shares_file = std::any_of(files.begin(), files.end(), is_dropped);
+                if(!shares_file) {
+                    continue;
+                }
+
+                changed_names.insert(vt.first);
+                changed.push_back(GetProject(vt.first));
+                dropped_files.insert(files.begin(), files.end());
+                dropped_more = true;
+            }
+        }
+
+        JSON existing(compile_commands_file);
+        JSONItem entries = existing.toElement();
+        if(existing.isOk() && entries.isArray()) {
+            for(const JSONItem& entry : entries.GetAsVector()) {
+                wxString file = entry["file"].toString();
+                if(dropped_files.count(file) == 0) {
+                    add_entry(file, entry["directory"].toString(), entry["command"].toString());
+                }
+            }
+        } else {
+            // the existing file can not be merged, generate everything
+            full = true;
+            changed.clear();
+            for(const auto& vt : m_projects) {
+                if(current.count(vt.first)) {
+                    changed.push_back(vt.second);
+                }
+            }
+        }
+    }
+
+    for(ProjectPtr project : changed) {
+        JSON project_json(cJSON_Array);
+        JSONItem project_commands = project_json.toElement();
+        project->CreateCompileCommandsJSON(project_commands, compilersGlobalPaths, false);
+
+        ProjectFingerprint& fingerprint = current[project->GetName()];
+        fingerprint.files.clear();
+        for(const JSONItem& entry : project_commands.GetAsVector()) {
+            wxString file = entry["file"].toString();
+            fingerprint.files.Add(file);
+            add_entry(file, entry["directory"].toString(), entry["command"].toString());
+        }
+    }
+
+    clDEBUG() << "Updating compile_commands.json:" << changed.size() << "out of" << current.size()
+              << "projects were generated" << (full ? "(full)" : "") << endl;
+
+    json.save(compile_commands_file);
+
+    JSON fingerprints(cJSON_Object);
+    JSONItem root = fingerprints.toElement();
+    root.addProperty("version", COMPILE_COMMANDS_FINGERPRINTS_VERSION);
+    root.addProperty("global", global_fingerprint);
+    root.addProperty("mtime", (size_t)FileUtils::GetFileModificationTime(compile_commands_file));
+    root.addProperty("size", FileUtils::GetFileSize(compile_commands_file));
+    JSONItem projects = root.AddArray("projects");
+    for(const auto& vt : current) {
+        JSONItem project = JSONItem::createObject();
+        project.addProperty("name", vt.first);
+        project.addProperty("fingerprint", vt.second.fingerprint);
+        project.addProperty("files", vt.second.files);
+        projects.arrayAppend(project);
+    }
+    fingerprints.save(fingerprints_file);
+    return true;
+}
+
 ProjectPtr clCxxWorkspace::GetActiveProject() const { return GetProject(GetActiveProjectName()); }
 
 ProjectPtr clCxxWorkspace::GetProject(const wxString& name) const
@@ -1255,15 +1459,95 @@ void clCxxWorkspace::DoUnselectActiveProject()
 
 void clCxxWorkspace::DoLoadProjectsFromXml(wxXmlNode* parentNode, const wxString& folder,
                                            std::vector<wxXmlNode*>& removedChildren)
+{
+    std::vector<ProjectLoadJob> jobs;
+    DoCollectProjectsFromXml(parentNode, folder, jobs);
+    if(jobs.empty()) {
+        return;
+    }
+
+    wxFileName snapshotFile = GetProjectsSnapshotFileName();
+    clProjectsSnapshot snapshot;
+    snapshot.Load(snapshotFile);
+    for(auto& job : jobs) {
+        snapshot.Take(job.path, job.snapshot);
+        // the Project constructor creates default settings (which uses global managers), so keep it on this thread
+        job.project = std::make_shared<Project>();
+    }
+
+    // entries left in the snapshot belong to projects that are no longer part of the workspace
+    bool saveSnapshot = snapshot.GetCount() > 0;
+    snapshot.Clear();
+
+    // Parse the project files in parallel. Project::DoLoadXml() only touches the project it loads
+    std::atomic_size_t next{ 0 };
+    auto worker = [&jobs, &next]() {
+        for(size_t index = next++; index < jobs.size(); index = next++) {
+            ProjectLoadJob& job = jobs[index];
+            job.loaded = job.project->DoLoadXml(job.path, &job.snapshot, job.restored);
+        }
+    };
+
+    size_t threadsCount = std::max(1u, std::thread::hardware_concurrency());
+    threadsCount = std::min(threadsCount, jobs.size());
+
+    // the calling thread is a worker as well
+    std::vector<std::thread> workers;
+    for(size_t i = 1; i < threadsCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for(auto& t : workers) {
+        t.join();
+    }
+
+    // Complete the loading and register the projects on the main thread, in the order they appear in the workspace
+    size_t restoredCount = 0;
+    for(auto& job : jobs) {
+        if(!job.loaded || !job.project->DoLoadComplete()) {
+            clWARNING() << "Corrupted project file:" << job.path << endl;
+            removedChildren.push_back(job.xml_node);
+            continue;
+        }
+
+        m_projects.insert(std::make_pair(job.project->GetName(), job.project));
+        job.project->AssociateToWorkspace(this);
+        job.project->SetWorkspaceFolder(job.folder);
+
+        if(job.restored) {
+            ++restoredCount;
+        } else {
+            saveSnapshot = true;
+        }
+        snapshot.Set(job.path, std::move(job.snapshot));
+    }
+
+    clDEBUG() << "Loaded" << jobs.size() << "projects using" << threadsCount << "threads." << restoredCount
+              << "projects were restored from the snapshot" << endl;
+
+    if(saveSnapshot && !snapshot.Save(snapshotFile)) {
+        clWARNING() << "Failed to write projects snapshot:" << snapshotFile << endl;
+    }
+}
+
+void clCxxWorkspace::DoCollectProjectsFromXml(wxXmlNode* parentNode, const wxString& folder,
+                                              std::vector<ProjectLoadJob>& jobs)
 {
     wxXmlNode* child = parentNode->GetChildren();
     while(child) {
         if(child->GetName() == wxT("Project")) {
-            wxString projectPath = child->GetAttribute(wxT("Path"), wxEmptyString);
-            wxString errmsg;
-            if(!DoAddProject(projectPath, folder, errmsg)) {
-                removedChildren.push_back(child);
+            // Convert the path to absolute path
+            wxFileName projectFile(child->GetAttribute(wxT("Path"), wxEmptyString));
+            if(projectFile.IsRelative()) {
+                projectFile.MakeAbsolute(m_fileName.GetPath());
             }
+
+            ProjectLoadJob job;
+            job.xml_node = child;
+            job.path = projectFile.GetFullPath();
+            job.folder = folder;
+            jobs.push_back(std::move(job));
+
         } else if(child->GetName() == wxT("VirtualDirectory")) {
             // Virtual directory
             wxString currentFolder = folder;
@@ -1272,7 +1556,7 @@ void clCxxWorkspace::DoLoadProjectsFromXml(wxXmlNode* parentNode, const wxString
                 currentFolder << "/";
             }
             currentFolder << vdName;
-            DoLoadProjectsFromXml(child, currentFolder, removedChildren);
+            DoCollectProjectsFromXml(child, currentFolder, jobs);
         } else if((child->GetName() == wxT("WorkspaceParserPaths")) ||
                   (child->GetName() == wxT("WorkspaceParserMacros"))) {
             wxString swtlw = XmlUtils::ReadString(m_doc.GetRoot(), "SWTLW");
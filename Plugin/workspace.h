@@ -105,6 +105,16 @@ public:
     void ClearBacktickCache();
 
 private:
+    struct ProjectLoadJob {
+        wxXmlNode* xml_node = nullptr;
+        wxString path;
+        wxString folder;
+        ProjectPtr project;
+        clProjectsSnapshot::Entry snapshot;
+        bool loaded = false;
+        bool restored = false;
+    };
+
     void DoUpdateBuildMatrix();
     /**
      * @brief mark all projects as non-active
@@ -112,10 +122,15 @@ private:
     void DoUnselectActiveProject();
 
     /**
-     * @brief load projects from the XML file
+     * @brief load projects from the XML file. The project files are parsed in parallel
      */
     void DoLoadProjectsFromXml(wxXmlNode* parentNode, const wxString& folder, std::vector<wxXmlNode*>& removedChildren);
 
+    /**
+     * @brief collect the projects to load (recursively) from the XML file
+     */
+    void DoCollectProjectsFromXml(wxXmlNode* parentNode, const wxString& folder, std::vector<ProjectLoadJob>& jobs);
+
     // return the wxXmlNode instance for the give path
     // the path is separated by "/"
     // return NULL if no such virtual directory exists
@@ -146,6 +161,11 @@ private:
      */
     void OnBuildHotspotClicked(clBuildEvent& event);
 
+    /**
+     * @brief return the global include paths of the compilers, as a ';' separated list, keyed by the compiler name
+     */
+    wxStringMap_t DoGetCompilersGlobalPaths() const;
+
 public:
     /**
      * @brief move 'projectName' to folder. Create the folder if it does not exists
@@ -178,6 +198,14 @@ public:
      */
     cJSON* CreateCompileCommandsJSON(bool createCompileFlagsTxt, wxArrayString* generated_paths) const;
 
+    /**
+     * @brief update compile_commands.json incrementally. Each project keeps a fingerprint (see
+     * Project::GetCompileCommandsFingerprint) in the workspace private folder: only the entries of the projects whose
+     * fingerprint changed are generated again, the others are kept from the existing file
+     * @return true if the file was written, false if it is already up to date (or can not be generated)
+     */
+    bool UpdateCompileCommandsJSON(const wxFileName& compile_commands_file) const;
+
     wxString GetFileName() const override { return GetWorkspaceFileName().GetFullPath(); }
     wxString GetDir() const override { return GetWorkspaceFileName().GetPath(); }
 
@@ -448,6 +476,12 @@ public:
      */
     wxFileName GetTagsFileName() const;
 
+    /**
+     * @brief return the file used to store the projects snapshot (the files and virtual folders tables of the
+     * projects)
+     */
+    wxFileName GetProjectsSnapshotFileName() const;
+
     /**
      * @brief return project by name
      */
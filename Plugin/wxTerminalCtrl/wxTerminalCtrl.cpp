@@ -158,8 +158,8 @@ void wxTerminalCtrl::Run(const wxString& command)
 void wxTerminalCtrl::AppendText(wxStringView text)
 {
     wxString window_title;
+    // the view writes the text on its next flush, and moves the caret to the end then
     m_outputView->StyleAndAppend(text, &window_title);
-    m_outputView->SetCaretEnd();
     m_inputCtrl->SetWritePositionEnd();
 
     if (!window_title.empty()) {
@@ -255,6 +255,8 @@ bool wxTerminalCtrl::PromptForPasswordIfNeeded(const wxString& line)
     };
 
     if (should_prompt_user_func(line.Lower())) {
+        // show the output that leads to the prompt
+        m_outputView->Flush();
         wxString pass = ::wxGetPasswordFromUser(line, "CodeLite", wxEmptyString, wxTheApp->GetTopWindow());
         if (pass.empty()) {
             GenerateCtrlC();
@@ -350,20 +352,19 @@ void wxTerminalCtrl::ProcessOutputBuffer()
 
     AppendText(sv);
 
-    wxArrayString new_lines = ::wxStringTokenize(m_processOutput, "\r\n", wxTOKEN_STRTOK);
+    // a process waiting for a password prints the prompt last: only the last line needs to be checked. Checking
+    // every line would make large outputs expensive
+    wxString last_line = m_processOutput;
+    last_line.Trim();
+    last_line = last_line.AfterLast('\n');
 
     // consume the string from the output buffer
     m_processOutput.clear();
 
-    // Check if any of the newly added lines require password prompting
-    for (const auto& line : new_lines) {
-        if (PromptForPasswordIfNeeded(line)) {
-            break;
-        }
-    }
-
     // see if we need to prompt for password
-    m_inputCtrl->CallAfter(&wxTerminalInputCtrl::NotifyTerminalOutput);
+    PromptForPasswordIfNeeded(last_line);
+
+    // the view notifies the input control once the output is written
 }
 
 void wxTerminalCtrl::ProcessIdle()
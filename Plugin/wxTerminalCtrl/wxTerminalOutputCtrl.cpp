@@ -7,6 +7,7 @@
 #include "clIdleEventThrottler.hpp"
 #include "clSystemSettings.h"
 #include "clWorkspaceManager.h"
+#include "cl_config.h"
 #include "codelite_events.h"
 #include "dirsaver.h"
 #include "event_notifier.h"
@@ -16,6 +17,7 @@
 #include "wxTerminalCtrl.h"
 #include "wxTerminalInputCtrl.hpp"
 
+#include <algorithm>
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
 #include <wx/sizer.h>
@@ -24,6 +26,46 @@
 
 namespace
 {
+/// the buffered output is written to the view at most once per this interval (~60 times per second)
+constexpr int FLUSH_INTERVAL_MS = 16;
+
+/// an OSC sequence that is not terminated yet is kept in the buffer until the rest of it arrives, up to this size
+constexpr size_t MAX_INCOMPLETE_SEQUENCE = 4096;
+
+/// return the position of the escape sequence that is still incomplete at the end of `buffer`, or the buffer length
+/// if there is none. Uses the same rules as StringUtils::StripTerminalOSC()
+size_t FindIncompleteSequence(const wxString& buffer)
+{
+    size_t len = buffer.length();
+    size_t osc_start = wxString::npos;
+    for (size_t i = 0; i < len; ++i) {
+        wxChar ch = buffer[i];
+        if (osc_start == wxString::npos) {
+            if (ch != 0x1B) {
+                continue;
+            }
+            if (i + 1 == len) {
+                return i;
+            }
+            if (buffer[i + 1] == ']') {
+                osc_start = i;
+                ++i;
+            }
+        } else if (ch == 0x07 /* BELL */) {
+            osc_start = wxString::npos;
+        } else if (ch == 0x1B /* ESC */) {
+            if (i + 1 == len) {
+                return osc_start;
+            }
+            if (buffer[i + 1] == 0x5C /* \\ */) {
+                osc_start = wxString::npos;
+                ++i;
+            }
+        }
+    }
+    return osc_start == wxString::npos ? len : osc_start;
+}
+
 /// given range, [start, end), return the string in this range without any ANSI escape codes
 wxString GetSelectedRange(wxStyledTextCtrl* ctrl, int start_pos, int end_pos)
 {
@@ -129,6 +171,8 @@ void wxTerminalOutputCtrl::Initialise(const wxFont& font, const wxColour& bg_col
     m_ctrl->SetLexer(wxSTC_LEX_CONTAINER);
     m_ctrl->SetWrapMode(wxSTC_WRAP_CHAR);
     m_ctrl->SetEditable(false);
+    // the output is never undone, do not keep a copy of it in the undo buffer
+    m_ctrl->SetUndoCollection(false);
     m_ctrl->SetWordChars(R"#(\:~abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_$/.-+@)#");
     m_ctrl->IndicatorSetStyle(INDICATOR_HYPERLINK, wxSTC_INDIC_COMPOSITIONTHICK);
     auto lexer = ColoursAndFontsManager::Get().GetLexer("terminal");
@@ -147,11 +191,17 @@ void wxTerminalOutputCtrl::Initialise(const wxFont& font, const wxColour& bg_col
 
     m_ctrl->Bind(wxEVT_KILL_FOCUS, &wxTerminalOutputCtrl::OnFocusLost, this);
     m_ctrl->Bind(wxEVT_SET_FOCUS, &wxTerminalOutputCtrl::OnFocus, this);
+
+    m_flushTimer = new wxTimer(this);
+    Bind(wxEVT_TIMER, &wxTerminalOutputCtrl::OnFlushTimer, this, m_flushTimer->GetId());
 }
 
 wxTerminalOutputCtrl::~wxTerminalOutputCtrl()
 {
     wxDELETE(m_stcRenderer);
+    Unbind(wxEVT_TIMER, &wxTerminalOutputCtrl::OnFlushTimer, this, m_flushTimer->GetId());
+    m_flushTimer->Stop();
+    wxDELETE(m_flushTimer);
     m_ctrl->Unbind(wxEVT_CHAR_HOOK, &wxTerminalOutputCtrl::OnKeyDown, this);
     m_ctrl->Unbind(wxEVT_LEFT_UP, &wxTerminalOutputCtrl::OnLeftUp, this);
 
@@ -162,11 +212,62 @@ wxTerminalOutputCtrl::~wxTerminalOutputCtrl()
 
 void wxTerminalOutputCtrl::AppendText(const wxString& buffer)
 {
-    EditorEnabler d{ m_ctrl };
+    QueueOutput(wxStringView{ buffer.wc_str(), buffer.length() });
+}
+
+void wxTerminalOutputCtrl::QueueOutput(wxStringView buffer)
+{
+    if (buffer.empty()) {
+        return;
+    }
 
-    // Remove unwanted ANSI OSC escape sequences
-    m_ctrl->AppendText(StringUtils::StripTerminalOSC(buffer));
+    m_pendingOutput.append(buffer.data(), buffer.length());
+    if (!m_flushTimer->IsRunning()) {
+        m_flushTimer->StartOnce(FLUSH_INTERVAL_MS);
+    }
+}
+
+void wxTerminalOutputCtrl::OnFlushTimer(wxTimerEvent& event)
+{
+    wxUnusedVar(event);
+    Flush();
+}
+
+void wxTerminalOutputCtrl::Flush()
+{
+    m_flushTimer->Stop();
+    if (m_pendingOutput.empty()) {
+        return;
+    }
+
+    // an escape sequence might be split between two reads: keep its beginning until the rest of it arrives
+    size_t count = FindIncompleteSequence(m_pendingOutput);
+    if (m_pendingOutput.length() - count > MAX_INCOMPLETE_SEQUENCE) {
+        count = m_pendingOutput.length();
+    }
+
+    // Remove unwanted ANSI OSC escape sequences. The colours are handled by the lexer, only for the visible lines
+    wxString text = StringUtils::StripTerminalOSC(wxStringView{ m_pendingOutput.wc_str(), count });
+    m_pendingOutput.erase(0, count);
+    if (!m_pendingOutput.empty()) {
+        m_flushTimer->StartOnce(FLUSH_INTERVAL_MS);
+    }
+
+    if (text.empty()) {
+        return;
+    }
+
+    {
+        EditorEnabler d{ m_ctrl };
+        m_ctrl->AppendText(text);
+    }
+    Truncate();
+    SetCaretEnd();
     RequestScrollToEnd();
+
+    if (m_terminal && m_terminal->GetInputCtrl()) {
+        m_terminal->GetInputCtrl()->NotifyTerminalOutput();
+    }
 }
 
 long wxTerminalOutputCtrl::GetLastPosition() const { return m_ctrl->GetLastPosition(); }
@@ -200,13 +301,15 @@ void wxTerminalOutputCtrl::Replace(long from, long to, const wxString& replaceWi
 
 wxString wxTerminalOutputCtrl::GetLineText(int lineNumber) const { return m_ctrl->GetLineText(lineNumber); }
 
-void wxTerminalOutputCtrl::ReloadSettings() { ApplyTheme(); }
+void wxTerminalOutputCtrl::ReloadSettings()
+{
+    m_scrollbackLines = clConfig::Get().Read("terminal/scrollback_lines", 10000);
+    ApplyTheme();
+}
 
 void wxTerminalOutputCtrl::StyleAndAppend(wxStringView buffer, [[maybe_unused]] wxString* window_title)
 {
-    EditorEnabler enabler{ m_ctrl };
-    m_ctrl->AppendText(StringUtils::StripTerminalOSC(buffer));
-    RequestScrollToEnd();
+    QueueOutput(buffer);
 }
 
 void wxTerminalOutputCtrl::ShowCommandLine()
@@ -225,15 +328,18 @@ void wxTerminalOutputCtrl::SetCaretEnd()
 
 int wxTerminalOutputCtrl::Truncate()
 {
-    if (GetNumberOfLines() > 1000) {
-        // Start removing lines from the top
-        long linesToRemove = (GetNumberOfLines() - 1000);
-        long startPos = 0;
-        long endPos = XYToPosition(0, linesToRemove);
-        this->Remove(startPos, endPos);
-        return endPos - startPos;
+    // remove the lines above the scrollback limit. Lines are removed in blocks of 10% of the limit, so the view is
+    // not shifted on every write
+    int lines = GetNumberOfLines();
+    if (m_scrollbackLines <= 0 || lines <= m_scrollbackLines + std::max(m_scrollbackLines / 10, 1)) {
+        return 0;
     }
-    return 0;
+
+    int endPos = m_ctrl->PositionFromLine(lines - m_scrollbackLines);
+    ClearIndicators();
+    EditorEnabler d{ m_ctrl };
+    m_ctrl->DeleteRange(0, endPos);
+    return endPos;
 }
 
 wxChar wxTerminalOutputCtrl::GetLastChar() const { return m_ctrl->GetCharAt(m_ctrl->GetLastPosition() - 1); }
@@ -242,6 +348,10 @@ int wxTerminalOutputCtrl::GetCurrentStyle() { return 0; }
 
 void wxTerminalOutputCtrl::Clear()
 {
+    // the output that was not written yet is cleared as well
+    m_pendingOutput.clear();
+    m_flushTimer->Stop();
+
     EditorEnabler d{ m_ctrl };
     m_ctrl->ClearAll();
 }
@@ -10,6 +10,7 @@
 
 #include <wx/stc/stc.h>
 #include <wx/textctrl.h>
+#include <wx/timer.h>
 
 class wxTerminalCtrl;
 class wxTerminalInputCtrl;
@@ -71,6 +72,9 @@ class WXDLLIMPEXP_SDK wxTerminalOutputCtrl : public wxWindow
     wxTerminalCtrl* m_terminal = nullptr;
     clEditEventsHandler::Ptr_t m_editEvents;
     IndicatorRange m_indicatorHyperlink;
+    wxString m_pendingOutput;
+    wxTimer* m_flushTimer = nullptr;
+    int m_scrollbackLines = 10000;
     friend class wxTerminalCtrl;
 
 protected:
@@ -93,6 +97,8 @@ protected:
 
     void OnFocusLost(wxFocusEvent& event);
     void OnFocus(wxFocusEvent& event);
+    void OnFlushTimer(wxTimerEvent& event);
+    void QueueOutput(wxStringView buffer);
 
 public:
     explicit wxTerminalOutputCtrl(wxTerminalCtrl* parent,
@@ -108,8 +114,23 @@ public:
     wxEvtHandler* GetSink() { return m_sink; }
 
     // API
+    /**
+     * @brief append text to the view. The text is buffered and written to the view at most once per frame, so a
+     * process that produces a lot of output does not keep the UI busy
+     */
     void AppendText(const wxString& buffer);
     void StyleAndAppend(wxStringView buffer, wxString* window_title);
+
+    /**
+     * @brief write the buffered output to the view now
+     */
+    void Flush();
+
+    /**
+     * @brief the number of lines kept in the view. 0 means no limit
+     */
+    void SetScrollbackLines(int lines) { m_scrollbackLines = lines; }
+    int GetScrollbackLines() const { return m_scrollbackLines; }
     long GetLastPosition() const;
     wxString GetRange(int from, int to) const;
     bool PositionToXY(long pos, long* x, long* y) const;
@@ -35,6 +35,7 @@
 #include "SSHAccountManagerDlg.h"
 #include "bitmap_loader.h"
 #include "clFileOrFolderDropTarget.h"
+#include "clSFTPManager.hpp"
 #include "clToolBarButtonBase.h"
 #include "cl_config.h"
 #include "event_notifier.h"
@@ -51,6 +52,7 @@
 #include <algorithm>
 #include <vector>
 #include <wx/busyinfo.h>
+#include <wx/dirdlg.h>
 #include <wx/fdrepdlg.h>
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
@@ -64,6 +66,7 @@ SFTPTreeView::SFTPTreeView(wxWindow* parent, SFTP* plugin)
 {
     m_view = new clRemoteDirCtrl(this);
     GetSizer()->Add(m_view, 1, wxEXPAND);
+    m_view->Bind(wxEVT_REMOTEDIR_DIR_CONTEXT_MENU_SHOWING, &SFTPTreeView::OnDirContextMenu, this);
 
     m_timer = new wxTimer(this);
     Bind(wxEVT_TIMER, &SFTPTreeView::OnKeepAliveTimer, this, m_timer->GetId());
@@ -112,11 +115,94 @@ SFTPTreeView::~SFTPTreeView()
     wxTheApp->GetTopWindow()->Unbind(wxEVT_MENU, &SFTPTreeView::OnUndo, this, wxID_UNDO);
     wxTheApp->GetTopWindow()->Unbind(wxEVT_MENU, &SFTPTreeView::OnRedo, this, wxID_REDO);
 
+    m_view->Unbind(wxEVT_REMOTEDIR_DIR_CONTEXT_MENU_SHOWING, &SFTPTreeView::OnDirContextMenu, this);
+
     m_timer->Stop();
     Unbind(wxEVT_TIMER, &SFTPTreeView::OnKeepAliveTimer, this, m_timer->GetId());
     wxDELETE(m_timer);
 }
 
+void SFTPTreeView::OnDirContextMenu(clContextMenuEvent& event)
+{
+    event.Skip();
+    wxMenu* menu = event.GetMenu();
+    wxString remoteFolder = m_view->GetSelectedFolder();
+    if (!menu || remoteFolder.empty()) {
+        return;
+    }
+
+    menu->AppendSeparator();
+    menu->Append(XRCID("sftp-upload-folder"), _("Upload a local folder here..."));
+    menu->Bind(
+        wxEVT_MENU,
+        [this, remoteFolder](wxCommandEvent& event) {
+            wxUnusedVar(event);
+            CallAfter(&SFTPTreeView::DoUploadFolder, remoteFolder);
+        },
+        XRCID("sftp-upload-folder"));
+    menu->Append(XRCID("sftp-download-folder"), _("Download folder..."));
+    menu->Bind(
+        wxEVT_MENU,
+        [this, remoteFolder](wxCommandEvent& event) {
+            wxUnusedVar(event);
+            CallAfter(&SFTPTreeView::DoDownloadFolder, remoteFolder);
+        },
+        XRCID("sftp-download-folder"));
+}
+
+void SFTPTreeView::DoUploadFolder(const wxString& remoteFolder)
+{
+    wxString localFolder = ::wxDirSelector(_("Select a local folder to upload"));
+    if (localFolder.empty()) {
+        return;
+    }
+
+    wxArrayString dirs = wxFileName::DirName(localFolder).GetDirs();
+    if (dirs.empty()) {
+        return;
+    }
+
+    // the folder is uploaded as a child of the selected remote folder
+    wxString target = remoteFolder;
+    if (!target.EndsWith("/")) {
+        target << "/";
+    }
+    target << dirs.Last();
+
+    // the files are spread over several SFTP sessions
+    if (!clSFTPManager::Get().AwaitUploadFolder(localFolder, target, m_account.GetAccountName())) {
+        ::wxMessageBox(_("Failed to upload folder:\n") + clSFTPManager::Get().GetLastError(), "SFTP",
+                       wxICON_ERROR | wxOK | wxCENTER);
+        return;
+    }
+    clGetManager()->SetStatusMessage(_("Uploaded ") + target + ". " +
+                                     clSFTPManager::Get().GetLastTransferStats().ToString());
+}
+
+void SFTPTreeView::DoDownloadFolder(const wxString& remoteFolder)
+{
+    wxString localFolder = ::wxDirSelector(_("Select the local folder to download into"));
+    if (localFolder.empty()) {
+        return;
+    }
+
+    // the folder is downloaded as a child of the selected local folder (unless it is the remote root)
+    wxFileName target = wxFileName::DirName(localFolder);
+    wxString name = remoteFolder.EndsWith("/") ? remoteFolder.BeforeLast('/').AfterLast('/')
+                                               : remoteFolder.AfterLast('/');
+    if (!name.empty()) {
+        target.AppendDir(name);
+    }
+
+    if (!clSFTPManager::Get().AwaitDownloadFolder(remoteFolder, target.GetPath(), m_account.GetAccountName())) {
+        ::wxMessageBox(_("Failed to download folder:\n") + clSFTPManager::Get().GetLastError(), "SFTP",
+                       wxICON_ERROR | wxOK | wxCENTER);
+        return;
+    }
+    clGetManager()->SetStatusMessage(_("Downloaded ") + remoteFolder + ". " +
+                                     clSFTPManager::Get().GetLastTransferStats().ToString());
+}
+
 void SFTPTreeView::OnDisconnect(wxCommandEvent& event) { DoCloseSession(); }
 void SFTPTreeView::OnConnect(wxCommandEvent& event) { DoOpenSession(); }
 
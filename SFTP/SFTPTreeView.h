@@ -79,6 +79,9 @@ protected:
     void OnDisconnectUI(wxUpdateUIEvent& event);
     void OnConnect(wxCommandEvent& event);
     void OnKeepAliveTimer(wxTimerEvent& event);
+    void OnDirContextMenu(clContextMenuEvent& event);
+    void DoUploadFolder(const wxString& remoteFolder);
+    void DoDownloadFolder(const wxString& remoteFolder);
 
     // Edit events
     void OnCopy(wxCommandEvent& event);
@@ -0,0 +1,116 @@
+#include "cl_exception.h"
+#include "ssh/cl_sftp.h"
+#include "ssh/cl_ssh.h"
+#include "tester.h"
+
+#include <cstring>
+#include <iostream>
+#include <wx/init.h>
+#include <wx/log.h>
+#include <wx/utils.h>
+
+using namespace std;
+
+namespace
+{
+/// connect to a local sshd. Return nullptr (skip the test) unless SFTP_TEST_USER is set. The other variables are
+/// optional: SFTP_TEST_PORT (default 22), SFTP_TEST_PASSWORD and SFTP_TEST_KEY (a private key file)
+clSFTP::Ptr_t open_loopback_sftp()
+{
+    wxString user, password, key_file, port_str;
+    if(!wxGetEnv("SFTP_TEST_USER", &user)) {
+        cout << "SFTP loopback test skipped. Please set environment variable SFTP_TEST_USER (local sshd account)"
+             << endl;
+        return nullptr;
+    }
+    wxGetEnv("SFTP_TEST_PASSWORD", &password);
+    long port = 22;
+    if(wxGetEnv("SFTP_TEST_PORT", &port_str)) {
+        port_str.ToCLong(&port);
+    }
+
+    wxArrayString keys;
+    if(wxGetEnv("SFTP_TEST_KEY", &key_file)) {
+        keys.Add(key_file);
+    }
+
+    clSSH::Ptr_t ssh(new clSSH("127.0.0.1", user, password, keys, port));
+    ssh->Open();
+    wxString message;
+    if(!ssh->AuthenticateServer(message)) {
+        // a local test server, we trust it
+        ssh->AcceptServerAuthentication();
+    }
+    ssh->Login();
+
+    clSFTP::Ptr_t sftp(new clSFTP(ssh));
+    sftp->Initialize();
+    return sftp;
+}
+} // namespace
+
+TEST_FUNC(test_sftp_loopback_transfer)
+{
+    clSFTP::Ptr_t sftp;
+    try {
+        sftp = open_loopback_sftp();
+    } catch(const clException& e) {
+        cout << "SFTP loopback test: failed to connect. " << e.What() << endl;
+        CHECK_BOOL(false);
+    }
+
+    if(!sftp) {
+        return true;
+    }
+
+    // several read and write chunks, the last one is partial
+    wxMemoryBuffer content;
+    const size_t content_size = 1024 * 1024 + 4321;
+    char* data = (char*)content.GetWriteBuf(content_size);
+    for(size_t i = 0; i < content_size; ++i) {
+        data[i] = (char)((i * 31 + i / 7) & 0xFF);
+    }
+    content.UngetWriteBuf(content_size);
+
+    wxString remote_file;
+    remote_file << "/tmp/sftp-tests-" << ::wxGetProcessId() << ".bin";
+    bool same_content = false;
+    bool empty_content = false;
+    clSFTPTransferStats write_stats;
+    clSFTPTransferStats read_stats;
+    try {
+        sftp->Write(content, remote_file);
+        write_stats = sftp->GetLastTransferStats();
+
+        wxMemoryBuffer read_back;
+        sftp->Read(remote_file, read_back);
+        read_stats = sftp->GetLastTransferStats();
+        same_content = read_back.GetDataLen() == content.GetDataLen() &&
+                       memcmp(read_back.GetData(), content.GetData(), content.GetDataLen()) == 0;
+
+        // an empty file does not issue any read request
+        sftp->Write(wxMemoryBuffer(), remote_file);
+        wxMemoryBuffer empty;
+        sftp->Read(remote_file, empty);
+        empty_content = empty.GetDataLen() == 0;
+        sftp->UnlinkFile(remote_file);
+
+    } catch(const clException& e) {
+        cout << "SFTP loopback test: transfer failed. " << e.What() << endl;
+        CHECK_BOOL(false);
+    }
+
+    CHECK_BOOL(same_content);
+    CHECK_BOOL(empty_content);
+    CHECK_SIZE(write_stats.bytes, content_size);
+    CHECK_SIZE(read_stats.bytes, content_size);
+    CHECK_BOOL(read_stats.requests > 1);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    wxInitializer initializer(argc, argv);
+    wxLogNull NOLOG;
+    return Tester::Instance()->RunTests();
+}
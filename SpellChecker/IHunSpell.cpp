@@ -49,6 +49,7 @@
 #include "CorrectSpellingDlg.h"
 #include "IHunSpell.h"
 #include "ctags_manager.h"
+#include "lexer_configuration.h"
 #include "scGlobals.h"
 #include "spellcheck.h"
 
@@ -166,6 +167,11 @@ void HighlightWord(IEditor* editor, int pos)
     editor->SetUserIndicator(indicator_start, len);
 }
 
+/// lines above and below the visible area that are checked as well in continuous mode
+constexpr int VIEWPORT_MARGIN = 20;
+/// max number of lines checked per continuous mode iteration
+constexpr int MAX_LINES_PER_ITERATION = 500;
+
 } // namespace
 
 // ------------------------------------------------------------
@@ -178,12 +184,15 @@ IHunSpell::IHunSpell()
     , m_pPlugIn(nullptr)
     , m_pSpellDlg(nullptr)
     , m_scanners(0)
+    , m_thread(nullptr)
+    , m_requestId(0)
 {
     InitLanguageList();
 }
 // ------------------------------------------------------------
 IHunSpell::~IHunSpell()
 {
+    StopThread();
     CloseEngine();
 
     if (m_pSpellDlg != NULL)
@@ -226,6 +235,7 @@ bool IHunSpell::InitEngine()
         return false;
     }
     // so far ok, init engine
+    std::lock_guard lock{ m_spellMutex };
     m_pSpell = Hunspell_create(affBuffer, dicBuffer);
     return true;
 }
@@ -233,11 +243,17 @@ bool IHunSpell::InitEngine()
 // ------------------------------------------------------------
 void IHunSpell::CloseEngine()
 {
+    std::lock_guard lock{ m_spellMutex };
     if (m_pSpell != NULL) {
         Hunspell_destroy(m_pSpell);
         SaveUserDict(m_userDictPath + s_userDict);
     }
     m_pSpell = NULL;
+
+    // cached lookups belong to the dictionary we just closed
+    m_cache.Clear();
+    m_pending.clear();
+    m_editors.clear();
 }
 // ------------------------------------------------------------
 bool IHunSpell::CheckWord(const wxString& word) const
@@ -256,6 +272,20 @@ bool IHunSpell::CheckWord(const wxString& word) const
     if (rehex.Matches(word))
         return true;
 
+    bool correct = false;
+    if (m_cache.Get(word, correct))
+        return correct;
+
+    correct = DictionaryLookup(word);
+    m_cache.Put(word, correct);
+    return correct;
+}
+// ------------------------------------------------------------
+bool IHunSpell::DictionaryLookup(const wxString& word) const
+{
+    std::lock_guard lock{ m_spellMutex };
+    if (m_pSpell == NULL)
+        return true;
     return Hunspell_spell(m_pSpell, word.ToUTF8()) != 0;
 }
 // ------------------------------------------------------------
@@ -264,6 +294,7 @@ wxArrayString IHunSpell::GetSuggestions(const wxString& misspelled)
     wxArrayString suggestions;
     suggestions.Empty();
 
+    std::lock_guard lock{ m_spellMutex };
     if (m_pSpell) {
         char** wlst;
 
@@ -387,6 +418,216 @@ void IHunSpell::CheckSpelling()
     }
 }
 // ------------------------------------------------------------
+void IHunSpell::CheckSpellingIncremental(IEditor* editor)
+{
+    static thread_local wxRegEx rehex(s_dectHex, wxRE_ADVANCED);
+
+    CHECK_PTR_RET(editor);
+    CHECK_COND_RET(InitEngine());
+    StartThread();
+
+    wxStyledTextCtrl* ctrl = editor->GetCtrl();
+    wxString filename = editor->GetFileName().GetFullPath();
+    if (filename != m_lastFile) {
+        // the active editor changed, forget about editors that are no longer open
+        m_lastFile = filename;
+        IEditor::List_t editors;
+        ::clGetManager()->GetAllEditors(editors);
+        std::unordered_set<wxString> open_files;
+        for (IEditor* e : editors) {
+            open_files.insert(e->GetFileName().GetFullPath());
+        }
+        for (auto iter = m_editors.begin(); iter != m_editors.end();) {
+            iter = open_files.count(iter->first) ? std::next(iter) : m_editors.erase(iter);
+        }
+    }
+
+    EditorState& state = m_editors[filename];
+    size_t line_count = ctrl->GetLineCount();
+    if (state.checked.size() != line_count) {
+        // new (or out of sync) state: start from scratch
+        state.checked.assign(line_count, 0);
+        editor->ClearUserIndicators();
+    }
+
+    // collect the dirty lines in and around the visible area
+    int first_line = ctrl->DocLineFromVisible(ctrl->GetFirstVisibleLine()) - VIEWPORT_MARGIN;
+    int last_line = ctrl->DocLineFromVisible(ctrl->GetFirstVisibleLine() + ctrl->LinesOnScreen()) + VIEWPORT_MARGIN;
+    first_line = wxMax(first_line, 0);
+    last_line = wxMin(last_line, (int)line_count - 1);
+
+    std::vector<int> lines;
+    for (int line = first_line; line <= last_line && (int)lines.size() < MAX_LINES_PER_ITERATION; ++line) {
+        if (!state.checked[line]) {
+            lines.push_back(line);
+        }
+    }
+
+    if (lines.empty()) {
+        return;
+    }
+
+    const std::unordered_set<int>* STRING_STYLES = nullptr;
+    const std::unordered_set<int>* COMMENT_STYLES = nullptr;
+
+    if (ALLOWED_STYLES_STRINGS.count(editor->GetLexerId())) {
+        STRING_STYLES = &ALLOWED_STYLES_STRINGS[editor->GetLexerId()];
+    }
+
+    if (ALLOWED_STYLES_COMMENTS.count(editor->GetLexerId())) {
+        COMMENT_STYLES = &ALLOWED_STYLES_COMMENTS[editor->GetLexerId()];
+    }
+
+#define IS_STYLE_ALLOWED(pset, style_id) (!pset || (pset && pset->count(style_id)))
+
+    PendingCheck pending;
+    pending.filename = filename;
+    pending.generation = state.generation;
+    std::unordered_set<wxString> lookups;
+
+    ctrl->SetIndicatorCurrent(INDICATOR_USER);
+    for (int line : lines) {
+        state.checked[line] = 1;
+
+        int line_start_pos = ctrl->PositionFromLine(line);
+        ctrl->IndicatorClearRange(line_start_pos, ctrl->GetLineEndPosition(line) - line_start_pos);
+
+        wxString text = ctrl->GetLine(line);
+        wxStringTokenizer tkz(text, s_defDelimiters);
+        int offset = 0;
+        while (tkz.HasMoreTokens()) {
+            wxString token = tkz.GetNextToken();
+            int pos = tkz.GetPosition() - token.length() + line_start_pos;
+            size_t utf8_len = FileUtils::UTF8Length(token.c_str(), token.length());
+            if (utf8_len > token.length()) {
+                offset += (utf8_len - token.length());
+            }
+            pos += offset;
+
+            if (token.length() <= MIN_TOKEN_LEN)
+                continue;
+
+            int style_at_pos = editor->GetStyleAtPos(pos + token.length() / 2);
+            if (!IS_STYLE_ALLOWED(STRING_STYLES, style_at_pos) && !IS_STYLE_ALLOWED(COMMENT_STYLES, style_at_pos))
+                continue;
+
+            if (m_ignoreList.count(token) || m_userDict.count(token) || rehex.Matches(token))
+                continue;
+
+            bool correct = false;
+            if (m_cache.Get(token, correct)) {
+                if (!correct) {
+                    HighlightWord(editor, pos + (token.length() / 2));
+                }
+                continue;
+            }
+
+            // unknown word, ask the worker thread
+            lookups.insert(token);
+            pending.tokens.push_back({ pos + (int)(token.length() / 2), token });
+        }
+    }
+#undef IS_STYLE_ALLOWED
+
+    if (lookups.empty()) {
+        return;
+    }
+
+    SpellCheckThreadRequest* req = new SpellCheckThreadRequest;
+    req->requestId = ++m_requestId;
+    req->words.insert(req->words.end(), lookups.begin(), lookups.end());
+    m_pending.insert({ req->requestId, std::move(pending) });
+    m_thread->Add(req);
+}
+// ------------------------------------------------------------
+void IHunSpell::OnWordsChecked(const SpellCheckThreadReply& reply)
+{
+    auto iter = m_pending.find(reply.requestId);
+    if (iter == m_pending.end()) {
+        // the request was cancelled (e.g. the dictionary was changed), its results can not be trusted
+        return;
+    }
+    PendingCheck pending = std::move(iter->second);
+    m_pending.erase(iter);
+
+    for (const auto& [word, correct] : reply.results) {
+        m_cache.Put(word, correct);
+    }
+
+    IEditor* editor = ::clGetManager()->GetActiveEditor();
+    if (!editor || editor->GetFileName().GetFullPath() != pending.filename) {
+        // the lines are highlighted once this file becomes active again
+        ResetIncrementalState(pending.filename);
+        return;
+    }
+
+    auto state = m_editors.find(pending.filename);
+    if (state == m_editors.end() || state->second.generation != pending.generation) {
+        // the editor was modified while we were checking, the positions are no longer valid
+        ResetIncrementalState(pending.filename);
+        return;
+    }
+
+    for (const auto& token : pending.tokens) {
+        bool correct = true;
+        m_cache.Get(token.word, correct);
+        if (!correct && !m_ignoreList.count(token.word) && !m_userDict.count(token.word)) {
+            HighlightWord(editor, token.pos);
+        }
+    }
+}
+// ------------------------------------------------------------
+void IHunSpell::EditorModified(const wxString& filename, int line, int linesAdded)
+{
+    auto iter = m_editors.find(filename);
+    if (iter == m_editors.end()) {
+        return;
+    }
+
+    EditorState& state = iter->second;
+    state.generation++;
+    if (line < 0 || line >= (int)state.checked.size()) {
+        state.checked.clear(); // out of sync, start over
+        return;
+    }
+
+    if (linesAdded > 0) {
+        state.checked.insert(state.checked.begin() + line + 1, linesAdded, 0);
+    } else if (linesAdded < 0) {
+        int count = wxMin(-linesAdded, (int)state.checked.size() - line - 1);
+        state.checked.erase(state.checked.begin() + line + 1, state.checked.begin() + line + 1 + count);
+    }
+    state.checked[line] = 0;
+}
+// ------------------------------------------------------------
+void IHunSpell::ResetIncrementalState(const wxString& filename)
+{
+    if (filename.IsEmpty()) {
+        m_editors.clear();
+        m_pending.clear();
+        return;
+    }
+    m_editors.erase(filename);
+}
+// ------------------------------------------------------------
+void IHunSpell::StartThread()
+{
+    if (m_thread) {
+        return;
+    }
+    m_thread = new SpellCheckThread(this);
+    m_thread->Start();
+}
+// ------------------------------------------------------------
+void IHunSpell::StopThread()
+{
+    if (!m_thread) {
+        return;
+    }
+    m_thread->Stop();
+    wxDELETE(m_thread);
+}
+// ------------------------------------------------------------
 // tools
 // ------------------------------------------------------------
 
@@ -575,3 +816,33 @@ void IHunSpell::SetCaseSensitiveUserDictionary(const bool caseSensitiveUserDicti
         m_ignoreList.swap(ignoreList);
     }
 }
+// ------------------------------------------------------------
+bool SpellCheckWordCache::Get(const wxString& word, bool& correct)
+{
+    auto iter = m_index.find(word);
+    if (iter == m_index.end()) {
+        return false;
+    }
+
+    // move it to the front of the list
+    m_items.splice(m_items.begin(), m_items, iter->second);
+    correct = iter->second->second;
+    return true;
+}
+// ------------------------------------------------------------
+void SpellCheckWordCache::Put(const wxString& word, bool correct)
+{
+    auto iter = m_index.find(word);
+    if (iter != m_index.end()) {
+        iter->second->second = correct;
+        m_items.splice(m_items.begin(), m_items, iter->second);
+        return;
+    }
+
+    m_items.push_front({ word, correct });
+    m_index.insert({ word, m_items.begin() });
+    if (m_index.size() > m_maxSize) {
+        m_index.erase(m_items.back().first);
+        m_items.pop_back();
+    }
+}
@@ -36,13 +36,18 @@
 #ifndef _IHUNSPELL_
 #define _IHUNSPELL_
 // ------------------------------------------------------------
+#include "SpellCheckThread.h"
 #include "wxStringHash.h"
 
 #include <hunspell/hunspell.h>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 #include <wx/arrstr.h>
+#include <wx/event.h>
 #include <wx/hashmap.h>
 // ------------------------------------------------------------
 WX_DECLARE_STRING_HASH_MAP(wxString, languageMap);
@@ -96,7 +101,35 @@ private:
     bool m_isCaseSensitive;
 };
 
-class IHunSpell
+/**
+ * @brief a least-recently-used cache of dictionary lookups (word -> correct?), shared by all the editors
+ */
+class SpellCheckWordCache
+{
+    typedef std::list<std::pair<wxString, bool>> List_t;
+    List_t m_items;
+    std::unordered_map<wxString, List_t::iterator> m_index;
+    size_t m_maxSize;
+
+public:
+    SpellCheckWordCache(size_t maxSize = 20000)
+        : m_maxSize(maxSize)
+    {
+    }
+
+    /// return true if the word is cached, its spelling result is placed in `correct`
+    bool Get(const wxString& word, bool& correct);
+    /// add the result of a dictionary lookup, evicting the least recently used entry if needed
+    void Put(const wxString& word, bool correct);
+    void Clear()
+    {
+        m_items.clear();
+        m_index.clear();
+    }
+    size_t GetSize() const { return m_index.size(); }
+};
+
+class IHunSpell : public wxEvtHandler
 {
 public:
     IHunSpell();
@@ -112,10 +145,21 @@ public:
     bool ChangeLanguage(const wxString& language);
     /// check spelling for one word. Return true if the word was found.
     bool CheckWord(const wxString& word) const;
+    /// check the word against the Hunspell dictionary only (no cache, no user lists). Thread safe.
+    bool DictionaryLookup(const wxString& word) const;
     /// returns an array with suggestions for the misspelled word.
     wxArrayString GetSuggestions(const wxString& misspelled);
     /// makes a spell check for the given plain text. Canceled is set to true when the user cancels.
     void CheckSpelling();
+    /// continuous mode: check the modified lines in the visible area of the editor. The dictionary lookups for words
+    /// that are not cached are done by a worker thread and the indicators are added when they complete
+    void CheckSpellingIncremental(IEditor* editor);
+    /// continuous mode: `linesAdded` lines were added (or removed, when negative) at `line`
+    void EditorModified(const wxString& filename, int line, int linesAdded);
+    /// continuous mode: forget what was checked for `filename` (or for all the files, when empty)
+    void ResetIncrementalState(const wxString& filename = wxEmptyString);
+    /// called by the worker thread when a batch of dictionary lookups is done
+    void OnWordsChecked(const SpellCheckThreadReply& reply);
     /// checks for predefined language names, which could be found in path
     void GetAvailableLanguageKeyNames(const wxString& path, wxArrayString& lang);
     /// returns the base filename for language key without extension
@@ -173,7 +217,25 @@ public:
 protected:
     using CustomDictionary = std::unordered_set<wxString, StringHashOptionalCase, StringCompareOptionalCase>;
 
+    struct EditorState {
+        std::vector<char> checked; // per line: was it checked since it was last modified?
+        size_t generation = 0;     // incremented on every modification
+    };
+
+    struct PendingToken {
+        int pos = 0;
+        wxString word;
+    };
+
+    struct PendingCheck {
+        wxString filename;
+        size_t generation = 0;
+        std::vector<PendingToken> tokens;
+    };
+
     void InitLanguageList();
+    void StartThread();
+    void StopThread();
 
     bool LoadUserDict(const wxString& filename);
     bool SaveUserDict(const wxString& filename);
@@ -193,6 +255,14 @@ protected:
 
     partList m_parseValues; // list with position results for CPP parsing
 
+    mutable std::mutex m_spellMutex;                       // guards m_pSpell, used by the worker thread as well
+    mutable SpellCheckWordCache m_cache;                   // dictionary lookups cache
+    SpellCheckThread* m_thread;                            // continuous mode dictionary lookups
+    std::unordered_map<wxString, EditorState> m_editors;   // continuous mode, per file state
+    std::unordered_map<size_t, PendingCheck> m_pending;    // lookups in progress
+    size_t m_requestId;
+    wxString m_lastFile; // last file checked in continuous mode
+
     int m_scanners; // flags for scanner types
 };
 #endif // _HUNSPELLINTERFACE_
@@ -0,0 +1,28 @@
+#include "SpellCheckThread.h"
+
+#include "IHunSpell.h"
+#include "macros.h"
+
+SpellCheckThread::SpellCheckThread(IHunSpell* engine)
+    : m_engine(engine)
+{
+}
+
+SpellCheckThread::~SpellCheckThread() {}
+
+void SpellCheckThread::ProcessRequest(ThreadRequest* request)
+{
+    SpellCheckThreadRequest* req = dynamic_cast<SpellCheckThreadRequest*>(request);
+    CHECK_PTR_RET(req);
+
+    SpellCheckThreadReply reply;
+    reply.requestId = req->requestId;
+    reply.results.reserve(req->words.size());
+    for (const wxString& word : req->words) {
+        if (TestDestroy()) {
+            return;
+        }
+        reply.results.push_back({ word, m_engine->DictionaryLookup(word) });
+    }
+    m_engine->CallAfter(&IHunSpell::OnWordsChecked, reply);
+}
@@ -0,0 +1,35 @@
+#ifndef SPELLCHECKTHREAD_H
+#define SPELLCHECKTHREAD_H
+
+#include "worker_thread.h"
+
+#include <vector>
+#include <wx/string.h>
+
+class IHunSpell;
+
+struct SpellCheckThreadRequest : public ThreadRequest {
+    size_t requestId = 0;
+    std::vector<wxString> words;
+};
+
+struct SpellCheckThreadReply {
+    size_t requestId = 0;
+    std::vector<std::pair<wxString, bool>> results;
+};
+
+/**
+ * @brief runs the dictionary lookups of the continuous spell checker off the main thread.
+ * The results are delivered back to the engine with CallAfter()
+ */
+class SpellCheckThread : public WorkerThread
+{
+    IHunSpell* m_engine = nullptr;
+
+public:
+    SpellCheckThread(IHunSpell* engine);
+    ~SpellCheckThread() override;
+    void ProcessRequest(ThreadRequest* request) override;
+};
+
+#endif // SPELLCHECKTHREAD_H
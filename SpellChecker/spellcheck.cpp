@@ -112,6 +112,12 @@ SpellCheck::~SpellCheck()
     m_topWin->Unbind(wxEVT_CONTEXT_MENU_EDITOR, &SpellCheck::OnContextMenu, this);
     m_topWin->Unbind(wxEVT_WORKSPACE_LOADED, &SpellCheck::OnWspLoaded, this);
     m_topWin->Unbind(wxEVT_WORKSPACE_CLOSED, &SpellCheck::OnWspClosed, this);
+    m_topWin->Unbind(wxEVT_STC_MODIFIED, &SpellCheck::OnEditorModified, this);
+    EventNotifier::Get()->Unbind(wxEVT_ACTIVE_EDITOR_CHANGED, &SpellCheck::OnActiveEditorChanged, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_LOADED, &SpellCheck::OnFileLoaded, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_SAVED, &SpellCheck::OnFileSaved, this);
+    EventNotifier::Get()->Unbind(wxEVT_EDITOR_CLOSING, &SpellCheck::OnEditorClosing, this);
+    EventNotifier::Get()->Unbind(wxEVT_ALL_EDITORS_CLOSED, &SpellCheck::OnAllEditorsClosed, this);
 
     m_topWin->Unbind(wxEVT_MENU, &SpellCheck::OnSuggestion, this, SPC_SUGGESTION_ID,
                      SPC_SUGGESTION_ID + maxSuggestions - 1);
@@ -157,6 +163,12 @@ void SpellCheck::Init()
     m_topWin->Bind(wxEVT_CONTEXT_MENU_EDITOR, &SpellCheck::OnContextMenu, this);
     m_topWin->Bind(wxEVT_WORKSPACE_LOADED, &SpellCheck::OnWspLoaded, this);
     m_topWin->Bind(wxEVT_WORKSPACE_CLOSED, &SpellCheck::OnWspClosed, this);
+    m_topWin->Bind(wxEVT_STC_MODIFIED, &SpellCheck::OnEditorModified, this);
+    EventNotifier::Get()->Bind(wxEVT_ACTIVE_EDITOR_CHANGED, &SpellCheck::OnActiveEditorChanged, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_LOADED, &SpellCheck::OnFileLoaded, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_SAVED, &SpellCheck::OnFileSaved, this);
+    EventNotifier::Get()->Bind(wxEVT_EDITOR_CLOSING, &SpellCheck::OnEditorClosing, this);
+    EventNotifier::Get()->Bind(wxEVT_ALL_EDITORS_CLOSED, &SpellCheck::OnAllEditorsClosed, this);
 
     m_topWin->Bind(wxEVT_MENU, &SpellCheck::OnSuggestion, this, SPC_SUGGESTION_ID,
                    SPC_SUGGESTION_ID + maxSuggestions - 1);
@@ -373,10 +385,7 @@ void SpellCheck::OnContinuousCheck(wxCommandEvent& e)
     IEditor* editor = m_mgr->GetActiveEditor();
     CHECK_PTR_RET(editor);
 
-    m_pEngine->CheckSpelling();
-    if(!GetCheckContinuous()) {
-        editor->ClearUserIndicators();
-    }
+    m_pEngine->CheckSpellingIncremental(editor);
     m_timer.Start(PARSE_TIME);
 }
 
@@ -393,19 +402,93 @@ void SpellCheck::OnTimer(wxTimerEvent& e)
     CHECK_PTR_RET(editor);
     CHECK_COND_RET(GetCheckContinuous());
 
-    // Only run the checks if we've not run them or the file is modified.
-    const auto modificationCount(editor->GetModificationCount());
-    if(!m_forceCheck && ((editor == m_pLastEditor) && (m_lastModificationCount == modificationCount))) {
-        return;
+    if(m_forceCheck || m_pLastEditor == nullptr) {
+        // the word lists or the settings were changed, re-check the editor
+        m_pEngine->ResetIncrementalState(editor->GetFileName().GetFullPath());
     }
 
+    // Only the modified lines within the visible area are checked
     m_pLastEditor = editor;
-    m_lastModificationCount = modificationCount;
-    m_pLastEditor->ClearUserIndicators();
-    m_pEngine->CheckSpelling();
+    m_pEngine->CheckSpellingIncremental(editor);
     m_forceCheck = false; // consume it
 }
 
+// ------------------------------------------------------------
+void SpellCheck::OnEditorModified(wxStyledTextEvent& e)
+{
+    e.Skip();
+    CHECK_PTR_RET(m_pEngine);
+    CHECK_COND_RET(GetCheckContinuous());
+
+    int type = e.GetModificationType();
+    if(!(type & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT))) {
+        return;
+    }
+
+    wxStyledTextCtrl* ctrl = dynamic_cast<wxStyledTextCtrl*>(e.GetEventObject());
+    CHECK_PTR_RET(ctrl);
+
+    auto iter = m_editorCtrls.find(ctrl);
+    if(iter == m_editorCtrls.end()) {
+        // not an editor (e.g. an output pane)
+        return;
+    }
+
+    IEditor* editor = m_mgr->GetActiveEditor();
+    if(!editor || editor->GetCtrl() != ctrl) {
+        // not the active editor: re-check it from scratch once it is activated
+        m_pEngine->ResetIncrementalState(iter->second);
+        return;
+    }
+    m_pEngine->EditorModified(editor->GetFileName().GetFullPath(), ctrl->LineFromPosition(e.GetPosition()),
+                              e.GetLinesAdded());
+}
+// ------------------------------------------------------------
+void SpellCheck::OnActiveEditorChanged(wxCommandEvent& e)
+{
+    e.Skip();
+    DoUpdateEditorCtrls();
+}
+// ------------------------------------------------------------
+void SpellCheck::OnFileLoaded(clCommandEvent& e)
+{
+    e.Skip();
+    // the editor might have been opened in the background
+    DoUpdateEditorCtrls();
+}
+// ------------------------------------------------------------
+void SpellCheck::OnFileSaved(clCommandEvent& e)
+{
+    e.Skip();
+    // "save as" changes the file of the editor
+    DoUpdateEditorCtrls();
+}
+// ------------------------------------------------------------
+void SpellCheck::OnEditorClosing(wxCommandEvent& e)
+{
+    e.Skip();
+    IEditor* editor = reinterpret_cast<IEditor*>(e.GetClientData());
+    CHECK_PTR_RET(editor);
+    m_editorCtrls.erase(editor->GetCtrl());
+}
+// ------------------------------------------------------------
+void SpellCheck::OnAllEditorsClosed(wxCommandEvent& e)
+{
+    e.Skip();
+    m_editorCtrls.clear();
+}
+// ------------------------------------------------------------
+void SpellCheck::DoUpdateEditorCtrls()
+{
+    IEditor::List_t editors;
+    m_mgr->GetAllEditors(editors);
+
+    m_editorCtrls.clear();
+    for(IEditor* editor : editors) {
+        m_editorCtrls.insert({ editor->GetCtrl(), editor->GetFileName().GetFullPath() });
+    }
+}
+
 // ------------------------------------------------------------
 void SpellCheck::SetCheckContinuous(bool value)
 {
@@ -424,6 +507,9 @@ void SpellCheck::SetCheckContinuous(bool value)
         if(m_timer.IsRunning()) {
             m_timer.Stop();
         }
+        if(m_pEngine) {
+            m_pEngine->ResetIncrementalState();
+        }
         if(btn) {
             btn->Check(false);
             clGetManager()->GetToolBar()->Refresh();
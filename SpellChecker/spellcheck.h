@@ -40,6 +40,8 @@
 #include "plugin.h"
 #include "spellcheckeroptions.h"
 
+#include <unordered_map>
+#include <wx/stc/stc.h>
 #include <wx/timer.h>
 //------------------------------------------------------------
 class IHunSpell;
@@ -71,6 +73,12 @@ public:
     void OnSuggestion(wxCommandEvent& e);
     void OnIgnoreWord(wxCommandEvent& e);
     void OnAddWord(wxCommandEvent& e);
+    void OnEditorModified(wxStyledTextEvent& e);
+    void OnActiveEditorChanged(wxCommandEvent& e);
+    void OnFileLoaded(clCommandEvent& e);
+    void OnFileSaved(clCommandEvent& e);
+    void OnEditorClosing(wxCommandEvent& e);
+    void OnAllEditorsClosed(wxCommandEvent& e);
 
     wxMenuItem* m_sepItem;
     wxEvtHandler* m_topWin;
@@ -84,15 +92,17 @@ protected:
     void ClearIndicatorsFromEditors();
     void OnContextMenu(clContextMenuEvent& e);
     void AppendSubMenuItems(wxMenu& subMenu);
+    void DoUpdateEditorCtrls();
 
 protected:
     IHunSpell* m_pEngine;
     wxTimer m_timer;
     wxString m_currentWspPath;
 
-    IEditor* m_pLastEditor;           // The editor checked last time the spell check ran.
-    wxUint64 m_lastModificationCount; // Modification count of the editor last time the spell check ran.
-    bool m_forceCheck = false;        // Force re-check if user added or ignored a word to the list
+    IEditor* m_pLastEditor;    // The editor checked last time the spell check ran.
+    bool m_forceCheck = false; // Force re-check if user added or ignored a word to the list
+    // the controls of the open editors and their files: wxEVT_STC_MODIFIED is received from every wxStyledTextCtrl
+    std::unordered_map<wxStyledTextCtrl*, wxString> m_editorCtrls;
 };
 //------------------------------------------------------------
 #endif // SpellCheck
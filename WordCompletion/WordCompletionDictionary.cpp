@@ -1,10 +1,12 @@
 #include "WordCompletionDictionary.h"
+#include "WordCompletionSettings.h"
 #include "event_notifier.h"
 #include "codelite_events.h"
 #include <algorithm>
 #include "globals.h"
 #include "ieditor.h"
 #include "imanager.h"
+#include <wx/app.h>
 #include <wx/stc/stc.h>
 
 WordCompletionDictionary::WordCompletionDictionary()
@@ -12,6 +14,12 @@ WordCompletionDictionary::WordCompletionDictionary()
     EventNotifier::Get()->Bind(wxEVT_ACTIVE_EDITOR_CHANGED, &WordCompletionDictionary::OnEditorChanged, this);
     EventNotifier::Get()->Bind(wxEVT_ALL_EDITORS_CLOSED, &WordCompletionDictionary::OnAllEditorsClosed, this);
     EventNotifier::Get()->Bind(wxEVT_FILE_SAVED, &WordCompletionDictionary::OnFileSaved, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_LOADED, &WordCompletionDictionary::OnFileLoaded, this);
+    EventNotifier::Get()->Bind(wxEVT_EDITOR_CLOSING, &WordCompletionDictionary::OnEditorClosing, this);
+
+    // editor modifications propagate up to the application object (clEditor skips them)
+    wxTheApp->Bind(wxEVT_STC_MODIFIED, &WordCompletionDictionary::OnEditorModified, this);
+    ReloadSettings();
 
     m_thread = new WordCompletionThread(this);
     m_thread->Start();
@@ -22,64 +30,112 @@ WordCompletionDictionary::~WordCompletionDictionary()
     EventNotifier::Get()->Unbind(wxEVT_ACTIVE_EDITOR_CHANGED, &WordCompletionDictionary::OnEditorChanged, this);
     EventNotifier::Get()->Unbind(wxEVT_ALL_EDITORS_CLOSED, &WordCompletionDictionary::OnAllEditorsClosed, this);
     EventNotifier::Get()->Unbind(wxEVT_FILE_SAVED, &WordCompletionDictionary::OnFileSaved, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_LOADED, &WordCompletionDictionary::OnFileLoaded, this);
+    EventNotifier::Get()->Unbind(wxEVT_EDITOR_CLOSING, &WordCompletionDictionary::OnEditorClosing, this);
+    wxTheApp->Unbind(wxEVT_STC_MODIFIED, &WordCompletionDictionary::OnEditorModified, this);
 
     m_thread->Stop();   // Stop the thread
     wxDELETE(m_thread); // Delete it
 }
 
+void WordCompletionDictionary::ReloadSettings()
+{
+    WordCompletionSettings settings;
+    settings.Load();
+    m_keepClosedFiles = settings.IsKeepClosedFiles();
+    m_index.SetMemoryBudget(settings.GetMemoryBudgetMB() * 1024 * 1024);
+}
+
 void WordCompletionDictionary::OnEditorChanged(wxCommandEvent& event)
 {
     event.Skip();
 
-    // 1) Get a list of all open editors and set the compare it to the current cached files
-    //    and delete all "closed" editors
+    // 1) Get a list of all open editors and compare it to the files we know are open.
+    //    Closed editors are kept in the index as "recently used" files (within the memory budget)
     // 2) Request to cache the newly opened file's words
     IEditor::List_t allEditors;
-    wxArrayString openEditors, cachedEditors, closedEditors;
+    wxStringSet_t openEditors;
     ::clGetManager()->GetAllEditors(allEditors);
 
     for (IEditor* editor : allEditors) {
-        openEditors.Add(editor->GetFileName().GetFullPath());
+        openEditors.insert(editor->GetFileName().GetFullPath());
     }
 
-    for (const auto& p : m_files) {
-        cachedEditors.Add(p.first);
+    for (auto iter = m_openFiles.begin(); iter != m_openFiles.end();) {
+        if (openEditors.count(*iter) == 0) {
+            m_index.SetFileClosed(*iter, m_keepClosedFiles);
+            m_pending.erase(*iter);
+            m_modifiedWhilePending.erase(*iter);
+            iter = m_openFiles.erase(iter);
+        } else {
+            ++iter;
+        }
     }
 
-    // std::set_difference requires that both arrays will be sorted
-    openEditors.Sort();
-    cachedEditors.Sort();
+    // 2: cache the active editor
+    DoUpdateEditorCtrls();
+    DoCacheActiveEditor(false);
+}
 
-    // Create a new array "closedEditors" which contains list of files that exists
-    // in the cachedEditors but not in openEditors list
-    std::set_difference(cachedEditors.begin(),
-                        cachedEditors.end(),
-                        openEditors.begin(),
-                        openEditors.end(),
-                        std::back_inserter(closedEditors));
+void WordCompletionDictionary::OnFileLoaded(clCommandEvent& event)
+{
+    event.Skip();
+    // the editor might have been opened in the background
+    DoUpdateEditorCtrls();
+}
 
-    for(size_t i = 0; i < closedEditors.size(); ++i) {
-        m_files.erase(closedEditors.Item(i));
-    }
+void WordCompletionDictionary::OnEditorClosing(wxCommandEvent& event)
+{
+    event.Skip();
+    IEditor* editor = reinterpret_cast<IEditor*>(event.GetClientData());
+    CHECK_PTR_RET(editor);
+    m_editorCtrls.erase(editor->GetCtrl());
+}
 
-    // 2: cache the active editor
-    DoCacheActiveEditor(false);
+void WordCompletionDictionary::DoUpdateEditorCtrls()
+{
+    IEditor::List_t allEditors;
+    ::clGetManager()->GetAllEditors(allEditors);
+
+    m_editorCtrls.clear();
+    for (IEditor* editor : allEditors) {
+        m_editorCtrls.insert({ editor->GetCtrl(), editor->GetFileName().GetFullPath() });
+    }
 }
 
 void WordCompletionDictionary::OnSuggestThread(const WordCompletionThreadReply& reply)
 {
-    // Remove the current file's dictionary
-    std::map<wxString, wxStringSet_t>::iterator iter = m_files.find(reply.filename.GetFullPath());
-    if(iter != m_files.end()) m_files.erase(iter);
+    wxString filename = reply.filename.GetFullPath();
+    auto iter = m_pending.find(filename);
+    if (iter == m_pending.end() || iter->second != reply.generation) {
+        // the file was closed or a newer request is on its way
+        return;
+    }
+    m_pending.erase(iter);
 
-    // Keep the words
-    m_files.insert(std::make_pair(reply.filename.GetFullPath(), reply.suggest));
+    if (m_modifiedWhilePending.count(filename)) {
+        // the buffer we parsed is outdated, parse the current content
+        m_modifiedWhilePending.erase(filename);
+        IEditor* editor = ::clGetManager()->FindEditor(filename);
+        if (editor) {
+            DoQueueEditor(editor);
+        }
+        return;
+    }
+
+    m_index.SetFile(filename, reply.lines);
 }
 
 void WordCompletionDictionary::OnAllEditorsClosed(wxCommandEvent& event)
 {
     event.Skip();
-    m_files.clear();
+    for (const wxString& filename : m_openFiles) {
+        m_index.SetFileClosed(filename, m_keepClosedFiles);
+    }
+    m_openFiles.clear();
+    m_pending.clear();
+    m_modifiedWhilePending.clear();
+    m_editorCtrls.clear();
 }
 
 void WordCompletionDictionary::DoCacheActiveEditor(bool overwrite)
@@ -88,36 +144,119 @@ void WordCompletionDictionary::DoCacheActiveEditor(bool overwrite)
     IEditor* activeEditor = ::clGetManager()->GetActiveEditor();
     CHECK_PTR_RET(activeEditor);
 
-    if(!overwrite && m_files.count(activeEditor->GetFileName().GetFullPath()))
-        return; // we already have this file in the cache
-        
-    m_files.erase(activeEditor->GetFileName().GetFullPath());
-    
-    // Insert a dummy entry, so we won't queue this file if not needed
-    m_files.insert(std::make_pair(activeEditor->GetFileName().GetFullPath(), wxStringSet_t()));
-    
-    // Queue this file
-    wxStyledTextCtrl* stc = activeEditor->GetCtrl();
-    
-    // Invoke the thread to parse and suggest words for this file
+    wxString filename = activeEditor->GetFileName().GetFullPath();
+    m_openFiles.insert(filename);
+    if (m_pending.count(filename)) {
+        return; // already queued
+    }
+
+    if (!overwrite && m_index.HasFile(filename)) {
+        // we already have this file in the index
+        m_index.Touch(filename);
+        return;
+    }
+    DoQueueEditor(activeEditor);
+}
+
+void WordCompletionDictionary::DoQueueEditor(IEditor* editor)
+{
+    wxString filename = editor->GetFileName().GetFullPath();
+    size_t generation = ++m_generation;
+    m_pending[filename] = generation;
+
+    // Invoke the thread to parse and index the words of this file
     WordCompletionThreadRequest* req = new WordCompletionThreadRequest;
-    req->buffer = stc->GetText();
-    req->filename = activeEditor->GetFileName();
+    req->buffer = editor->GetCtrl()->GetText();
+    req->filename = editor->GetFileName();
     req->filter = "filter";
+    req->generation = generation;
     m_thread->Add(req);
 }
 
 void WordCompletionDictionary::OnFileSaved(clCommandEvent& event)
 {
     event.Skip();
-    DoCacheActiveEditor(true);
+    // the index is kept up to date while editing, only refresh the lines that were changed
+    IEditor* activeEditor = ::clGetManager()->GetActiveEditor();
+    CHECK_PTR_RET(activeEditor);
+    UpdateDirtyLines(activeEditor);
+
+    // "save as" changes the file of the editor
+    DoUpdateEditorCtrls();
+}
+
+void WordCompletionDictionary::OnEditorModified(wxStyledTextEvent& event)
+{
+    event.Skip();
+
+    int type = event.GetModificationType();
+    if (!(type & (wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT))) {
+        return;
+    }
+
+    wxStyledTextCtrl* ctrl = dynamic_cast<wxStyledTextCtrl*>(event.GetEventObject());
+    CHECK_PTR_RET(ctrl);
+
+    auto iter = m_editorCtrls.find(ctrl);
+    if (iter == m_editorCtrls.end()) {
+        // not an editor (e.g. an output pane)
+        return;
+    }
+
+    IEditor* editor = ::clGetManager()->GetActiveEditor();
+    if (!editor || editor->GetCtrl() != ctrl) {
+        // a background editor was modified (e.g. replace in files), drop it and re-index it once it is activated
+        const wxString& filename = iter->second;
+        m_index.RemoveFile(filename);
+        m_pending.erase(filename);
+        m_modifiedWhilePending.erase(filename);
+        return;
+    }
+
+    wxString filename = editor->GetFileName().GetFullPath();
+    if (m_pending.count(filename)) {
+        m_modifiedWhilePending.insert(filename);
+        return;
+    }
+
+    int line = ctrl->LineFromPosition(event.GetPosition());
+    int linesAdded = event.GetLinesAdded();
+    if (type & wxSTC_MOD_INSERTTEXT) {
+        m_index.LinesInserted(filename, line, linesAdded);
+    } else {
+        m_index.LinesDeleted(filename, line, -linesAdded);
+    }
+}
+
+void WordCompletionDictionary::UpdateDirtyLines(IEditor* editor)
+{
+    CHECK_PTR_RET(editor);
+    wxString filename = editor->GetFileName().GetFullPath();
+
+    std::vector<int> lines;
+    if (!m_index.GetDirtyLines(filename, lines)) {
+        return;
+    }
+
+    // lex all the dirty lines at once, each line is terminated with its own "\n"
+    wxStyledTextCtrl* stc = editor->GetCtrl();
+    wxString buffer;
+    for (int line : lines) {
+        wxString text = stc->GetLine(line);
+        text.Trim().Trim(false);
+        buffer << text << "\n";
+    }
+
+    WordCompletionIndex::Lines_t words;
+    WordCompletionThread::ParseLines(buffer, words);
+    m_index.UpdateLines(filename, lines, words);
 }
 
-wxStringSet_t WordCompletionDictionary::GetWords() const
+void WordCompletionDictionary::FindWords(const wxString& filter, int comparisonMethod, wxStringSet_t& words) const
 {
-    wxStringSet_t words;
-    for (const auto& p : m_files) {
-        words.insert(p.second.begin(), p.second.end());
+    if (comparisonMethod == WordCompletionSettings::kComparisonStartsWith) {
+        m_index.FindByPrefix(filter, words);
+    } else {
+        m_index.FindContains(filter, words);
     }
-    return words;
 }
@@ -29,22 +29,41 @@
 #include "macros.h"
 #include <wx/string.h>
 #include <wx/event.h>
+#include "WordCompletionIndex.h"
 #include "WordCompletionThread.h"
 #include "WordCompletionRequestReply.h"
 #include "cl_command_event.h"
+#include <unordered_map>
+#include <wx/stc/stc.h>
 
+class IEditor;
 class WordCompletionDictionary : public wxEvtHandler
 {
-    std::map<wxString, wxStringSet_t> m_files;
+    WordCompletionIndex m_index;
     WordCompletionThread* m_thread;
+    wxStringSet_t m_openFiles;
+    // files queued for parsing and the generation of their latest request
+    std::unordered_map<wxString, size_t> m_pending;
+    // files that were modified while their parse request was in flight
+    wxStringSet_t m_modifiedWhilePending;
+    size_t m_generation = 0;
+    bool m_keepClosedFiles = true;
+    // the controls of the open editors and their files. wxEVT_STC_MODIFIED is received from every wxStyledTextCtrl
+    // in the application, this lets us ignore the other controls without searching the editors
+    std::unordered_map<wxStyledTextCtrl*, wxString> m_editorCtrls;
 
 protected:
     void OnEditorChanged(wxCommandEvent& event);
     void OnAllEditorsClosed(wxCommandEvent& event);
     void OnFileSaved(clCommandEvent& event);
+    void OnFileLoaded(clCommandEvent& event);
+    void OnEditorClosing(wxCommandEvent& event);
+    void OnEditorModified(wxStyledTextEvent& event);
 
 private:
+    void DoUpdateEditorCtrls();
     void DoCacheActiveEditor(bool overwrite);
+    void DoQueueEditor(IEditor* editor);
 
 public:
     WordCompletionDictionary();
@@ -57,9 +76,19 @@ public:
     void OnSuggestThread(const WordCompletionThreadReply& reply);
     
     /**
-     * @brief return a set of words from the current editors
+     * @brief apply the settings (memory budget, keeping closed files)
      */
-    wxStringSet_t GetWords() const;
+    void ReloadSettings();
+
+    /**
+     * @brief re-parse the lines of `editor` that were modified since they were last indexed
+     */
+    void UpdateDirtyLines(IEditor* editor);
+
+    /**
+     * @brief collect the words matching `filter` using the comparison method (WordCompletionSettings::kComparison*)
+     */
+    void FindWords(const wxString& filter, int comparisonMethod, wxStringSet_t& words) const;
 };
 
 #endif // WORDCOMPLETIONDICTIONARY_H
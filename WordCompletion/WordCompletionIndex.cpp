@@ -0,0 +1,355 @@
+#include "WordCompletionIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+// rough per-word overhead: the node in m_ids, the node in m_prefixIndex and the entry in m_words
+constexpr size_t WORD_OVERHEAD = 128;
+} // namespace
+
+WordCompletionIndex::WordCompletionIndex(size_t memoryBudget)
+    : m_memoryBudget(memoryBudget)
+{
+}
+
+WordCompletionIndex::~WordCompletionIndex() {}
+
+void WordCompletionIndex::SetMemoryBudget(size_t bytes)
+{
+    m_memoryBudget = bytes;
+    EnforceBudget();
+}
+
+WordCompletionIndex::WordId_t WordCompletionIndex::AddRef(const wxString& word)
+{
+    auto iter = m_ids.find(word);
+    if (iter != m_ids.end()) {
+        m_words[iter->second].refcount++;
+        return iter->second;
+    }
+
+    WordId_t id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = m_words.size();
+        m_words.emplace_back();
+    }
+
+    Word& w = m_words[id];
+    w.text = word;
+    w.refcount = 1;
+    m_ids.insert({ word, id });
+    m_prefixIndex.insert({ word.Lower(), id });
+    m_textBytes += word.length() * sizeof(wxChar) * 3;
+    return id;
+}
+
+void WordCompletionIndex::Release(WordId_t id)
+{
+    Word& w = m_words[id];
+    if (w.refcount == 0) {
+        return;
+    }
+
+    w.refcount--;
+    if (w.refcount > 0) {
+        return;
+    }
+
+    // last reference, remove the word
+    m_prefixIndex.erase({ w.text.Lower(), id });
+    m_ids.erase(w.text);
+    m_textBytes -= w.text.length() * sizeof(wxChar) * 3;
+    w.text.clear();
+    m_freeIds.push_back(id);
+}
+
+void WordCompletionIndex::SetLineWords(Line& line, const LineWords_t& words)
+{
+    // add the new references before releasing the old ones, so words that appear in both
+    // are not removed and re-interned
+    std::vector<WordId_t> ids;
+    ids.reserve(words.size());
+    for (const auto& word : words) {
+        ids.push_back(AddRef(word));
+    }
+
+    ReleaseLine(line);
+    m_idsCount += ids.size();
+    line.words.swap(ids);
+    line.dirty = false;
+}
+
+void WordCompletionIndex::ReleaseLine(Line& line)
+{
+    for (WordId_t id : line.words) {
+        Release(id);
+    }
+    m_idsCount -= line.words.size();
+    line.words.clear();
+}
+
+void WordCompletionIndex::ReleaseFile(File& file)
+{
+    for (auto& line : file.lines) {
+        ReleaseLine(line);
+    }
+    m_linesCount -= file.lines.size();
+    file.lines.clear();
+}
+
+void WordCompletionIndex::SetFile(const wxString& filename, const Lines_t& lines)
+{
+    File& file = m_files[filename];
+    std::vector<Line> old_lines;
+    old_lines.swap(file.lines);
+
+    file.lines.resize(lines.size());
+    for (size_t i = 0; i < lines.size(); ++i) {
+        SetLineWords(file.lines[i], lines[i]);
+    }
+    m_linesCount += file.lines.size();
+
+    // release the previous content only now, so common words are not re-interned
+    for (auto& line : old_lines) {
+        ReleaseLine(line);
+    }
+    m_linesCount -= old_lines.size();
+
+    file.first_dirty = wxNOT_FOUND;
+    file.last_dirty = wxNOT_FOUND;
+    file.is_open = true;
+    file.last_used = ++m_clock;
+    EnforceBudget();
+}
+
+void WordCompletionIndex::RemoveFile(const wxString& filename)
+{
+    auto iter = m_files.find(filename);
+    if (iter == m_files.end()) {
+        return;
+    }
+    ReleaseFile(iter->second);
+    m_files.erase(iter);
+}
+
+void WordCompletionIndex::SetFileClosed(const wxString& filename, bool keep)
+{
+    if (!keep) {
+        RemoveFile(filename);
+        return;
+    }
+
+    auto iter = m_files.find(filename);
+    if (iter == m_files.end()) {
+        return;
+    }
+
+    File& file = iter->second;
+    file.is_open = false;
+    if (file.first_dirty != wxNOT_FOUND) {
+        // we can no longer refresh the dirty lines, drop the file
+        RemoveFile(filename);
+        return;
+    }
+    EnforceBudget();
+}
+
+void WordCompletionIndex::Touch(const wxString& filename)
+{
+    auto iter = m_files.find(filename);
+    if (iter == m_files.end()) {
+        return;
+    }
+    iter->second.is_open = true;
+    iter->second.last_used = ++m_clock;
+}
+
+void WordCompletionIndex::Clear()
+{
+    m_words.clear();
+    m_freeIds.clear();
+    m_ids.clear();
+    m_prefixIndex.clear();
+    m_files.clear();
+    m_idsCount = 0;
+    m_linesCount = 0;
+    m_textBytes = 0;
+}
+
+void WordCompletionIndex::MarkDirty(File& file, int from, int to)
+{
+    if (file.lines.empty()) {
+        return;
+    }
+
+    from = std::clamp(from, 0, (int)file.lines.size() - 1);
+    to = std::clamp(to, 0, (int)file.lines.size() - 1);
+    for (int i = from; i <= to; ++i) {
+        file.lines[i].dirty = true;
+    }
+
+    if (file.first_dirty == wxNOT_FOUND) {
+        file.first_dirty = from;
+        file.last_dirty = to;
+    } else {
+        file.first_dirty = std::min(file.first_dirty, from);
+        file.last_dirty = std::max(file.last_dirty, to);
+    }
+}
+
+void WordCompletionIndex::LinesInserted(const wxString& filename, int line, int count)
+{
+    auto iter = m_files.find(filename);
+    if (iter == m_files.end()) {
+        return;
+    }
+
+    File& file = iter->second;
+    if (file.lines.empty()) {
+        file.lines.resize(1);
+        m_linesCount++;
+    }
+
+    line = std::clamp(line, 0, (int)file.lines.size() - 1);
+    if (count > 0) {
+        file.lines.insert(file.lines.begin() + line + 1, count, Line());
+        m_linesCount += count;
+
+        // shift the dirty range
+        if (file.first_dirty > line) {
+            file.first_dirty += count;
+        }
+        if (file.last_dirty > line) {
+            file.last_dirty += count;
+        }
+    }
+    MarkDirty(file, line, line + std::max(count, 0));
+}
+
+void WordCompletionIndex::LinesDeleted(const wxString& filename, int line, int count)
+{
+    auto iter = m_files.find(filename);
+    if (iter == m_files.end()) {
+        return;
+    }
+
+    File& file = iter->second;
+    if (file.lines.empty()) {
+        return;
+    }
+
+    line = std::clamp(line, 0, (int)file.lines.size() - 1);
+    count = std::clamp(count, 0, (int)file.lines.size() - line - 1);
+    if (count > 0) {
+        auto first = file.lines.begin() + line + 1;
+        auto last = first + count;
+        for (auto it = first; it != last; ++it) {
+            ReleaseLine(*it);
+        }
+        file.lines.erase(first, last);
+        m_linesCount -= count;
+
+        // shift the dirty range, lines that were removed collapse into `line`
+        auto shift = [line, count](int& n) {
+            if (n == wxNOT_FOUND || n <= line) {
+                return;
+            }
+            n = n > line + count ? n - count : line;
+        };
+        shift(file.first_dirty);
+        shift(file.last_dirty);
+    }
+    MarkDirty(file, line, line);
+}
+
+bool WordCompletionIndex::GetDirtyLines(const wxString& filename, std::vector<int>& lines) const
+{
+    lines.clear();
+    auto iter = m_files.find(filename);
+    if (iter == m_files.end() || iter->second.first_dirty == wxNOT_FOUND) {
+        return false;
+    }
+
+    const File& file = iter->second;
+    int last = std::min(file.last_dirty, (int)file.lines.size() - 1);
+    for (int i = file.first_dirty; i <= last; ++i) {
+        if (file.lines[i].dirty) {
+            lines.push_back(i);
+        }
+    }
+    return !lines.empty();
+}
+
+void WordCompletionIndex::UpdateLines(const wxString& filename, const std::vector<int>& lines, const Lines_t& words)
+{
+    auto iter = m_files.find(filename);
+    if (iter == m_files.end()) {
+        return;
+    }
+
+    File& file = iter->second;
+    for (size_t i = 0; i < lines.size() && i < words.size(); ++i) {
+        int line = lines[i];
+        if (line < 0 || line >= (int)file.lines.size()) {
+            continue;
+        }
+        SetLineWords(file.lines[line], words[i]);
+    }
+    file.first_dirty = wxNOT_FOUND;
+    file.last_dirty = wxNOT_FOUND;
+    file.last_used = ++m_clock;
+}
+
+void WordCompletionIndex::FindByPrefix(const wxString& prefix, wxStringSet_t& words) const
+{
+    wxString lcPrefix = prefix.Lower();
+    for (auto iter = m_prefixIndex.lower_bound({ lcPrefix, 0 }); iter != m_prefixIndex.end(); ++iter) {
+        if (!iter->first.StartsWith(lcPrefix)) {
+            break;
+        }
+        words.insert(m_words[iter->second].text);
+    }
+}
+
+void WordCompletionIndex::FindContains(const wxString& str, wxStringSet_t& words) const
+{
+    wxString lcStr = str.Lower();
+    for (const auto& p : m_prefixIndex) {
+        if (lcStr.empty() || p.first.Contains(lcStr)) {
+            words.insert(m_words[p.second].text);
+        }
+    }
+}
+
+size_t WordCompletionIndex::GetMemoryUsage() const
+{
+    return m_textBytes + (m_prefixIndex.size() * WORD_OVERHEAD) + (m_idsCount * sizeof(WordId_t)) +
+           (m_linesCount * sizeof(Line));
+}
+
+void WordCompletionIndex::EnforceBudget()
+{
+    while (GetMemoryUsage() > m_memoryBudget) {
+        // evict the least recently used closed file
+        auto victim = m_files.end();
+        for (auto iter = m_files.begin(); iter != m_files.end(); ++iter) {
+            if (iter->second.is_open) {
+                continue;
+            }
+            if (victim == m_files.end() || iter->second.last_used < victim->second.last_used) {
+                victim = iter;
+            }
+        }
+
+        if (victim == m_files.end()) {
+            // only open files left
+            break;
+        }
+        ReleaseFile(victim->second);
+        m_files.erase(victim);
+    }
+}
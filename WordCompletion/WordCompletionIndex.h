@@ -0,0 +1,138 @@
+#ifndef WORDCOMPLETIONINDEX_H
+#define WORDCOMPLETIONINDEX_H
+
+#include "macros.h"
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief a shared word index for all the files known to the word completion plugin.
+ * Every unique word is interned once and reference counted. Files only keep the ids of their words, line by line, so
+ * an edit only touches the lines it modified. A lower-case ordered set of all the words answers prefix queries with a
+ * single lower_bound() followed by a scan of the matches
+ */
+class WordCompletionIndex
+{
+public:
+    typedef uint32_t WordId_t;
+    typedef std::vector<wxString> LineWords_t;
+    typedef std::vector<LineWords_t> Lines_t;
+
+protected:
+    struct Word {
+        wxString text;
+        size_t refcount = 0;
+    };
+
+    struct Line {
+        std::vector<WordId_t> words;
+        bool dirty = false;
+    };
+
+    struct File {
+        std::vector<Line> lines;
+        int first_dirty = wxNOT_FOUND;
+        int last_dirty = wxNOT_FOUND;
+        uint64_t last_used = 0;
+        bool is_open = true;
+    };
+
+    std::vector<Word> m_words;
+    std::vector<WordId_t> m_freeIds;
+    std::unordered_map<wxString, WordId_t> m_ids;
+    std::set<std::pair<wxString, WordId_t>> m_prefixIndex;
+    std::unordered_map<wxString, File> m_files;
+    uint64_t m_clock = 0;
+    size_t m_idsCount = 0;
+    size_t m_linesCount = 0;
+    size_t m_textBytes = 0;
+    size_t m_memoryBudget = 0;
+
+protected:
+    WordId_t AddRef(const wxString& word);
+    void Release(WordId_t id);
+    void SetLineWords(Line& line, const LineWords_t& words);
+    void ReleaseLine(Line& line);
+    void ReleaseFile(File& file);
+    void MarkDirty(File& file, int from, int to);
+    void EnforceBudget();
+
+public:
+    WordCompletionIndex(size_t memoryBudget = 32 * 1024 * 1024);
+    ~WordCompletionIndex();
+
+    /**
+     * @brief set the memory budget (in bytes). When exceeded, closed files are evicted from the index, least recently
+     * used first. Open files are never evicted
+     */
+    void SetMemoryBudget(size_t bytes);
+
+    /**
+     * @brief replace the content of a file with the given lines
+     */
+    void SetFile(const wxString& filename, const Lines_t& lines);
+
+    /**
+     * @brief remove a file (and its words) from the index
+     */
+    void RemoveFile(const wxString& filename);
+
+    /**
+     * @brief the file was closed. Its words are kept (as a recently used file) as long as the memory budget allows it
+     * @param keep when false, the file is removed from the index
+     */
+    void SetFileClosed(const wxString& filename, bool keep);
+
+    /**
+     * @brief mark the file as open and recently used
+     */
+    void Touch(const wxString& filename);
+    bool HasFile(const wxString& filename) const { return m_files.count(filename) > 0; }
+    void Clear();
+
+    /**
+     * @brief `count` lines were inserted after `line`. `line` and the new lines are marked as dirty
+     */
+    void LinesInserted(const wxString& filename, int line, int count);
+
+    /**
+     * @brief the `count` lines following `line` were joined into `line`. `line` is marked as dirty
+     */
+    void LinesDeleted(const wxString& filename, int line, int count);
+
+    /**
+     * @brief return the dirty lines of a file, sorted
+     */
+    bool GetDirtyLines(const wxString& filename, std::vector<int>& lines) const;
+
+    /**
+     * @brief update the words of the given lines and clear the dirty state of the file
+     */
+    void UpdateLines(const wxString& filename, const std::vector<int>& lines, const Lines_t& words);
+
+    /**
+     * @brief collect all the words that start with `prefix` (case insensitive)
+     */
+    void FindByPrefix(const wxString& prefix, wxStringSet_t& words) const;
+
+    /**
+     * @brief collect all the words that contain `str` (case insensitive)
+     */
+    void FindContains(const wxString& str, wxStringSet_t& words) const;
+
+    /**
+     * @brief return the number of unique words
+     */
+    size_t GetWordsCount() const { return m_prefixIndex.size(); }
+
+    /**
+     * @brief return an estimate of the memory used by the index, in bytes
+     */
+    size_t GetMemoryUsage() const;
+};
+
+#endif // WORDCOMPLETIONINDEX_H
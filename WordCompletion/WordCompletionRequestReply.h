@@ -26,6 +26,7 @@
 #ifndef WordCompletionRequestReply_H__
 #define WordCompletionRequestReply_H__
 
+#include "WordCompletionIndex.h"
 #include "worker_thread.h"
 
 struct WordCompletionThreadRequest : public ThreadRequest {
@@ -33,13 +34,15 @@ struct WordCompletionThreadRequest : public ThreadRequest {
     wxString filter;
     wxFileName filename;
     bool insertSingleMatch;
+    size_t generation = 0;
 };
 
 struct WordCompletionThreadReply {
-    wxStringSet_t suggest;
+    WordCompletionIndex::Lines_t lines;
     wxFileName filename;
     wxString filter;
     bool insertSingleMatch;
+    size_t generation = 0;
 };
 
 #endif
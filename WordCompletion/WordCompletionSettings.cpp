@@ -4,6 +4,8 @@ WordCompletionSettings::WordCompletionSettings()
     : clConfigItem("WordCompletionSettings")
     , m_comparisonMethod(kComparisonStartsWith)
     , m_enabled(true)
+    , m_keepClosedFiles(true)
+    , m_memoryBudgetMB(32)
 {
 }
 
@@ -13,6 +15,8 @@ void WordCompletionSettings::FromJSON(const JSONItem& json)
 {
     m_comparisonMethod = json.namedObject("m_comparisonMethod").toInt(m_comparisonMethod);
     m_enabled = json.namedObject("m_enabled").toBool(m_enabled);
+    m_keepClosedFiles = json.namedObject("m_keepClosedFiles").toBool(m_keepClosedFiles);
+    m_memoryBudgetMB = json.namedObject("m_memoryBudgetMB").toSize_t(m_memoryBudgetMB);
 }
 
 JSONItem WordCompletionSettings::ToJSON() const
@@ -20,6 +24,8 @@ JSONItem WordCompletionSettings::ToJSON() const
     JSONItem element = JSONItem::createObject(GetName());
     element.addProperty("m_comparisonMethod", m_comparisonMethod);
     element.addProperty("m_enabled", m_enabled);
+    element.addProperty("m_keepClosedFiles", m_keepClosedFiles);
+    element.addProperty("m_memoryBudgetMB", m_memoryBudgetMB);
     return element;
 }
 
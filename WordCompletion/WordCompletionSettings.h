@@ -39,6 +39,8 @@ public:
 private:
     int m_comparisonMethod;
     bool m_enabled;
+    bool m_keepClosedFiles;
+    size_t m_memoryBudgetMB;
 
 public:
     WordCompletionSettings();
@@ -53,6 +55,12 @@ public:
 
     void SetEnabled(bool enabled) { this->m_enabled = enabled; }
     bool IsEnabled() const { return m_enabled; }
+
+    void SetKeepClosedFiles(bool keepClosedFiles) { this->m_keepClosedFiles = keepClosedFiles; }
+    bool IsKeepClosedFiles() const { return m_keepClosedFiles; }
+
+    void SetMemoryBudgetMB(size_t memoryBudgetMB) { this->m_memoryBudgetMB = memoryBudgetMB; }
+    size_t GetMemoryBudgetMB() const { return m_memoryBudgetMB; }
     
     WordCompletionSettings& Load();
     WordCompletionSettings& Save();
@@ -21,15 +21,16 @@ void WordCompletionThread::ProcessRequest(ThreadRequest* request)
     WordCompletionThreadRequest* req = dynamic_cast<WordCompletionThreadRequest*>(request);
     CHECK_PTR_RET(req);
 
-    wxStringSet_t suggestions;
-    ParseBuffer(req->buffer, suggestions);
+    WordCompletionIndex::Lines_t lines;
+    ParseLines(req->buffer, lines);
 
     // Parse and send back the reply
     WordCompletionThreadReply reply;
     reply.filename = req->filename;
     reply.filter = req->filter;
     reply.insertSingleMatch = req->insertSingleMatch;
-    reply.suggest.swap(suggestions);
+    reply.generation = req->generation;
+    reply.lines.swap(lines);
     m_dict->CallAfter(&WordCompletionDictionary::OnSuggestThread, reply);
 }
 
@@ -73,3 +74,45 @@ void WordCompletionThread::ParseBuffer(const wxString& buffer, wxStringSet_t& su
     ::WordLexerDestroy(&scanner);
 #endif
 }
+
+void WordCompletionThread::ParseLines(const wxString& buffer, WordCompletionIndex::Lines_t& lines)
+{
+    lines.clear();
+    lines.emplace_back();
+
+    WordScanner_t scanner = ::WordLexerNew(buffer);
+    if(!scanner)
+        return;
+
+    WordLexerToken token;
+    std::string curword;
+    auto flush_word = [&]() {
+        if(!curword.empty()) {
+            lines.back().push_back(wxString(curword.c_str(), wxConvUTF8, curword.length()));
+        }
+        curword.clear();
+    };
+
+    while(::WordLexerNext(scanner, token)) {
+        switch(token.type) {
+        case kWordDelim:
+            flush_word();
+            if(token.text && token.text[0] == '\n') {
+                lines.emplace_back();
+            }
+            break;
+
+        case kWordNumber: {
+            if(!curword.empty()) {
+                curword += token.text;
+            }
+            break;
+        }
+        default:
+            curword += token.text;
+            break;
+        }
+    }
+    flush_word();
+    ::WordLexerDestroy(&scanner);
+}
@@ -48,6 +48,12 @@ public:
      * @brief parse 'buffer' and return set of words to complete
      */
     static void ParseBuffer(const wxString& buffer, wxStringSet_t& suggest);
+
+    /**
+     * @brief parse 'buffer' and return the words found on each of its lines. The words of line `i` are placed in
+     * `lines[i]`
+     */
+    static void ParseLines(const wxString& buffer, WordCompletionIndex::Lines_t& lines);
 };
 
 #endif // WORDCOMPLETIONTHREAD_H
@@ -105,22 +105,12 @@ void WordCompletionPlugin::OnWordComplete(clCodeCompletionEvent& event)
 
     wxString filter = event.GetWord().Lower(); // stc->GetTextRange(start, curPos);
 
-    wxStringSet_t words = m_dictionary->GetWords();
-    // Parse the current buffer (if modified), to include non saved words
-    if(activeEditor->IsEditorModified()) {
-        // For performance (this parsing is done in the main thread)
-        // only parse the visible area of the document
-        wxStringSet_t unsavedBufferWords;
-        wxStyledTextCtrl* stc = activeEditor->GetCtrl();
-        int startPos = stc->PositionFromLine(stc->GetFirstVisibleLine());
-        int endPos = stc->GetCurrentPos();
-
-        wxString buffer = stc->GetTextRange(startPos, endPos);
-        WordCompletionThread::ParseBuffer(buffer, unsavedBufferWords);
-
-        // Merge the results
-        words.insert(unsavedBufferWords.begin(), unsavedBufferWords.end());
-    }
+    // Bring the lines modified since the last completion up to date, then query the index
+    m_dictionary->UpdateDirtyLines(activeEditor);
+
+    wxStringSet_t filteredSet;
+    m_dictionary->FindWords(filter, settings.GetComparisonMethod(), filteredSet);
+    filteredSet.erase(filter);
 
     // Get the editor keywords and add them
     LexerConf::Ptr_t lexer = ColoursAndFontsManager::Get().GetLexerForFile(activeEditor->GetFileName().GetFullName());
@@ -130,16 +120,11 @@ void WordCompletionPlugin::OnWordComplete(clCodeCompletionEvent& event)
             keywords << lexer->GetKeyWords(i) << " ";
         }
         wxArrayString langWords = ::wxStringTokenize(keywords, "\n\t \r", wxTOKEN_STRTOK);
-        words.insert(langWords.begin(), langWords.end());
-    }
-
-    wxStringSet_t filteredSet;
-    if(filter.IsEmpty()) {
-        filteredSet.swap(words);
-    } else {
-        for (const auto& word : words) {
+        for(const auto& word : langWords) {
             wxString lcWord = word.Lower();
-            if(settings.GetComparisonMethod() == WordCompletionSettings::kComparisonStartsWith) {
+            if(filter.IsEmpty()) {
+                filteredSet.insert(word);
+            } else if(settings.GetComparisonMethod() == WordCompletionSettings::kComparisonStartsWith) {
                 if(lcWord.StartsWith(filter) && filter != word) {
                     filteredSet.insert(word);
                 }
@@ -160,7 +145,9 @@ void WordCompletionPlugin::OnWordComplete(clCodeCompletionEvent& event)
 void WordCompletionPlugin::OnSettings(wxCommandEvent& event)
 {
     WordCompletionSettingsDlg dlg(EventNotifier::Get()->TopFrame());
-    dlg.ShowModal();
+    if(dlg.ShowModal() == wxID_OK) {
+        m_dictionary->ReloadSettings();
+    }
 }
 
 IEditor* WordCompletionPlugin::GetEditor(const wxString& filepath) const
@@ -56,6 +56,7 @@ CL_PLUGIN_API PluginInfo* GetPluginInfo()
     info.SetName("Abbreviation");
     info.SetDescription(_("Abbreviation plugin"));
     info.SetVersion("v1.1");
+    info.EnableFlag(PluginInfo::kLoadOnIdle, true);
     return &info;
 }
 
@@ -295,10 +295,17 @@ void clMakeGeneratorApp::DoGenerateCompileCommands()
     }
 
     wxArrayString generated_paths;
-    JSON json(clCxxWorkspaceST::Get()->CreateCompileCommandsJSON(!m_generateCompileCommands, &generated_paths));
-    if(json.isOk()) {
-        // Save the file
-        json.save(fn);
+    if(m_generateCompileCommands) {
+        // only the entries of the modified projects are generated. The path is printed only if the file was
+        // modified, so CodeLite does not restart the language servers for nothing
+        if(clCxxWorkspaceST::Get()->UpdateCompileCommandsJSON(fn)) {
+            generated_paths.Add(fn.GetFullPath());
+        } else {
+            Info("-- compile_commands.json was not modified");
+        }
+    } else {
+        // compile_flags.txt files are written by the projects, nothing is returned
+        clCxxWorkspaceST::Get()->CreateCompileCommandsJSON(true, &generated_paths);
     }
     for(const wxString& path : generated_paths) {
         wxFprintf(stdout, "%s\n", path);
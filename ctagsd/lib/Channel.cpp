@@ -51,6 +51,7 @@ bool ChannelSocket::write_reply(const wxString& message)
     // append the data
     s.append(cb.data(), cb.length());
     LOG_IF_TRACE { clDEBUG1() << "Sending reply:" << s << endl; }
+    std::lock_guard<std::mutex> lk{ m_write_mutex };
     client->Send(s);
     return true;
 }
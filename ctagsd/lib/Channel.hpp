@@ -5,6 +5,7 @@
 #include "SocketAPI/clSocketServer.h"
 
 #include <memory>
+#include <mutex>
 #include <wx/string.h>
 
 enum class eReadSome {
@@ -31,6 +32,8 @@ class ChannelSocket : public Channel
     wxString m_ip;
     int m_port = -1;
     clSocketBase::Ptr_t client;
+    // replies are written by the main thread and by the request workers
+    std::mutex m_write_mutex;
 
 protected:
     eReadSome read_some();
@@ -0,0 +1,482 @@
+#include "NameIndex.hpp"
+
+#include "file_logger.h"
+
+#include <algorithm>
+#include <iterator>
+#include <wx/stopwatch.h>
+#include <wx/tokenzr.h>
+
+namespace
+{
+// match kinds, best first
+constexpr int SCORE_EXACT = 1000;
+constexpr int SCORE_PREFIX = 800;
+constexpr int SCORE_WORD = 600;
+constexpr int SCORE_SUBSTRING = 500;
+constexpr int SCORE_CAMEL_HUMP = 400;
+constexpr int SCORE_FUZZY = 200;
+// bonus for a match that also respects the case
+constexpr int SCORE_CASE = 50;
+
+std::string to_utf8(const wxString& str)
+{
+    const wxScopedCharBuffer cb = str.utf8_str();
+    return std::string(cb.data(), cb.length());
+}
+
+std::string to_lower(const std::string& str)
+{
+    // only ASCII is folded, bytes of multibyte UTF-8 sequences are left as-is
+    std::string lower = str;
+    for(char& ch : lower) {
+        if(ch >= 'A' && ch <= 'Z') {
+            ch = ch - 'A' + 'a';
+        }
+    }
+    return lower;
+}
+
+bool is_upper(char ch) { return ch >= 'A' && ch <= 'Z'; }
+bool is_lower(char ch) { return ch >= 'a' && ch <= 'z'; }
+bool is_digit(char ch) { return ch >= '0' && ch <= '9'; }
+
+/**
+ * @brief does a word start at `pos`? Words are separated by underscores, by a case change ("fooBar", "HTTPServer")
+ * and digits
+ */
+bool is_word_start(const std::string& name, size_t pos)
+{
+    if(pos == 0) {
+        return true;
+    }
+    char prev = name[pos - 1];
+    char ch = name[pos];
+    if(ch == '_') {
+        return false;
+    }
+    if(prev == '_') {
+        return true;
+    }
+    if(is_upper(ch)) {
+        return !is_upper(prev) || (pos + 1 < name.size() && is_lower(name[pos + 1]));
+    }
+    return is_digit(ch) && !is_digit(prev);
+}
+
+/**
+ * @brief match the term against the word starts of `name`: each character either continues the current word or
+ * starts the next matching word ("gtbn" or "gettagsbn" both match "GetTagsByName")
+ */
+bool is_camel_hump_match(const std::string& name, const std::string& lower, const std::string& term_lower)
+{
+    size_t pos = 0;
+    bool in_word = false;
+    for(char ch : term_lower) {
+        if(in_word && pos < lower.size() && lower[pos] == ch) {
+            ++pos;
+            continue;
+        }
+        while(pos < lower.size() && !(lower[pos] == ch && is_word_start(name, pos))) {
+            ++pos;
+        }
+        if(pos == lower.size()) {
+            return false;
+        }
+        ++pos;
+        in_word = true;
+    }
+    return true;
+}
+
+/**
+ * @brief match the term as a subsequence of `lower`. Return the number of gaps between the matched characters, or
+ * -1 if the term is not a subsequence
+ */
+int fuzzy_gaps(const std::string& lower, const std::string& term_lower)
+{
+    int gaps = 0;
+    size_t pos = 0;
+    for(size_t i = 0; i < term_lower.size(); ++i) {
+        size_t match = lower.find(term_lower[i], pos);
+        if(match == std::string::npos) {
+            return -1;
+        }
+        if(i > 0 && match != pos) {
+            ++gaps;
+        }
+        pos = match + 1;
+    }
+    return gaps;
+}
+
+wxUint32 make_trigram(const std::string& str, size_t pos)
+{
+    return ((wxUint32)(unsigned char)str[pos] << 16) | ((wxUint32)(unsigned char)str[pos + 1] << 8) |
+           (wxUint32)(unsigned char)str[pos + 2];
+}
+} // namespace
+
+NameIndex::NameIndex()
+    : m_ready(false)
+{
+}
+
+NameIndex::~NameIndex() {}
+
+wxUint32 NameIndex::intern_name(Data& data, const std::string& name)
+{
+    auto where = data.name_ids.insert({ name, (wxUint32)data.names.size() });
+    wxUint32 name_id = where.first->second;
+    if(!where.second) {
+        return name_id;
+    }
+
+    data.names.emplace_back();
+    Name& entry = data.names.back();
+    entry.name = &where.first->first;
+    entry.lower = to_lower(name);
+    data.buckets[(unsigned char)entry.lower[0]].push_back(name_id);
+
+    // names are only appended, so the postings remain sorted
+    std::vector<wxUint32> trigrams;
+    for(size_t i = 0; i + 3 <= entry.lower.size(); ++i) {
+        trigrams.push_back(make_trigram(entry.lower, i));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    for(wxUint32 trigram : trigrams) {
+        data.trigrams[trigram].push_back(name_id);
+    }
+    return name_id;
+}
+
+wxUint32 NameIndex::intern_scope(Data& data, const std::string& scope)
+{
+    auto where = data.scope_ids.insert({ scope, (wxUint32)data.scopes.size() });
+    if(where.second) {
+        data.scopes.push_back(scope);
+    }
+    return where.first->second;
+}
+
+void NameIndex::add_row(Data& data, const Row& row)
+{
+    std::string name = to_utf8(row.name);
+    if(name.empty()) {
+        return;
+    }
+
+    // the scope is the path without the trailing "::name"
+    std::string lower = to_lower(name);
+    std::string path = to_lower(to_utf8(row.path));
+    std::string scope;
+    if(path.size() > lower.size() + 2 && path.compare(path.size() - lower.size(), lower.size(), lower) == 0 &&
+       path.compare(path.size() - lower.size() - 2, 2, "::") == 0) {
+        scope = path.substr(0, path.size() - lower.size() - 2);
+    } else if(path != lower) {
+        scope = path;
+    }
+
+    auto where = data.file_ids.insert({ row.file, (wxUint32)data.file_names.size() });
+    if(where.second) {
+        data.file_names.emplace_back();
+    }
+
+    Entry entry;
+    entry.id = row.id;
+    entry.scope = intern_scope(data, scope);
+    entry.file = where.first->second;
+
+    wxUint32 name_id = intern_name(data, name);
+    data.names[name_id].entries.push_back(entry);
+    data.file_names[entry.file].push_back(name_id);
+    ++data.entries_count;
+}
+
+void NameIndex::remove_file(Data& data, const wxString& file)
+{
+    auto iter = data.file_ids.find(file);
+    if(iter == data.file_ids.end()) {
+        return;
+    }
+
+    // the interned names are kept even when they no longer have entries, they are likely to come back when the
+    // file is parsed again
+    wxUint32 file_id = iter->second;
+    std::vector<wxUint32>& names = data.file_names[file_id];
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    for(wxUint32 name_id : names) {
+        std::vector<Entry>& entries = data.names[name_id].entries;
+        size_t count = entries.size();
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [file_id](const Entry& entry) { return entry.file == file_id; }),
+                      entries.end());
+        data.entries_count -= count - entries.size();
+    }
+    names.clear();
+}
+
+void NameIndex::build(ITagsStoragePtr db)
+{
+    wxStopWatch sw;
+    {
+        // from now on, the updates are queued: the rows they replace may already be read into `data`
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        m_building = true;
+    }
+
+    Data data;
+    db->EnumerateTagNames(wxArrayString(),
+                          [&data](long id, const wxString& name, const wxString& path, const wxString& file) {
+                              add_row(data, { id, name, path, file });
+                          });
+
+    size_t names_count = data.names.size();
+    size_t entries_count = data.entries_count;
+    std::vector<wxString> pending_files;
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        std::swap(m_data, data);
+        m_pending_files.swap(pending_files);
+        m_building = false;
+        m_ready.store(true);
+    }
+    clDEBUG() << "Name index: indexed" << entries_count << "tags," << names_count << "distinct names in" << sw.Time()
+              << "ms" << endl;
+
+    // replay the updates made while the database was read
+    if(!pending_files.empty()) {
+        std::sort(pending_files.begin(), pending_files.end());
+        pending_files.erase(std::unique(pending_files.begin(), pending_files.end()), pending_files.end());
+        clDEBUG() << "Name index: replaying the updates of" << pending_files.size() << "files" << endl;
+        update(db, pending_files);
+    }
+}
+
+void NameIndex::update(ITagsStoragePtr db, const std::vector<wxString>& files)
+{
+    if(files.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> update_lock{ m_update_mutex };
+    {
+        std::lock_guard<std::mutex> lock{ m_mutex };
+        if(m_building) {
+            m_pending_files.insert(m_pending_files.end(), files.begin(), files.end());
+            return;
+        }
+        if(!m_ready.load()) {
+            return;
+        }
+    }
+
+    // read the rows before taking the lock, so queries are not blocked by the database
+    wxArrayString files_arr;
+    files_arr.reserve(files.size());
+    for(const wxString& file : files) {
+        files_arr.Add(file);
+    }
+
+    std::vector<Row> rows;
+    db->EnumerateTagNames(files_arr, [&rows](long id, const wxString& name, const wxString& path,
+                                             const wxString& file) { rows.push_back({ id, name, path, file }); });
+
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    for(const wxString& file : files) {
+        remove_file(m_data, file);
+    }
+    for(const Row& row : rows) {
+        add_row(m_data, row);
+    }
+    LOG_IF_TRACE
+    {
+        clDEBUG1() << "Name index: updated" << files.size() << "files," << rows.size() << "tags. Total"
+                   << m_data.entries_count << "tags" << endl;
+    }
+}
+
+int NameIndex::score_name(const Name& name, const std::string& term, const std::string& term_lower)
+{
+    const std::string& lower = name.lower;
+    if(lower.size() < term_lower.size()) {
+        return 0;
+    }
+
+    if(lower == term_lower) {
+        return *name.name == term ? SCORE_EXACT + SCORE_CASE : SCORE_EXACT;
+    }
+
+    size_t pos = lower.find(term_lower);
+    if(pos == 0) {
+        return name.name->compare(0, term.size(), term) == 0 ? SCORE_PREFIX + SCORE_CASE : SCORE_PREFIX;
+    }
+
+    if(pos != std::string::npos) {
+        for(; pos != std::string::npos; pos = lower.find(term_lower, pos + 1)) {
+            if(is_word_start(*name.name, pos)) {
+                return SCORE_WORD;
+            }
+        }
+        return SCORE_SUBSTRING;
+    }
+
+    if(is_camel_hump_match(*name.name, lower, term_lower)) {
+        return SCORE_CAMEL_HUMP;
+    }
+
+    int gaps = fuzzy_gaps(lower, term_lower);
+    if(gaps < 0) {
+        return 0;
+    }
+    return SCORE_FUZZY - std::min(gaps, SCORE_FUZZY - 1);
+}
+
+void NameIndex::collect_candidates(const std::string& term, const std::string& term_lower,
+                                   std::vector<Candidate>& candidates) const
+{
+    auto add_candidate = [&](wxUint32 name_id) {
+        const Name& name = m_data.names[name_id];
+        if(name.entries.empty()) {
+            return;
+        }
+        int score = score_name(name, term, term_lower);
+        if(score > 0) {
+            candidates.push_back({ score, name_id });
+        }
+    };
+
+    // names starting with the same character: prefix, camel humps and fuzzy matches
+    unsigned char first = term_lower[0];
+    for(wxUint32 name_id : m_data.buckets[first]) {
+        add_candidate(name_id);
+    }
+
+    // names containing the term elsewhere, found by intersecting the trigram postings
+    if(term_lower.size() < 3) {
+        return;
+    }
+
+    std::vector<const std::vector<wxUint32>*> postings;
+    for(size_t i = 0; i + 3 <= term_lower.size(); ++i) {
+        auto iter = m_data.trigrams.find(make_trigram(term_lower, i));
+        if(iter == m_data.trigrams.end()) {
+            return;
+        }
+        postings.push_back(&iter->second);
+    }
+    std::sort(postings.begin(), postings.end(),
+              [](const std::vector<wxUint32>* a, const std::vector<wxUint32>* b) { return a->size() < b->size(); });
+
+    std::vector<wxUint32> matches = *postings[0];
+    std::vector<wxUint32> tmp;
+    for(size_t i = 1; i < postings.size() && !matches.empty(); ++i) {
+        tmp.clear();
+        std::set_intersection(matches.begin(), matches.end(), postings[i]->begin(), postings[i]->end(),
+                              std::back_inserter(tmp));
+        matches.swap(tmp);
+    }
+
+    for(wxUint32 name_id : matches) {
+        // names from the bucket were already scored
+        if((unsigned char)m_data.names[name_id].lower[0] != first) {
+            add_candidate(name_id);
+        }
+    }
+}
+
+bool NameIndex::find(const wxString& query, size_t limit, std::vector<long>& ids) const
+{
+    if(!m_ready.load()) {
+        return false;
+    }
+
+    wxArrayString words = ::wxStringTokenize(query, " \t", wxTOKEN_STRTOK);
+    if(words.empty()) {
+        return false;
+    }
+
+    wxString last = words.Last();
+    words.RemoveAt(words.size() - 1);
+
+    std::string scope_term;
+    size_t sep = last.rfind("::");
+    if(sep != wxString::npos) {
+        scope_term = to_lower(to_utf8(last.Mid(0, sep)));
+        last = last.Mid(sep + 2);
+    }
+
+    std::string term = to_utf8(last);
+    if(term.empty()) {
+        return false;
+    }
+    std::string term_lower = to_lower(term);
+
+    std::vector<std::string> path_terms;
+    for(const wxString& word : words) {
+        path_terms.push_back(to_lower(to_utf8(word)));
+    }
+
+    wxStopWatch sw;
+    std::lock_guard<std::mutex> lock{ m_mutex };
+    std::vector<Candidate> candidates;
+    collect_candidates(term, term_lower, candidates);
+
+    // best score first, then shorter names, then alphabetically
+    auto compare = [this](const Candidate& a, const Candidate& b) {
+        if(a.score != b.score) {
+            return a.score > b.score;
+        }
+        const std::string& name_a = m_data.names[a.name_id].lower;
+        const std::string& name_b = m_data.names[b.name_id].lower;
+        if(name_a.size() != name_b.size()) {
+            return name_a.size() < name_b.size();
+        }
+        int cmp = name_a.compare(name_b);
+        return cmp != 0 ? cmp < 0 : a.name_id < b.name_id;
+    };
+
+    // each candidate yields at least one tag unless filtered out: sort only what is likely to be returned
+    size_t sorted = std::min(limit, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + sorted, candidates.end(), compare);
+
+    std::string path;
+    for(size_t i = 0; i < candidates.size() && ids.size() < limit; ++i) {
+        if(i == sorted) {
+            std::sort(candidates.begin() + sorted, candidates.end(), compare);
+            sorted = candidates.size();
+        }
+
+        const Name& name = m_data.names[candidates[i].name_id];
+        for(const Entry& entry : name.entries) {
+            if(ids.size() >= limit) {
+                break;
+            }
+
+            const std::string& scope = m_data.scopes[entry.scope];
+            if(!scope_term.empty() && scope.find(scope_term) == std::string::npos) {
+                continue;
+            }
+
+            if(!path_terms.empty()) {
+                path = scope.empty() ? name.lower : scope + "::" + name.lower;
+                bool match = std::all_of(path_terms.begin(), path_terms.end(), [&path](const std::string& word) {
+                    return path.find(word) != std::string::npos;
+                });
+                if(!match) {
+                    continue;
+                }
+            }
+            ids.push_back(entry.id);
+        }
+    }
+
+    LOG_IF_TRACE
+    {
+        clDEBUG1() << "Name index: query" << query << "matched" << candidates.size() << "names, returned" << ids.size()
+                   << "tags in" << sw.Time() << "ms" << endl;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef NAMEINDEX_HPP
+#define NAMEINDEX_HPP
+
+#include "database/istorage.h"
+#include "wxStringHash.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+/**
+ * @brief an in-memory index of the tag names, used to answer "workspace/symbol" requests without scanning the tags
+ * table. Each distinct name is interned once and listed in the postings of the trigrams of its lower case form.
+ * A query is matched against the distinct names only (substring, prefix, camel humps and fuzzy), the names are ranked
+ * and the IDs of the best tags are returned, so only these tags are read from the database.
+ * The index is updated by the parser thread after chunks of files are stored and queried by the main thread
+ */
+class NameIndex
+{
+    struct Entry {
+        long id = 0;
+        wxUint32 scope = 0; // lower case tag path without the name
+        wxUint32 file = 0;
+    };
+
+    struct Name {
+        const std::string* name = nullptr; // points to the key in Data::name_ids
+        std::string lower;
+        std::vector<Entry> entries;
+    };
+
+    struct Row {
+        long id = 0;
+        wxString name;
+        wxString path;
+        wxString file;
+    };
+
+    struct Data {
+        std::vector<Name> names;
+        std::unordered_map<std::string, wxUint32> name_ids;
+        // names by the first byte of their lower case form
+        std::vector<wxUint32> buckets[256];
+        // trigram -> names containing it (sorted, names are only appended)
+        std::unordered_map<wxUint32, std::vector<wxUint32>> trigrams;
+        std::vector<std::string> scopes;
+        std::unordered_map<std::string, wxUint32> scope_ids;
+        std::unordered_map<wxString, wxUint32> file_ids;
+        // file -> names that have entries from this file
+        std::vector<std::vector<wxUint32>> file_names;
+        size_t entries_count = 0;
+    };
+
+    struct Candidate {
+        int score = 0;
+        wxUint32 name_id = 0;
+    };
+
+    mutable std::mutex m_mutex;
+    Data m_data;
+    std::atomic_bool m_ready;
+    // guarded by m_mutex: while build() reads the database, the updated files are queued and replayed after the swap
+    bool m_building = false;
+    std::vector<wxString> m_pending_files;
+    // serializes the updates, so the rows of a file read from the database are applied in order
+    std::mutex m_update_mutex;
+
+protected:
+    static void add_row(Data& data, const Row& row);
+    static void remove_file(Data& data, const wxString& file);
+    static wxUint32 intern_name(Data& data, const std::string& name);
+    static wxUint32 intern_scope(Data& data, const std::string& scope);
+
+    /**
+     * @brief score `name` against the query term. 0 means no match
+     */
+    static int score_name(const Name& name, const std::string& term, const std::string& term_lower);
+    void collect_candidates(const std::string& term, const std::string& term_lower,
+                            std::vector<Candidate>& candidates) const;
+
+public:
+    NameIndex();
+    ~NameIndex();
+
+    /**
+     * @brief (re)build the index from all the tags in the database
+     */
+    void build(ITagsStoragePtr db);
+
+    /**
+     * @brief the tags of `files` were stored in the database, replace their entries. Ignored until the index is
+     * built. While the index is being built, the files are queued and their entries are replaced once it is ready
+     */
+    void update(ITagsStoragePtr db, const std::vector<wxString>& files);
+
+    /**
+     * @brief return the IDs of the best `limit` tags for `query`, best match first. The last `::` separated part
+     * of the last word is matched against the names, the other parts of the last word must appear in the scope and
+     * the other words must appear in the tag path. Return false when the index can not answer the query (not built
+     * yet, or there is no name to match)
+     */
+    bool find(const wxString& query, size_t limit, std::vector<long>& ids) const;
+
+    bool is_ready() const { return m_ready.load(); }
+};
+
+#endif // NAMEINDEX_HPP
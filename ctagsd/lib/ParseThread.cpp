@@ -7,6 +7,12 @@ ParseThread::ParseThread() {}
 
 ParseThread::~ParseThread() { stop(); }
 
+void ParseThread::set_idle_task(std::function<void()>&& task, std::chrono::milliseconds delay)
+{
+    m_idle_task = std::move(task);
+    m_idle_delay = delay;
+}
+
 void ParseThread::start(const wxString& settings_folder, const wxString& indexer_path)
 {
     stop();
@@ -14,11 +20,22 @@ void ParseThread::start(const wxString& settings_folder, const wxString& indexer
         [=](std::mutex& m, std::condition_variable& cv, std::vector<ParseThreadTaskFunc>& Q) {
             FileLogger::RegisterThread(wxThread::GetCurrentId(), "Parser");
             clDEBUG() << "ctagsd parser thread started..." << endl;
+            bool idle_pending = false;
             while(true) {
                 ParseThreadTaskFunc task_callback = nullptr;
                 {
                     std::unique_lock<std::mutex> lk{ m };
-                    cv.wait(lk, [&] { return !Q.empty(); });
+                    if(idle_pending && m_idle_task) {
+                        if(!cv.wait_for(lk, m_idle_delay, [&] { return !Q.empty(); })) {
+                            // no request for a while
+                            idle_pending = false;
+                            lk.unlock();
+                            m_idle_task();
+                            continue;
+                        }
+                    } else {
+                        cv.wait(lk, [&] { return !Q.empty(); });
+                    }
                     task_callback = std::move(Q.front());
                     Q.erase(Q.begin());
                 }
@@ -27,6 +44,7 @@ void ParseThread::start(const wxString& settings_folder, const wxString& indexer
                 if(task_callback() == eParseThreadCallbackRC::RC_EXIT) {
                     break;
                 }
+                idle_pending = true;
             }
         },
         ref(m_mutex), ref(m_cv), ref(m_queue));
@@ -55,3 +73,9 @@ void ParseThread::queue_parse_request(ParseThreadTaskFunc&& task)
     m_queue.emplace_back(std::move(task));
     m_cv.notify_one();
 }
+
+void ParseThread::schedule_idle_task()
+{
+    // an empty request: the idle task runs once the queue stays empty
+    queue_parse_request([]() { return eParseThreadCallbackRC::RC_SUCCESS; });
+}
@@ -2,6 +2,7 @@
 #define PARSETHREAD_HPP
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <thread>
@@ -24,14 +25,27 @@ class ParseThread
     std::vector<ParseThreadTaskFunc> m_queue;
     wxString m_settings_folder;
     wxString m_indexer_path;
+    std::function<void()> m_idle_task;
+    std::chrono::milliseconds m_idle_delay{ 0 };
 
 public:
     ParseThread();
     ~ParseThread();
 
+    /**
+     * @brief run `task` on the parser thread once no request was queued for `delay` after the last one. It runs
+     * once per batch of requests. Call this before start()
+     */
+    void set_idle_task(std::function<void()>&& task, std::chrono::milliseconds delay);
+
     void start(const wxString& settings_folder, const wxString& indexer_path);
     void stop();
     void queue_parse_request(ParseThreadTaskFunc&& task);
+
+    /**
+     * @brief the database was modified outside of the parser thread: schedule the idle task
+     */
+    void schedule_idle_task();
 };
 
 #endif // PARSETHREAD_HPP
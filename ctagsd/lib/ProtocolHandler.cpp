@@ -18,6 +18,7 @@
 #include "database/tags_storage_sqlite3.h"
 #include "file_logger.h"
 #include "fileextmanager.h"
+#include "fileutils.h"
 #include "tags_options_data.h"
 
 #include <deque>
@@ -30,6 +31,9 @@ using LSP::eSymbolKind;
 
 namespace
 {
+// quiet period after the last parse before the tags snapshot is written again
+constexpr int SNAPSHOT_REBUILD_DELAY_SECONDS = 3;
+
 FileLogger& operator<<(FileLogger& logger, const TagEntry& tag)
 {
     wxString s;
@@ -172,7 +176,17 @@ JSONItem ProtocolHandler::build_result(JSONItem& reply, size_t id, int result_ki
     return result;
 }
 
-void ProtocolHandler::parse_buffer(const wxFileName& filename, const wxString& buffer, const CTagsdSettings& settings)
+void ProtocolHandler::run_request(size_t id, Channel::ptr_t channel, RequestScheduler::AsyncRequest_t&& request)
+{
+    if(m_scheduler) {
+        m_scheduler->run_async(id, std::move(request));
+    } else {
+        channel->write_reply(request());
+    }
+}
+
+void ProtocolHandler::parse_buffer(const wxFileName& filename, const wxString& buffer, const CTagsdSettings& settings,
+                                   NameIndex* name_index)
 {
     clDEBUG() << "Parsing buffer of file:" << filename << endl;
 
@@ -198,23 +212,61 @@ void ProtocolHandler::parse_buffer(const wxFileName& filename, const wxString& b
     time_t update_time = time(nullptr);
     db->Store(tags, false);
 
-    if(db->InsertFileEntry(filename.GetFullPath(), (int)update_time) == TagExist) {
-        db->UpdateFileEntry(filename.GetFullPath(), (int)update_time);
+    // the tags describe the buffer: once it is saved, the file is skipped by FilterNonNeededFilesForRetaging()
+    wxString hash = FileUtils::GetContentHash(FileUtils::ToStdString(buffer));
+    if(db->InsertFileEntry(filename.GetFullPath(), (int)update_time, hash) == TagExist) {
+        db->UpdateFileEntry(filename.GetFullPath(), (int)update_time, hash);
     }
 
     // Commit whats left
     db->Commit();
+    if(name_index) {
+        name_index->update(db, { filename.GetFullPath() });
+    }
     clDEBUG() << "Success" << endl;
 }
 
-void ProtocolHandler::parse_file(const wxFileName& filename, const CTagsdSettings& settings)
+void ProtocolHandler::delete_files(const std::vector<wxString>& files, const CTagsdSettings& settings,
+                                   NameIndex* name_index)
 {
-    parse_files({ filename.GetFullPath() }, settings);
+    wxFileName dbfile(settings.GetSettingsDir(), "tags.db");
+    if(!dbfile.FileExists()) {
+        return;
+    }
+
+    ITagsStoragePtr db(new TagsStorageSQLite());
+    db->OpenDatabase(dbfile);
+    db->Begin();
+    for(const wxString& file : files) {
+        db->DeleteByFileName({}, file, false);
+    }
+    db->Commit();
+
+    // the files no longer have rows: their entries are removed from the index
+    if(name_index) {
+        name_index->update(db, files);
+    }
+    clDEBUG() << "Deleted the symbols of" << files.size() << "files" << endl;
+}
+
+void ProtocolHandler::parse_file(const wxFileName& filename, const CTagsdSettings& settings, NameIndex* name_index)
+{
+    parse_files({ filename.GetFullPath() }, settings, name_index);
 }
 
 void ProtocolHandler::do_parse_chunk(ITagsStoragePtr db, const std::vector<wxString>& file_list, size_t chunk_id,
-                                     const CTagsdSettings& settings)
+                                     const CTagsdSettings& settings, NameIndex* name_index,
+                                     const wxStringMap_t& hashes, time_t update_time)
 {
+    // hash the files before the indexer reads them. If a file is modified while it is being parsed, its stored hash
+    // does not match its content and the file is parsed again
+    std::vector<wxString> file_hashes;
+    file_hashes.reserve(file_list.size());
+    for(const wxString& file : file_list) {
+        auto iter = hashes.find(file);
+        file_hashes.push_back(iter != hashes.end() ? iter->second : FileUtils::GetFileHash(file));
+    }
+
     std::vector<TagEntryPtr> tags;
     LOG_IF_DEBUG { clDEBUG() << "Parsing chunk (" << chunk_id << ") of" << file_list.size() << "files" << endl; }
     if(CTags::ParseFiles(file_list, settings.GetCodeliteIndexer(), settings.GetMacroTable(), tags) == 0) {
@@ -230,24 +282,28 @@ void ProtocolHandler::do_parse_chunk(ITagsStoragePtr db, const std::vector<wxStr
     }
     LOG_IF_DEBUG { clDEBUG() << "Storing" << tags.size() << "tags" << endl; }
     db->Begin();
-
-    time_t update_time = time(nullptr);
     db->Store(tags, false);
 
     // update the files table in the database
     // we do this here, since some files might not yield tags
-    // but we still want to mark them as "parsed"
-    for(const wxString& file : file_list) {
-        if(db->InsertFileEntry(file, (int)update_time) == TagExist) {
-            db->UpdateFileEntry(file, (int)update_time);
+    // but we still want to mark them as "parsed". The content hash lets us skip files that are
+    // touched later without being modified
+    for(size_t i = 0; i < file_list.size(); ++i) {
+        const wxString& file = file_list[i];
+        if(db->InsertFileEntry(file, (int)update_time, file_hashes[i]) == TagExist) {
+            db->UpdateFileEntry(file, (int)update_time, file_hashes[i]);
         }
     }
 
     // Commit whats left
     db->Commit();
+    if(name_index) {
+        name_index->update(db, file_list);
+    }
 }
 
-void ProtocolHandler::parse_files(const std::vector<wxString>& file_list, const CTagsdSettings& settings)
+void ProtocolHandler::parse_files(const std::vector<wxString>& file_list, const CTagsdSettings& settings,
+                                  NameIndex* name_index)
 {
     clDEBUG() << "Parsing" << file_list.size() << "files" << endl;
     clDEBUG() << "Removing un-modified and unwanted files..." << endl;
@@ -265,7 +321,11 @@ void ProtocolHandler::parse_files(const std::vector<wxString>& file_list, const
         files_to_parse.Add(file);
     }
 
-    TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files_to_parse, db);
+    // the files are stored with a time taken before they are read, so a file modified while it is parsed is parsed
+    // again
+    time_t update_time = time(nullptr);
+    wxStringMap_t hashes;
+    TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files_to_parse, db, &hashes);
     std::vector<wxString> filtered_file_list = { files_to_parse.begin(), files_to_parse.end() };
     clDEBUG() << "There are total of" << filtered_file_list.size() << "files that require parsing" << endl;
     clDEBUG() << "Generating ctags file..." << endl;
@@ -294,7 +354,7 @@ void ProtocolHandler::parse_files(const std::vector<wxString>& file_list, const
             iter_end = filtered_file_list.end();
         }
         std::vector<wxString> chunk_vec{ iter_start, iter_end };
-        do_parse_chunk(db, chunk_vec, i, settings);
+        do_parse_chunk(db, chunk_vec, i, settings, name_index, hashes, update_time);
     }
     clDEBUG() << "Success" << endl;
 }
@@ -477,6 +537,17 @@ void ProtocolHandler::on_initialize(std::unique_ptr<JSON>&& msg, Channel::ptr_t
     wxSetEnv("CTAGS_REPLACEMENTS", ctagsReplacements.GetFullPath());
     TagsManagerST::Get()->SetIndexerPath(m_settings.GetCodeliteIndexer());
 
+    // once the edits settle, the parser thread writes a new snapshot of the tags table. The lookups pick it up on
+    // their next check (see ITagsStorage::RecheckSnapshot)
+    wxFileName snapshot_db_path(m_settings_folder, "tags.db");
+    m_parse_thread.set_idle_task(
+        [snapshot_db_path]() {
+            ITagsStoragePtr db(new TagsStorageSQLite());
+            db->OpenDatabase(snapshot_db_path);
+            db->BuildSnapshot();
+        },
+        std::chrono::seconds(SNAPSHOT_REBUILD_DELAY_SECONDS));
+
     // start the "on_change" parser thread
     m_parse_thread.start(m_settings_folder, m_settings.GetCodeliteIndexer());
 
@@ -502,7 +573,7 @@ void ProtocolHandler::on_initialize(std::unique_ptr<JSON>&& msg, Channel::ptr_t
     wxString indexer_path = m_settings.GetCodeliteIndexer();
     std::vector<wxString> files_to_parse = { files.begin(), files.end() };
     clDEBUG() << "on_initialize(): parsing files..." << endl;
-    ProtocolHandler::parse_files(files_to_parse, m_settings);
+    ProtocolHandler::parse_files(files_to_parse, m_settings, nullptr);
     clDEBUG() << "on_initialize(): parsing files... Success" << endl;
 
     // Now that the database is parsed, re-open it
@@ -510,6 +581,13 @@ void ProtocolHandler::on_initialize(std::unique_ptr<JSON>&& msg, Channel::ptr_t
     TagsManagerST::Get()->OpenDatabase(fn_db_path);
     TagsManagerST::Get()->GetDatabase()->SetSingleSearchLimit(m_settings.GetLimitResults());
     TagsManagerST::Get()->GetDatabase()->SetUseCache(true);
+    // the snapshot is built after the full index. Parsing a file makes it stale: the lookups fall back to SQL until
+    // the parser thread writes a new one
+    TagsManagerST::Get()->GetDatabase()->SetUseSnapshot(true);
+    TagsManagerST::Get()->GetDatabase()->BuildSnapshot();
+
+    // index the names for "workspace/symbol". From now on, the parser thread keeps it up to date
+    m_name_index.build(TagsManagerST::Get()->GetDatabase());
 
     // reparse the workspace
     send_log_message(_("Initialization completed"), LSP_LOG_INFO, channel);
@@ -557,7 +635,8 @@ void ProtocolHandler::on_did_open(std::unique_ptr<JSON>&& msg, Channel::ptr_t ch
     parse_file_for_includes_and_using_namespace(filepath);
 
     // make sure this file is up to date
-    parse_file(filepath, m_settings);
+    parse_file(filepath, m_settings, &m_name_index);
+    m_parse_thread.schedule_idle_task();
 
     // keep the file content in-cache
     m_filesOpened.insert({ filepath, file_content });
@@ -636,7 +715,7 @@ void ProtocolHandler::on_did_change(std::unique_ptr<JSON>&& msg, Channel::ptr_t
         wxString settings_folder = m_settings_folder;
         ParseThreadTaskFunc buffer_parse_task = [=]() {
             clDEBUG() << "on_did_change(): parsing file task" << filepath << endl;
-            ProtocolHandler::parse_buffer(filepath, file_content, m_settings);
+            ProtocolHandler::parse_buffer(filepath, file_content, m_settings, &m_name_index);
             clDEBUG() << "on_did_change(): parsing file task ... Success" << endl;
             return eParseThreadCallbackRC::RC_SUCCESS;
         };
@@ -648,7 +727,7 @@ void ProtocolHandler::on_did_change(std::unique_ptr<JSON>&& msg, Channel::ptr_t
             std::vector<wxString> includes_to_parse{ new_includes.begin(), new_includes.end() };
             ParseThreadTaskFunc headers_parse_task = [=]() {
                 clDEBUG() << "on_did_change(): parsing header files" << includes_to_parse << endl;
-                ProtocolHandler::parse_files(includes_to_parse, m_settings);
+                ProtocolHandler::parse_files(includes_to_parse, m_settings, &m_name_index);
                 clDEBUG() << "on_did_change(): parsing header files ... Success" << endl;
                 return eParseThreadCallbackRC::RC_SUCCESS;
             };
@@ -886,7 +965,7 @@ void ProtocolHandler::on_did_save(std::unique_ptr<JSON>&& msg, Channel::ptr_t ch
     wxString settings_folder = m_settings_folder;
     ParseThreadTaskFunc task = [=]() {
         clDEBUG() << "on_did_save: parsing task:" << files.size() << "files..." << endl;
-        ProtocolHandler::parse_files(files, m_settings);
+        ProtocolHandler::parse_files(files, m_settings, &m_name_index);
         clDEBUG() << "on_did_save: parsing task: ... Success!" << endl;
         return eParseThreadCallbackRC::RC_SUCCESS;
     };
@@ -898,6 +977,40 @@ void ProtocolHandler::on_did_save(std::unique_ptr<JSON>&& msg, Channel::ptr_t ch
     m_additional_scopes.clear();
 }
 
+// Notification -->
+void ProtocolHandler::on_did_change_watched_files(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel)
+{
+    wxUnusedVar(channel);
+    JSONItem changes = msg->toElement()["params"]["changes"];
+
+    // FileChangeType: 1 created, 2 changed, 3 deleted
+    std::vector<wxString> files_to_parse;
+    std::vector<wxString> files_to_delete;
+    for(auto change : changes) {
+        wxString filepath = wxFileSystem::URLToFileName(change["uri"].toString()).GetFullPath();
+        if(change["type"].toInt() == 3) {
+            files_to_delete.push_back(filepath);
+        } else {
+            files_to_parse.push_back(filepath);
+        }
+    }
+    clDEBUG() << "workspace/didChangeWatchedFiles:" << files_to_parse.size() << "files to parse,"
+              << files_to_delete.size() << "files to delete" << endl;
+
+    // the database is only written by the parse thread
+    ParseThreadTaskFunc task = [=]() {
+        if(!files_to_delete.empty()) {
+            ProtocolHandler::delete_files(files_to_delete, m_settings, &m_name_index);
+        }
+        if(!files_to_parse.empty()) {
+            ProtocolHandler::parse_files(files_to_parse, m_settings, &m_name_index);
+        }
+        return eParseThreadCallbackRC::RC_SUCCESS;
+    };
+    m_parse_thread.queue_parse_request(std::move(task));
+    TagsManagerST::Get()->GetDatabase()->ClearCache();
+}
+
 namespace
 {
 void add_to_locals_set(const wxString& name, wxStringSet_t& locals, wxStringSet_t& types)
@@ -922,17 +1035,26 @@ void ProtocolHandler::on_semantic_tokens(std::unique_ptr<JSON>&& msg, Channel::p
 {
     JSONItem json = msg->toElement();
     LOG_IF_TRACE { clDEBUG1() << json.format() << endl; }
+    size_t id = json["id"].toSize_t();
     wxString filepath_uri = json["params"]["textDocument"]["uri"].toString();
     wxString filepath = wxFileSystem::URLToFileName(filepath_uri).GetFullPath();
     clDEBUG() << "textDocument/semanticTokens/full: for file" << filepath << endl;
 
+    // the tokens are computed from a copy of the buffer, so later changes to the document do not affect them
+    wxString buffer = m_filesOpened[filepath];
+    wxString indexer = m_settings.GetCodeliteIndexer();
+    wxStringMap_t macros = m_settings.GetMacroTable();
+    run_request(id, channel, [=]() { return build_semantic_tokens_reply(id, filepath, buffer, indexer, macros); });
+}
+
+wxString ProtocolHandler::build_semantic_tokens_reply(size_t id, const wxString& filepath, const wxString& buffer,
+                                                      const wxString& indexer, const wxStringMap_t& macros)
+{
     // use CTags to gather local variables
-    wxString tmpdir = clStandardPaths::Get().GetTempDir();
     std::vector<TagEntryPtr> tags;
 
     // get list of local tags
-    CTags::ParseLocals(filepath, m_filesOpened[filepath], m_settings.GetCodeliteIndexer(), m_settings.GetMacroTable(),
-                       tags);
+    CTags::ParseLocals(filepath, buffer, indexer, macros, tags);
 
     LOG_IF_TRACE { clDEBUG1() << "File tags:" << tags.size() << endl; }
     wxStringSet_t locals_set;
@@ -977,8 +1099,6 @@ void ProtocolHandler::on_semantic_tokens(std::unique_ptr<JSON>&& msg, Channel::p
     LOG_IF_TRACE { clDEBUG1() << "Locals:" << locals_set << endl; }
     LOG_IF_TRACE { clDEBUG1() << "Types:" << types_set << endl; }
 
-    const wxString& buffer = m_filesOpened[filepath];
-
     // collect all interesting tokens from the document
     SimpleTokenizer tokenizer(buffer);
     TokenWrapper token_wrapper;
@@ -1057,7 +1177,6 @@ void ProtocolHandler::on_semantic_tokens(std::unique_ptr<JSON>&& msg, Channel::p
     }
 
     // build the response
-    size_t id = json["id"].toSize_t();
     JSON root(cJSON_Object);
     JSONItem response = root.toElement();
     auto result = build_result(response, id, cJSON_Object);
@@ -1069,7 +1188,7 @@ void ProtocolHandler::on_semantic_tokens(std::unique_ptr<JSON>&& msg, Channel::p
     LSPUtils::encode_semantic_tokens(tokens_vec, &encoding);
     result.addProperty("data", encoding);
     LOG_IF_TRACE { clDEBUG1() << response.format() << endl; }
-    channel->write_reply(response);
+    return response.format(false);
 }
 
 // Request <-->
@@ -1079,10 +1198,17 @@ void ProtocolHandler::on_workspace_symbol(std::unique_ptr<JSON>&& msg, Channel::
     size_t id = json["id"].toSize_t();
 
     wxString query = json["params"]["query"].toString();
-    wxArrayString parts = ::wxStringTokenize(query, " \t", wxTOKEN_STRTOK);
 
+    // rank the names in memory and fetch only the best tags. Fallback to the database search when the index can
+    // not answer the query
     std::vector<TagEntryPtr> tags;
-    TagsManagerST::Get()->GetTagsByPartialNames(parts, tags);
+    std::vector<long> ids;
+    if(m_name_index.find(query, m_settings.GetLimitResults(), ids)) {
+        TagsManagerST::Get()->GetDatabase()->GetTagsByIds(ids, tags);
+    } else {
+        wxArrayString parts = ::wxStringTokenize(query, " \t", wxTOKEN_STRTOK);
+        TagsManagerST::Get()->GetTagsByPartialNames(parts, tags);
+    }
 
     // build the reply
     JSON root(cJSON_Object);
@@ -1113,10 +1239,19 @@ void ProtocolHandler::on_document_symbol(std::unique_ptr<JSON>&& msg, Channel::p
     if(!ensure_file_content_exists(filepath, channel, id))
         return;
 
+    // parse a copy of the buffer on the scheduler pool
+    wxString buffer = m_filesOpened[filepath];
+    wxString indexer = m_settings.GetCodeliteIndexer();
+    wxStringMap_t macros = m_settings.GetMacroTable();
+    run_request(id, channel, [=]() { return build_document_symbol_reply(id, filepath, buffer, indexer, macros); });
+}
+
+wxString ProtocolHandler::build_document_symbol_reply(size_t id, const wxString& filepath, const wxString& buffer,
+                                                      const wxString& indexer, const wxStringMap_t& macros)
+{
     // parse hte buffer
     std::vector<TagEntryPtr> tags;
-    CTags::ParseBuffer(filepath, m_filesOpened[filepath], m_settings.GetCodeliteIndexer(), m_settings.GetMacroTable(),
-                       tags);
+    CTags::ParseBuffer(filepath, buffer, indexer, macros, tags);
     if(tags.empty()) {
         clDEBUG() << "no tags were found in file:" << filepath << endl;
     }
@@ -1141,7 +1276,7 @@ void ProtocolHandler::on_document_symbol(std::unique_ptr<JSON>&& msg, Channel::p
     for(const LSP::SymbolInformation& symbol : symbols) {
         result.arrayAppend(symbol.ToJSON(wxEmptyString));
     }
-    channel->write_reply(response);
+    return response.format(false);
 }
 
 // Request <-->
@@ -5,7 +5,9 @@
 #include "CompletionHelper.hpp"
 #include "Cxx/CxxCodeCompletion.hpp"
 #include "JSON.h"
+#include "NameIndex.hpp"
 #include "ParseThread.hpp"
+#include "RequestScheduler.hpp"
 #include "Scanner.hpp"
 #include "Settings.hpp"
 #include "database/istorage.h"
@@ -46,26 +48,48 @@ private:
     Scanner m_file_scanner;
     CxxCodeCompletion::ptr_t m_completer;
     ParseThread m_parse_thread;
+    NameIndex m_name_index;
+    RequestScheduler* m_scheduler = nullptr;
 
 private:
-    JSONItem build_result(JSONItem& reply, size_t id, int result_kind);
+    static JSONItem build_result(JSONItem& reply, size_t id, int result_kind);
 
     /**
-     * @brief parse source file
+     * @brief compute the reply of request `id` on the scheduler pool (or right away, when there is no scheduler).
+     * `request` runs on another thread: it must only use the data it captured
      */
-    static void parse_file(const wxFileName& filename, const CTagsdSettings& settings);
+    void run_request(size_t id, Channel::ptr_t channel, RequestScheduler::AsyncRequest_t&& request);
+
+    static wxString build_semantic_tokens_reply(size_t id, const wxString& filepath, const wxString& buffer,
+                                                const wxString& indexer, const wxStringMap_t& macros);
+    static wxString build_document_symbol_reply(size_t id, const wxString& filepath, const wxString& buffer,
+                                                const wxString& indexer, const wxStringMap_t& macros);
+
+    /**
+     * @brief parse source file. The tags stored are reflected in `name_index`, when provided
+     */
+    static void parse_file(const wxFileName& filename, const CTagsdSettings& settings, NameIndex* name_index);
     /**
      * @brief parse buffer of a given file name
      */
-    static void parse_buffer(const wxFileName& filename, const wxString& buffer, const CTagsdSettings& settings);
+    static void parse_buffer(const wxFileName& filename, const wxString& buffer, const CTagsdSettings& settings,
+                             NameIndex* name_index);
     /**
      * @brief parse list of files
      */
-    static void parse_files(const std::vector<wxString>& files, const CTagsdSettings& settings);
+    static void parse_files(const std::vector<wxString>& files, const CTagsdSettings& settings,
+                            NameIndex* name_index);
+    /**
+     * @brief delete the symbols of `files` from the database (and from `name_index`, when provided)
+     */
+    static void delete_files(const std::vector<wxString>& files, const CTagsdSettings& settings,
+                             NameIndex* name_index);
 
-    // helper method for parsing a chunk of files
+    // helper method for parsing a chunk of files. `hashes` holds the content hash of the files that were already read
+    // and `update_time` is a time taken before any of the files was read
     static void do_parse_chunk(ITagsStoragePtr db, const std::vector<wxString>& files, size_t chunk_id,
-                               const CTagsdSettings& settings);
+                               const CTagsdSettings& settings, NameIndex* name_index, const wxStringMap_t& hashes,
+                               time_t update_time);
 
     bool ensure_file_content_exists(const wxString& filepath, Channel::ptr_t channel, size_t req_id);
     void update_comments_for_file(const wxString& filepath, const wxString& file_content);
@@ -105,6 +129,8 @@ public:
     ProtocolHandler();
     ~ProtocolHandler();
 
+    void set_scheduler(RequestScheduler* scheduler) { m_scheduler = scheduler; }
+
     void on_initialize(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
     void on_initialized(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
     void on_unsupported_message(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
@@ -120,6 +146,7 @@ public:
     void on_declaration(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
     void on_hover(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
     void on_workspace_symbol(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
+    void on_did_change_watched_files(std::unique_ptr<JSON>&& msg, Channel::ptr_t channel);
 
     /**
      * @brief send a "window/logMessage" message to the client
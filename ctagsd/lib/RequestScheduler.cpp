@@ -0,0 +1,204 @@
+#include "RequestScheduler.hpp"
+
+#include "LSP/ResponseError.h"
+#include "file_logger.h"
+
+#include <algorithm>
+#include <wx/thread.h>
+
+RequestScheduler::RequestScheduler(Channel::ptr_t channel, size_t workers_count)
+    : m_channel(channel)
+    , m_workers_count(std::max(workers_count, (size_t)1))
+{
+}
+
+RequestScheduler::~RequestScheduler() { stop(); }
+
+bool RequestScheduler::is_query(const wxString& method)
+{
+    return method == "textDocument/completion" || method == "textDocument/signatureHelp" ||
+           method == "textDocument/hover" || method == "textDocument/definition" ||
+           method == "textDocument/declaration" || method == "textDocument/documentSymbol" ||
+           method == "textDocument/semanticTokens/full" || method == "workspace/symbol";
+}
+
+bool RequestScheduler::is_interactive(const wxString& method)
+{
+    return method == "textDocument/completion" || method == "textDocument/signatureHelp";
+}
+
+void RequestScheduler::start()
+{
+    stop();
+    m_eof = false;
+    m_shutdown = false;
+    m_reader = new std::thread(&RequestScheduler::read_messages, this);
+    for(size_t i = 0; i < m_workers_count; ++i) {
+        m_workers.push_back(new std::thread(&RequestScheduler::run_jobs, this));
+    }
+}
+
+void RequestScheduler::stop()
+{
+    if(m_reader) {
+        // the reader exits once the channel is closed
+        m_reader->join();
+        wxDELETE(m_reader);
+    }
+
+    {
+        std::lock_guard<std::mutex> lk{ m_mutex };
+        m_shutdown = true;
+    }
+    m_jobs_cv.notify_all();
+    for(std::thread* worker : m_workers) {
+        worker->join();
+        delete worker;
+    }
+    m_workers.clear();
+}
+
+void RequestScheduler::read_messages()
+{
+    FileLogger::RegisterThread(wxThread::GetCurrentId(), "Reader");
+    try {
+        while(true) {
+            auto msg = m_channel->read_message();
+            if(!msg) {
+                break;
+            }
+
+            auto json = msg->toElement();
+            Message message;
+            message.method = json["method"].toString();
+            if(message.method == "$/cancelRequest") {
+                cancel(json["params"]["id"].toInt(wxNOT_FOUND));
+                continue;
+            }
+
+            message.id = json.hasNamedObject("id") ? json["id"].toInt(wxNOT_FOUND) : wxNOT_FOUND;
+            message.msg = std::move(msg);
+            {
+                std::lock_guard<std::mutex> lk{ m_mutex };
+                m_messages.push_back(std::move(message));
+            }
+            m_messages_cv.notify_one();
+        }
+    } catch (const clSocketException& e) {
+        clERROR() << "Failed to read message:" << e.what() << endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk{ m_mutex };
+        m_eof = true;
+    }
+    m_messages_cv.notify_all();
+}
+
+std::unique_ptr<JSON> RequestScheduler::next_message()
+{
+    std::unique_lock<std::mutex> lk{ m_mutex };
+    m_messages_cv.wait(lk, [this] { return !m_messages.empty() || m_eof; });
+    if(m_messages.empty()) {
+        return nullptr;
+    }
+
+    auto where = m_messages.begin();
+    for(auto iter = m_messages.begin(); iter != m_messages.end() && is_query(iter->method); ++iter) {
+        if(is_interactive(iter->method)) {
+            where = iter;
+            break;
+        }
+    }
+
+    auto msg = std::move(where->msg);
+    m_messages.erase(where);
+    return msg;
+}
+
+void RequestScheduler::run_async(long id, AsyncRequest_t&& request)
+{
+    {
+        std::lock_guard<std::mutex> lk{ m_mutex };
+        m_jobs.push_back({ id, std::move(request) });
+    }
+    m_jobs_cv.notify_one();
+}
+
+void RequestScheduler::run_jobs()
+{
+    FileLogger::RegisterThread(wxThread::GetCurrentId(), "Worker");
+    while(true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lk{ m_mutex };
+            m_jobs_cv.wait(lk, [this] { return m_shutdown || !m_jobs.empty(); });
+            if(m_shutdown) {
+                break;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_running.insert(job.id);
+        }
+
+        wxString reply = job.request();
+
+        bool cancelled = false;
+        {
+            std::lock_guard<std::mutex> lk{ m_mutex };
+            m_running.erase(job.id);
+            cancelled = m_cancelled.erase(job.id) > 0;
+        }
+
+        try {
+            if(cancelled) {
+                write_cancelled(job.id);
+            } else {
+                m_channel->write_reply(reply);
+            }
+        } catch (const clSocketException& e) {
+            clERROR() << "Failed to send reply:" << e.what() << endl;
+        }
+    }
+}
+
+void RequestScheduler::cancel(long id)
+{
+    if(id == wxNOT_FOUND) {
+        return;
+    }
+
+    bool dropped = false;
+    {
+        std::lock_guard<std::mutex> lk{ m_mutex };
+        auto message = std::find_if(m_messages.begin(), m_messages.end(),
+                                    [id](const Message& m) { return m.id == id && is_query(m.method); });
+        auto job = std::find_if(m_jobs.begin(), m_jobs.end(), [id](const Job& j) { return j.id == id; });
+        if(message != m_messages.end()) {
+            m_messages.erase(message);
+            dropped = true;
+        } else if(job != m_jobs.end()) {
+            m_jobs.erase(job);
+            dropped = true;
+        } else if(m_running.count(id)) {
+            m_cancelled.insert(id);
+        }
+    }
+
+    clDEBUG() << "Request" << id << "cancelled." << (dropped ? "It was dropped" : "") << endl;
+    if(dropped) {
+        write_cancelled(id);
+    }
+}
+
+void RequestScheduler::write_cancelled(long id)
+{
+    JSON root(cJSON_Object);
+    auto response = root.toElement();
+    response.addProperty("id", id);
+    response.addProperty("jsonrpc", "2.0");
+    auto error = response.AddObject("error");
+    error.addProperty("code", (int)LSP::ResponseError::kErrorCodeRequestCancelled);
+    error.addProperty("message", "Request cancelled");
+    m_channel->write_reply(response);
+}
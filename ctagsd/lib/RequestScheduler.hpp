@@ -0,0 +1,96 @@
+#ifndef REQUESTSCHEDULER_HPP
+#define REQUESTSCHEDULER_HPP
+
+#include "Channel.hpp"
+#include "JSON.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief reads the messages from the channel on a dedicated thread and hands them over to the main loop.
+ * Messages are dispatched in the order they were received, except for completion requests: they are moved ahead of
+ * the queries queued before them, but never ahead of a notification (the document they refer to must be up to date).
+ * Requests that only need a copy of the document can be executed on a small pool of workers, so a slow request does
+ * not delay the next ones. "$/cancelRequest" is handled as soon as it is read: a request that did not start yet is
+ * dropped and answered with a RequestCancelled error, a request running on the pool has its result replaced by this
+ * error
+ */
+class RequestScheduler
+{
+public:
+    /**
+     * @brief compute the reply of a request
+     */
+    typedef std::function<wxString()> AsyncRequest_t;
+
+private:
+    struct Message {
+        std::unique_ptr<JSON> msg;
+        wxString method;
+        long id = wxNOT_FOUND;
+    };
+
+    struct Job {
+        long id = wxNOT_FOUND;
+        AsyncRequest_t request;
+    };
+
+    Channel::ptr_t m_channel;
+    size_t m_workers_count = 0;
+    std::thread* m_reader = nullptr;
+    std::vector<std::thread*> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_messages_cv;
+    std::deque<Message> m_messages;
+    bool m_eof = false;
+
+    std::condition_variable m_jobs_cv;
+    std::deque<Job> m_jobs;
+    std::unordered_set<long> m_running;
+    std::unordered_set<long> m_cancelled;
+    bool m_shutdown = false;
+
+protected:
+    void read_messages();
+    void run_jobs();
+    void cancel(long id);
+    void write_cancelled(long id);
+
+    /**
+     * @brief requests that do not modify the server state
+     */
+    static bool is_query(const wxString& method);
+    /**
+     * @brief requests sent while the user is typing
+     */
+    static bool is_interactive(const wxString& method);
+
+public:
+    RequestScheduler(Channel::ptr_t channel, size_t workers_count);
+    ~RequestScheduler();
+
+    void start();
+    void stop();
+
+    /**
+     * @brief return the next message to dispatch. Block until a message is available, return nullptr once the
+     * channel is closed and all the messages were dispatched
+     */
+    std::unique_ptr<JSON> next_message();
+
+    /**
+     * @brief compute the reply of request `id` on the pool, and send it
+     */
+    void run_async(long id, AsyncRequest_t&& request);
+};
+
+#endif // REQUESTSCHEDULER_HPP
@@ -1,5 +1,6 @@
 #include "Channel.hpp"
 #include "ProtocolHandler.hpp"
+#include "RequestScheduler.hpp"
 #include "cl_standard_paths.h"
 #include "ctags_manager.h"
 #include "file_logger.h"
@@ -27,6 +28,7 @@ std::unordered_map<wxString, ProtocolHandler::CallbackFunc> function_table = {
     { "textDocument/hover", &ProtocolHandler::on_hover },
     { "textDocument/documentSymbol", &ProtocolHandler::on_document_symbol },
     { "workspace/symbol", &ProtocolHandler::on_workspace_symbol },
+    { "workspace/didChangeWatchedFiles", &ProtocolHandler::on_did_change_watched_files },
 };
 }
 
@@ -72,11 +74,16 @@ int main(int argc, char** argv)
         channel->open();
 
         ProtocolHandler protocol_handler;
+
+        // messages are read on a separate thread, so cancellations are handled while a request is running.
+        // Each worker runs its own codelite_indexer process: keep the pool small
+        RequestScheduler scheduler(channel, 2);
+        protocol_handler.set_scheduler(&scheduler);
+        scheduler.start();
         clSYSTEM() << "Started main loop" << endl;
 
-        wxString message;
         while(true) {
-            auto msg = channel->read_message();
+            auto msg = scheduler.next_message();
             if(!msg) {
                 break;
             }
@@ -86,10 +93,16 @@ int main(int argc, char** argv)
                 LOG_IF_TRACE { clDEBUG1() << "Received unsupported method:" << method << endl; }
                 protocol_handler.on_unsupported_message(std::move(msg), channel);
             } else {
+                // the state of the tags snapshot is checked once per request
+                auto db = TagsManagerST::Get()->GetDatabase();
+                if(db) {
+                    db->RecheckSnapshot();
+                }
                 auto& cb = function_table[method];
                 (protocol_handler.*cb)(std::move(msg), channel);
             }
         }
+        scheduler.stop();
 
     } catch (const clSocketException& e) {
         clERROR() << "Uncaught exception:" << e.what() << endl;
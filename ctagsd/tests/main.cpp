@@ -6,6 +6,7 @@
 #include "Cxx/CxxTokenizer.h"
 #include "Cxx/CxxVariableScanner.h"
 #include "LSPUtils.hpp"
+#include "NameIndex.hpp"
 #include "Settings.hpp"
 #include "SimpleTokenizer.hpp"
 #include "clFilesCollector.h"
@@ -16,6 +17,7 @@
 #include "strings.hpp"
 #include "tester.hpp"
 
+#include <cstring>
 #include <iostream>
 #include <wx/init.h>
 #include <wx/log.h>
@@ -1512,6 +1514,181 @@ TEST_FUNC(test_cxx_code_completion)
     return true;
 }
 
+TEST_FUNC(test_name_index)
+{
+    wxFileName fn(wxFileName::GetTempDir(), "ctagsd-tests-name-index.db");
+    if(fn.FileExists()) {
+        ::wxRemoveFile(fn.GetFullPath());
+    }
+
+    ITagsStoragePtr db(new TagsStorageSQLite());
+    db->OpenDatabase(fn);
+
+    auto make_tag = [](const wxString& name, const wxString& scope, const wxString& file) {
+        TagEntryPtr tag(new TagEntry());
+        tag->SetName(name);
+        tag->SetScope(scope);
+        tag->SetPath(scope.empty() ? name : scope + "::" + name);
+        tag->SetFile(file);
+        tag->SetKind("function");
+        tag->SetLine(1);
+        return tag;
+    };
+    db->Store({ make_tag("GetTagsByName", "TagsManager", "/src/a.cpp"), make_tag("GetName", "TagEntry", "/src/a.cpp"),
+                make_tag("SetName", "TagEntry", "/src/b.cpp"), make_tag("rename_file", "", "/src/b.cpp") });
+
+    NameIndex index;
+    index.build(db);
+
+    std::vector<long> ids;
+    std::vector<TagEntryPtr> tags;
+    auto find = [&](const wxString& query) {
+        ids.clear();
+        tags.clear();
+        bool res = index.find(query, 10, ids);
+        db->GetTagsByIds(ids, tags);
+        return res;
+    };
+
+    // camel humps
+    CHECK_BOOL(find("gtbn"));
+    CHECK_SIZE(tags.size(), 1);
+    CHECK_STRING(tags[0]->GetName(), "GetTagsByName");
+
+    // substring: matches at the start of a word rank first, shorter names first
+    CHECK_BOOL(find("name"));
+    CHECK_SIZE(tags.size(), 4);
+    CHECK_STRING(tags[0]->GetName(), "GetName");
+    CHECK_STRING(tags[1]->GetName(), "SetName");
+    CHECK_STRING(tags[2]->GetName(), "GetTagsByName");
+    CHECK_STRING(tags[3]->GetName(), "rename_file");
+
+    // scope
+    CHECK_BOOL(find("tagentry::name"));
+    CHECK_SIZE(tags.size(), 2);
+
+    // updating a file replaces its entries
+    db->Store({ make_tag("GetNames", "TagEntry", "/src/a.cpp") });
+    index.update(db, { "/src/a.cpp" });
+    CHECK_BOOL(find("getn"));
+    CHECK_SIZE(tags.size(), 1);
+    CHECK_STRING(tags[0]->GetName(), "GetNames");
+
+    // no name to match
+    CHECK_BOOL(!find("TagEntry::"));
+    return true;
+}
+
+namespace
+{
+/// runs `on_built` once, right after the tags of the whole database were enumerated (NameIndex::build)
+class BuildHookStorage : public TagsStorageSQLite
+{
+public:
+    std::function<void()> on_built;
+
+    void EnumerateTagNames(const wxArrayString& files, const TagNameCallback_t& callback) override
+    {
+        TagsStorageSQLite::EnumerateTagNames(files, callback);
+        if(files.empty() && on_built) {
+            auto func = std::move(on_built);
+            on_built = nullptr;
+            func();
+        }
+    }
+};
+} // namespace
+
+TEST_FUNC(test_name_index_update_during_build)
+{
+    wxFileName fn(wxFileName::GetTempDir(), "ctagsd-tests-name-index-build.db");
+    if(fn.FileExists()) {
+        ::wxRemoveFile(fn.GetFullPath());
+    }
+
+    BuildHookStorage* storage = new BuildHookStorage();
+    ITagsStoragePtr db(storage);
+    db->OpenDatabase(fn);
+
+    auto make_tag = [](const wxString& name, const wxString& file) {
+        TagEntryPtr tag(new TagEntry());
+        tag->SetName(name);
+        tag->SetPath(name);
+        tag->SetFile(file);
+        tag->SetKind("function");
+        tag->SetLine(1);
+        return tag;
+    };
+    db->Store({ make_tag("OldName", "/src/a.cpp") });
+
+    // the parser thread stores a file after build() read the database but before the index is ready
+    NameIndex index;
+    storage->on_built = [&]() {
+        db->DeleteByFileName({}, "/src/a.cpp", true);
+        db->Store({ make_tag("NewName", "/src/a.cpp") });
+        index.update(db, { "/src/a.cpp" });
+    };
+    index.build(db);
+
+    std::vector<long> ids;
+    std::vector<TagEntryPtr> tags;
+    CHECK_BOOL(index.find("NewName", 10, ids));
+    db->GetTagsByIds(ids, tags);
+    CHECK_SIZE(tags.size(), 1);
+    CHECK_STRING(tags[0]->GetName(), "NewName");
+
+    ids.clear();
+    CHECK_BOOL(index.find("OldName", 10, ids));
+    CHECK_SIZE(ids.size(), 0);
+    return true;
+}
+
+TEST_FUNC(test_stable_hash)
+{
+    // XXH64 reference values
+    const char* text = "Nobody inspects the spammish repetition";
+    CHECK_BOOL(FileUtils::GetStableHash("", 0) == 0xef46db3751d8e999ULL);
+    CHECK_BOOL(FileUtils::GetStableHash(text, strlen(text)) == 0xfbcea83c8a378bf1ULL);
+    CHECK_BOOL(FileUtils::GetStableHash(text, strlen(text), 0xef46db3751d8e999ULL) == 0x35aa89418937fe49ULL);
+    CHECK_BOOL(FileUtils::GetStableHash(wxString(text)) == 0xfbcea83c8a378bf1ULL);
+    return true;
+}
+
+TEST_FUNC(test_retag_unchanged_content)
+{
+    CHECK_STRING(FileUtils::GetContentHash(""), "ef46db3751d8e999");
+    CHECK_STRING(FileUtils::GetContentHash("Nobody inspects the spammish repetition"), "fbcea83c8a378bf1");
+
+    wxFileName dbfile(wxFileName::GetTempDir(), "ctagsd-tests-files-hash.db");
+    if(dbfile.FileExists()) {
+        ::wxRemoveFile(dbfile.GetFullPath());
+    }
+    ITagsStoragePtr db(new TagsStorageSQLite());
+    db->OpenDatabase(dbfile);
+
+    wxFileName source(wxFileName::GetTempDir(), "ctagsd-tests-files-hash.cpp");
+    FileUtils::WriteFileContent(source, "int foo();");
+
+    // tagged before the last modification, same content
+    db->InsertFileEntry(source.GetFullPath(), 0, FileUtils::GetFileHash(source.GetFullPath()));
+    wxArrayString files;
+    files.Add(source.GetFullPath());
+    TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files, db);
+    CHECK_SIZE(files.size(), 0);
+
+    // different content
+    db->InsertFileEntry(source.GetFullPath(), 0, FileUtils::GetContentHash("int bar();"));
+    files.Add(source.GetFullPath());
+    wxStringMap_t hashes;
+    TagsManagerST::Get()->FilterNonNeededFilesForRetaging(files, db, &hashes);
+    CHECK_SIZE(files.size(), 1);
+
+    // the hash computed while filtering is handed to the parser
+    CHECK_SIZE(hashes.size(), 1);
+    CHECK_BOOL(hashes[source.GetFullPath()] == FileUtils::GetContentHash("int foo();"));
+    return true;
+}
+
 int main(int argc, char** argv)
 {
     wxInitializer initializer(argc, argv);
@@ -61,6 +61,8 @@ public:
   
   /// Close a result set returned by the database or a prepared statement previously
   virtual bool CloseResultSet(DatabaseResultSet* pResultSet);
+  /// Abort the statement running on another thread (no-op unless the database supports it)
+  virtual void Interrupt() { }
 
   // PreparedStatement support
   /// Prepare a SQL statement which can be reused with different parameters
@@ -49,6 +49,7 @@ public:
   // query database
   virtual int RunQuery(const wxString& strQuery, bool bParseQuery);
   virtual DatabaseResultSet* RunQueryWithResults(const wxString& strQuery);
+  virtual void Interrupt();
   
   // PreparedStatement support
   virtual PreparedStatement* PrepareStatement(const wxString& strQuery);
@@ -100,6 +100,13 @@ bool SqliteDatabaseLayer::IsOpen()
   return (m_pDatabase != NULL);
 }
 
+void SqliteDatabaseLayer::Interrupt()
+{
+  // sqlite3_interrupt is safe to call from any thread while the connection is open
+  if (m_pDatabase != NULL)
+    sqlite3_interrupt((sqlite3*)m_pDatabase);
+}
+
 void SqliteDatabaseLayer::BeginTransaction()
 {
   wxLogDebug(_("Beginning transaction"));
@@ -55,6 +55,7 @@ CL_PLUGIN_API PluginInfo* GetPluginInfo()
     info.SetName(wxT("wxFormBuilder"));
     info.SetDescription(_("wxFormBuilder integration with CodeLite"));
     info.SetVersion(wxT("v1.0"));
+    info.EnableFlag(PluginInfo::kLoadOnIdle, true);
     return &info;
 }
 